@@ -0,0 +1,309 @@
+#include "AdaptiveTableGenerator.h"
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace {
+    typedef RPATableInterpolator::PerformanceData PerformanceData;
+
+    const double G0 = 9.80665;
+    const double R_UNIVERSAL = 8.314462618;
+
+    void fieldValues(const PerformanceData& p, double out[RPATableInterpolator::NUM_FIELDS]) {
+        out[RPATableInterpolator::FIELD_CF] = p.Cf;
+        out[RPATableInterpolator::FIELD_CSTAR] = p.Cstar;
+        out[RPATableInterpolator::FIELD_ISP] = p.Isp;
+        out[RPATableInterpolator::FIELD_VE] = p.Ve;
+        out[RPATableInterpolator::FIELD_PE] = p.Pe;
+        out[RPATableInterpolator::FIELD_GAMMA] = p.gamma;
+    }
+
+    std::vector<double> linspace(const AdaptiveTableGenerator::Axis& axis) {
+        std::vector<double> values;
+        if (axis.initialPoints <= 1) {
+            values.push_back(axis.min);
+            return values;
+        }
+        double step = (axis.max - axis.min) / (axis.initialPoints - 1);
+        for (int i = 0; i < axis.initialPoints; ++i) {
+            values.push_back(i == axis.initialPoints - 1 ? axis.max : axis.min + step * i);
+        }
+        return values;
+    }
+}
+
+AdaptiveTableGenerator::Settings::Settings()
+    : tolerance(1.0e-3)
+    , fields(RPATableInterpolator::MASK_ALL)
+    , mode(RPATableInterpolator::InterpolationMode::Trilinear)
+    , maxPoints(200000)
+    , maxPasses(20) {
+    Pc = { 100.0, 1000.0, 3 };
+    OF = { 1.0, 3.5, 3 };
+    Pa = { 0.0, 14.7, 2 };
+}
+
+AdaptiveTableGenerator::AdaptiveTableGenerator(const Settings& settings)
+    : m_settings(settings) {
+    m_report = Report();
+}
+
+const PerformanceData* AdaptiveTableGenerator::sample(Oracle& oracle, const Point& p) {
+    auto it = m_samples.find(p);
+    if (it != m_samples.end()) {
+        return &it->second;
+    }
+
+    PerformanceData data;
+    if (!oracle.sample(p[0], p[1], p[2], data)) {
+        m_error = "Oracle failed at Pc=" + std::to_string(p[0]) + ", OF=" + std::to_string(p[1]) +
+                  ", Pa=" + std::to_string(p[2]);
+        return nullptr;
+    }
+    return &m_samples.insert(std::make_pair(p, data)).first->second;
+}
+
+bool AdaptiveTableGenerator::gridSamples(Oracle& oracle, std::vector<PerformanceData>& points) {
+    points.clear();
+    points.reserve(m_axes[0].size() * m_axes[1].size() * m_axes[2].size());
+    for (double Pc : m_axes[0]) {
+        for (double OF : m_axes[1]) {
+            for (double Pa : m_axes[2]) {
+                const PerformanceData* p = sample(oracle, Point{ { Pc, OF, Pa } });
+                if (!p) return false;
+                points.push_back(*p);
+            }
+        }
+    }
+    return true;
+}
+
+bool AdaptiveTableGenerator::buildTable(RPATableInterpolator& table) const {
+    std::vector<PerformanceData> points;
+    points.reserve(m_axes[0].size() * m_axes[1].size() * m_axes[2].size());
+    for (double Pc : m_axes[0]) {
+        for (double OF : m_axes[1]) {
+            for (double Pa : m_axes[2]) {
+                auto it = m_samples.find(Point{ { Pc, OF, Pa } });
+                if (it == m_samples.end()) return false;
+                points.push_back(it->second);
+            }
+        }
+    }
+    table.setInterpolationMode(m_settings.mode);
+    return table.loadGrid(m_axes[0], m_axes[1], m_axes[2], points);
+}
+
+bool AdaptiveTableGenerator::generate(Oracle& oracle) {
+    const int NF = RPATableInterpolator::NUM_FIELDS;
+
+    m_axes[0] = linspace(m_settings.Pc);
+    m_axes[1] = linspace(m_settings.OF);
+    m_axes[2] = linspace(m_settings.Pa);
+    m_report = Report();
+    m_error.clear();
+
+    for (int pass = 1; pass <= m_settings.maxPasses; ++pass) {
+        m_report.passes = pass;
+
+        std::vector<PerformanceData> points;
+        if (!gridSamples(oracle, points)) {
+            return false;
+        }
+
+        RPATableInterpolator table;
+        table.setInterpolationMode(m_settings.mode);
+        if (!table.loadGrid(m_axes[0], m_axes[1], m_axes[2], points)) {
+            m_error = "Invalid grid";
+            return false;
+        }
+
+        // Absolute tolerance per field from its largest magnitude
+        double tolerance[NF];
+        for (int f = 0; f < NF; ++f) tolerance[f] = 0.0;
+        for (const auto& p : points) {
+            double v[NF];
+            fieldValues(p, v);
+            for (int f = 0; f < NF; ++f) tolerance[f] = std::max(tolerance[f], std::abs(v[f]));
+        }
+        for (int f = 0; f < NF; ++f) {
+            tolerance[f] = m_settings.tolerance * (tolerance[f] > 0.0 ? tolerance[f] : 1.0);
+        }
+
+        size_t n[3];
+        std::vector<char> refine[3];
+        std::vector<double> intervalError[3];   // Worst edge-midpoint error ratio per interval
+        for (int a = 0; a < 3; ++a) {
+            n[a] = m_axes[a].size();
+            refine[a].assign(n[a] > 1 ? n[a] - 1 : 0, 0);
+            intervalError[a].assign(refine[a].size(), 0.0);
+        }
+
+        m_report.maxErrorRatio = 0.0;
+        m_report.midpointsChecked = 0;
+        for (int f = 0; f < NF; ++f) m_report.maxError[f] = 0.0;
+
+        // Each nonempty axis subset picks the points at interval midpoints
+        // along those axes and on breakpoints along the others: cell edge
+        // midpoints (one axis) first, then face centres (two) and cell
+        // centres (three)
+        static const unsigned SUBSETS[7] = { 1, 2, 4, 3, 5, 6, 7 };
+        for (unsigned subset : SUBSETS) {
+            size_t count[3];
+            bool usable = true;
+            for (int a = 0; a < 3; ++a) {
+                bool mid = (subset >> a) & 1u;
+                if (mid && n[a] < 2) usable = false;
+                count[a] = mid ? n[a] - 1 : n[a];
+            }
+            if (!usable) continue;
+
+            size_t idx[3];
+            for (idx[0] = 0; idx[0] < count[0]; ++idx[0]) {
+                for (idx[1] = 0; idx[1] < count[1]; ++idx[1]) {
+                    for (idx[2] = 0; idx[2] < count[2]; ++idx[2]) {
+                        Point p;
+                        for (int a = 0; a < 3; ++a) {
+                            const std::vector<double>& v = m_axes[a];
+                            p[a] = ((subset >> a) & 1u) ? 0.5 * (v[idx[a]] + v[idx[a] + 1]) : v[idx[a]];
+                        }
+
+                        const PerformanceData* exact = sample(oracle, p);
+                        if (!exact) return false;
+                        PerformanceData got = table.getPerformance(p[0], p[1], p[2]);
+
+                        double e[NF], g[NF];
+                        fieldValues(*exact, e);
+                        fieldValues(got, g);
+                        double ratio = 0.0;
+                        for (int f = 0; f < NF; ++f) {
+                            if (!(m_settings.fields & (1u << f))) continue;
+                            double err = std::abs(g[f] - e[f]);
+                            m_report.maxError[f] = std::max(m_report.maxError[f], err);
+                            ratio = std::max(ratio, err / tolerance[f]);
+                        }
+                        m_report.maxErrorRatio = std::max(m_report.maxErrorRatio, ratio);
+                        ++m_report.midpointsChecked;
+
+                        int single = (subset == 1) ? 0 : (subset == 2) ? 1 : (subset == 4) ? 2 : -1;
+                        if (single >= 0) {
+                            double& worst = intervalError[single][idx[single]];
+                            worst = std::max(worst, ratio);
+                            if (ratio > 1.0) refine[single][idx[single]] = 1;
+                            continue;
+                        }
+                        if (ratio <= 1.0) continue;
+
+                        // A face or cell centre failing is usually the edge
+                        // error of one axis showing through; if none of its
+                        // intervals is split yet, split the one whose edges
+                        // are worst (mixed-derivative error gets another
+                        // pass to resolve)
+                        int worstAxis = -1;
+                        for (int a = 0; a < 3; ++a) {
+                            if (!((subset >> a) & 1u)) continue;
+                            if (refine[a][idx[a]]) {
+                                worstAxis = -1;
+                                break;
+                            }
+                            if (worstAxis < 0 ||
+                                intervalError[a][idx[a]] > intervalError[worstAxis][idx[worstAxis]]) {
+                                worstAxis = a;
+                            }
+                        }
+                        if (worstAxis >= 0) refine[worstAxis][idx[worstAxis]] = 1;
+                    }
+                }
+            }
+        }
+
+        m_report.gridPoints = points.size();
+        for (int a = 0; a < 3; ++a) m_report.axisPoints[a] = n[a];
+        m_report.oracleSamples = m_samples.size();
+
+        size_t refined[3];
+        size_t newPoints = 1;
+        for (int a = 0; a < 3; ++a) {
+            refined[a] = std::count(refine[a].begin(), refine[a].end(), 1);
+            newPoints *= n[a] + refined[a];
+        }
+        if (refined[0] + refined[1] + refined[2] == 0) {
+            m_report.converged = true;
+            return true;
+        }
+        if (pass == m_settings.maxPasses || newPoints > m_settings.maxPoints) {
+            // Out of budget: keep the last checked grid
+            return true;
+        }
+
+        // Split every flagged interval at its midpoint
+        for (int a = 0; a < 3; ++a) {
+            std::vector<double> values;
+            for (size_t i = 0; i < n[a]; ++i) {
+                values.push_back(m_axes[a][i]);
+                if (i + 1 < n[a] && refine[a][i]) {
+                    values.push_back(0.5 * (m_axes[a][i] + m_axes[a][i + 1]));
+                }
+            }
+            m_axes[a].swap(values);
+        }
+    }
+    return true;
+}
+
+bool AdaptiveTableGenerator::writeCsv(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "Pc_psi,OF,Pa_psi,Cf,Cstar_ms,Isp_s,Ve_ms,Pe_psi,Gamma\n";
+    // Breakpoints are written exactly so the axes load back unchanged
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (double Pc : m_axes[0]) {
+        for (double OF : m_axes[1]) {
+            for (double Pa : m_axes[2]) {
+                auto it = m_samples.find(Point{ { Pc, OF, Pa } });
+                if (it == m_samples.end()) return false;
+                const PerformanceData& p = it->second;
+                file << Pc << "," << OF << "," << Pa << ","
+                     << p.Cf << "," << p.Cstar << "," << p.Isp << ","
+                     << p.Ve << "," << p.Pe << "," << p.gamma << "\n";
+            }
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+bool AnalyticOracle::sample(double Pc, double OF, double Pa, PerformanceData& out) {
+    const double Tc = 3450.0 * std::exp(-0.35 * (OF - 2.6) * (OF - 2.6));
+    const double M = 18.0 + 3.0 * OF;                       // g/mol
+    const double g = 1.25 - 0.04 * (OF - 1.0) + 0.002 * std::log(Pc);
+    const double gm1 = g - 1.0, gp1 = g + 1.0;
+
+    const double Gamma = std::sqrt(g) * std::pow(2.0 / gp1, gp1 / (2.0 * gm1));
+    const double cstar = std::sqrt(R_UNIVERSAL * 1000.0 / M * Tc) / Gamma;
+
+    // Supersonic exit Mach number for the area ratio (Newton on ln)
+    double Me = 3.0;
+    for (int i = 0; i < 50; ++i) {
+        double base = (2.0 / gp1) * (1.0 + 0.5 * gm1 * Me * Me);
+        double f = std::log(std::pow(base, gp1 / (2.0 * gm1)) / Me) - std::log(m_areaRatio);
+        double df = (Me * Me - 1.0) / (Me * (1.0 + 0.5 * gm1 * Me * Me));
+        double step = f / df;
+        Me = std::max(1.0001, Me - step);
+        if (std::abs(step) < 1e-14) break;
+    }
+    const double PeRatio = std::pow(1.0 + 0.5 * gm1 * Me * Me, -g / gm1);
+
+    const double cfMomentum = Gamma * std::sqrt(2.0 * g / gm1 * (1.0 - std::pow(PeRatio, gm1 / g)));
+    out.Cf = cfMomentum + (PeRatio - Pa / Pc) * m_areaRatio;
+    out.Cstar = cstar;
+    out.Isp = out.Cf * cstar / G0;
+    out.Ve = cfMomentum * cstar;
+    out.Pe = PeRatio * Pc;
+    out.gamma = g;
+    return true;
+}
@@ -0,0 +1,131 @@
+#ifndef ADAPTIVE_TABLE_GENERATOR_H
+#define ADAPTIVE_TABLE_GENERATOR_H
+
+#include "RPATableInterpolator.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <array>
+
+/**
+ * AdaptiveTableGenerator
+ *
+ * Builds a performance table with as few grid points as possible for a
+ * given accuracy. Starting from a coarse grid, every pass compares the
+ * interpolated table against the sample oracle at the midpoint of every
+ * cell edge, face and body. An edge midpoint out of tolerance splits its
+ * interval; a face or body centre out of tolerance splits only the interval
+ * whose edges are worst, so an axis the fields are nearly linear in (Pa)
+ * stays coarse. Refinement stops once every midpoint is within tolerance.
+ *
+ * The result is a full tensor grid with non-uniform axes, which
+ * RPATableInterpolator loads natively (CSV or compiled).
+ */
+class AdaptiveTableGenerator {
+public:
+    /**
+     * Source of exact table values (an equilibrium solver, RPA, or an
+     * analytic model for testing)
+     */
+    class Oracle {
+    public:
+        virtual ~Oracle() {}
+
+        /**
+         * Performance at one operating point
+         * @return false if the point cannot be evaluated
+         */
+        virtual bool sample(double Pc, double OF, double Pa,
+                            RPATableInterpolator::PerformanceData& out) = 0;
+    };
+
+    struct Axis {
+        double min, max;
+        int initialPoints;      // Breakpoints of the starting grid (>= 2, or 1 for a fixed value)
+    };
+
+    struct Settings {
+        Axis Pc, OF, Pa;
+        // Error allowed in each field, relative to the largest magnitude of
+        // that field in the table
+        double tolerance;
+        // Fields the tolerance applies to (FieldMask values)
+        unsigned fields;
+        // Interpolation scheme the table will be used with
+        RPATableInterpolator::InterpolationMode mode;
+        // Refinement stops (unconverged) rather than exceed this many grid points
+        size_t maxPoints;
+        int maxPasses;
+
+        Settings();
+    };
+
+    struct Report {
+        bool converged;
+        int passes;
+        size_t gridPoints;
+        size_t axisPoints[3];       // Pc, OF, Pa
+        size_t oracleSamples;       // Distinct points sampled (grid and midpoints)
+        size_t midpointsChecked;    // In the final pass
+        double maxErrorRatio;       // Worst error / tolerance in the final pass
+        double maxError[RPATableInterpolator::NUM_FIELDS];  // Worst absolute error per field, final pass
+    };
+
+    explicit AdaptiveTableGenerator(const Settings& settings);
+
+    /**
+     * Refine the grid until it meets the tolerance
+     * @return false if the oracle failed at some point (see getError)
+     */
+    bool generate(Oracle& oracle);
+
+    const Report& getReport() const { return m_report; }
+    const std::string& getError() const { return m_error; }
+
+    const std::vector<double>& getAxis(int axis) const { return m_axes[axis]; }
+
+    /**
+     * The generated table, loaded into an interpolator
+     */
+    bool buildTable(RPATableInterpolator& table) const;
+
+    /**
+     * Write the generated table in the generate_rpa_tables.js CSV format
+     */
+    bool writeCsv(const std::string& filename) const;
+
+private:
+    typedef std::array<double, 3> Point;
+
+    // Oracle value at a point, cached across passes
+    const RPATableInterpolator::PerformanceData* sample(Oracle& oracle, const Point& p);
+
+    // Grid samples in [Pc][OF][Pa] order
+    bool gridSamples(Oracle& oracle, std::vector<RPATableInterpolator::PerformanceData>& points);
+
+    Settings m_settings;
+    std::vector<double> m_axes[3];
+    std::map<Point, RPATableInterpolator::PerformanceData> m_samples;
+    Report m_report;
+    std::string m_error;
+};
+
+/**
+ * AnalyticOracle
+ *
+ * Ideal rocket with frozen gamma at a fixed area ratio and a smooth
+ * synthetic combustion model (chamber temperature peaking near
+ * stoichiometric O/F). Curved like real tables but needs no data files, so
+ * the refinement can be tested anywhere.
+ */
+class AnalyticOracle : public AdaptiveTableGenerator::Oracle {
+public:
+    explicit AnalyticOracle(double areaRatio) : m_areaRatio(areaRatio) {}
+
+    bool sample(double Pc, double OF, double Pa, RPATableInterpolator::PerformanceData& out) override;
+
+private:
+    double m_areaRatio;
+};
+
+#endif // ADAPTIVE_TABLE_GENERATOR_H
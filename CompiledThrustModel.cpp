@@ -0,0 +1,46 @@
+#include "CompiledThrustModel.h"
+#include "RPATableInterpolator.h"
+#include <stdexcept>
+
+CompiledThrustModel::CompiledThrustModel(const RPATableInterpolator& table, double At_in2)
+    : m_stridePc(0)
+    , m_strideOF(0)
+    , m_At_in2(At_in2) {
+    if (!table.isValid()) {
+        throw std::invalid_argument("CompiledThrustModel: performance table not loaded");
+    }
+    if (table.getInterpolationMode() != RPATableInterpolator::InterpolationMode::Trilinear) {
+        throw std::invalid_argument("CompiledThrustModel: performance table must use trilinear interpolation");
+    }
+    if (!(At_in2 > 0.0) || !std::isfinite(At_in2)) {
+        throw std::invalid_argument("CompiledThrustModel: throat area must be positive");
+    }
+
+    const std::vector<double>& Pc = table.getPcBreakpoints();
+    const std::vector<double>& OF = table.getOFBreakpoints();
+    const std::vector<double>& Pa = table.getPaBreakpoints();
+    m_Pc_axis.assign(Pc);
+    m_OF_axis.assign(OF);
+    m_Pa_axis.assign(Pa);
+    m_strideOF = Pa.size();
+    m_stridePc = OF.size() * Pa.size();
+
+    // Cf at a breakpoint is the stored grid value, whatever the storage precision
+    m_thrustPerPsi.reserve(Pc.size() * m_stridePc);
+    for (double p : Pc) {
+        for (double r : OF) {
+            for (double a : Pa) {
+                m_thrustPerPsi.push_back(table.getFields<RPATableInterpolator::MASK_CF>(p, r, a).Cf * At_in2);
+            }
+        }
+    }
+}
+
+void CompiledThrustModel::thrustBatch(const double* Pc, const double* OF, const double* Pa, size_t count,
+                                      double* F, unsigned& status) const noexcept {
+    unsigned flags = STATUS_OK;
+    for (size_t i = 0; i < count; ++i) {
+        F[i] = thrust(Pc[i], OF[i], Pa[i], flags);
+    }
+    status |= flags;
+}
@@ -0,0 +1,110 @@
+#ifndef COMPILED_THRUST_MODEL_H
+#define COMPILED_THRUST_MODEL_H
+
+#include "TableAxis.h"
+#include "MultilinearKernel.h"
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+
+class RPATableInterpolator;
+
+/**
+ * CompiledThrustModel
+ *
+ * Immutable thrust surface for the inner loop of a simulation, produced by
+ * ThrustCalculator::compile(). Cf × At is folded into one thrust-per-psi
+ * value per grid point, so thrust is a single trilinear interpolation times
+ * Pc: F = (Cf × At)(Pc, O/F, Pa) × Pc.
+ *
+ * Everything is validated when the model is built. Queries are noexcept,
+ * perform no readiness checks and never throw. Problems with the inputs are
+ * reported by OR-ing Status flags into a caller-owned status word, so a step
+ * loop can test it once after many queries. Results match
+ * ThrustCalculator::calculateThrust on a trilinear table to rounding.
+ *
+ * The model owns its data; it stays valid when the calculator or table it
+ * came from changes or goes away, and is safe to share across threads.
+ */
+class CompiledThrustModel {
+public:
+    enum Status {
+        STATUS_OK = 0,
+        STATUS_NON_FINITE = 1u << 0,        // NaN or infinite input; thrust is NaN
+        STATUS_CLAMPED = 1u << 1,           // Pc, O/F or Pa outside the table, clamped to its edge
+        STATUS_INVALID_FLOW = 1u << 2       // Fuel flow not positive, so O/F is undefined; thrust is NaN
+    };
+
+    /**
+     * Fold a loaded trilinear table and a throat area into a thrust surface
+     * @throws std::invalid_argument if the table is not loaded, is not in
+     *         trilinear mode, or At is not positive
+     */
+    CompiledThrustModel(const RPATableInterpolator& table, double At_in2);
+
+    /**
+     * Thrust (lbf) at chamber pressure Pc (psi), mixture ratio and ambient
+     * pressure Pa (psi)
+     * @param status Status flags are OR-ed in (never cleared)
+     */
+    double thrust(double Pc, double OF, double Pa, unsigned& status) const noexcept;
+
+    /**
+     * Thrust from propellant flows, like ThrustCalculator::calculateThrust
+     */
+    double thrust(double Pc, double mdot_ox, double mdot_fuel, double Pa, unsigned& status) const noexcept;
+
+    /**
+     * Thrust at many points (structure-of-arrays); status collects the flags
+     * of every point
+     */
+    void thrustBatch(const double* Pc, const double* OF, const double* Pa, size_t count,
+                     double* F, unsigned& status) const noexcept;
+
+    double getThroatArea() const noexcept { return m_At_in2; }
+
+private:
+    TableAxis m_Pc_axis;
+    TableAxis m_OF_axis;
+    TableAxis m_Pa_axis;
+    size_t m_stridePc;
+    size_t m_strideOF;
+    std::vector<double> m_thrustPerPsi;     // Cf × At (lbf/psi), [Pc][OF][Pa], Pa fastest
+    double m_At_in2;
+};
+
+inline double CompiledThrustModel::thrust(double Pc, double OF, double Pa, unsigned& status) const noexcept {
+    // Non-short-circuit tests keep the flag computation branch-free
+    const bool finite = std::isfinite(Pc) & std::isfinite(OF) & std::isfinite(Pa);
+    const bool clamped = (Pc < m_Pc_axis.front()) | (Pc > m_Pc_axis.back()) |
+                         (OF < m_OF_axis.front()) | (OF > m_OF_axis.back()) |
+                         (Pa < m_Pa_axis.front()) | (Pa > m_Pa_axis.back());
+    status |= (finite ? 0u : unsigned(STATUS_NON_FINITE)) | (clamped ? unsigned(STATUS_CLAMPED) : 0u);
+
+    // findBounds clamps (NaN goes to the first breakpoint)
+    int i0, i1, j0, j1, k0, k1;
+    double t[3];
+    m_Pc_axis.findBounds(Pc, i0, i1, t[0]);
+    m_OF_axis.findBounds(OF, j0, j1, t[1]);
+    m_Pa_axis.findBounds(Pa, k0, k1, t[2]);
+
+    const size_t delta[3] = { (i1 - i0) * m_stridePc, (j1 - j0) * m_strideOF, static_cast<size_t>(k1 - k0) };
+
+    // Same kernel as RPATableInterpolator's trilinear path
+    double c[8];
+    MultilinearKernel<3>::gatherCorners(m_thrustPerPsi.data() + i0 * m_stridePc + j0 * m_strideOF + k0, delta, c);
+    double perPsi = MultilinearKernel<3>::blend(c, t);
+
+    return finite ? perPsi * Pc : std::numeric_limits<double>::quiet_NaN();
+}
+
+inline double CompiledThrustModel::thrust(double Pc, double mdot_ox, double mdot_fuel, double Pa,
+                                          unsigned& status) const noexcept {
+    const bool validFlow = mdot_fuel > 0.0;
+    status |= validFlow ? 0u : unsigned(STATUS_INVALID_FLOW);
+    double F = thrust(Pc, mdot_ox / (validFlow ? mdot_fuel : 1.0), Pa, status);
+    return validFlow ? F : std::numeric_limits<double>::quiet_NaN();
+}
+
+#endif // COMPILED_THRUST_MODEL_H
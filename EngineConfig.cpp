@@ -0,0 +1,385 @@
+#include "EngineConfig.h"
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+namespace {
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+    const double PA_PER_PSI = 6894.757293168;
+    const double N_PER_LBF = 4.4482216152605;
+    const double G0 = 9.80665;      // m/s^2, for kgf and tf
+
+    // One libconfig setting; groups, lists and arrays hold children
+    struct Setting {
+        enum Type { GROUP, LIST, NUMBER, STRING, BOOLEAN };
+
+        Type type;
+        std::string name;           // Empty for list and array elements
+        double number;
+        std::string text;
+        bool flag;
+        std::vector<Setting> children;
+
+        Setting() : type(GROUP), number(0.0), flag(false) {}
+
+        const Setting* child(const std::string& key) const {
+            for (const Setting& c : children) {
+                if (c.name == key) return &c;
+            }
+            return nullptr;
+        }
+    };
+
+    /**
+     * Recursive-descent parser for the libconfig grammar: settings are
+     * name (':' | '=') value, optionally followed by ';' or ','
+     */
+    class Parser {
+    public:
+        explicit Parser(const std::string& text)
+            : m_p(text.c_str()), m_end(text.c_str() + text.size()), m_line(1) {
+        }
+
+        bool parse(Setting& root, std::string& error) {
+            root.type = Setting::GROUP;
+            if (!parseSettings(root, '\0')) {
+                std::ostringstream msg;
+                msg << "line " << m_line << ": " << m_error;
+                error = msg.str();
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        bool fail(const char* message) {
+            m_error = message;
+            return false;
+        }
+
+        // Skip whitespace and #, // and /* */ comments
+        void skipSpace() {
+            while (m_p < m_end) {
+                if (*m_p == '\n') {
+                    ++m_line;
+                    ++m_p;
+                } else if (std::isspace(static_cast<unsigned char>(*m_p))) {
+                    ++m_p;
+                } else if (*m_p == '#' || (*m_p == '/' && m_p + 1 < m_end && m_p[1] == '/')) {
+                    while (m_p < m_end && *m_p != '\n') ++m_p;
+                } else if (*m_p == '/' && m_p + 1 < m_end && m_p[1] == '*') {
+                    for (m_p += 2; m_p < m_end && !(*m_p == '*' && m_p + 1 < m_end && m_p[1] == '/'); ++m_p) {
+                        if (*m_p == '\n') ++m_line;
+                    }
+                    m_p = m_p < m_end ? m_p + 2 : m_end;
+                } else {
+                    break;
+                }
+            }
+        }
+
+        bool accept(char c) {
+            skipSpace();
+            if (m_p < m_end && *m_p == c) {
+                ++m_p;
+                return true;
+            }
+            return false;
+        }
+
+        static bool isNameChar(char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-' || c == '*';
+        }
+
+        // Settings up to the terminator ('}' for a group, '\0' at file end)
+        bool parseSettings(Setting& group, char terminator) {
+            for (;;) {
+                skipSpace();
+                if (m_p == m_end) {
+                    return terminator == '\0' ? true : fail("missing '}'");
+                }
+                if (*m_p == terminator) {
+                    ++m_p;
+                    return true;
+                }
+                if (*m_p == '@') {
+                    return fail("@include is not supported");
+                }
+                if (!std::isalpha(static_cast<unsigned char>(*m_p)) && *m_p != '*') {
+                    return fail("expected a setting name");
+                }
+                Setting setting;
+                const char* start = m_p;
+                const size_t nameLine = m_line;
+                while (m_p < m_end && isNameChar(*m_p)) ++m_p;
+                setting.name.assign(start, m_p);
+                if (!accept(':') && !accept('=')) {
+                    m_line = nameLine;
+                    return fail("expected ':' or '=' after a setting name");
+                }
+                if (!parseValue(setting)) {
+                    return false;
+                }
+                if (!accept(';')) accept(',');
+                group.children.push_back(std::move(setting));
+            }
+        }
+
+        // Comma-separated values of a list or array, up to the closing bracket
+        bool parseElements(Setting& list, char close) {
+            list.type = Setting::LIST;
+            if (accept(close)) {
+                return true;
+            }
+            for (;;) {
+                Setting element;
+                if (!parseValue(element)) {
+                    return false;
+                }
+                list.children.push_back(std::move(element));
+                if (accept(close)) {
+                    return true;
+                }
+                if (!accept(',')) {
+                    return fail("expected ',' between elements");
+                }
+            }
+        }
+
+        bool parseValue(Setting& setting) {
+            skipSpace();
+            if (m_p == m_end) {
+                return fail("missing value");
+            }
+            const char c = *m_p;
+            if (c == '{') {
+                ++m_p;
+                setting.type = Setting::GROUP;
+                return parseSettings(setting, '}');
+            }
+            if (c == '(' || c == '[') {
+                ++m_p;
+                return parseElements(setting, c == '(' ? ')' : ']');
+            }
+            if (c == '"') {
+                setting.type = Setting::STRING;
+                // Adjacent string literals are concatenated
+                do {
+                    if (!parseString(setting.text)) return false;
+                    skipSpace();
+                } while (m_p < m_end && *m_p == '"');
+                return true;
+            }
+            if (std::isalpha(static_cast<unsigned char>(c))) {
+                const char* start = m_p;
+                while (m_p < m_end && std::isalpha(static_cast<unsigned char>(*m_p))) ++m_p;
+                std::string word(start, m_p);
+                for (char& w : word) w = static_cast<char>(std::tolower(static_cast<unsigned char>(w)));
+                if (word != "true" && word != "false") {
+                    return fail("unexpected word where a value was expected");
+                }
+                setting.type = Setting::BOOLEAN;
+                setting.flag = word == "true";
+                return true;
+            }
+            return parseNumber(setting);
+        }
+
+        bool parseString(std::string& out) {
+            ++m_p;      // Opening quote
+            while (m_p < m_end && *m_p != '"') {
+                char c = *m_p++;
+                if (c == '\n') {
+                    ++m_line;
+                } else if (c == '\\' && m_p < m_end) {
+                    c = *m_p++;
+                    switch (c) {
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case 'r': c = '\r'; break;
+                    case 'f': c = '\f'; break;
+                    default: break;     // \" and \\ stand for themselves
+                    }
+                }
+                out += c;
+            }
+            if (m_p == m_end) {
+                return fail("unterminated string");
+            }
+            ++m_p;
+            return true;
+        }
+
+        bool parseNumber(Setting& setting) {
+            // The file is not NUL-terminated, so copy the token for strtod
+            const char* start = m_p;
+            while (m_p < m_end && (std::isalnum(static_cast<unsigned char>(*m_p)) ||
+                                   *m_p == '.' || *m_p == '+' || *m_p == '-')) {
+                ++m_p;
+            }
+            std::string token(start, m_p);
+            while (!token.empty() && (token.back() == 'L' || token.back() == 'l')) {
+                token.pop_back();   // 64-bit integer suffix
+            }
+            if (token.empty()) {
+                return fail("expected a value");
+            }
+            char* parsed = nullptr;
+            const bool hex = token.size() > 2 && token[0] == '0' && (token[1] == 'x' || token[1] == 'X');
+            setting.number = hex ? static_cast<double>(std::strtoull(token.c_str(), &parsed, 16))
+                                 : std::strtod(token.c_str(), &parsed);
+            if (parsed != token.c_str() + token.size()) {
+                return fail("malformed number");
+            }
+            setting.type = Setting::NUMBER;
+            return true;
+        }
+
+        const char* m_p;
+        const char* m_end;
+        size_t m_line;
+        std::string m_error;
+    };
+
+    // Setting at a dot-separated path below group, or null
+    const Setting* find(const Setting& group, const char* path) {
+        const Setting* s = &group;
+        while (s && *path) {
+            const char* dot = std::strchr(path, '.');
+            const std::string key = dot ? std::string(path, dot) : std::string(path);
+            s = s->type == Setting::GROUP ? s->child(key) : nullptr;
+            path = dot ? dot + 1 : path + key.size();
+        }
+        return s;
+    }
+
+    double number(const Setting* s) {
+        return s && s->type == Setting::NUMBER ? s->number : NaN;
+    }
+
+    std::string text(const Setting* s) {
+        return s && s->type == Setting::STRING ? s->text : std::string();
+    }
+
+    // Pressure in psi from a { value, unit } group; NaN for unknown units
+    double pressure(const Setting* s) {
+        if (!s) return NaN;
+        const double value = number(s->child("value"));
+        const std::string unit = text(s->child("unit"));
+        if (unit == "psi") return value;
+        if (unit == "Pa") return value / PA_PER_PSI;
+        if (unit == "kPa") return value * 1e3 / PA_PER_PSI;
+        if (unit == "MPa") return value * 1e6 / PA_PER_PSI;
+        if (unit == "bar") return value * 1e5 / PA_PER_PSI;
+        if (unit == "atm") return value * 101325.0 / PA_PER_PSI;
+        if (unit == "at") return value * 98066.5 / PA_PER_PSI;
+        return NaN;
+    }
+
+    // Force in lbf from a { value, unit } group; NaN for unknown units
+    double force(const Setting* s) {
+        if (!s) return NaN;
+        const double value = number(s->child("value"));
+        const std::string unit = text(s->child("unit"));
+        if (unit == "lbf") return value;
+        if (unit == "N") return value / N_PER_LBF;
+        if (unit == "kN") return value * 1e3 / N_PER_LBF;
+        if (unit == "MN") return value * 1e6 / N_PER_LBF;
+        if (unit == "kg" || unit == "kgf") return value * G0 / N_PER_LBF;
+        if (unit == "t" || unit == "tf") return value * 1e3 * G0 / N_PER_LBF;
+        return NaN;
+    }
+
+    void readComponents(const Setting* list, std::vector<EngineConfig::Component>& out) {
+        if (!list) return;
+        for (const Setting& entry : list->children) {
+            EngineConfig::Component component;
+            component.name = text(entry.child("name"));
+            component.massFraction = number(entry.child("massFraction"));
+            if (component.massFraction != component.massFraction) component.massFraction = 1.0;
+            if (!component.name.empty()) out.push_back(component);
+        }
+    }
+
+    std::string joinComponents(const std::vector<EngineConfig::Component>& components) {
+        if (components.size() == 1) {
+            return components[0].name;
+        }
+        std::ostringstream joined;
+        for (size_t i = 0; i < components.size(); ++i) {
+            joined << (i ? "+" : "") << components[i].name << ':' << components[i].massFraction;
+        }
+        return joined.str();
+    }
+}
+
+EngineConfig::EngineConfig()
+    : m_chamberPressure(NaN)
+    , m_mixtureRatio(NaN)
+    , m_areaRatio(NaN)
+    , m_exitPressure(NaN)
+    , m_thrust(NaN)
+    , m_thrustAmbientPressure(NaN) {
+}
+
+bool EngineConfig::load(const std::string& filename) {
+    *this = EngineConfig();
+    m_filename = filename;
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        m_error = "cannot open file";
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+
+    Setting root;
+    if (!Parser(contents.str()).parse(root, m_error)) {
+        return false;
+    }
+
+    m_name = text(find(root, "name"));
+    m_info = text(find(root, "info"));
+
+    m_chamberPressure = pressure(find(root, "combustionChamberConditions.pressure"));
+    if (!(m_chamberPressure > 0.0)) {
+        m_error = "no chamber pressure in a known unit";
+        return false;
+    }
+
+    // Bipropellants list components; monopropellants and solids a mixture
+    readComponents(find(root, "propellant.components.oxidizer"), m_oxidizer);
+    readComponents(find(root, "propellant.components.fuel"), m_fuel);
+    readComponents(find(root, "propellant.mixture.species"), m_mixture);
+    if (m_oxidizer.empty() && m_fuel.empty() && m_mixture.empty()) {
+        m_error = "no propellant";
+        return false;
+    }
+
+    // RPA writes the mass mixture ratio as "O/F" or "km"
+    const Setting* ratio = find(root, "propellant.components.ratio");
+    const std::string ratioUnit = text(ratio ? ratio->child("unit") : nullptr);
+    if (!m_fuel.empty() && (ratioUnit == "O/F" || ratioUnit == "km")) {
+        m_mixtureRatio = number(ratio->child("value"));
+    }
+
+    m_areaRatio = number(find(root, "nozzleFlow.nozzleExitConditions.areaRatio"));
+    m_exitPressure = pressure(find(root, "nozzleFlow.nozzleExitConditions.pressure"));
+
+    m_thrust = force(find(root, "engineSize.thrust"));
+    m_thrustAmbientPressure = pressure(find(root, "engineSize.ambientConditions"));
+    return true;
+}
+
+std::string EngineConfig::getOxidizerName() const {
+    return joinComponents(m_mixture.empty() ? m_oxidizer : m_mixture);
+}
+
+std::string EngineConfig::getFuelName() const {
+    return m_mixture.empty() ? joinComponents(m_fuel) : std::string();
+}
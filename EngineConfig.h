@@ -0,0 +1,104 @@
+#ifndef ENGINE_CONFIG_H
+#define ENGINE_CONFIG_H
+
+#include <vector>
+#include <string>
+
+/**
+ * EngineConfig
+ *
+ * Engine definition read from an RPA configuration file (.cfg, libconfig
+ * syntax), such as the engines in RPA/2.3/standard/examples. Only what is
+ * needed to pick and size a performance table is kept: the propellants,
+ * chamber pressure, mixture ratio, nozzle exit condition and design thrust.
+ * Pressures are converted to psi and thrust to lbf, matching ThrustCalculator.
+ *
+ * The file is parsed natively (groups, lists, arrays, scalars and comments);
+ * @include directives are not supported.
+ */
+class EngineConfig {
+public:
+    struct Component {
+        std::string name;       // RPA species name, e.g. "O2(L)"
+        double massFraction;
+    };
+
+    EngineConfig();
+
+    /**
+     * Read an engine definition
+     * @return false if the file cannot be read, is not valid libconfig, or
+     *         lacks a chamber pressure or propellant (see getError)
+     */
+    bool load(const std::string& filename);
+
+    /**
+     * Why the last load failed (with the line number for syntax errors)
+     */
+    const std::string& getError() const { return m_error; }
+
+    const std::string& getName() const { return m_name; }
+    const std::string& getInfo() const { return m_info; }
+    const std::string& getFilename() const { return m_filename; }
+
+    /**
+     * Bipropellant components; both empty for a single premixed propellant
+     * (monopropellants and solids), which is listed by getMixture instead
+     */
+    const std::vector<Component>& getOxidizer() const { return m_oxidizer; }
+    const std::vector<Component>& getFuel() const { return m_fuel; }
+    const std::vector<Component>& getMixture() const { return m_mixture; }
+
+    /**
+     * Propellant as one string: the component name, or "name:fraction"
+     * entries joined by '+' when there are several. For a premixed
+     * propellant getOxidizerName is the mixture and getFuelName is empty.
+     */
+    std::string getOxidizerName() const;
+    std::string getFuelName() const;
+
+    /**
+     * Design chamber pressure (psi)
+     */
+    double getChamberPressure() const { return m_chamberPressure; }
+
+    /**
+     * Design O/F mass ratio; NaN if the file gives it another way (e.g. as
+     * oxidizer excess ratio alpha) or has no fuel
+     */
+    double getMixtureRatio() const { return m_mixtureRatio; }
+
+    /**
+     * Nozzle exit area ratio Ae/At; NaN if the exit is set by pressure
+     */
+    double getAreaRatio() const { return m_areaRatio; }
+
+    /**
+     * Nozzle exit pressure (psi); NaN if the exit is set by area ratio
+     */
+    double getExitPressure() const { return m_exitPressure; }
+
+    /**
+     * Design thrust (lbf) and the ambient pressure it is quoted at (psi);
+     * NaN if not given
+     */
+    double getThrust() const { return m_thrust; }
+    double getThrustAmbientPressure() const { return m_thrustAmbientPressure; }
+
+private:
+    std::string m_filename;
+    std::string m_error;
+    std::string m_name;
+    std::string m_info;
+    std::vector<Component> m_oxidizer;
+    std::vector<Component> m_fuel;
+    std::vector<Component> m_mixture;
+    double m_chamberPressure;
+    double m_mixtureRatio;
+    double m_areaRatio;
+    double m_exitPressure;
+    double m_thrust;
+    double m_thrustAmbientPressure;
+};
+
+#endif // ENGINE_CONFIG_H
@@ -0,0 +1,219 @@
+#include "EngineLibrary.h"
+#include <filesystem>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+const size_t EngineLibrary::DEFAULT_MEMORY_BUDGET;
+
+EngineLibrary::Stats::Stats()
+    : hits(0)
+    , loads(0)
+    , coalesced(0)
+    , evictions(0)
+    , failedLoads(0)
+    , residentTables(0)
+    , residentBytes(0)
+    , budgetBytes(0) {
+}
+
+EngineLibrary::EngineLibrary(size_t memoryBudget)
+    : m_residentBytes(0)
+    , m_budget(memoryBudget) {
+}
+
+size_t EngineLibrary::addDirectory(const std::string& directory) {
+    std::error_code ec;
+    std::vector<std::string> files;
+    for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() == ".cfg" && it->is_regular_file(ec)) {
+            files.push_back(it->path().string());
+        }
+    }
+    if (ec) {
+        ConfigError error = { directory, "cannot read directory" };
+        m_configErrors.push_back(error);
+        return 0;
+    }
+
+    // Directory order is unspecified; sort so duplicate ids resolve the same way
+    std::sort(files.begin(), files.end());
+    size_t added = 0;
+    for (const std::string& file : files) {
+        added += addEngine(file) ? 1 : 0;
+    }
+    return added;
+}
+
+bool EngineLibrary::addEngine(const std::string& filename) {
+    const std::string id = std::filesystem::path(filename).stem().string();
+    if (m_engines.count(id)) {
+        ConfigError error = { filename, "engine id " + id + " already added" };
+        m_configErrors.push_back(error);
+        return false;
+    }
+
+    EngineConfig config;
+    if (!config.load(filename)) {
+        ConfigError error = { filename, config.getError() };
+        m_configErrors.push_back(error);
+        return false;
+    }
+    m_engines[id] = config;
+    return true;
+}
+
+std::vector<std::string> EngineLibrary::getEngineIds() const {
+    std::vector<std::string> ids;
+    for (const auto& engine : m_engines) {
+        ids.push_back(engine.first);
+    }
+    return ids;
+}
+
+const EngineConfig& EngineLibrary::getEngine(const std::string& id) const {
+    auto it = m_engines.find(id);
+    if (it == m_engines.end()) {
+        throw std::invalid_argument("Unknown engine: " + id);
+    }
+    return it->second;
+}
+
+void EngineLibrary::mapPropellants(const std::string& oxidizer, const std::string& fuel,
+                                   const std::string& tableFile, double areaRatio) {
+    PropellantTable table = { tableFile, areaRatio };
+    m_propellantTables[std::make_pair(oxidizer, fuel)].push_back(table);
+}
+
+void EngineLibrary::mapEngine(const std::string& id, const std::string& tableFile) {
+    getEngine(id);
+    m_engineTables[id] = tableFile;
+}
+
+std::string EngineLibrary::getTableFile(const std::string& id) const {
+    const EngineConfig& engine = getEngine(id);
+    auto mapped = m_engineTables.find(id);
+    if (mapped != m_engineTables.end()) {
+        return mapped->second;
+    }
+
+    auto pair = m_propellantTables.find(std::make_pair(engine.getOxidizerName(), engine.getFuelName()));
+    if (pair == m_propellantTables.end()) {
+        return std::string();
+    }
+
+    // Closest area ratio by ratio rather than difference, so 10 is as far
+    // from 5 as from 20; tables of unknown area ratio only as a fallback
+    const std::vector<PropellantTable>& tables = pair->second;
+    const PropellantTable* best = &tables[0];
+    double bestDistance = HUGE_VAL;
+    const double areaRatio = engine.getAreaRatio();
+    for (const PropellantTable& table : tables) {
+        if (table.areaRatio > 0.0 && areaRatio > 0.0) {
+            const double distance = std::fabs(std::log(table.areaRatio / areaRatio));
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                best = &table;
+            }
+        }
+    }
+    return best->tableFile;
+}
+
+EngineLibrary::TablePtr EngineLibrary::getTable(const std::string& id) {
+    const std::string file = getTableFile(id);
+    if (file.empty()) {
+        return nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_cache.find(file);
+    if (it != m_cache.end()) {
+        CacheEntry& entry = it->second;
+        if (entry.table) {
+            ++m_stats.hits;
+            m_lru.splice(m_lru.begin(), m_lru, entry.lru);
+            return entry.table;
+        }
+        // Another thread is loading this table; wait for its result
+        ++m_stats.coalesced;
+        std::shared_future<TablePtr> pending = entry.pending;
+        lock.unlock();
+        return pending.get();
+    }
+
+    std::promise<TablePtr> promise;
+    CacheEntry& entry = m_cache[file];
+    entry.pending = promise.get_future().share();
+    entry.bytes = 0;
+    lock.unlock();
+
+    // Load outside the lock so resident tables stay available meanwhile. If
+    // the load throws, waiters get the exception and the next request retries.
+    TablePtr table;
+    try {
+        table = PerformanceTableRegistry::instance().acquire(file);
+    } catch (...) {
+        lock.lock();
+        ++m_stats.failedLoads;
+        m_cache.erase(file);
+        lock.unlock();
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+
+    lock.lock();
+    if (table) {
+        ++m_stats.loads;
+        CacheEntry& loaded = m_cache[file];
+        loaded.table = table;
+        loaded.pending = std::shared_future<TablePtr>();
+        loaded.bytes = table->getGridBytes();
+        m_lru.push_front(file);
+        loaded.lru = m_lru.begin();
+        m_residentBytes += loaded.bytes;
+        evict();
+    } else {
+        ++m_stats.failedLoads;
+        m_cache.erase(file);
+    }
+    lock.unlock();
+
+    promise.set_value(table);
+    return table;
+}
+
+void EngineLibrary::evict() {
+    while (m_residentBytes > m_budget && m_lru.size() > 1) {
+        auto victim = m_cache.find(m_lru.back());
+        m_residentBytes -= victim->second.bytes;
+        m_cache.erase(victim);
+        m_lru.pop_back();
+        ++m_stats.evictions;
+    }
+}
+
+void EngineLibrary::setMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = bytes;
+    evict();
+}
+
+void EngineLibrary::clearCache() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const std::string& file : m_lru) {
+        m_cache.erase(file);
+    }
+    m_lru.clear();
+    m_residentBytes = 0;
+}
+
+EngineLibrary::Stats EngineLibrary::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.residentTables = m_lru.size();
+    stats.residentBytes = m_residentBytes;
+    stats.budgetBytes = m_budget;
+    return stats;
+}
@@ -0,0 +1,167 @@
+#ifndef ENGINE_LIBRARY_H
+#define ENGINE_LIBRARY_H
+
+#include "EngineConfig.h"
+#include "PerformanceTableRegistry.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <cstdint>
+
+/**
+ * EngineLibrary
+ *
+ * Engines read from RPA .cfg files, each mapped to its performance table,
+ * for studies across many engines in one process.
+ *
+ * Tables are loaded lazily on the first getTable for an engine that uses
+ * them, and kept in an LRU cache under a memory budget: when the resident
+ * tables exceed it, the least recently used are dropped. Engines with the
+ * same propellants and table share one entry. Concurrent first requests for
+ * a table wait on a single load. Loads go through PerformanceTableRegistry,
+ * so a dropped table that a calculator still holds is shared again rather
+ * than reloaded.
+ *
+ * Add engines and table mappings before querying from several threads;
+ * getTable and the statistics are thread-safe.
+ */
+class EngineLibrary {
+public:
+    typedef PerformanceTableRegistry::TablePtr TablePtr;
+
+    struct Stats {
+        uint64_t hits;              // Table was resident
+        uint64_t loads;             // Tables loaded
+        uint64_t coalesced;         // Requests that waited on another thread's load
+        uint64_t evictions;
+        uint64_t failedLoads;
+        size_t residentTables;
+        size_t residentBytes;
+        size_t budgetBytes;
+
+        Stats();
+    };
+
+    // A .cfg file that could not be added
+    struct ConfigError {
+        std::string filename;
+        std::string message;
+    };
+
+    static const size_t DEFAULT_MEMORY_BUDGET = size_t(256) << 20;
+
+    explicit EngineLibrary(size_t memoryBudget = DEFAULT_MEMORY_BUDGET);
+
+    EngineLibrary(const EngineLibrary&) = delete;
+    EngineLibrary& operator=(const EngineLibrary&) = delete;
+
+    /**
+     * Add every .cfg file in a directory (not its subdirectories)
+     * @return Number of engines added; the rest are listed by getConfigErrors
+     */
+    size_t addDirectory(const std::string& directory);
+
+    /**
+     * Add one engine, identified by its file name without extension (the
+     * names inside RPA files are not unique, e.g. RD-170 and RD-170_altitude)
+     * @return false if the file cannot be parsed or the id is taken
+     */
+    bool addEngine(const std::string& filename);
+
+    const std::vector<ConfigError>& getConfigErrors() const { return m_configErrors; }
+
+    /**
+     * Ids of all engines, sorted
+     */
+    std::vector<std::string> getEngineIds() const;
+
+    bool hasEngine(const std::string& id) const { return m_engines.count(id) != 0; }
+
+    /**
+     * @throws std::invalid_argument if no engine has this id
+     */
+    const EngineConfig& getEngine(const std::string& id) const;
+
+    /**
+     * Use a table for every engine burning this propellant pair
+     * Names are as EngineConfig::getOxidizerName and getFuelName give them
+     * (fuel empty for a premixed propellant). Tables are generated for one
+     * nozzle area ratio; when several are mapped to one pair, an engine uses
+     * the one closest to its own area ratio.
+     * @param areaRatio Area ratio the table was generated for (0 if unknown)
+     */
+    void mapPropellants(const std::string& oxidizer, const std::string& fuel,
+                        const std::string& tableFile, double areaRatio = 0.0);
+
+    /**
+     * Use a table for one engine, overriding the propellant mapping
+     * @throws std::invalid_argument if no engine has this id
+     */
+    void mapEngine(const std::string& id, const std::string& tableFile);
+
+    /**
+     * Table file an engine resolves to, or empty if none is mapped
+     * @throws std::invalid_argument if no engine has this id
+     */
+    std::string getTableFile(const std::string& id) const;
+
+    /**
+     * Table for an engine, loading it on first use
+     * @return Shared immutable table, or nullptr if no table is mapped or it
+     *         cannot be loaded
+     * @throws std::invalid_argument if no engine has this id
+     */
+    TablePtr getTable(const std::string& id);
+
+    /**
+     * Change the memory budget, dropping tables beyond it
+     * The most recently used table is always kept, even if larger.
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /**
+     * Drop every resident table (tables in use stay alive with their users)
+     */
+    void clearCache();
+
+    Stats getStats() const;
+
+private:
+    struct PropellantTable {
+        std::string tableFile;
+        double areaRatio;
+    };
+
+    struct CacheEntry {
+        TablePtr table;                             // Null while loading
+        std::shared_future<TablePtr> pending;       // Valid while a load is in flight
+        size_t bytes;
+        std::list<std::string>::iterator lru;
+    };
+
+    /**
+     * Drop least recently used tables until within budget (m_mutex held)
+     */
+    void evict();
+
+    std::map<std::string, EngineConfig> m_engines;
+    std::vector<ConfigError> m_configErrors;
+    std::map<std::pair<std::string, std::string>, std::vector<PropellantTable>> m_propellantTables;
+    std::map<std::string, std::string> m_engineTables;
+
+    // Table cache by file, guarded by m_mutex. m_lru holds resident tables,
+    // most recently used first; tables being loaded are in m_cache only.
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, CacheEntry> m_cache;
+    std::list<std::string> m_lru;
+    size_t m_residentBytes;
+    size_t m_budget;
+    Stats m_stats;
+};
+
+#endif // ENGINE_LIBRARY_H
@@ -0,0 +1,314 @@
+#include "EquilibriumSolver.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+namespace {
+    // Gas constant (J/mol/K)
+    const double R_UNIVERSAL = 8.314462618;
+
+    const int MAX_ITERATIONS = 80;
+
+    // Convergence limits of RP-1311
+    const double COMPOSITION_TOLERANCE = 0.5e-5;
+    const double TEMPERATURE_TOLERANCE = 1.0e-4;
+    const double ELEMENT_TOLERANCE = 1.0e-6;
+
+    // ln(1e-8): species below this mole fraction are treated as trace in
+    // the step-size control
+    const double LN_TRACE = -18.420681;
+    const double LN_TRACE_TARGET = 9.2103404;
+
+    // Floor on ln mole fraction so trace species cannot underflow
+    const double LN_MOLE_FRACTION_FLOOR = -80.0;
+
+    // Cold-start guess (RP-1311)
+    const double INITIAL_TEMPERATURE = 3800.0;
+    const double INITIAL_MOLES = 0.1;
+
+    /**
+     * Solve A x = b in place by Gaussian elimination with partial pivoting
+     * @return false if A is singular
+     */
+    bool solveLinear(std::vector<double>& A, std::vector<double>& b, size_t n) {
+        for (size_t c = 0; c < n; ++c) {
+            size_t pivot = c;
+            for (size_t r = c + 1; r < n; ++r) {
+                if (std::abs(A[r * n + c]) > std::abs(A[pivot * n + c])) pivot = r;
+            }
+            if (A[pivot * n + c] == 0.0) return false;
+            if (pivot != c) {
+                for (size_t k = 0; k < n; ++k) std::swap(A[c * n + k], A[pivot * n + k]);
+                std::swap(b[c], b[pivot]);
+            }
+            for (size_t r = c + 1; r < n; ++r) {
+                double f = A[r * n + c] / A[c * n + c];
+                if (f == 0.0) continue;
+                for (size_t k = c; k < n; ++k) A[r * n + k] -= f * A[c * n + k];
+                b[r] -= f * b[c];
+            }
+        }
+        for (size_t c = n; c-- > 0;) {
+            double sum = b[c];
+            for (size_t k = c + 1; k < n; ++k) sum -= A[c * n + k] * b[k];
+            b[c] = sum / A[c * n + c];
+        }
+        return true;
+    }
+}
+
+EquilibriumSolver::State::State()
+    : lnTotal(0.0)
+    , T(0.0)
+    , P(0.0)
+    , initialised(false)
+    , iterations(0)
+    , moles(0.0)
+    , enthalpy(0.0)
+    , entropy(0.0)
+    , cp(0.0) {
+}
+
+double EquilibriumSolver::State::density() const {
+    return P * 1.0e5 / (moles * R_UNIVERSAL * T);
+}
+
+EquilibriumSolver::EquilibriumSolver(const ThermoDatabase& db, const std::vector<std::string>& reactantNames) {
+    for (const auto& name : reactantNames) {
+        const ThermoDatabase::Species* sp = db.find(name);
+        if (!sp) {
+            throw std::invalid_argument("Reactant not found in thermo database: " + name);
+        }
+        m_reactants.push_back(sp);
+        for (const auto& f : sp->formula) {
+            if (std::find(m_elements.begin(), m_elements.end(), f.first) == m_elements.end()) {
+                m_elements.push_back(f.first);
+            }
+        }
+    }
+
+    // Neutral gaseous products made only of the propellant elements
+    for (const auto& sp : db.species()) {
+        if (!sp.product || sp.condensed || sp.intervals.empty()) continue;
+        bool usable = true;
+        for (const auto& f : sp.formula) {
+            if (std::find(m_elements.begin(), m_elements.end(), f.first) == m_elements.end()) {
+                usable = false;
+                break;
+            }
+        }
+        if (usable) m_products.push_back(&sp);
+    }
+
+    const size_t ne = m_elements.size();
+    m_atoms.assign(m_products.size() * ne, 0.0);
+    for (size_t j = 0; j < m_products.size(); ++j) {
+        for (size_t k = 0; k < ne; ++k) {
+            m_atoms[j * ne + k] = m_products[j]->atoms(m_elements[k]);
+        }
+    }
+}
+
+EquilibriumSolver::Reactants EquilibriumSolver::makeReactants(const std::vector<double>& massFractions,
+                                                              double T) const {
+    if (massFractions.size() != m_reactants.size()) {
+        throw std::invalid_argument("One mass fraction is needed per reactant");
+    }
+
+    Reactants r;
+    r.elements.assign(m_elements.size(), 0.0);
+    r.enthalpy = 0.0;
+    for (size_t i = 0; i < m_reactants.size(); ++i) {
+        const ThermoDatabase::Species& sp = *m_reactants[i];
+        double molesPerKg = massFractions[i] * 1000.0 / sp.molWeight;
+        for (size_t k = 0; k < m_elements.size(); ++k) {
+            r.elements[k] += molesPerKg * sp.atoms(m_elements[k]);
+        }
+        r.enthalpy += molesPerKg * sp.enthalpyAt(T);
+    }
+    return r;
+}
+
+bool EquilibriumSolver::solveHP(const Reactants& reactants, double P_bar, State& state) const {
+    return solve(PROBLEM_HP, reactants, P_bar, reactants.enthalpy, state);
+}
+
+bool EquilibriumSolver::solveSP(const Reactants& reactants, double P_bar, double entropy, State& state) const {
+    return solve(PROBLEM_SP, reactants, P_bar, entropy, state);
+}
+
+bool EquilibriumSolver::solveTP(const Reactants& reactants, double P_bar, double T, State& state) const {
+    return solve(PROBLEM_TP, reactants, P_bar, T, state);
+}
+
+void EquilibriumSolver::initialGuess(State& state) const {
+    const size_t ns = m_products.size();
+    state.lnMoles.assign(ns, std::log(INITIAL_MOLES / ns));
+    state.lnTotal = std::log(INITIAL_MOLES);
+    state.T = INITIAL_TEMPERATURE;
+    state.initialised = true;
+}
+
+bool EquilibriumSolver::solve(Problem problem, const Reactants& reactants, double P_bar,
+                              double assigned, State& state) const {
+    const size_t ns = m_products.size();
+    const size_t ne = m_elements.size();
+    if (ns == 0 || reactants.elements.size() != ne) {
+        return false;
+    }
+
+    if (!state.initialised || state.lnMoles.size() != ns) {
+        initialGuess(state);
+    }
+    if (problem == PROBLEM_TP) {
+        state.T = assigned;
+    }
+    state.P = P_bar;
+
+    const double lnP = std::log(P_bar);     // Reference pressure is 1 bar
+    const bool energy = problem != PROBLEM_TP;
+    const size_t dim = ne + 1 + (energy ? 1 : 0);
+    const size_t rowN = ne;                 // Total-moles equation
+    const size_t rowE = ne + 1;             // Energy (enthalpy or entropy) equation
+
+    double bMax = 0.0;
+    for (double b : reactants.elements) bMax = std::max(bMax, b);
+
+    std::vector<double> cp(ns), h(ns), s(ns), g(ns), n(ns), dln(ns);
+    std::vector<double> A(dim * dim), x(dim), b(ne);
+
+    for (int iter = 1; iter <= MAX_ITERATIONS; ++iter) {
+        const double T = state.T;
+        const double lnN = state.lnTotal;
+        const double nTotal = std::exp(lnN);
+
+        std::fill(A.begin(), A.end(), 0.0);
+        std::fill(x.begin(), x.end(), 0.0);
+        std::fill(b.begin(), b.end(), 0.0);
+        double sumN = 0.0, sumH = 0.0, sumS = 0.0;
+
+        for (size_t j = 0; j < ns; ++j) {
+            m_products[j]->evaluate(T, cp[j], h[j], s[j]);
+            n[j] = std::exp(state.lnMoles[j]);
+            // Chemical potential mu_j/RT
+            g[j] = h[j] - s[j] + state.lnMoles[j] - lnN + lnP;
+
+            const double nj = n[j];
+            const double* aj = &m_atoms[j * ne];
+            const double Sj = s[j] - state.lnMoles[j] + lnN - lnP;   // Species entropy / R
+            const double Ej = (problem == PROBLEM_SP) ? Sj : h[j];   // Energy-row weight
+            sumN += nj;
+
+            for (size_t k = 0; k < ne; ++k) {
+                if (aj[k] == 0.0) continue;
+                const double akn = aj[k] * nj;
+                for (size_t i = 0; i < ne; ++i) A[k * dim + i] += akn * aj[i];
+                A[k * dim + rowN] += akn;
+                x[k] += akn * g[j];
+                b[k] += akn;
+                if (energy) {
+                    A[k * dim + rowE] += akn * h[j];
+                    A[rowE * dim + k] += akn * Ej;
+                }
+            }
+            for (size_t i = 0; i < ne; ++i) A[rowN * dim + i] += aj[i] * nj;
+            x[rowN] += nj * g[j];
+
+            if (energy) {
+                A[rowN * dim + rowE] += nj * h[j];
+                A[rowE * dim + rowN] += nj * Ej;
+                A[rowE * dim + rowE] += nj * (cp[j] + h[j] * Ej);
+                x[rowE] += nj * Ej * g[j];
+                sumH += nj * h[j];
+                sumS += nj * Sj;
+            }
+        }
+
+        for (size_t k = 0; k < ne; ++k) {
+            x[k] += reactants.elements[k] - b[k];
+        }
+        A[rowN * dim + rowN] = sumN - nTotal;
+        x[rowN] += nTotal - sumN;
+        if (problem == PROBLEM_HP) {
+            x[rowE] += assigned / (R_UNIVERSAL * T) - sumH;
+        } else if (problem == PROBLEM_SP) {
+            x[rowE] += assigned / R_UNIVERSAL - sumS + nTotal - sumN;
+        }
+
+        if (!solveLinear(A, x, dim)) {
+            return false;
+        }
+
+        const double dlnN = x[rowN];
+        const double dlnT = energy ? x[rowE] : 0.0;
+
+        // Step control (RP-1311 eqs. 3.1-3.3)
+        double largest = 5.0 * std::max(std::abs(dlnT), std::abs(dlnN));
+        double lambda2 = 1.0;
+        double residual = 0.0;
+        for (size_t j = 0; j < ns; ++j) {
+            const double* aj = &m_atoms[j * ne];
+            double d = -g[j] + dlnN + h[j] * dlnT;
+            for (size_t i = 0; i < ne; ++i) d += aj[i] * x[i];
+            dln[j] = d;
+            residual += n[j] * std::abs(d);
+
+            double lnFraction = state.lnMoles[j] - lnN;
+            if (lnFraction > LN_TRACE) {
+                if (d > 0.0) largest = std::max(largest, d);
+            } else if (d >= 0.0 && d - dlnN != 0.0) {
+                lambda2 = std::min(lambda2, std::abs((-lnFraction - LN_TRACE_TARGET) / (d - dlnN)));
+            }
+        }
+        double lambda = std::min(lambda2, largest > 2.0 ? 2.0 / largest : 1.0);
+
+        for (size_t j = 0; j < ns; ++j) {
+            state.lnMoles[j] += lambda * dln[j];
+        }
+        state.lnTotal += lambda * dlnN;
+        state.T = std::min(std::max(T * std::exp(lambda * dlnT), 100.0), 20000.0);
+        for (size_t j = 0; j < ns; ++j) {
+            state.lnMoles[j] = std::max(state.lnMoles[j], state.lnTotal + LN_MOLE_FRACTION_FLOOR);
+        }
+
+        double elementError = 0.0;
+        for (size_t k = 0; k < ne; ++k) {
+            elementError = std::max(elementError, std::abs(reactants.elements[k] - b[k]));
+        }
+
+        if (lambda == 1.0 &&
+            residual / sumN <= COMPOSITION_TOLERANCE &&
+            nTotal * std::abs(dlnN) / sumN <= COMPOSITION_TOLERANCE &&
+            std::abs(dlnT) <= TEMPERATURE_TOLERANCE &&
+            elementError <= ELEMENT_TOLERANCE * bMax) {
+            state.iterations = iter;
+            updateProperties(state);
+            return true;
+        }
+    }
+
+    state.iterations = MAX_ITERATIONS;
+    return false;
+}
+
+void EquilibriumSolver::updateProperties(State& state) const {
+    const double lnP = std::log(state.P);
+    double sumN = 0.0;
+    for (double lnn : state.lnMoles) sumN += std::exp(lnn);
+    const double lnSum = std::log(sumN);
+
+    double h = 0.0, s = 0.0, c = 0.0;
+    for (size_t j = 0; j < m_products.size(); ++j) {
+        double cpj, hj, sj;
+        m_products[j]->evaluate(state.T, cpj, hj, sj);
+        double nj = std::exp(state.lnMoles[j]);
+        h += nj * hj;
+        s += nj * (sj - state.lnMoles[j] + lnSum - lnP);
+        c += nj * cpj;
+    }
+
+    state.moles = sumN;
+    state.enthalpy = h * R_UNIVERSAL * state.T;
+    state.entropy = s * R_UNIVERSAL;
+    state.cp = c * R_UNIVERSAL;
+}
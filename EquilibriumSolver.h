@@ -0,0 +1,109 @@
+#ifndef EQUILIBRIUM_SOLVER_H
+#define EQUILIBRIUM_SOLVER_H
+
+#include "ThermoDatabase.h"
+#include <vector>
+#include <string>
+
+/**
+ * EquilibriumSolver
+ *
+ * Chemical equilibrium of gaseous combustion products by minimisation of
+ * Gibbs energy, following the Gordon & McBride formulation used by CEA and
+ * RPA (NASA RP-1311): Newton iteration on the element Lagrange multipliers,
+ * the total moles and (for assigned enthalpy or entropy) the temperature.
+ *
+ * Products are every gaseous, neutral species in the database built only
+ * from the propellant's elements. Condensed products and ions are not
+ * considered.
+ *
+ * A solver is immutable after construction and can be shared by threads;
+ * all iteration state lives in the caller's State.
+ */
+class EquilibriumSolver {
+public:
+    /**
+     * Propellant mixture: element content and enthalpy per kilogram, built
+     * from the database by makeReactants
+     */
+    struct Reactants {
+        std::vector<double> elements;   // mol of each solver element per kg
+        double enthalpy;                // J/kg
+    };
+
+    /**
+     * Equilibrium composition and the Newton iterate; passing the converged
+     * State of a nearby problem warm-starts the next solve
+     */
+    struct State {
+        std::vector<double> lnMoles;    // ln(mol/kg) per product species
+        double lnTotal;                 // ln of the iterate's total mol/kg
+        double T;                       // K
+        double P;                       // bar
+        bool initialised;
+        int iterations;                 // Newton steps taken by the last solve
+
+        // Mixture properties of the converged state
+        double moles;                   // Total mol/kg
+        double enthalpy;                // J/kg
+        double entropy;                 // J/kg/K
+        double cp;                      // Frozen Cp, J/kg/K
+
+        State();
+
+        double molecularWeight() const { return 1000.0 / moles; }  // g/mol
+        double density() const;                                   // kg/m^3
+    };
+
+    /**
+     * Select product species for the elements of the given reactants
+     * @param db Loaded thermodynamic database (must outlive the solver)
+     * @param reactantNames Propellant components, e.g. { "N2O4(L)", "UDMH" }
+     * @throws std::invalid_argument if a reactant is not in the database
+     */
+    EquilibriumSolver(const ThermoDatabase& db, const std::vector<std::string>& reactantNames);
+
+    /**
+     * Mixture of the reactants by mass fraction
+     * @param massFractions One per reactant passed to the constructor
+     * @param T Reactant temperature (K); assigned-enthalpy reactants use their
+     *          tabulated value regardless
+     */
+    Reactants makeReactants(const std::vector<double>& massFractions, double T = 298.15) const;
+
+    /**
+     * Equilibrium at assigned pressure and enthalpy (combustion chamber)
+     * @return false if the iteration did not converge
+     */
+    bool solveHP(const Reactants& reactants, double P_bar, State& state) const;
+
+    /**
+     * Equilibrium at assigned pressure and entropy (isentropic expansion)
+     * @param entropy Mixture entropy to hold (J/kg/K)
+     */
+    bool solveSP(const Reactants& reactants, double P_bar, double entropy, State& state) const;
+
+    /**
+     * Equilibrium at assigned pressure and temperature
+     */
+    bool solveTP(const Reactants& reactants, double P_bar, double T, State& state) const;
+
+    const std::vector<std::string>& elements() const { return m_elements; }
+    size_t productCount() const { return m_products.size(); }
+    const ThermoDatabase::Species& product(size_t j) const { return *m_products[j]; }
+
+private:
+    enum Problem { PROBLEM_TP, PROBLEM_HP, PROBLEM_SP };
+
+    bool solve(Problem problem, const Reactants& reactants, double P_bar,
+               double assigned, State& state) const;
+    void initialGuess(State& state) const;
+    void updateProperties(State& state) const;
+
+    std::vector<std::string> m_elements;
+    std::vector<const ThermoDatabase::Species*> m_reactants;
+    std::vector<const ThermoDatabase::Species*> m_products;
+    std::vector<double> m_atoms;    // [product][element], row-major
+};
+
+#endif // EQUILIBRIUM_SOLVER_H
@@ -0,0 +1,426 @@
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+#include <cstring>
+
+namespace {
+    // File layout: header, column names, then chunks of chunkBytes each
+    // (column after column, chunkRows doubles per column, zero-padded to
+    // ALIGNMENT), then the event table. rowCount and the event table are
+    // written by close(); a log that was never closed has eventOffset 0.
+    const char LOG_MAGIC[8] = { 'R', 'P', 'A', 'F', 'L', 'O', 'G', '\0' };
+    const uint32_t LOG_VERSION = 1;
+    const uint32_t LOG_ENDIAN_TAG = 0x01020304;
+    const uint64_t ALIGNMENT = 64;
+    const size_t MAX_NAME = FlightRecorder::MAX_COLUMN_NAME;
+    const size_t NAME_BYTES = MAX_NAME + 1;
+
+    struct LogHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t endianTag;
+        uint32_t headerSize;
+        uint32_t columnCount;
+        uint32_t chunkRows;
+        uint32_t eventCount;
+        uint64_t rowCount;
+        uint64_t chunkOffset;
+        uint64_t chunkBytes;
+        uint64_t eventOffset;
+    };
+
+    struct LogEvent {
+        double time;
+        uint32_t code;
+        uint32_t reserved;
+        uint64_t row;
+    };
+
+    // How long an idle writer sleeps before looking at the queue again
+    const std::chrono::milliseconds WRITER_POLL(2);
+
+    // Event row not known yet
+    const uint64_t NO_ROW = ~uint64_t(0);
+
+    uint64_t alignUp(uint64_t n) {
+        return (n + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    void fillHeader(LogHeader& header, size_t columns, size_t chunkRows) {
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC));
+        header.version = LOG_VERSION;
+        header.endianTag = LOG_ENDIAN_TAG;
+        header.headerSize = sizeof(LogHeader);
+        header.columnCount = static_cast<uint32_t>(columns);
+        header.chunkRows = static_cast<uint32_t>(chunkRows);
+        header.chunkOffset = alignUp(sizeof(LogHeader) + columns * NAME_BYTES);
+        header.chunkBytes = alignUp(uint64_t(columns) * chunkRows * sizeof(double));
+    }
+}
+
+const size_t FlightRecorder::MAX_COLUMN_NAME;
+
+FlightRecorder::Settings::Settings()
+    : chunkRows(1024)
+    , chunkCount(4)
+    , decimation(1)
+    , eventWindow(0.5)
+    , preEventRows(256) {
+}
+
+FlightRecorder::Stats::Stats()
+    : samples(0)
+    , rows(0)
+    , chunks(0)
+    , events(0)
+    , stalls(0)
+    , fileBytes(0) {
+}
+
+void FlightRecorder::ChunkQueue::reset(size_t capacity) {
+    // One slot stays empty to tell a full ring from an empty one
+    m_slots.assign(capacity + 1, 0);
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+}
+
+bool FlightRecorder::ChunkQueue::push(uint32_t chunk) {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    const size_t next = tail + 1 == m_slots.size() ? 0 : tail + 1;
+    if (next == m_head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    m_slots[tail] = chunk;
+    m_tail.store(next, std::memory_order_release);
+    return true;
+}
+
+bool FlightRecorder::ChunkQueue::pop(uint32_t& chunk) {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    chunk = m_slots[head];
+    m_head.store(head + 1 == m_slots.size() ? 0 : head + 1, std::memory_order_release);
+    return true;
+}
+
+FlightRecorder::FlightRecorder()
+    : m_chunk(0)
+    , m_chunkFill(0)
+    , m_heldStart(0)
+    , m_heldCount(0)
+    , m_windowEvent(0)
+    , m_rowEvent(0)
+    , m_stopping(false)
+    , m_writeFailed(false) {
+}
+
+FlightRecorder::~FlightRecorder() {
+    close();
+}
+
+bool FlightRecorder::open(const std::string& filename, const std::vector<std::string>& columns,
+                          const Settings& settings) {
+    if (columns.empty() || settings.chunkRows == 0 || settings.chunkCount == 0 ||
+        settings.decimation == 0 || !(settings.eventWindow >= 0.0)) {
+        throw std::invalid_argument("Recorder needs columns, and positive chunk rows, chunk count and decimation");
+    }
+    for (const std::string& name : columns) {
+        if (name.empty() || name.size() > MAX_COLUMN_NAME) {
+            throw std::invalid_argument("Recorder column names must be 1 to 15 characters: '" + name + "'");
+        }
+    }
+    close();
+
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        return false;
+    }
+
+    // Header (finished by close()) and names, padded to the first chunk
+    LogHeader header;
+    fillHeader(header, columns.size(), settings.chunkRows);
+    std::vector<char> prefix(header.chunkOffset, 0);
+    std::memcpy(prefix.data(), &header, sizeof(header));
+    for (size_t c = 0; c < columns.size(); ++c) {
+        std::memcpy(prefix.data() + sizeof(header) + c * NAME_BYTES, columns[c].data(), columns[c].size());
+    }
+    if (!m_file.write(prefix.data(), prefix.size())) {
+        m_file.close();
+        return false;
+    }
+
+    m_settings = settings;
+    m_stats = Stats();
+    m_columns = columns;
+    m_pool.assign(settings.chunkCount * columns.size() * settings.chunkRows, 0.0);
+    m_full.reset(settings.chunkCount);
+    m_free.reset(settings.chunkCount);
+    for (size_t i = 0; i < settings.chunkCount; ++i) {
+        m_free.push(static_cast<uint32_t>(i));
+    }
+    m_chunkFill = settings.chunkRows;
+    // At least one slot, so close() can tell the last sample
+    m_held.assign(std::max<size_t>(settings.preEventRows, 1) * columns.size(), 0.0);
+    m_heldStart = 0;
+    m_heldCount = 0;
+    m_events.clear();
+    m_events.reserve(64);
+    m_windowEvent = 0;
+    m_rowEvent = 0;
+
+    m_stopping.store(false);
+    m_writeFailed.store(false);
+    m_writer = std::thread(&FlightRecorder::writerLoop, this);
+    return true;
+}
+
+void FlightRecorder::record(const double* values) {
+    if (!isOpen()) {
+        throw std::runtime_error("No recording open");
+    }
+
+    // Delay each sample by the hold ring, so events marked in the meantime
+    // can still pull it in at full rate
+    const size_t columns = m_columns.size();
+    const size_t capacity = m_held.size() / columns;
+    if (m_heldCount == capacity) {
+        release(m_held.data() + m_heldStart * columns, m_stats.samples - capacity, false);
+        m_heldStart = (m_heldStart + 1) % capacity;
+        --m_heldCount;
+    }
+    const size_t slot = (m_heldStart + m_heldCount++) % capacity;
+    std::copy(values, values + columns, m_held.data() + slot * columns);
+    ++m_stats.samples;
+}
+
+void FlightRecorder::markEvent(uint32_t code, double time) {
+    if (!isOpen()) {
+        throw std::runtime_error("No recording open");
+    }
+    if (!m_events.empty() && time < m_events.back().time) {
+        throw std::invalid_argument("Recorder events must be marked in time order");
+    }
+    m_events.push_back(EventRecord{ time, code, 0, NO_ROW });
+    ++m_stats.events;
+}
+
+void FlightRecorder::release(const double* values, uint64_t sample, bool keep) {
+    // Events whose window ends before this sample no longer matter
+    const double t = values[0];
+    const double window = m_settings.eventWindow;
+    while (m_windowEvent < m_events.size() && m_events[m_windowEvent].time + window < t) {
+        ++m_windowEvent;
+    }
+    keep = keep || sample % m_settings.decimation == 0 ||
+           (m_windowEvent < m_events.size() && m_events[m_windowEvent].time - window <= t);
+    if (keep) {
+        appendRow(values);
+    }
+}
+
+void FlightRecorder::appendRow(const double* values) {
+    if (m_chunkFill == m_settings.chunkRows) {
+        // Wait for the writer to give a chunk back
+        bool stalled = false;
+        while (!m_free.pop(m_chunk)) {
+            stalled = true;
+            m_wake.notify_one();
+            std::this_thread::yield();
+        }
+        if (stalled) ++m_stats.stalls;
+        m_chunkFill = 0;
+    }
+
+    while (m_rowEvent < m_events.size() && m_events[m_rowEvent].time <= values[0]) {
+        m_events[m_rowEvent++].row = m_stats.rows;
+    }
+    for (size_t c = 0; c < m_columns.size(); ++c) {
+        chunkColumn(m_chunk, c)[m_chunkFill] = values[c];
+    }
+    ++m_stats.rows;
+    if (++m_chunkFill == m_settings.chunkRows) {
+        handOff();
+    }
+}
+
+void FlightRecorder::handOff() {
+    // The full queue has room for every chunk in the pool
+    m_full.push(m_chunk);
+    ++m_stats.chunks;
+    m_wake.notify_one();
+}
+
+void FlightRecorder::writerLoop() {
+    const size_t chunkDoubles = m_columns.size() * m_settings.chunkRows;
+    const uint64_t padding = alignUp(chunkDoubles * sizeof(double)) - chunkDoubles * sizeof(double);
+    const char zeros[ALIGNMENT] = {};
+
+    for (;;) {
+        // Every hand-off happens before the stop flag is raised, so once it
+        // is seen an empty queue means all chunks are written
+        const bool stopping = m_stopping.load(std::memory_order_acquire);
+        uint32_t chunk;
+        if (m_full.pop(chunk)) {
+            if (!m_writeFailed.load(std::memory_order_relaxed)) {
+                m_file.write(reinterpret_cast<const char*>(chunkColumn(chunk, 0)), chunkDoubles * sizeof(double));
+                m_file.write(zeros, padding);
+                if (!m_file) m_writeFailed.store(true);
+            }
+            m_free.push(chunk);
+            continue;
+        }
+        if (stopping) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait_for(lock, WRITER_POLL);
+    }
+}
+
+bool FlightRecorder::close() {
+    if (!isOpen()) {
+        return false;
+    }
+
+    // Release the hold ring; the log always ends at the last sample offered
+    const size_t columns = m_columns.size();
+    const size_t capacity = m_held.size() / columns;
+    for (size_t i = 0; i < m_heldCount; ++i) {
+        release(m_held.data() + (m_heldStart + i) % capacity * columns,
+                m_stats.samples - m_heldCount + i, i + 1 == m_heldCount);
+    }
+    m_heldCount = 0;
+    if (m_chunkFill < m_settings.chunkRows) {
+        for (size_t c = 0; c < m_columns.size(); ++c) {
+            double* column = chunkColumn(m_chunk, c);
+            std::fill(column + m_chunkFill, column + m_settings.chunkRows, 0.0);
+        }
+        m_chunkFill = m_settings.chunkRows;
+        handOff();
+    }
+
+    m_stopping.store(true, std::memory_order_release);
+    m_wake.notify_one();
+    m_writer.join();
+
+    LogHeader header;
+    fillHeader(header, m_columns.size(), m_settings.chunkRows);
+    header.rowCount = m_stats.rows;
+    header.eventCount = static_cast<uint32_t>(m_events.size());
+    header.eventOffset = header.chunkOffset + m_stats.chunks * header.chunkBytes;
+    for (const EventRecord& event : m_events) {
+        LogEvent record = { event.time, event.code, 0, event.row == NO_ROW ? m_stats.rows : event.row };
+        m_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.close();
+    const bool ok = !m_writeFailed.load() && !m_file.fail();
+
+    m_stats.fileBytes = header.eventOffset + m_events.size() * sizeof(LogEvent);
+    m_pool.clear();
+    m_pool.shrink_to_fit();
+    m_held.clear();
+    m_held.shrink_to_fit();
+    return ok;
+}
+
+FlightLog::FlightLog()
+    : m_rows(0)
+    , m_chunkRows(0)
+    , m_chunkOffset(0)
+    , m_chunkBytes(0) {
+}
+
+bool FlightLog::open(const std::string& filename) {
+    close();
+    if (!m_file.open(filename) || m_file.size() < sizeof(LogHeader)) {
+        m_file.close();
+        return false;
+    }
+
+    LogHeader header;
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    const uint64_t chunkRows = header.chunkRows;
+    const uint64_t chunks = chunkRows ? (header.rowCount + chunkRows - 1) / chunkRows : 0;
+    LogHeader expected;
+    fillHeader(expected, header.columnCount, header.chunkRows);
+    if (std::memcmp(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0 ||
+        header.version != LOG_VERSION ||
+        header.endianTag != LOG_ENDIAN_TAG ||
+        header.headerSize != sizeof(LogHeader) ||
+        header.columnCount == 0 || chunkRows == 0 ||
+        header.chunkOffset != expected.chunkOffset ||
+        header.chunkBytes != expected.chunkBytes ||
+        header.eventOffset != header.chunkOffset + chunks * header.chunkBytes ||
+        header.eventOffset + uint64_t(header.eventCount) * sizeof(LogEvent) != m_file.size()) {
+        m_file.close();
+        return false;
+    }
+
+    for (size_t c = 0; c < header.columnCount; ++c) {
+        const char* name = reinterpret_cast<const char*>(m_file.data()) + sizeof(LogHeader) + c * NAME_BYTES;
+        m_columns.push_back(std::string(name, std::find(name, name + MAX_NAME, '\0')));
+    }
+    for (size_t i = 0; i < header.eventCount; ++i) {
+        LogEvent record;
+        std::memcpy(&record, m_file.data() + header.eventOffset + i * sizeof(LogEvent), sizeof(record));
+        m_events.push_back(Event{ record.time, record.code, record.row });
+    }
+    m_rows = header.rowCount;
+    m_chunkRows = header.chunkRows;
+    m_chunkOffset = header.chunkOffset;
+    m_chunkBytes = header.chunkBytes;
+    return true;
+}
+
+void FlightLog::close() {
+    m_file.close();
+    m_columns.clear();
+    m_events.clear();
+    m_rows = 0;
+    m_chunkRows = 0;
+    m_chunkOffset = 0;
+    m_chunkBytes = 0;
+}
+
+int FlightLog::findColumn(const std::string& name) const {
+    for (size_t c = 0; c < m_columns.size(); ++c) {
+        if (m_columns[c] == name) return static_cast<int>(c);
+    }
+    return -1;
+}
+
+const double* FlightLog::chunkColumn(size_t column, size_t chunk, size_t& rows) const {
+    if (column >= m_columns.size() || chunk >= getChunkCount()) {
+        throw std::invalid_argument("Flight log column or chunk out of range");
+    }
+    rows = std::min(m_chunkRows, m_rows - chunk * m_chunkRows);
+    const unsigned char* data = m_file.data() + m_chunkOffset + chunk * m_chunkBytes;
+    return reinterpret_cast<const double*>(data) + column * m_chunkRows;
+}
+
+double FlightLog::value(size_t column, size_t row) const {
+    if (row >= m_rows) {
+        throw std::invalid_argument("Flight log row out of range");
+    }
+    size_t rows;
+    return chunkColumn(column, row / m_chunkRows, rows)[row % m_chunkRows];
+}
+
+void FlightLog::readColumn(size_t column, std::vector<double>& values) const {
+    if (column >= m_columns.size()) {
+        throw std::invalid_argument("Flight log column out of range");
+    }
+    values.clear();
+    values.reserve(m_rows);
+    for (size_t chunk = 0; chunk < getChunkCount(); ++chunk) {
+        size_t rows;
+        const double* data = chunkColumn(column, chunk, rows);
+        values.insert(values.end(), data, data + rows);
+    }
+}
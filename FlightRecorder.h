@@ -0,0 +1,239 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * FlightRecorder
+ *
+ * Streams simulation samples to a columnar log file with flat memory use.
+ * Each sample is one row of doubles, the first column being time. Rows are
+ * written column by column into fixed-size chunks from a pool allocated at
+ * open(); a full chunk is handed to a background writer thread through a
+ * lock-free single-producer queue and comes back through another once on
+ * disk. record() therefore never allocates and only waits if the writer falls
+ * a whole pool behind (counted in Stats::stalls).
+ *
+ * Outside event windows only every decimation-th sample is kept; within
+ * eventWindow seconds either side of an event every sample is, so a
+ * decimated log still has every step around burnout or apogee. Samples pass
+ * through a ring of preEventRows before that choice is made, which lets an
+ * event marked late (apogee is only found a step after it) reach back over
+ * samples already offered. The first and last samples are always kept.
+ *
+ * One thread records; read the file back with FlightLog.
+ */
+class FlightRecorder {
+public:
+    struct Settings {
+        size_t chunkRows;           // Rows per chunk
+        size_t chunkCount;          // Chunks in the pool
+        size_t decimation;          // Keep every Nth sample outside event windows (1 = all)
+        double eventWindow;         // Full-rate capture before and after each event, s
+        size_t preEventRows;        // Samples held back for capture before a later event
+
+        Settings();
+    };
+
+    struct Stats {
+        uint64_t samples;           // Rows offered to record()
+        uint64_t rows;              // Rows kept
+        uint64_t chunks;            // Chunks handed to the writer
+        uint64_t events;
+        uint64_t stalls;            // Times record() waited for a free chunk
+        uint64_t fileBytes;         // Set by close()
+
+        Stats();
+    };
+
+    // Column names are stored in fixed 16-byte fields
+    static const size_t MAX_COLUMN_NAME = 15;
+
+    FlightRecorder();
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    /**
+     * Create a log file and start the writer (closing any open recording)
+     * @param columns Column names, time first
+     * @return false if the file cannot be created
+     * @throws std::invalid_argument for no columns, a name longer than
+     *         MAX_COLUMN_NAME, zero chunk rows, chunk count or decimation,
+     *         or a negative event window
+     */
+    bool open(const std::string& filename, const std::vector<std::string>& columns,
+              const Settings& settings = Settings());
+
+    /**
+     * Offer one sample
+     * @param values One value per column; time must not decrease
+     * @throws std::runtime_error if no recording is open
+     */
+    void record(const double* values);
+
+    /**
+     * Mark an event (code is the caller's, e.g. FlightSim::Event) and
+     * capture the samples around it at full rate. Only samples among the
+     * last preEventRows offered, or yet to come, can still be captured.
+     * @throws std::runtime_error if no recording is open
+     * @throws std::invalid_argument if time is before an earlier event's
+     */
+    void markEvent(uint32_t code, double time);
+
+    /**
+     * Write the remaining rows and the event table, finish the header and
+     * stop the writer
+     * @return false if any write failed (or nothing was open)
+     */
+    bool close();
+
+    bool isOpen() const { return m_writer.joinable(); }
+    const Stats& getStats() const { return m_stats; }
+    const Settings& getSettings() const { return m_settings; }
+
+private:
+    /**
+     * Fixed-capacity lock-free queue of chunk indices between exactly one
+     * pushing and one popping thread
+     */
+    class ChunkQueue {
+    public:
+        void reset(size_t capacity);
+        bool push(uint32_t chunk);
+        bool pop(uint32_t& chunk);
+
+    private:
+        std::vector<uint32_t> m_slots;
+        alignas(64) std::atomic<size_t> m_head{ 0 };   // Next pop, advanced by the consumer
+        alignas(64) std::atomic<size_t> m_tail{ 0 };   // Next push, advanced by the producer
+    };
+
+    struct EventRecord {
+        double time;
+        uint32_t code;
+        uint32_t reserved;
+        uint64_t row;               // First row at or after the event
+    };
+
+    /**
+     * Decide on a sample leaving the hold ring
+     * @param sample Its index among all samples offered
+     * @param keep Keep it whatever the decimation
+     */
+    void release(const double* values, uint64_t sample, bool keep);
+    void appendRow(const double* values);
+    void handOff();
+    void writerLoop();
+    double* chunkColumn(uint32_t chunk, size_t column) {
+        return m_pool.data() + (size_t(chunk) * m_columns.size() + column) * m_settings.chunkRows;
+    }
+
+    Settings m_settings;
+    Stats m_stats;
+    std::vector<std::string> m_columns;
+
+    std::vector<double> m_pool;     // chunkCount x columns x chunkRows
+    ChunkQueue m_full;              // Recorder -> writer
+    ChunkQueue m_free;              // Writer -> recorder
+    uint32_t m_chunk;               // Chunk being filled
+    size_t m_chunkFill;             // Rows in it; chunkRows = none acquired
+
+    // Samples not yet released, oldest at m_heldStart
+    std::vector<double> m_held;
+    size_t m_heldStart;
+    size_t m_heldCount;
+    std::vector<EventRecord> m_events;
+    size_t m_windowEvent;           // First event whose window may hold the next release
+    size_t m_rowEvent;              // First event without a row yet
+
+    std::ofstream m_file;           // Owned by the writer thread between open() and close()
+    std::thread m_writer;
+    std::atomic<bool> m_stopping;
+    std::atomic<bool> m_writeFailed;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+};
+
+/**
+ * FlightLog
+ *
+ * Read-only view of a FlightRecorder file. The file is memory-mapped and
+ * every chunk's columns are contiguous, aligned doubles, so chunkColumn()
+ * hands them out without copying.
+ */
+class FlightLog {
+public:
+    struct Event {
+        double time;
+        uint32_t code;
+        uint64_t row;               // First row at or after the event (rowCount if none)
+    };
+
+    FlightLog();
+
+    FlightLog(const FlightLog&) = delete;
+    FlightLog& operator=(const FlightLog&) = delete;
+
+    /**
+     * Map a log file
+     * @return false if it cannot be read, is not a finished FlightRecorder
+     *         log or its layout is inconsistent
+     */
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    size_t getRowCount() const { return m_rows; }
+    size_t getColumnCount() const { return m_columns.size(); }
+    const std::vector<std::string>& getColumns() const { return m_columns; }
+
+    /**
+     * @return Index of the named column, or -1
+     */
+    int findColumn(const std::string& name) const;
+
+    size_t getChunkRows() const { return m_chunkRows; }
+    size_t getChunkCount() const { return m_chunkRows ? (m_rows + m_chunkRows - 1) / m_chunkRows : 0; }
+
+    /**
+     * One column of one chunk, in place in the mapping
+     * @param rows Set to the rows in the chunk (chunkRows except in the last)
+     * @throws std::invalid_argument for a bad column or chunk index
+     */
+    const double* chunkColumn(size_t column, size_t chunk, size_t& rows) const;
+
+    /**
+     * @throws std::invalid_argument for a bad column or row index
+     */
+    double value(size_t column, size_t row) const;
+
+    /**
+     * Copy a whole column
+     * @throws std::invalid_argument for a bad column index
+     */
+    void readColumn(size_t column, std::vector<double>& values) const;
+
+    const std::vector<Event>& getEvents() const { return m_events; }
+
+private:
+    MappedFile m_file;
+    std::vector<std::string> m_columns;
+    std::vector<Event> m_events;
+    size_t m_rows;
+    size_t m_chunkRows;
+    uint64_t m_chunkOffset;
+    uint64_t m_chunkBytes;
+};
+
+#endif // FLIGHT_RECORDER_H
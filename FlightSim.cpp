@@ -1,86 +1,541 @@
-#include <iostream>
-
-enum COORDINATE_SYSTEM {
-    GLOBAL,
-    ROCKET
-};
-
-struct Force {
-    std::array<float, 3> components;
-    COORDINATE_SYSTEM coordSystem;
-    
-    Force() : components(0.0f, 0.0f, 0.0f), coordSystem(GLOBAL) {}
-    
-    Force(float x, float y, float z)
-            : components{x, y, z}, coordSystem(TRUE) {}
-    
-    Force(float x, float y, float z, COORDINATE_SYSTEM cs)
-            : components{x, y, z}, coordSystem(cs) {}
-    
-};
-
-class FlightSim {
-    float dt = 0.05;
-    Rocket rocket;
-    
-    struct FlightSnapshot {
-        
-    };
-    
-    class FlightData {
-        std::vector<FlightSnapshot> flightData;
-        
-        // add data
-        
-    };
-    
-    
-    // evaluateForces
-    void evaluateForces(FlightSnapshot& state, CoeffData& coeffs) {
-        // Fd = 0.5 * A * Cd * rho * v^2
-        // Fn = q * A * Cn
-        // Ft = thrust curve
-        
-        // return net force?
-        
-    }
-    
-    void run() {
-        
-    }
-    
-};
-
-
-
-// contains basic data about rocket
-class Rocket {
-    float hollowMass;
-    Engine engine;
-    
-    
-    
-};
-
-
-class RasData {
-    // initialized using csv file
-    // functions for accessing interpolated coeffs
-    
-    class CoeffData { // maybe struct instead
-        // given the full ras constructed interpolators, make rocket specfic coeffs
-        
+#include "FlightSim.h"
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+namespace {
+    const double SEA_LEVEL_DENSITY = 1.225;     // kg/m^3
+    const double SCALE_HEIGHT = 8500.0;         // m
+    const double SEA_LEVEL_PRESSURE = 14.6959;  // psi
+    const double SPEED_OF_SOUND = 340.29;       // m/s
+
+    const double PA_PER_PSI = 6894.757293168;
+    const double M2_PER_IN2 = 0.00064516;
+
+    const double PI = 3.14159265358979323846;
+
+    double dot(const double a[3], const double b[3]) {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // Body-to-inertial rotation matrix of a unit quaternion (w, x, y, z)
+    void rotationMatrix(const double q[4], double R[3][3]) {
+        const double w = q[0], x = q[1], y = q[2], z = q[3];
+        R[0][0] = 1 - 2 * (y * y + z * z);  R[0][1] = 2 * (x * y - w * z);      R[0][2] = 2 * (x * z + w * y);
+        R[1][0] = 2 * (x * y + w * z);      R[1][1] = 1 - 2 * (x * x + z * z);  R[1][2] = 2 * (y * z - w * x);
+        R[2][0] = 2 * (x * z - w * y);      R[2][1] = 2 * (y * z + w * x);      R[2][2] = 1 - 2 * (x * x + y * y);
+    }
+}
+
+PressureFedEngine::PressureFedEngine()
+    : throatArea(1.1)
+    , tankPressure(450.0)
+    , pressureLoss(100.0)
+    , blowdownRatio(0.7)
+    , mixtureRatio(2.4)
+    , burnTime(4.4) {
+}
+
+double PressureFedEngine::chamberPressure(double t) const {
+    if (t < 0.0 || t >= burnTime) {
+        return 0.0;
+    }
+    const double tank = tankPressure * (1.0 - (1.0 - blowdownRatio) * t / burnTime);
+    return std::max(0.0, tank - pressureLoss);
+}
+
+Rocket::Rocket()
+    : dryMass(18.0)
+    , propellantMass(4.0)
+    , rollInertiaDry(0.04)
+    , rollInertiaWet(0.05)
+    , pitchInertiaDry(8.0)
+    , pitchInertiaWet(9.5)
+    , thrustTime({ 0.0, 0.1, 0.3, 4.0, 4.4 })
+    , thrust({ 0.0, 2600.0, 2400.0, 2000.0, 0.0 })
+    , referenceArea(0.25 * PI * 0.127 * 0.127)
+    , referenceLength(0.127)
+    , dragCoefficient(0.45)
+    , normalForceSlope(9.5)
+    , staticMargin(0.25)
+    , pitchDampingCoefficient(40.0)
+    , aeroDragScale(1.0)
+    , aeroNormalScale(1.0) {
+}
+
+double Rocket::thrustAt(double t) const {
+    if (thrustTime.empty() || t < thrustTime.front() || t >= thrustTime.back()) {
+        return 0.0;
+    }
+    const size_t i = std::upper_bound(thrustTime.begin(), thrustTime.end(), t) - thrustTime.begin();
+    const double f = (t - thrustTime[i - 1]) / (thrustTime[i] - thrustTime[i - 1]);
+    return thrust[i - 1] + f * (thrust[i] - thrust[i - 1]);
+}
+
+void Rocket::setAerodynamics(const RasData& ras) {
+    aero = std::make_shared<const CoeffData>(ras, referenceArea);
+}
+
+double Rocket::totalImpulse() const {
+    double impulse = 0.0;
+    for (size_t i = 1; i < thrustTime.size(); ++i) {
+        impulse += 0.5 * (thrust[i - 1] + thrust[i]) * (thrustTime[i] - thrustTime[i - 1]);
+    }
+    return impulse;
+}
+
+FlightSim::Settings::Settings()
+    : launchAngle(5.0 * PI / 180.0)
+    , launchHeading(0.0)
+    , railLength(5.0)
+    , wind{ 4.0, 0.0, 0.0 }
+    , maxTime(600.0) {
+}
+
+FlightSim::Result::Result()
+    : apogee(0.0)
+    , apogeeTime(0.0)
+    , maxSpeed(0.0)
+    , burnoutTime(0.0)
+    , burnoutSpeed(0.0)
+    , railExitSpeed(0.0)
+    , flightTime(0.0)
+    , range(0.0)
+    , landing{ 0.0, 0.0 }
+    , impacted(false)
+    , boostSteps(0)
+    , coastSteps(0) {
+}
+
+FlightSim::FlightSim(const Rocket& rocket, const Settings& settings)
+    : m_totalImpulse(0.0)
+    , m_railDirection{ 0.0, 0.0, 1.0 }
+    , m_recorder(nullptr) {
+    setRocket(rocket);
+    setSettings(settings);
+}
+
+void FlightSim::setRocket(const Rocket& rocket) {
+    validateRocket(rocket);
+    m_rocket = rocket;
+    m_totalImpulse = rocket.totalImpulse();
+    m_cursor.invalidate();
+}
+
+void FlightSim::setSettings(const Settings& settings) {
+    validateSettings(settings);
+    m_integrator.setSettings(settings.integrator);
+    m_settings = settings;
+    railDirection(settings, m_railDirection);
+}
+
+void FlightSim::validateRocket(const Rocket& rocket) {
+    bool valid = rocket.dryMass > 0.0 && rocket.propellantMass >= 0.0 &&
+                 rocket.rollInertiaDry > 0.0 && rocket.rollInertiaWet > 0.0 &&
+                 rocket.pitchInertiaDry > 0.0 && rocket.pitchInertiaWet > 0.0 &&
+                 rocket.referenceArea > 0.0 && rocket.referenceLength > 0.0 &&
+                 rocket.thrustTime.size() == rocket.thrust.size();
+    for (size_t i = 0; valid && i < rocket.thrust.size(); ++i) {
+        valid = rocket.thrust[i] >= 0.0 && (i == 0 || rocket.thrustTime[i] > rocket.thrustTime[i - 1]);
+    }
+    if (!valid) {
+        throw std::invalid_argument("Rocket needs positive mass, inertia and reference size, "
+                                    "and a thrust curve with increasing times and non-negative thrust");
+    }
+    const PressureFedEngine& engine = rocket.engine;
+    if (rocket.hasEngine() &&
+        (!engine.table->isValid() || !(engine.throatArea > 0.0) || !(engine.burnTime > 0.0) ||
+         !(engine.mixtureRatio > 0.0) || !(engine.blowdownRatio > 0.0 && engine.blowdownRatio <= 1.0) ||
+         !(engine.pressureLoss >= 0.0 && engine.pressureLoss < engine.tankPressure))) {
+        throw std::invalid_argument("Engine needs a loaded table, positive throat area, burn time and mixture "
+                                    "ratio, a blowdown ratio in (0, 1] and feed loss below tank pressure");
+    }
+    if (rocket.aero && (rocket.aero->getReferenceArea() != rocket.referenceArea ||
+                        !(rocket.aeroDragScale >= 0.0) || !(rocket.aeroNormalScale >= 0.0))) {
+        throw std::invalid_argument("Aero tables must be scaled to the rocket's reference area, "
+                                    "with non-negative drag and normal force scale factors");
+    }
+}
+
+void FlightSim::validateSettings(const Settings& settings) {
+    if (!(settings.launchAngle >= 0.0 && settings.launchAngle < 0.5 * PI) || !(settings.railLength >= 0.0)) {
+        throw std::invalid_argument("Launch angle must be in [0, 90) degrees from vertical and rail length non-negative");
+    }
+}
+
+void FlightSim::railDirection(const Settings& settings, double direction[3]) {
+    const double s = std::sin(settings.launchAngle);
+    direction[0] = s * std::cos(settings.launchHeading);
+    direction[1] = s * std::sin(settings.launchHeading);
+    direction[2] = std::cos(settings.launchAngle);
+}
+
+double FlightSim::airDensity(double z) {
+    return SEA_LEVEL_DENSITY * std::exp(-std::max(z, 0.0) / SCALE_HEIGHT);
+}
+
+double FlightSim::ambientPressure(double z) {
+    return SEA_LEVEL_PRESSURE * std::exp(-std::max(z, 0.0) / SCALE_HEIGHT);
+}
+
+double FlightSim::speedOfSound(double) {
+    return SPEED_OF_SOUND;
+}
+
+void FlightSim::propulsion(double t, const RigidBodyState& state, double& thrust, double& massFlow) const {
+    if (!m_rocket.hasEngine()) {
+        // Propellant burns in proportion to thrust
+        thrust = m_rocket.thrustAt(t);
+        massFlow = m_totalImpulse > 0.0 ? m_rocket.propellantMass * thrust / m_totalImpulse : 0.0;
+        return;
+    }
+
+    const PressureFedEngine& engine = m_rocket.engine;
+    const double Pc = engine.chamberPressure(t);
+    if (Pc <= 0.0 || state.mass() <= m_rocket.dryMass) {
+        thrust = 0.0;
+        massFlow = 0.0;
+        return;
+    }
+    const RPATableInterpolator::PerformanceData perf =
+        engine.table->getFields<RPATableInterpolator::MASK_CF | RPATableInterpolator::MASK_CSTAR>(
+            Pc, engine.mixtureRatio, ambientPressure(state.position()[2]), m_cursor);
+    engineThrust(engine, Pc, perf.Cf, perf.Cstar, thrust, massFlow);
+}
+
+void FlightSim::engineThrust(const PressureFedEngine& engine, double Pc, double Cf, double Cstar,
+                             double& thrust, double& massFlow) {
+    const double PcAt = Pc * PA_PER_PSI * engine.throatArea * M2_PER_IN2;   // N
+    thrust = Cf * PcAt;
+    massFlow = PcAt / Cstar;
+}
+
+std::vector<std::string> FlightSim::recordColumns() {
+    return { "t", "x", "y", "z", "vx", "vy", "vz", "qw", "qx", "qy", "qz", "p", "q", "r", "mass" };
+}
+
+const char* FlightSim::eventName(Event event) {
+    switch (event) {
+    case Event::RAIL_EXIT: return "rail exit";
+    case Event::BURNOUT: return "burnout";
+    case Event::APOGEE: return "apogee";
+    case Event::IMPACT: return "impact";
+    }
+    return "unknown";
+}
+
+void FlightSim::record(double t, const RigidBodyState& state) {
+    if (m_recorder) {
+        double row[1 + RigidBodyState::SIZE];
+        row[0] = t;
+        std::copy(state.x, state.x + RigidBodyState::SIZE, row + 1);
+        m_recorder->record(row);
+    }
+}
+
+void FlightSim::markEvent(Event event, double t) {
+    if (m_recorder) {
+        m_recorder->markEvent(static_cast<uint32_t>(event), t);
+    }
+}
+
+RigidBodyState FlightSim::initialState() const {
+    return initialState(m_rocket, m_railDirection);
+}
+
+RigidBodyState FlightSim::initialState(const Rocket& rocket, const double railDirection[3]) {
+    RigidBodyState state;
+    std::fill(state.x, state.x + RigidBodyState::SIZE, 0.0);
+
+    // Rotate the body x axis onto the rail: about ex x d by the angle between them
+    const double* d = railDirection;
+    const double angle = std::acos(std::min(1.0, std::max(-1.0, d[0])));
+    const double axisNorm = std::sqrt(d[1] * d[1] + d[2] * d[2]);
+    double* q = state.attitude();
+    q[0] = std::cos(0.5 * angle);
+    if (axisNorm > 0.0) {
+        const double s = std::sin(0.5 * angle) / axisNorm;
+        q[2] = -d[2] * s;
+        q[3] = d[1] * s;
+    }
+    state.mass() = rocket.dryMass + rocket.propellantMass;
+    return state;
+}
+
+void FlightSim::breakpoints(const Rocket& rocket, const double*& times, size_t& count) {
+    // An engine's chamber pressure is smooth up to its burn time
+    if (rocket.hasEngine()) {
+        times = &rocket.engine.burnTime;
+        count = 1;
+    } else {
+        times = rocket.thrustTime.data();
+        count = rocket.thrustTime.size();
+    }
+}
+
+void FlightSim::evaluateForces(double t, const RigidBodyState& state, Forces& forces) const {
+    double R[3][3];
+    rotationMatrix(state.attitude(), R);
+    const double* v = state.velocity();
+    const double* omega = state.angularRate();
+
+    // Thrust along the body x axis, and gravity
+    propulsion(t, state, forces.thrust, forces.massFlow);
+    for (size_t i = 0; i < 3; ++i) {
+        forces.force[i] = forces.thrust * R[i][0];
+        forces.moment[i] = 0.0;
+    }
+    forces.force[2] -= GRAVITY * state.mass();
+
+    // The rail holds the rocket until its nose has travelled the rail length
+    const double* r = state.position();
+    const double along = dot(r, m_railDirection);
+    forces.onRail = along < m_settings.railLength && dot(v, m_railDirection) >= 0.0 &&
+                    dot(r, r) - along * along < 1e-6;
+
+    const double vAir[3] = { v[0] - m_settings.wind[0], v[1] - m_settings.wind[1], v[2] - m_settings.wind[2] };
+    const double speed = std::sqrt(dot(vAir, vAir));
+    if (speed < MIN_AIR_SPEED) {
+        return;
+    }
+    const double qbar = 0.5 * airDensity(r[2]) * speed * speed;
+    const double qA = qbar * m_rocket.referenceArea;
+
+    const double vb[3] = {
+        R[0][0] * vAir[0] + R[1][0] * vAir[1] + R[2][0] * vAir[2],
+        R[0][1] * vAir[0] + R[1][1] * vAir[1] + R[2][1] * vAir[2],
+        R[0][2] * vAir[0] + R[1][2] * vAir[1] + R[2][2] * vAir[2]
     };
-    
-};
-
-class WindData {
-    
-};
-
-int main() {
-    std::cout << "Hello World!";
-    
-    return 0;
-    
+    const double lateral = std::sqrt(vb[1] * vb[1] + vb[2] * vb[2]);
+    const double alpha = lateral > 0.0 ? std::atan2(lateral, vb[0]) : 0.0;
+    double drag, normalForce;
+    if (m_rocket.aero) {
+        const CoeffData::Coefficients c = m_rocket.aero->lookup(
+            forces.thrust > 0.0 ? RasData::Power::ON : RasData::Power::OFF, speed / speedOfSound(r[2]), alpha,
+            m_rocket.aeroDragScale, m_rocket.aeroNormalScale);
+        drag = qbar * c.dragArea;
+        normalForce = qbar * c.normalArea;
+    } else {
+        drag = qA * m_rocket.dragCoefficient;
+        normalForce = qA * m_rocket.normalForceSlope * alpha;
+    }
+
+    // Drag opposes the air-relative velocity
+    for (size_t i = 0; i < 3; ++i) {
+        forces.force[i] -= drag * vAir[i] / speed;
+    }
+
+    // Normal force from the angle of attack, acting at the centre of
+    // pressure; in body axes it opposes the lateral air-relative velocity
+    if (lateral > 0.0) {
+        const double normal = normalForce / lateral;
+        const double fy = -normal * vb[1];
+        const double fz = -normal * vb[2];
+        for (size_t i = 0; i < 3; ++i) {
+            forces.force[i] += R[i][1] * fy + R[i][2] * fz;
+        }
+        // (-staticMargin, 0, 0) x (0, fy, fz)
+        forces.moment[1] += m_rocket.staticMargin * fz;
+        forces.moment[2] -= m_rocket.staticMargin * fy;
+    }
+
+    // Pitch and yaw damping
+    const double damping = qA * m_rocket.referenceLength * m_rocket.pitchDampingCoefficient *
+                           m_rocket.referenceLength / (2.0 * speed);
+    forces.moment[1] -= damping * omega[1];
+    forces.moment[2] -= damping * omega[2];
+}
+
+void FlightSim::derivative(double t, const RigidBodyState& state, RigidBodyState& rate) {
+    Forces forces;
+    evaluateForces(t, state, forces);
+
+    const double* v = state.velocity();
+    const double m = state.mass();
+    double* dr = rate.position();
+    double* dv = rate.velocity();
+    for (size_t i = 0; i < 3; ++i) {
+        dr[i] = v[i];
+        dv[i] = forces.force[i] / m;
+    }
+
+    const double* w = state.angularRate();
+    double* dw = rate.angularRate();
+    if (forces.onRail) {
+        // Slide along the rail only, never back down it
+        double a = dot(dv, m_railDirection);
+        if (a < 0.0 && dot(v, m_railDirection) <= 0.0) a = 0.0;
+        for (size_t i = 0; i < 3; ++i) {
+            dv[i] = a * m_railDirection[i];
+            dw[i] = 0.0;
+        }
+    } else {
+        // Euler's equations with inertia between dry and wet by propellant left
+        const double remaining = m_rocket.propellantMass > 0.0 ? (m - m_rocket.dryMass) / m_rocket.propellantMass : 0.0;
+        const double f = std::min(1.0, std::max(0.0, remaining));
+        const double Ix = m_rocket.rollInertiaDry + f * (m_rocket.rollInertiaWet - m_rocket.rollInertiaDry);
+        const double Iy = m_rocket.pitchInertiaDry + f * (m_rocket.pitchInertiaWet - m_rocket.pitchInertiaDry);
+        dw[0] = forces.moment[0] / Ix;
+        dw[1] = (forces.moment[1] - (Ix - Iy) * w[2] * w[0]) / Iy;
+        dw[2] = (forces.moment[2] - (Iy - Ix) * w[0] * w[1]) / Iy;
+    }
+
+    // dq/dt = q * (0, omega) / 2
+    const double* q = state.attitude();
+    double* dq = rate.attitude();
+    dq[0] = -0.5 * (q[1] * w[0] + q[2] * w[1] + q[3] * w[2]);
+    dq[1] = 0.5 * (q[0] * w[0] + q[2] * w[2] - q[3] * w[1]);
+    dq[2] = 0.5 * (q[0] * w[1] + q[3] * w[0] - q[1] * w[2]);
+    dq[3] = 0.5 * (q[0] * w[2] + q[1] * w[1] - q[2] * w[0]);
+
+    rate.mass() = -forces.massFlow;
+}
+
+FlightSim::Result FlightSim::run() {
+    if (m_recorder && !m_recorder->isOpen()) {
+        throw std::runtime_error("Flight recorder is not open");
+    }
+    Result result;
+    RigidBodyState state = initialState();
+    double t = 0.0;
+    m_integrator.restart();
+    m_integrator.resetStats();
+
+    // Stop on each breakpoint, the last being burnout, and restart the
+    // integrator so no step straddles one
+    const double* times;
+    size_t count;
+    breakpoints(m_rocket, times, count);
+    bool flying = true;
+    for (size_t i = 0; flying && i < count && t < m_settings.maxTime; ++i) {
+        if (times[i] > t) {
+            flying = integrate(t, state, std::min(times[i], m_settings.maxTime), result);
+            m_integrator.restart();
+        }
+    }
+    // Burnout only if the flight lasted until the motor stopped
+    if (flying && count && t >= m_rocket.burnTime()) {
+        result.burnoutTime = t;
+        markEvent(Event::BURNOUT, t);
+        result.boostSteps = m_integrator.getStats().steps;
+        result.burnoutSpeed = std::sqrt(dot(state.velocity(), state.velocity()));
+    }
+    if (flying) {
+        integrate(t, state, m_settings.maxTime, result);
+    }
+
+    record(t, state);
+    finishFlight(t, state, result);
+    result.steps = m_integrator.getStats();
+    return result;
+}
+
+void FlightSim::finishFlight(double t, const RigidBodyState& state, Result& result) {
+    result.flightTime = t;
+    result.landing[0] = state.position()[0];
+    result.landing[1] = state.position()[1];
+    result.range = std::sqrt(result.landing[0] * result.landing[0] + result.landing[1] * result.landing[1]);
+}
+
+bool FlightSim::integrate(double& t, RigidBodyState& state, double tEnd, Result& result) {
+    // Leaving the rail releases the lateral constraint, a discontinuity the
+    // adaptive method should step onto rather than across; RK4 keeps its
+    // fixed grid. The time to the rail end comes from the speed and
+    // acceleration of the last step.
+    const bool adaptive = m_integrator.getSettings().method != RigidBodyIntegrator::Method::RK4;
+    double railAcceleration = 0.0;
+    while (t < tEnd) {
+        // Events found in the step before are marked ahead of this sample
+        record(t, state);
+        const RigidBodyState previous = state;
+        const double t0 = t;
+        double stepEnd = tEnd;
+        const double along0 = dot(previous.position(), m_railDirection);
+        const bool onRail = result.railExitSpeed == 0.0 && along0 < m_settings.railLength;
+        if (adaptive && onRail) {
+            const double u = dot(previous.velocity(), m_railDirection);
+            const double d = m_settings.railLength - along0;
+            const double root = u * u + 2.0 * railAcceleration * d;
+            const double dt = root > 0.0 && u + std::sqrt(root) > 0.0 ? 2.0 * d / (u + std::sqrt(root)) : 0.0;
+            if (dt >= m_integrator.getSettings().minStep && t + dt < tEnd) {
+                stepEnd = t + dt;
+            }
+        }
+        const double h = m_integrator.step(*this, t, state, stepEnd);
+
+        StepEvents events;
+        const bool flying = trackStep(m_settings, m_railDirection, previous, t0, h, t, state,
+                                      m_integrator.getStats().steps, result, events);
+        if (events.railExit >= 0.0) {
+            markEvent(Event::RAIL_EXIT, events.railExit);
+            m_integrator.restart();
+        } else if (onRail) {
+            railAcceleration = (dot(state.velocity(), m_railDirection) - dot(previous.velocity(), m_railDirection)) / h;
+        }
+        if (events.apogee >= 0.0) markEvent(Event::APOGEE, events.apogee);
+        if (events.impact >= 0.0) markEvent(Event::IMPACT, events.impact);
+        if (!flying) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FlightSim::trackStep(const Settings& settings, const double railDirection[3],
+                          const RigidBodyState& previous, double t0, double h, double& t, RigidBodyState& state,
+                          uint64_t steps, Result& result, StepEvents& events) {
+    events.railExit = -1.0;
+    events.apogee = -1.0;
+    events.impact = -1.0;
+
+    const double* r = state.position();
+    const double* v = state.velocity();
+    const double speed = std::sqrt(dot(v, v));
+    result.maxSpeed = std::max(result.maxSpeed, speed);
+    const double along = dot(r, railDirection);
+    if (result.railExitSpeed == 0.0 && along >= settings.railLength) {
+        // Interpolate to the rail end within the step
+        const double along0 = dot(previous.position(), railDirection);
+        const double speed0 = std::sqrt(dot(previous.velocity(), previous.velocity()));
+        const double s = along > along0 ? (settings.railLength - along0) / (along - along0) : 1.0;
+        result.railExitSpeed = speed0 + std::max(0.0, s) * (speed - speed0);
+        events.railExit = t0 + std::max(0.0, s) * h;
+    }
+    if (r[2] > result.apogee) {
+        result.apogee = r[2];
+        result.apogeeTime = t;
+    }
+
+    // Apogee inside the step: where the vertical velocity, taken as
+    // linear over the step, is zero, on the cubic Hermite altitude curve
+    const double z0 = previous.position()[2], vz0 = previous.velocity()[2];
+    const double z1 = r[2], vz1 = v[2];
+    if (vz0 > 0.0 && vz1 <= 0.0) {
+        const double s = vz0 / (vz0 - vz1);
+        const double s2 = s * s, s3 = s2 * s;
+        const double z = (2 * s3 - 3 * s2 + 1) * z0 + (s3 - 2 * s2 + s) * h * vz0 +
+                         (3 * s2 - 2 * s3) * z1 + (s3 - s2) * h * vz1;
+        if (z > result.apogee) {
+            result.apogee = z;
+            result.apogeeTime = t0 + s * h;
+        }
+        events.apogee = t0 + s * h;
+        if (result.boostSteps && !result.coastSteps) {
+            result.coastSteps = steps - result.boostSteps;
+        }
+    }
+
+    // Ground impact: interpolate the state to z = 0 within the step
+    if (z1 < 0.0 && vz1 < 0.0) {
+        const double s = z0 / (z0 - z1);
+        for (size_t i = 0; i < RigidBodyState::SIZE; ++i) {
+            state.x[i] = previous.x[i] + s * (state.x[i] - previous.x[i]);
+        }
+        t = t0 + s * h;
+        result.impacted = true;
+        events.impact = t;
+        return false;
+    }
+    return true;
 }
@@ -0,0 +1,322 @@
+#ifndef FLIGHT_SIM_H
+#define FLIGHT_SIM_H
+
+#include "RigidBodyIntegrator.h"
+#include "RPATableInterpolator.h"
+#include "RasData.h"
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/**
+ * PressureFedEngine
+ *
+ * Liquid engine fed from blowdown tanks. Tank pressure falls linearly from
+ * tankPressure to blowdownRatio of it over the burn, and the chamber sees it
+ * less the feed loss. Thrust F = Cf Pc At and propellant flow Pc At / c* come
+ * from a performance table at the ambient pressure of the current altitude.
+ * The table is shared and read-only, so any number of simulations can hold it.
+ */
+struct PressureFedEngine {
+    std::shared_ptr<const RPATableInterpolator> table;     // No table = no engine
+    double throatArea;              // in^2
+    double tankPressure;            // Initial tank pressure, psi
+    double pressureLoss;            // Tank to chamber (lines and injector), psi
+    double blowdownRatio;           // Tank pressure at burnout over tankPressure
+    double mixtureRatio;            // O/F
+    double burnTime;                // s
+
+    PressureFedEngine();
+
+    /**
+     * Chamber pressure (psi) at t seconds after ignition; 0 outside the burn
+     */
+    double chamberPressure(double t) const;
+};
+
+/**
+ * Rocket
+ *
+ * Mass, inertia, propulsion and aerodynamic properties of a single-stage
+ * rocket (SI units). The defaults describe a small solid-motor sounding
+ * rocket.
+ *
+ * The body x axis is the rocket's long axis, pointing from tail to nose.
+ */
+struct Rocket {
+    double dryMass;                 // kg
+    double propellantMass;          // kg
+    double rollInertiaDry;          // About the long axis, kg m^2
+    double rollInertiaWet;
+    double pitchInertiaDry;         // About either lateral axis, kg m^2
+    double pitchInertiaWet;
+
+    // Thrust curve: piecewise linear in time from ignition, zero after the
+    // last point. Propellant burns in proportion to thrust, so it runs out
+    // exactly at the end of the curve.
+    std::vector<double> thrustTime;     // s, increasing
+    std::vector<double> thrust;         // N
+
+    // Replaces the thrust curve when it has a table. Its propellant flow
+    // drains propellantMass; thrust stops early if that runs out.
+    PressureFedEngine engine;
+
+    double referenceArea;           // m^2
+    double referenceLength;         // Body diameter, m
+    double dragCoefficient;
+    double normalForceSlope;        // CN per radian of angle of attack
+    double staticMargin;            // Centre of pressure behind the centre of mass, m
+    double pitchDampingCoefficient; // Cmq, per (rate x length / 2V)
+
+    // Replaces dragCoefficient and normalForceSlope when set: drag and normal
+    // force over Mach and angle of attack, scaled to referenceArea. Shared
+    // read-only, so copies of the rocket do not copy the tables.
+    std::shared_ptr<const CoeffData> aero;
+    double aeroDragScale;           // Multiplies the tables' CdA (Monte Carlo disperses it)
+    double aeroNormalScale;         // Multiplies the tables' CnA
+
+    Rocket();
+
+    bool hasEngine() const { return engine.table != nullptr; }
+
+    /**
+     * Take drag and normal force from RASAero data, scaled to the current
+     * referenceArea (set it again if that changes)
+     * @throws std::invalid_argument as CoeffData
+     */
+    void setAerodynamics(const RasData& ras);
+
+    /**
+     * Time the thrust curve or engine burn ends (s)
+     */
+    double burnTime() const {
+        return hasEngine() ? engine.burnTime : thrustTime.empty() ? 0.0 : thrustTime.back();
+    }
+
+    /**
+     * Thrust curve (N) at t seconds after ignition
+     */
+    double thrustAt(double t) const;
+
+    /**
+     * Integral of the thrust curve (N s)
+     */
+    double totalImpulse() const;
+};
+
+class FlightRecorder;
+template <size_t W> class FlightSimLanes;
+
+/**
+ * FlightSim
+ *
+ * 6-DOF flight of a Rocket over a flat, non-rotating Earth (z up) in an
+ * exponential atmosphere with a constant wind. The rocket leaves a launch
+ * rail, then flies under thrust, gravity, drag and a normal force acting at
+ * the centre of pressure, with pitch damping. The flight ends at ground
+ * impact or after maxTime.
+ *
+ * Drag and normal force come from the rocket's constant coefficients, or
+ * from its RASAero tables (Rocket::aero) at the flight Mach number, angle of
+ * attack and power on or off, with a constant speed of sound.
+ *
+ * The state is integrated by RigidBodyIntegrator with RK4 at a fixed step or
+ * adaptive RK45. Thrust curve points, burnout and (for RK45) rail exit are
+ * stepped to exactly, so no step straddles a discontinuity and the adaptive
+ * steps grow freely through the coast. The step loop does not allocate.
+ *
+ * A simulation keeps per-flight state (integrator stages, the engine table
+ * cursor), so use one per thread; reuse it across flights with setRocket().
+ *
+ * With a FlightRecorder attached, run() records the state at the start of
+ * every step and at the end of the flight (columns from recordColumns()),
+ * and marks each Event on it.
+ *
+ * FlightSimLanes flies the same model with RK4 on several rockets at once.
+ */
+class FlightSim : private RigidBodyDynamics {
+public:
+    // Event codes passed to FlightRecorder::markEvent
+    enum class Event : uint32_t {
+        RAIL_EXIT = 1,
+        BURNOUT,
+        APOGEE,
+        IMPACT
+    };
+
+    struct Settings {
+        RigidBodyIntegrator::Settings integrator;
+        double launchAngle;         // Rail elevation from vertical, rad
+        double launchHeading;       // Azimuth of the rail tilt from +x towards +y, rad
+        double railLength;          // m
+        double wind[3];             // m/s, inertial
+        double maxTime;             // s
+
+        Settings();
+    };
+
+    // Net loads on the rocket at one instant
+    struct Forces {
+        double force[3];            // Inertial, N
+        double moment[3];           // About the centre of mass, body axes, N m
+        double thrust;              // N
+        double massFlow;            // Propellant burnt, kg/s
+        bool onRail;                // Motion constrained to the rail
+    };
+
+    struct Result {
+        double apogee;              // m
+        double apogeeTime;          // s
+        double maxSpeed;            // m/s
+        double burnoutTime;         // s
+        double burnoutSpeed;        // m/s
+        double railExitSpeed;       // m/s
+        double flightTime;          // To ground impact (or maxTime), s
+        double range;               // Horizontal distance from the pad at the end, m
+        double landing[2];          // Horizontal position at the end, m
+        bool impacted;              // Ended at ground impact rather than maxTime
+        RigidBodyIntegrator::Stats steps;
+        uint64_t boostSteps;        // Ignition to burnout
+        uint64_t coastSteps;        // Burnout to apogee
+
+        Result();
+    };
+
+    static constexpr double GRAVITY = 9.80665;      // m/s^2
+    static constexpr double MIN_AIR_SPEED = 1e-6;   // Below this (m/s) aerodynamic loads are neglected
+
+    FlightSim(const Rocket& rocket, const Settings& settings = Settings());
+
+    /**
+     * @throws std::invalid_argument if the rocket has no mass, reference
+     *         area or inertia, its thrust curve is malformed, its engine
+     *         has no throat area, burn time or mixture ratio, a blowdown
+     *         ratio outside (0, 1], feed loss above tank pressure, or an
+     *         unloaded table, or its aero tables were scaled to another
+     *         reference area or have a negative scale factor
+     */
+    void setRocket(const Rocket& rocket);
+    const Rocket& getRocket() const { return m_rocket; }
+
+    /**
+     * @throws std::invalid_argument for invalid integrator settings
+     */
+    void setSettings(const Settings& settings);
+    const Settings& getSettings() const { return m_settings; }
+
+    /**
+     * Record every run() to an open recorder (not owned); nullptr to stop
+     */
+    void setRecorder(FlightRecorder* recorder) { m_recorder = recorder; }
+    FlightRecorder* getRecorder() const { return m_recorder; }
+
+    /**
+     * Fly from the launch rail to ground impact
+     * @throws std::runtime_error if the recorder set is not open
+     */
+    Result run();
+
+    /**
+     * State on the rail before ignition
+     */
+    RigidBodyState initialState() const;
+
+    /**
+     * Loads at time t in the given state
+     */
+    void evaluateForces(double t, const RigidBodyState& state, Forces& forces) const;
+
+    /**
+     * Air density (kg/m^3) at altitude z (m)
+     */
+    static double airDensity(double z);
+
+    /**
+     * Ambient pressure (psi) at altitude z (m)
+     */
+    static double ambientPressure(double z);
+
+    /**
+     * Speed of sound (m/s) at altitude z (m): constant, as the atmosphere is
+     * isothermal
+     */
+    static double speedOfSound(double z);
+
+    /**
+     * Recorder columns: t, then the RigidBodyState in order
+     */
+    static std::vector<std::string> recordColumns();
+
+    static const char* eventName(Event event);
+
+private:
+    template <size_t W> friend class FlightSimLanes;
+
+    // Events found within one step, at times interpolated within it (negative if none)
+    struct StepEvents {
+        double railExit;
+        double apogee;
+        double impact;
+    };
+
+    static void validateRocket(const Rocket& rocket);
+    static void validateSettings(const Settings& settings);
+    static void railDirection(const Settings& settings, double direction[3]);
+    static RigidBodyState initialState(const Rocket& rocket, const double railDirection[3]);
+
+    /**
+     * Times a flight stops at before it coasts, each a kink in thrust and
+     * mass flow: the thrust curve's points, or an engine's burn time
+     */
+    static void breakpoints(const Rocket& rocket, const double*& times, size_t& count);
+
+    /**
+     * Engine thrust (N) and propellant flow (kg/s) at chamber pressure Pc
+     * (psi) with table values Cf and Cstar
+     */
+    static void engineThrust(const PressureFedEngine& engine, double Pc, double Cf, double Cstar,
+                             double& thrust, double& massFlow);
+
+    /**
+     * Bookkeeping after a step of h from (t0, previous) to (t, state): speed,
+     * rail exit, apogee and coast steps; at ground impact t and state are
+     * interpolated back to z = 0
+     * @param steps Steps taken in the flight so far
+     * @return false at ground impact
+     */
+    static bool trackStep(const Settings& settings, const double railDirection[3],
+                          const RigidBodyState& previous, double t0, double h, double& t, RigidBodyState& state,
+                          uint64_t steps, Result& result, StepEvents& events);
+
+    /**
+     * Flight time, landing point and range at the end of a flight
+     */
+    static void finishFlight(double t, const RigidBodyState& state, Result& result);
+
+    void derivative(double t, const RigidBodyState& state, RigidBodyState& rate) override;
+
+    /**
+     * Integrate from t to tEnd, tracking apogee, speed and ground impact
+     * @return false if the rocket hit the ground
+     */
+    bool integrate(double& t, RigidBodyState& state, double tEnd, Result& result);
+
+    /**
+     * Thrust (N) and propellant flow (kg/s) from the engine or thrust curve
+     */
+    void propulsion(double t, const RigidBodyState& state, double& thrust, double& massFlow) const;
+
+    void record(double t, const RigidBodyState& state);
+    void markEvent(Event event, double t);
+
+    Rocket m_rocket;
+    Settings m_settings;
+    RigidBodyIntegrator m_integrator;
+    double m_totalImpulse;
+    double m_railDirection[3];      // Unit vector along the rail
+    FlightRecorder* m_recorder;
+    mutable InterpolationCursor m_cursor;   // Engine table lookups
+};
+
+#endif // FLIGHT_SIM_H
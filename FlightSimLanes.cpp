@@ -0,0 +1,590 @@
+/**
+ * FlightSimLanes.cpp
+ *
+ * The vector passes are written once, as loops over the lanes with every
+ * branch of FlightSim::evaluateForces and derivative turned into a select,
+ * and inlined into a scalar, an AVX2 and an AVX-512 function so each is
+ * vectorized for its instruction set. Like RPATableInterpolatorSimd.cpp they
+ * are built without FP contraction, so the vectorized arithmetic rounds
+ * exactly as FlightSim's does.
+ */
+
+#include "FlightSimLanes.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define RPA_HAVE_X86_KERNELS 1
+#else
+#define RPA_HAVE_X86_KERNELS 0
+#endif
+
+// As in RPATableInterpolatorSimd.cpp: no FMA in the vectorized passes
+#if defined(__GNUC__) && !defined(__clang__)
+#define RPA_NO_CONTRACT , optimize("fp-contract=off")
+#else
+#define RPA_NO_CONTRACT
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RPA_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define RPA_ALWAYS_INLINE inline
+#endif
+
+namespace {
+    const size_t N = RigidBodyState::SIZE;
+
+    // RK4 tableau, as in RigidBodyIntegrator::stepRK4
+    const double RK4_A[4][3] = { { 0, 0, 0 }, { 0.5, 0, 0 }, { 0, 0.5, 0 }, { 0, 0, 1.0 } };
+    const double RK4_C[4] = { 0.0, 0.5, 0.5, 1.0 };
+
+    // stage = x + h * sum(A[S][j] * k[j]) for j < S; the first stage is at x
+    template <size_t W, size_t S, class Block>
+    RPA_ALWAYS_INLINE void combineLanes(Block& b) {
+        if (S == 0) {
+            for (size_t i = 0; i < N; ++i) {
+                for (size_t l = 0; l < W; ++l) b.stage[i][l] = b.x[i][l];
+            }
+            return;
+        }
+        for (size_t i = 0; i < N; ++i) {
+            double sum[W];
+            for (size_t l = 0; l < W; ++l) sum[l] = 0.0;
+            for (size_t j = 0; j < S; ++j) {
+                const double a = RK4_A[S][j];
+                for (size_t l = 0; l < W; ++l) sum[l] += a * b.k[j][i][l];
+            }
+            for (size_t l = 0; l < W; ++l) b.stage[i][l] = b.x[i][l] + b.h[l] * sum[l];
+        }
+    }
+
+    // Rotation matrix, air velocity and its body components at the stage state
+    template <size_t W, class Block>
+    RPA_ALWAYS_INLINE void airLanes(Block& b) {
+        const double (*q)[W] = b.stage + RigidBodyState::ATTITUDE;
+        const double (*v)[W] = b.stage + RigidBodyState::VELOCITY;
+        for (size_t l = 0; l < W; ++l) {
+            const double w = q[0][l], x = q[1][l], y = q[2][l], z = q[3][l];
+            double R[3][3];
+            R[0][0] = 1 - 2 * (y * y + z * z);  R[0][1] = 2 * (x * y - w * z);      R[0][2] = 2 * (x * z + w * y);
+            R[1][0] = 2 * (x * y + w * z);      R[1][1] = 1 - 2 * (x * x + z * z);  R[1][2] = 2 * (y * z - w * x);
+            R[2][0] = 2 * (x * z - w * y);      R[2][1] = 2 * (y * z + w * x);      R[2][2] = 1 - 2 * (x * x + y * y);
+
+            double vAir[3];
+            for (size_t i = 0; i < 3; ++i) {
+                vAir[i] = v[i][l] - b.wind[i][l];
+                b.airVelocity[i][l] = vAir[i];
+                for (size_t j = 0; j < 3; ++j) b.R[i][j][l] = R[i][j];
+            }
+            double vb[3];
+            for (size_t j = 0; j < 3; ++j) {
+                vb[j] = R[0][j] * vAir[0] + R[1][j] * vAir[1] + R[2][j] * vAir[2];
+                b.bodyAirVelocity[j][l] = vb[j];
+            }
+            b.lateral[l] = std::sqrt(vb[1] * vb[1] + vb[2] * vb[2]);
+        }
+    }
+
+    // FlightSim::evaluateForces and derivative at the stage state, into k[K]
+    template <size_t W, size_t K, class Block>
+    RPA_ALWAYS_INLINE void rateLanes(Block& b) {
+        const double (*S)[W] = b.stage;
+        double (*rate)[W] = b.k[K];
+        for (size_t l = 0; l < W; ++l) {
+            const double r[3] = { S[0][l], S[1][l], S[2][l] };
+            const double v[3] = { S[3][l], S[4][l], S[5][l] };
+            const double q[4] = { S[6][l], S[7][l], S[8][l], S[9][l] };
+            const double omega[3] = { S[10][l], S[11][l], S[12][l] };
+            const double m = S[13][l];
+            const double d[3] = { b.railDirection[0][l], b.railDirection[1][l], b.railDirection[2][l] };
+            double R[3][3];
+            for (size_t i = 0; i < 3; ++i) {
+                for (size_t j = 0; j < 3; ++j) R[i][j] = b.R[i][j][l];
+            }
+
+            // Thrust and gravity
+            double thrustForce[3];
+            for (size_t i = 0; i < 3; ++i) thrustForce[i] = b.thrust[l] * R[i][0];
+            thrustForce[2] -= FlightSim::GRAVITY * m;
+
+            const double along = r[0] * d[0] + r[1] * d[1] + r[2] * d[2];
+            const double alongSpeed = v[0] * d[0] + v[1] * d[1] + v[2] * d[2];
+            // & rather than && keeps the loop free of branches
+            const bool onRail = (along < b.railLength[l]) & (alongSpeed >= 0.0) &
+                                ((r[0] * r[0] + r[1] * r[1] + r[2] * r[2]) - along * along < 1e-6);
+
+            // Aerodynamics, used only above MIN_AIR_SPEED
+            const double vAir[3] = { b.airVelocity[0][l], b.airVelocity[1][l], b.airVelocity[2][l] };
+            const double speed = std::sqrt(vAir[0] * vAir[0] + vAir[1] * vAir[1] + vAir[2] * vAir[2]);
+            const bool aero = !(speed < FlightSim::MIN_AIR_SPEED);
+            const double qbar = 0.5 * b.density[l] * speed * speed;
+            const double qA = qbar * b.referenceArea[l];
+            const bool tables = b.aeroTables[l] > 0.0;
+            const double tableDrag = qbar * b.dragArea[l];
+            const double tableNormal = qbar * b.normalArea[l];
+            const double constantDrag = qA * b.dragCoefficient[l];
+            const double constantNormal = qA * b.normalForceSlope[l] * b.alpha[l];
+            const double drag = tables ? tableDrag : constantDrag;
+            double aeroForce[3];
+            for (size_t i = 0; i < 3; ++i) {
+                aeroForce[i] = thrustForce[i] - drag * vAir[i] / speed;
+            }
+
+            const double lateral = b.lateral[l];
+            const bool normalLoad = lateral > 0.0;
+            const double normal = (tables ? tableNormal : constantNormal) / lateral;
+            const double fy = -normal * b.bodyAirVelocity[1][l];
+            const double fz = -normal * b.bodyAirVelocity[2][l];
+            for (size_t i = 0; i < 3; ++i) {
+                const double withNormal = aeroForce[i] + (R[i][1] * fy + R[i][2] * fz);
+                aeroForce[i] = normalLoad ? withNormal : aeroForce[i];
+            }
+            double moment1 = 0.0, moment2 = 0.0;
+            const double normalMoment1 = moment1 + b.staticMargin[l] * fz;
+            const double normalMoment2 = moment2 - b.staticMargin[l] * fy;
+            moment1 = normalLoad ? normalMoment1 : moment1;
+            moment2 = normalLoad ? normalMoment2 : moment2;
+
+            const double damping = qA * b.referenceLength[l] * b.pitchDampingCoefficient[l] *
+                                   b.referenceLength[l] / (2.0 * speed);
+            const double dampedMoment1 = moment1 - damping * omega[1];
+            const double dampedMoment2 = moment2 - damping * omega[2];
+
+            double force[3];
+            for (size_t i = 0; i < 3; ++i) force[i] = aero ? aeroForce[i] : thrustForce[i];
+            moment1 = aero ? dampedMoment1 : 0.0;
+            moment2 = aero ? dampedMoment2 : 0.0;
+
+            // Translation, held to the rail while on it
+            double dv[3];
+            for (size_t i = 0; i < 3; ++i) {
+                rate[RigidBodyState::POSITION + i][l] = v[i];
+                dv[i] = force[i] / m;
+            }
+            double a = dv[0] * d[0] + dv[1] * d[1] + dv[2] * d[2];
+            a = ((a < 0.0) & (alongSpeed <= 0.0)) ? 0.0 : a;
+            for (size_t i = 0; i < 3; ++i) {
+                rate[RigidBodyState::VELOCITY + i][l] = onRail ? a * d[i] : dv[i];
+            }
+
+            // Euler's equations
+            const double fraction = (m - b.dryMass[l]) / b.propellantMass[l];
+            const double remaining = b.propellantMass[l] > 0.0 ? fraction : 0.0;
+            const double atLeastZero = 0.0 < remaining ? remaining : 0.0;
+            const double f = atLeastZero < 1.0 ? atLeastZero : 1.0;
+            const double Ix = b.rollInertiaDry[l] + f * (b.rollInertiaWet[l] - b.rollInertiaDry[l]);
+            const double Iy = b.pitchInertiaDry[l] + f * (b.pitchInertiaWet[l] - b.pitchInertiaDry[l]);
+            const double moment0 = 0.0;
+            const double dw[3] = {
+                moment0 / Ix,
+                (moment1 - (Ix - Iy) * omega[2] * omega[0]) / Iy,
+                (moment2 - (Iy - Ix) * omega[0] * omega[1]) / Iy
+            };
+            for (size_t i = 0; i < 3; ++i) {
+                rate[RigidBodyState::ANGULAR_RATE + i][l] = onRail ? 0.0 : dw[i];
+            }
+
+            const double* w = omega;
+            rate[RigidBodyState::ATTITUDE + 0][l] = -0.5 * (q[1] * w[0] + q[2] * w[1] + q[3] * w[2]);
+            rate[RigidBodyState::ATTITUDE + 1][l] = 0.5 * (q[0] * w[0] + q[2] * w[2] - q[3] * w[1]);
+            rate[RigidBodyState::ATTITUDE + 2][l] = 0.5 * (q[0] * w[1] + q[3] * w[0] - q[1] * w[2]);
+            rate[RigidBodyState::ATTITUDE + 3][l] = 0.5 * (q[0] * w[2] + q[1] * w[1] - q[2] * w[0]);
+
+            rate[RigidBodyState::MASS][l] = -b.massFlow[l];
+        }
+    }
+
+    // RK4 sum, then RigidBodyState::normalizeAttitude
+    template <size_t W, class Block>
+    RPA_ALWAYS_INLINE void updateLanes(Block& b) {
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t l = 0; l < W; ++l) {
+                b.x[i][l] += b.h[l] / 6.0 * (b.k[0][i][l] + 2.0 * (b.k[1][i][l] + b.k[2][i][l]) + b.k[3][i][l]);
+            }
+        }
+        double (*q)[W] = b.x + RigidBodyState::ATTITUDE;
+        for (size_t l = 0; l < W; ++l) {
+            const double norm = std::sqrt(q[0][l] * q[0][l] + q[1][l] * q[1][l] + q[2][l] * q[2][l] + q[3][l] * q[3][l]);
+            for (size_t i = 0; i < 4; ++i) q[i][l] = norm > 0.0 ? q[i][l] / norm : q[i][l];
+        }
+    }
+
+    template <size_t W, class Block, class Pass>
+    RPA_ALWAYS_INLINE void runPass(Block& b, Pass pass, size_t stage) {
+        // Stage numbers become constants, so the compiler sees which k[] each
+        // pass reads and writes and need not guard against aliasing
+        switch (pass) {
+        case Pass::COMBINE:
+            switch (stage) {
+            case 0: combineLanes<W, 0>(b); break;
+            case 1: combineLanes<W, 1>(b); break;
+            case 2: combineLanes<W, 2>(b); break;
+            default: combineLanes<W, 3>(b); break;
+            }
+            break;
+        case Pass::AIR: airLanes<W>(b); break;
+        case Pass::RATES:
+            switch (stage) {
+            case 0: rateLanes<W, 0>(b); break;
+            case 1: rateLanes<W, 1>(b); break;
+            case 2: rateLanes<W, 2>(b); break;
+            default: rateLanes<W, 3>(b); break;
+            }
+            break;
+        case Pass::UPDATE: updateLanes<W>(b); break;
+        }
+    }
+
+    // The target attributes must be on free functions: GCC ignores them on
+    // out-of-class definitions of class template members
+#if RPA_HAVE_X86_KERNELS
+    template <size_t W, class Block, class Pass>
+    __attribute__((target("avx2") RPA_NO_CONTRACT))
+    void passAVX2(Block& b, Pass pass, size_t stage) {
+        runPass<W>(b, pass, stage);
+    }
+
+    template <size_t W, class Block, class Pass>
+    __attribute__((target("avx512f") RPA_NO_CONTRACT))
+    void passAVX512(Block& b, Pass pass, size_t stage) {
+        runPass<W>(b, pass, stage);
+    }
+#else
+    template <size_t W, class Block, class Pass>
+    void passAVX2(Block& b, Pass pass, size_t stage) {
+        runPass<W>(b, pass, stage);
+    }
+
+    template <size_t W, class Block, class Pass>
+    void passAVX512(Block& b, Pass pass, size_t stage) {
+        runPass<W>(b, pass, stage);
+    }
+#endif
+}
+
+template <size_t W>
+const size_t FlightSimLanes<W>::WIDTH;
+
+template <size_t W>
+FlightSimLanes<W>::Stats::Stats()
+    : flights(0)
+    , rejectedFlights(0)
+    , steps(0)
+    , laneSteps(0) {
+}
+
+template <size_t W>
+FlightSimLanes<W>::FlightSimLanes(const RigidBodyIntegrator::Settings& integrator)
+    : m_integrator(integrator)
+    , m_simdLevel(RPATableInterpolator::detectSimdLevel())
+    , m_block()
+    , m_supply(false) {
+    if (integrator.method != RigidBodyIntegrator::Method::RK4) {
+        throw std::invalid_argument("Flight lanes integrate with RK4 only");
+    }
+    RigidBodyIntegrator check(integrator);
+    for (Lane& lane : m_lanes) {
+        lane.phase = Phase::EMPTY;
+    }
+}
+
+template <size_t W>
+void FlightSimLanes<W>::setSimdLevel(RPATableInterpolator::SimdLevel level) {
+    RPATableInterpolator::SimdLevel supported = RPATableInterpolator::detectSimdLevel();
+    m_simdLevel = (static_cast<int>(level) > static_cast<int>(supported)) ? supported : level;
+}
+
+template <size_t W>
+void FlightSimLanes<W>::run(const NextFlight& next, const FlightDone& done) {
+    m_stats = Stats();
+    m_supply = true;
+    for (size_t l = 0; l < W; ++l) {
+        m_lanes[l].phase = Phase::EMPTY;
+        advance(l, next, done);
+    }
+
+    const double step = m_integrator.step;
+    for (;;) {
+        // Each lane's step, as RigidBodyIntegrator::step takes it
+        size_t active = 0;
+        for (size_t l = 0; l < W; ++l) {
+            Lane& lane = m_lanes[l];
+            if (lane.phase == Phase::EMPTY) {
+                m_block.h[l] = 0.0;
+                continue;
+            }
+            const double remaining = lane.phaseEnd - lane.t;
+            m_block.h[l] = remaining <= step * (1.0 + 1e-6) ? remaining : step;
+            gatherState(l, lane.previous);
+            ++active;
+        }
+        if (active == 0) {
+            break;
+        }
+
+        for (size_t s = 0; s < 4; ++s) {
+            pass(Pass::COMBINE, s);
+            propulsion(s);
+            pass(Pass::AIR, s);
+            aerodynamics();
+            pass(Pass::RATES, s);
+        }
+        pass(Pass::UPDATE, 0);
+        ++m_stats.steps;
+        m_stats.laneSteps += active;
+
+        for (size_t l = 0; l < W; ++l) {
+            Lane& lane = m_lanes[l];
+            if (lane.phase == Phase::EMPTY) {
+                continue;
+            }
+            const double t0 = lane.t;
+            const double h = m_block.h[l];
+            lane.t += h;
+            RigidBodyIntegrator::Stats& stats = lane.result.steps;
+            stats.minStepTaken = stats.steps ? std::min(stats.minStepTaken, h) : h;
+            stats.maxStepTaken = std::max(stats.maxStepTaken, h);
+            ++stats.steps;
+            stats.evaluations += 4;
+
+            RigidBodyState state;
+            gatherState(l, state);
+            FlightSim::StepEvents events;
+            if (!FlightSim::trackStep(lane.settings, lane.railDirection, lane.previous, t0, h, lane.t, state,
+                                      stats.steps, lane.result, events)) {
+                finish(l, state, done);
+            }
+            advance(l, next, done);
+        }
+    }
+}
+
+template <size_t W>
+bool FlightSimLanes<W>::load(size_t l, const NextFlight& next, const FlightDone& done) {
+    Lane& lane = m_lanes[l];
+    while (next(lane.id, lane.rocket, lane.settings)) {
+        try {
+            FlightSim::validateRocket(lane.rocket);
+            FlightSim::validateSettings(lane.settings);
+        } catch (const std::invalid_argument&) {
+            ++m_stats.flights;
+            ++m_stats.rejectedFlights;
+            done(lane.id, nullptr);
+            continue;
+        }
+
+        const Rocket& rocket = lane.rocket;
+        lane.phase = Phase::BOOST;
+        lane.t = 0.0;
+        lane.phaseEnd = 0.0;        // advance() picks the first breakpoint
+        lane.breakpoint = 0;
+        lane.totalImpulse = rocket.totalImpulse();
+        lane.result = FlightSim::Result();
+        lane.cursor.invalidate();
+        FlightSim::railDirection(lane.settings, lane.railDirection);
+        scatterState(l, FlightSim::initialState(rocket, lane.railDirection));
+
+        Block& b = m_block;
+        b.dryMass[l] = rocket.dryMass;
+        b.propellantMass[l] = rocket.propellantMass;
+        b.rollInertiaDry[l] = rocket.rollInertiaDry;
+        b.rollInertiaWet[l] = rocket.rollInertiaWet;
+        b.pitchInertiaDry[l] = rocket.pitchInertiaDry;
+        b.pitchInertiaWet[l] = rocket.pitchInertiaWet;
+        b.referenceArea[l] = rocket.referenceArea;
+        b.referenceLength[l] = rocket.referenceLength;
+        b.dragCoefficient[l] = rocket.dragCoefficient;
+        b.normalForceSlope[l] = rocket.normalForceSlope;
+        b.staticMargin[l] = rocket.staticMargin;
+        b.pitchDampingCoefficient[l] = rocket.pitchDampingCoefficient;
+        b.aeroTables[l] = rocket.aero ? 1.0 : 0.0;
+        for (size_t i = 0; i < 3; ++i) {
+            b.railDirection[i][l] = lane.railDirection[i];
+            b.wind[i][l] = lane.settings.wind[i];
+        }
+        b.railLength[l] = lane.settings.railLength;
+        return true;
+    }
+    lane.phase = Phase::EMPTY;
+    return false;
+}
+
+template <size_t W>
+void FlightSimLanes<W>::advance(size_t l, const NextFlight& next, const FlightDone& done) {
+    Lane& lane = m_lanes[l];
+    for (;;) {
+        if (lane.phase == Phase::EMPTY) {
+            m_supply = m_supply && load(l, next, done);
+            if (lane.phase == Phase::EMPTY) {
+                return;
+            }
+        }
+        if (lane.t < lane.phaseEnd) {
+            return;
+        }
+
+        RigidBodyState state;
+        gatherState(l, state);
+        if (lane.phase == Phase::BOOST) {
+            // As FlightSim::run: on to the next breakpoint ahead, then
+            // burnout if the flight lasted that long (RK4 has nothing to restart)
+            const double* times;
+            size_t count;
+            FlightSim::breakpoints(lane.rocket, times, count);
+            while (lane.breakpoint < count && !(times[lane.breakpoint] > lane.t)) {
+                ++lane.breakpoint;
+            }
+            if (lane.breakpoint < count && lane.t < lane.settings.maxTime) {
+                lane.phaseEnd = std::min(times[lane.breakpoint++], lane.settings.maxTime);
+                continue;
+            }
+            if (count && lane.t >= lane.rocket.burnTime()) {
+                const double* v = state.velocity();
+                lane.result.burnoutTime = lane.t;
+                lane.result.boostSteps = lane.result.steps.steps;
+                lane.result.burnoutSpeed = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+            }
+            lane.phase = Phase::COAST;
+            lane.phaseEnd = lane.settings.maxTime;
+        } else {
+            finish(l, state, done);
+        }
+    }
+}
+
+template <size_t W>
+void FlightSimLanes<W>::finish(size_t l, const RigidBodyState& state, const FlightDone& done) {
+    Lane& lane = m_lanes[l];
+    FlightSim::finishFlight(lane.t, state, lane.result);
+    lane.phase = Phase::EMPTY;
+    ++m_stats.flights;
+    done(lane.id, &lane.result);
+}
+
+template <size_t W>
+void FlightSimLanes<W>::gatherState(size_t l, RigidBodyState& state) const {
+    for (size_t i = 0; i < N; ++i) {
+        state.x[i] = m_block.x[i][l];
+    }
+}
+
+template <size_t W>
+void FlightSimLanes<W>::scatterState(size_t l, const RigidBodyState& state) {
+    for (size_t i = 0; i < N; ++i) {
+        m_block.x[i][l] = state.x[i];
+    }
+}
+
+template <size_t W>
+void FlightSimLanes<W>::propulsion(size_t s) {
+    Block& b = m_block;
+    const double (*S)[W] = b.stage;
+    const RPATableInterpolator* batchTable = nullptr;
+    size_t batched = 0;
+
+    for (size_t l = 0; l < W; ++l) {
+        Lane& lane = m_lanes[l];
+        b.thrust[l] = 0.0;
+        b.massFlow[l] = 0.0;
+        b.density[l] = 0.0;
+        if (lane.phase == Phase::EMPTY) {
+            continue;
+        }
+        const double t = s == 0 ? lane.t : lane.t + RK4_C[s] * b.h[l];
+        const double z = S[RigidBodyState::POSITION + 2][l];
+        b.density[l] = FlightSim::airDensity(z);
+
+        const Rocket& rocket = lane.rocket;
+        if (!rocket.hasEngine()) {
+            // As FlightSim::propulsion
+            b.thrust[l] = rocket.thrustAt(t);
+            b.massFlow[l] = lane.totalImpulse > 0.0 ? rocket.propellantMass * b.thrust[l] / lane.totalImpulse : 0.0;
+            continue;
+        }
+        const double Pc = rocket.engine.chamberPressure(t);
+        if (Pc <= 0.0 || S[RigidBodyState::MASS][l] <= rocket.dryMass) {
+            continue;
+        }
+        const double Pa = FlightSim::ambientPressure(z);
+        const RPATableInterpolator* table = rocket.engine.table.get();
+        if (!batchTable) {
+            batchTable = table;
+        }
+        if (table == batchTable) {
+            m_batchPc[batched] = Pc;
+            m_batchOF[batched] = rocket.engine.mixtureRatio;
+            m_batchPa[batched] = Pa;
+            m_batchLane[batched] = l;
+            ++batched;
+        } else {
+            const RPATableInterpolator::PerformanceData perf =
+                table->getFields<RPATableInterpolator::MASK_CF | RPATableInterpolator::MASK_CSTAR>(
+                    Pc, rocket.engine.mixtureRatio, Pa, lane.cursor);
+            FlightSim::engineThrust(rocket.engine, Pc, perf.Cf, perf.Cstar, b.thrust[l], b.massFlow[l]);
+        }
+    }
+    if (batched == 0) {
+        return;
+    }
+
+    // One query for the lanes on the first table seen (usually all of them)
+    RPATableInterpolator::PerformanceBatch out;
+    out.Cf = m_batchOut[0];
+    out.Cstar = m_batchOut[1];
+    out.Isp = m_batchOut[2];
+    out.Ve = m_batchOut[3];
+    out.Pe = m_batchOut[4];
+    out.gamma = m_batchOut[5];
+    batchTable->getPerformanceBatch(m_batchPc, m_batchOF, m_batchPa, batched, out);
+    for (size_t i = 0; i < batched; ++i) {
+        const size_t l = m_batchLane[i];
+        FlightSim::engineThrust(m_lanes[l].rocket.engine, m_batchPc[i], out.Cf[i], out.Cstar[i],
+                                b.thrust[l], b.massFlow[l]);
+    }
+}
+
+template <size_t W>
+void FlightSimLanes<W>::aerodynamics() {
+    Block& b = m_block;
+    for (size_t l = 0; l < W; ++l) {
+        b.alpha[l] = (m_lanes[l].phase != Phase::EMPTY && b.lateral[l] > 0.0)
+                         ? std::atan2(b.lateral[l], b.bodyAirVelocity[0][l]) : 0.0;
+        b.dragArea[l] = 0.0;
+        b.normalArea[l] = 0.0;
+        const Rocket& rocket = m_lanes[l].rocket;
+        const CoeffData* aero = rocket.aero.get();
+        if (m_lanes[l].phase == Phase::EMPTY || !aero) {
+            continue;
+        }
+        // As FlightSim::evaluateForces
+        const double vAir[3] = { b.airVelocity[0][l], b.airVelocity[1][l], b.airVelocity[2][l] };
+        const double speed = std::sqrt(vAir[0] * vAir[0] + vAir[1] * vAir[1] + vAir[2] * vAir[2]);
+        const double z = b.stage[RigidBodyState::POSITION + 2][l];
+        const CoeffData::Coefficients c = aero->lookup(
+            b.thrust[l] > 0.0 ? RasData::Power::ON : RasData::Power::OFF, speed / FlightSim::speedOfSound(z), b.alpha[l],
+            rocket.aeroDragScale, rocket.aeroNormalScale);
+        b.dragArea[l] = c.dragArea;
+        b.normalArea[l] = c.normalArea;
+    }
+}
+
+template <size_t W>
+void FlightSimLanes<W>::pass(Pass pass, size_t stage) {
+    switch (m_simdLevel) {
+    case RPATableInterpolator::SimdLevel::AVX512:
+        passAVX512<W>(m_block, pass, stage);
+        break;
+    case RPATableInterpolator::SimdLevel::AVX2:
+        passAVX2<W>(m_block, pass, stage);
+        break;
+    default:
+        runPass<W>(m_block, pass, stage);
+        break;
+    }
+}
+
+template class FlightSimLanes<4>;
+template class FlightSimLanes<8>;
+template class FlightSimLanes<16>;
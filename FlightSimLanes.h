@@ -0,0 +1,203 @@
+#ifndef FLIGHT_SIM_LANES_H
+#define FLIGHT_SIM_LANES_H
+
+#include "FlightSim.h"
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * FlightSimLanes
+ *
+ * Flies W rockets at once (W = 4, 8 or 16) with the FlightSim model and a
+ * fixed-step RK4. The lanes' states are held as structure-of-arrays, one
+ * array of W doubles per state component, and every stage of every step
+ * advances all lanes in lockstep through plain loops over the lanes that
+ * the compiler vectorizes: AVX2 and AVX-512 builds of them are selected at
+ * runtime as for RPATableInterpolator::getPerformanceBatch.
+ *
+ * Each lane still keeps its own time, step and flight phase. The parts that
+ * are not vector arithmetic run lane by lane between the vector passes: the
+ * thrust curve, the atmosphere, the angle of attack (libm calls) and aero
+ * table lookups. Engine Cf and c* for every burning lane on a shared table
+ * come from one getPerformanceBatch call per stage.
+ *
+ * The vector passes do the same IEEE operations in the same order as
+ * FlightSim, with selects in place of branches, and the bookkeeping between
+ * steps is FlightSim's own, so each flight's Result is bit-identical to
+ * FlightSim::run() with RK4 at the same step.
+ *
+ * As a lane's flight ends it is handed back and the lane is refilled with
+ * the next flight, so lanes stay busy until the supply runs out; lanes left
+ * empty at the end are masked (zero step).
+ */
+template <size_t W>
+class FlightSimLanes {
+public:
+    static_assert(W == 4 || W == 8 || W == 16, "FlightSimLanes is built for 4, 8 or 16 lanes");
+
+    /**
+     * Supplies the next flight: sets id (the caller's) and the inputs
+     * @return false when there are no more flights
+     */
+    typedef std::function<bool(uint64_t& id, Rocket& rocket, FlightSim::Settings& settings)> NextFlight;
+
+    /**
+     * Receives each finished flight; result is null if FlightSim rejected its
+     * rocket or settings. The integrator settings of every flight are the
+     * lanes' own.
+     */
+    typedef std::function<void(uint64_t id, const FlightSim::Result* result)> FlightDone;
+
+    struct Stats {
+        uint64_t flights;           // Flights finished, rejected ones included
+        uint64_t rejectedFlights;
+        uint64_t steps;             // Lockstep steps, all lanes at once
+        uint64_t laneSteps;         // Steps taken by lanes with a flight
+
+        Stats();
+    };
+
+    static const size_t WIDTH = W;
+
+    /**
+     * @throws std::invalid_argument unless the settings are valid RK4 settings
+     */
+    explicit FlightSimLanes(const RigidBodyIntegrator::Settings& integrator);
+
+    FlightSimLanes(const FlightSimLanes&) = delete;
+    FlightSimLanes& operator=(const FlightSimLanes&) = delete;
+
+    /**
+     * Fly every flight next() supplies, passing each to done() as it ends
+     * (not in supply order)
+     */
+    void run(const NextFlight& next, const FlightDone& done);
+
+    /**
+     * Select the vector passes' instruction set; requests above
+     * RPATableInterpolator::detectSimdLevel() are lowered to it.
+     * Defaults to the detected level.
+     */
+    void setSimdLevel(RPATableInterpolator::SimdLevel level);
+    RPATableInterpolator::SimdLevel getSimdLevel() const { return m_simdLevel; }
+
+    const Stats& getStats() const { return m_stats; }
+    const RigidBodyIntegrator::Settings& getIntegratorSettings() const { return m_integrator; }
+
+private:
+    enum class Phase {
+        EMPTY,
+        BOOST,
+        COAST
+    };
+
+    enum class Pass {
+        COMBINE,                    // Stage state
+        AIR,                        // Rotation and air velocity
+        RATES,                      // Loads and state derivative
+        UPDATE                      // RK4 sum and attitude renormalisation
+    };
+
+    // Lane state by component, x[RigidBodyState::POSITION][lane] and so on,
+    // and the vector passes' inputs and intermediates
+    struct Block {
+        static const size_t N = RigidBodyState::SIZE;
+
+        alignas(64) double x[N][W];
+        alignas(64) double stage[N][W];     // State at which a stage is evaluated
+        alignas(64) double k[4][N][W];      // Stage derivatives
+        alignas(64) double h[W];            // This step; 0 in an empty lane
+
+        // Rocket and settings, per lane
+        alignas(64) double dryMass[W];
+        alignas(64) double propellantMass[W];
+        alignas(64) double rollInertiaDry[W];
+        alignas(64) double rollInertiaWet[W];
+        alignas(64) double pitchInertiaDry[W];
+        alignas(64) double pitchInertiaWet[W];
+        alignas(64) double referenceArea[W];
+        alignas(64) double referenceLength[W];
+        alignas(64) double dragCoefficient[W];
+        alignas(64) double normalForceSlope[W];
+        alignas(64) double staticMargin[W];
+        alignas(64) double pitchDampingCoefficient[W];
+        alignas(64) double aeroTables[W];   // 1 if the rocket has aero tables, else 0
+        alignas(64) double railDirection[3][W];
+        alignas(64) double railLength[W];
+        alignas(64) double wind[3][W];
+
+        // Per stage: from the lane-by-lane passes
+        alignas(64) double thrust[W];
+        alignas(64) double massFlow[W];
+        alignas(64) double density[W];
+        alignas(64) double alpha[W];        // Angle of attack
+        alignas(64) double dragArea[W];     // From aero tables
+        alignas(64) double normalArea[W];
+
+        // Per stage: from the first vector pass
+        alignas(64) double R[3][3][W];      // Body-to-inertial rotation
+        alignas(64) double airVelocity[3][W];
+        alignas(64) double bodyAirVelocity[3][W];
+        alignas(64) double lateral[W];      // Lateral air speed in body axes
+    };
+
+    struct Lane {
+        uint64_t id;
+        Phase phase;
+        double t;
+        double phaseEnd;
+        size_t breakpoint;          // Next of FlightSim::breakpoints() to stop at
+        double totalImpulse;
+        double railDirection[3];
+        Rocket rocket;
+        FlightSim::Settings settings;
+        FlightSim::Result result;
+        RigidBodyState previous;    // State at the start of the step
+        InterpolationCursor cursor; // Engine lookups not in a batch
+    };
+
+    /**
+     * Take flights from next() into an empty lane until one is accepted
+     * @return false when there are no more flights
+     */
+    bool load(size_t lane, const NextFlight& next, const FlightDone& done);
+
+    /**
+     * Move a lane on past each breakpoint and burnout, and from the end of
+     * its flight to the next flight, until it has a step to take or no
+     * flight is left
+     */
+    void advance(size_t lane, const NextFlight& next, const FlightDone& done);
+    void finish(size_t lane, const RigidBodyState& state, const FlightDone& done);
+
+    void gatherState(size_t lane, RigidBodyState& state) const;
+    void scatterState(size_t lane, const RigidBodyState& state);
+
+    // Lane-by-lane inputs to the stage-th derivative
+    void propulsion(size_t stage);
+    void aerodynamics();
+
+    // One vector pass over all lanes, on the selected instruction set
+    void pass(Pass pass, size_t stage);
+
+    RigidBodyIntegrator::Settings m_integrator;
+    RPATableInterpolator::SimdLevel m_simdLevel;
+    Stats m_stats;
+    Block m_block;
+    Lane m_lanes[W];
+    bool m_supply;                  // next() has not yet returned false
+
+    // Batched engine lookups of one stage
+    alignas(64) double m_batchPc[W];
+    alignas(64) double m_batchOF[W];
+    alignas(64) double m_batchPa[W];
+    alignas(64) double m_batchOut[6][W];
+    size_t m_batchLane[W];
+};
+
+extern template class FlightSimLanes<4>;
+extern template class FlightSimLanes<8>;
+extern template class FlightSimLanes<16>;
+
+#endif // FLIGHT_SIM_LANES_H
@@ -0,0 +1,168 @@
+#include "Instrumentation.h"
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const char* const COUNTER_NAMES[Instrumentation::NUM_COUNTERS] = {
+        "pc_below_table",
+        "pc_above_table",
+        "of_below_table",
+        "of_above_table",
+        "pa_below_table",
+        "pa_above_table",
+        "non_finite_queries",
+        "interpolator_queries",
+        "thrust_queries",
+        "mass_flow_queries",
+        "mass_flow_inverse_hits",
+        "mass_flow_solves",
+        "mass_flow_unconverged"
+    };
+
+    const char* const HISTOGRAM_NAMES[Instrumentation::NUM_HISTOGRAMS] = {
+        "mass_flow_evaluations",
+        "mass_flow_latency_ns"
+    };
+}
+
+// Live thread blocks and the totals of exited threads. Never destroyed, so
+// threads exiting during static destruction can still retire their counts.
+struct Instrumentation::Registry {
+    std::mutex mutex;
+    std::vector<ThreadBlock*> threads;
+    uint64_t counters[NUM_COUNTERS];
+    uint64_t histograms[NUM_HISTOGRAMS][NUM_BUCKETS];
+
+    Registry() {
+        std::memset(counters, 0, sizeof(counters));
+        std::memset(histograms, 0, sizeof(histograms));
+    }
+
+    static Registry& instance() {
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+};
+
+Instrumentation::ThreadBlock::ThreadBlock() {
+    for (auto& c : counters) c.store(0, std::memory_order_relaxed);
+    for (auto& h : histograms) {
+        for (auto& b : h) b.store(0, std::memory_order_relaxed);
+    }
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.push_back(this);
+}
+
+Instrumentation::ThreadBlock::~ThreadBlock() {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (int c = 0; c < NUM_COUNTERS; ++c) {
+        registry.counters[c] += counters[c].load(std::memory_order_relaxed);
+    }
+    for (int h = 0; h < NUM_HISTOGRAMS; ++h) {
+        for (int b = 0; b < NUM_BUCKETS; ++b) {
+            registry.histograms[h][b] += histograms[h][b].load(std::memory_order_relaxed);
+        }
+    }
+    registry.threads.erase(std::remove(registry.threads.begin(), registry.threads.end(), this),
+                           registry.threads.end());
+}
+
+Instrumentation::Snapshot Instrumentation::snapshot() {
+    Snapshot s;
+    s.enabled = enabled();
+
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::memcpy(s.counters, registry.counters, sizeof(s.counters));
+    std::memcpy(s.histograms, registry.histograms, sizeof(s.histograms));
+    for (const ThreadBlock* block : registry.threads) {
+        for (int c = 0; c < NUM_COUNTERS; ++c) {
+            s.counters[c] += block->counters[c].load(std::memory_order_relaxed);
+        }
+        for (int h = 0; h < NUM_HISTOGRAMS; ++h) {
+            for (int b = 0; b < NUM_BUCKETS; ++b) {
+                s.histograms[h][b] += block->histograms[h][b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    return s;
+}
+
+void Instrumentation::reset() {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::memset(registry.counters, 0, sizeof(registry.counters));
+    std::memset(registry.histograms, 0, sizeof(registry.histograms));
+    for (ThreadBlock* block : registry.threads) {
+        for (auto& c : block->counters) c.store(0, std::memory_order_relaxed);
+        for (auto& h : block->histograms) {
+            for (auto& b : h) b.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+const char* Instrumentation::counterName(Counter counter) {
+    return COUNTER_NAMES[counter];
+}
+
+const char* Instrumentation::histogramName(Histogram histogram) {
+    return HISTOGRAM_NAMES[histogram];
+}
+
+uint64_t Instrumentation::bucketLowerBound(Histogram histogram, int bucket) {
+    if (histogram == MASS_FLOW_EVALUATIONS || bucket == 0) {
+        return static_cast<uint64_t>(bucket);
+    }
+    return uint64_t(1) << (bucket - 1);
+}
+
+uint64_t Instrumentation::Snapshot::count(Histogram h) const {
+    uint64_t total = 0;
+    for (int b = 0; b < NUM_BUCKETS; ++b) total += histograms[h][b];
+    return total;
+}
+
+void Instrumentation::Snapshot::writeText(std::ostream& out) const {
+    if (!enabled) {
+        out << "Instrumentation disabled (build with RPA_INSTRUMENTATION)" << std::endl;
+        return;
+    }
+    for (int c = 0; c < NUM_COUNTERS; ++c) {
+        out << counterName(static_cast<Counter>(c)) << ": " << counters[c] << "\n";
+    }
+    for (int h = 0; h < NUM_HISTOGRAMS; ++h) {
+        Histogram histogram = static_cast<Histogram>(h);
+        out << histogramName(histogram) << " (" << count(histogram) << " samples)\n";
+        for (int b = 0; b < NUM_BUCKETS; ++b) {
+            if (histograms[h][b] == 0) continue;
+            out << "  >= " << bucketLowerBound(histogram, b) << ": " << histograms[h][b] << "\n";
+        }
+    }
+    out.flush();
+}
+
+void Instrumentation::Snapshot::writeJson(std::ostream& out) const {
+    out << "{\"enabled\":" << (enabled ? "true" : "false") << ",\"counters\":{";
+    for (int c = 0; c < NUM_COUNTERS; ++c) {
+        out << (c ? "," : "") << "\"" << counterName(static_cast<Counter>(c)) << "\":" << counters[c];
+    }
+    out << "},\"histograms\":{";
+    for (int h = 0; h < NUM_HISTOGRAMS; ++h) {
+        Histogram histogram = static_cast<Histogram>(h);
+        out << (h ? "," : "") << "\"" << histogramName(histogram) << "\":{\"count\":" << count(histogram)
+            << ",\"buckets\":[";
+        // Nonempty buckets only, as [lower bound, count]
+        bool first = true;
+        for (int b = 0; b < NUM_BUCKETS; ++b) {
+            if (histograms[h][b] == 0) continue;
+            out << (first ? "" : ",") << "[" << bucketLowerBound(histogram, b) << "," << histograms[h][b] << "]";
+            first = false;
+        }
+        out << "]}";
+    }
+    out << "}}";
+}
@@ -0,0 +1,173 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * Instrumentation
+ *
+ * Process-wide event counters and histograms for the table and thrust hot
+ * paths: queries clamped at each table edge, non-finite inputs, how mass-flow
+ * queries are answered and how many table evaluations and nanoseconds each
+ * solve takes. Use them to size tables and to spot out-of-envelope operation.
+ *
+ * Recording is compiled in only when RPA_INSTRUMENTATION is defined (the
+ * CMake option of the same name); otherwise the RPA_COUNT / RPA_RECORD /
+ * RPA_TIME macros expand to nothing and snapshots are all zero. When enabled,
+ * each thread updates its own block with relaxed loads and stores (no locked
+ * instructions); snapshot() sums the blocks of live threads and the totals of
+ * threads that have exited.
+ */
+class Instrumentation {
+public:
+    enum Counter {
+        // Query coordinates outside the table, clamped to the edge
+        PC_BELOW_TABLE,
+        PC_ABOVE_TABLE,
+        OF_BELOW_TABLE,
+        OF_ABOVE_TABLE,
+        PA_BELOW_TABLE,
+        PA_ABOVE_TABLE,
+        NON_FINITE_QUERIES,         // NaN or infinite coordinate
+        INTERPOLATOR_QUERIES,       // Points evaluated by RPATableInterpolator (incl. batches)
+
+        THRUST_QUERIES,             // ThrustCalculator::calculateThrust
+        MASS_FLOW_QUERIES,          // ThrustCalculator::calculateThrustFromMassFlow
+        MASS_FLOW_INVERSE_HITS,     // ... answered from the inverse table
+        MASS_FLOW_SOLVES,           // ... answered by the iterative solve
+        MASS_FLOW_UNCONVERGED,      // Iterative solves (incl. inverse-table builds) stopped
+                                    // at the evaluation limit
+
+        NUM_COUNTERS
+    };
+
+    enum Histogram {
+        MASS_FLOW_EVALUATIONS,      // Table evaluations per iterative solve (linear buckets)
+        MASS_FLOW_LATENCY_NS,       // calculateThrustFromMassFlow wall time (power-of-two buckets)
+
+        NUM_HISTOGRAMS
+    };
+
+    static const int NUM_BUCKETS = 32;
+
+    struct Snapshot {
+        bool enabled;
+        uint64_t counters[NUM_COUNTERS];
+        uint64_t histograms[NUM_HISTOGRAMS][NUM_BUCKETS];
+
+        uint64_t count(Histogram h) const;     // Samples recorded in a histogram
+
+        void writeText(std::ostream& out) const;
+        void writeJson(std::ostream& out) const;
+    };
+
+    static bool enabled() {
+#ifdef RPA_INSTRUMENTATION
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Totals over all threads
+     * Exact once recording threads are quiescent; counts recorded
+     * concurrently may or may not be included.
+     */
+    static Snapshot snapshot();
+
+    /**
+     * Zero every counter and histogram
+     * Intended for quiescent moments; an increment racing with reset() may
+     * survive it.
+     */
+    static void reset();
+
+    static const char* counterName(Counter counter);
+    static const char* histogramName(Histogram histogram);
+
+    /**
+     * Smallest value falling in a histogram bucket
+     */
+    static uint64_t bucketLowerBound(Histogram histogram, int bucket);
+
+    static void increment(Counter counter, uint64_t n = 1) {
+        add(local().counters[counter], n);
+    }
+
+    static void record(Histogram histogram, uint64_t value) {
+        add(local().histograms[histogram][bucketIndex(histogram, value)], 1);
+    }
+
+    /**
+     * Records the lifetime of the enclosing scope in nanoseconds
+     */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Histogram histogram)
+            : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() {
+            auto elapsed = std::chrono::steady_clock::now() - m_start;
+            record(m_histogram, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+
+    private:
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        Histogram m_histogram;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+private:
+    struct Registry;
+
+    // One thread's counts; only the owning thread writes them
+    struct ThreadBlock {
+        std::atomic<uint64_t> counters[NUM_COUNTERS];
+        std::atomic<uint64_t> histograms[NUM_HISTOGRAMS][NUM_BUCKETS];
+
+        ThreadBlock();      // Registers the block
+        ~ThreadBlock();     // Folds the counts into the retired totals
+    };
+
+    static ThreadBlock& local() {
+        static thread_local ThreadBlock block;
+        return block;
+    }
+
+    static void add(std::atomic<uint64_t>& value, uint64_t n) {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static int bucketIndex(Histogram histogram, uint64_t value) {
+        if (histogram == MASS_FLOW_EVALUATIONS) {
+            return value < uint64_t(NUM_BUCKETS) ? static_cast<int>(value) : NUM_BUCKETS - 1;
+        }
+        // Bucket b >= 1 holds [2^(b-1), 2^b)
+        int bucket = 0;
+        while (value != 0 && bucket < NUM_BUCKETS - 1) {
+            value >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+};
+
+#ifdef RPA_INSTRUMENTATION
+#define RPA_COUNT(counter) Instrumentation::increment(Instrumentation::counter)
+#define RPA_COUNT_N(counter, n) Instrumentation::increment(Instrumentation::counter, (n))
+#define RPA_RECORD(histogram, value) Instrumentation::record(Instrumentation::histogram, (value))
+#define RPA_TIME(histogram) Instrumentation::ScopedTimer rpaScopedTimer(Instrumentation::histogram)
+#else
+#define RPA_COUNT(counter) ((void)0)
+#define RPA_COUNT_N(counter, n) ((void)0)
+#define RPA_RECORD(histogram, value) ((void)0)
+#define RPA_TIME(histogram) ((void)0)
+#endif
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,105 @@
+#include "MappedFile.h"
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_POSIX 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#define MAPPED_FILE_POSIX 0
+#endif
+
+MappedFile::MappedFile()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_mapped(false) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+#if MAPPED_FILE_POSIX
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping keeps its own reference to the file
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    m_data = static_cast<const unsigned char*>(addr);
+    m_size = static_cast<size_t>(st.st_size);
+    m_mapped = true;
+    return true;
+#else
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::streamsize size = file.tellg();
+    if (size <= 0) {
+        return false;
+    }
+    file.seekg(0);
+
+    m_buffer.resize(static_cast<size_t>(size));
+    if (!file.read(reinterpret_cast<char*>(m_buffer.data()), size)) {
+        m_buffer.clear();
+        return false;
+    }
+
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#if MAPPED_FILE_POSIX
+    if (m_mapped && m_data) {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+#endif
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
+
+bool MappedFile::statFile(const std::string& filename, uint64_t& size, int64_t& modified) {
+#if MAPPED_FILE_POSIX
+    struct stat st;
+    if (::stat(filename.c_str(), &st) != 0) {
+        return false;
+    }
+#if defined(__APPLE__)
+    const struct timespec& mtime = st.st_mtimespec;
+#else
+    const struct timespec& mtime = st.st_mtim;
+#endif
+    size = static_cast<uint64_t>(st.st_size);
+    modified = static_cast<int64_t>(mtime.tv_sec) * 1000000000 + mtime.tv_nsec;
+    return true;
+#else
+    (void)filename;
+    (void)size;
+    (void)modified;
+    return false;
+#endif
+}
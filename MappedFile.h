@@ -0,0 +1,58 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+
+/**
+ * MappedFile
+ *
+ * Read-only view of a whole file. On POSIX systems the file is mmap'd, so
+ * processes that map the same file share its physical pages through the page
+ * cache; elsewhere the file is read into a private buffer.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Map a file
+     * @param filename Path to file
+     * @return true if successful (an empty file counts as failure)
+     */
+    bool open(const std::string& filename);
+    void close();
+
+    const unsigned char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool isOpen() const { return m_data != nullptr; }
+
+    /**
+     * True if data() points at shared mapped pages rather than a private copy
+     */
+    bool isMapped() const { return m_mapped; }
+
+    /**
+     * Size and modification time of a file, without opening it
+     * @param modified Nanoseconds since the epoch
+     * @return false if the file cannot be examined, or the platform does
+     *         not report modification times
+     */
+    static bool statFile(const std::string& filename, uint64_t& size, int64_t& modified);
+
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+    bool m_mapped;
+    std::vector<unsigned char> m_buffer;  // Fallback storage when mmap is unavailable
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,305 @@
+#include "MonteCarlo.h"
+#include "FlightSimLanes.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    const double PI = 3.14159265358979323846;
+    const double TRUNCATION = 3.0;      // Sigma
+
+    /**
+     * Per-case random numbers: a SplitMix64 stream and Box-Muller normals,
+     * spelled out so draws are the same with every standard library
+     */
+    class CaseRandom {
+    public:
+        CaseRandom(uint64_t seed, uint64_t index)
+            : m_state(seed ^ (index * 0xd1b54a32d192ed03ull)) {
+            next();
+        }
+
+        // Standard normal truncated at +-TRUNCATION
+        double normal() {
+            const double u1 = (double(next() >> 11) + 1.0) * 0x1.0p-53;     // (0, 1]
+            const double u2 = double(next() >> 11) * 0x1.0p-53;             // [0, 1)
+            const double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * PI * u2);
+            return std::min(TRUNCATION, std::max(-TRUNCATION, z));
+        }
+
+    private:
+        uint64_t next() {
+            uint64_t z = (m_state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        uint64_t m_state;
+    };
+
+    uint64_t packRange(uint64_t begin, uint64_t end) {
+        return begin << 32 | end;
+    }
+
+    uint64_t rangeBegin(uint64_t range) { return range >> 32; }
+    uint64_t rangeEnd(uint64_t range) { return range & 0xffffffffu; }
+}
+
+const uint64_t MonteCarlo::MAX_CASES;
+
+MonteCarlo::Dispersions::Dispersions()
+    : throatArea(0.01)
+    , tankPressure(0.03)
+    , pressureLoss(0.10)
+    , mixtureRatio(0.02)
+    , dragCoefficient(0.05)
+    , normalForceSlope(0.05)
+    , pitchDampingCoefficient(0.10)
+    , staticMargin(0.02)
+    , wind(2.0)
+    , launchAngle(0.5 * PI / 180.0) {
+}
+
+MonteCarlo::Settings::Settings()
+    : seed(1)
+    , threads(0)
+    , schedule(Schedule::WORK_STEALING)
+    , lanes(0)
+    , simdLevel(RPATableInterpolator::detectSimdLevel()) {
+}
+
+MonteCarlo::Stats::Stats()
+    : cases(0)
+    , failedCases(0)
+    , steals(0)
+    , threads(0)
+    , seconds(0.0)
+    , laneOccupancy(0.0) {
+}
+
+MonteCarlo::MonteCarlo(const Rocket& nominal, const FlightSim::Settings& flight, const Settings& settings)
+    : m_nominal(nominal)
+    , m_flight(flight)
+    , m_settings(settings) {
+    FlightSim check(nominal, flight);
+    if (settings.lanes != 0 && settings.lanes != 4 && settings.lanes != 8 && settings.lanes != 16) {
+        throw std::invalid_argument("Monte Carlo lanes must be 0, 4, 8 or 16");
+    }
+    if (settings.lanes != 0 && flight.integrator.method != RigidBodyIntegrator::Method::RK4) {
+        throw std::invalid_argument("Monte Carlo lanes fly RK4 only");
+    }
+}
+
+void MonteCarlo::caseInputs(uint64_t index, Rocket& rocket, FlightSim::Settings& flight) const {
+    const Dispersions& d = m_settings.dispersions;
+    CaseRandom random(m_settings.seed, index);
+    // Assigning from the nominal reuses the vectors' storage
+    rocket = m_nominal;
+    flight = m_flight;
+
+    // Every draw is made whatever the rocket, so case i always sees the same numbers
+    const double throat = 1.0 + d.throatArea * random.normal();
+    const double tank = 1.0 + d.tankPressure * random.normal();
+    const double loss = 1.0 + d.pressureLoss * random.normal();
+    const double mixture = 1.0 + d.mixtureRatio * random.normal();
+    if (rocket.hasEngine()) {
+        rocket.engine.throatArea *= throat;
+        rocket.engine.tankPressure *= tank;
+        rocket.engine.pressureLoss *= loss;
+        rocket.engine.mixtureRatio *= mixture;
+    } else {
+        for (double& thrust : rocket.thrust) thrust *= throat * tank;
+    }
+    // Whichever aero model the rocket flies, constant or tabulated
+    const double drag = 1.0 + d.dragCoefficient * random.normal();
+    const double normal = 1.0 + d.normalForceSlope * random.normal();
+    rocket.dragCoefficient *= drag;
+    rocket.normalForceSlope *= normal;
+    rocket.aeroDragScale *= drag;
+    rocket.aeroNormalScale *= normal;
+    rocket.pitchDampingCoefficient *= 1.0 + d.pitchDampingCoefficient * random.normal();
+    rocket.staticMargin += d.staticMargin * random.normal();
+
+    flight.wind[0] += d.wind * random.normal();
+    flight.wind[1] += d.wind * random.normal();
+    flight.launchAngle = std::fabs(flight.launchAngle + d.launchAngle * random.normal());
+}
+
+const std::vector<MonteCarlo::CaseResult>& MonteCarlo::run(uint64_t count) {
+    if (count > MAX_CASES) {
+        throw std::invalid_argument("Monte Carlo runs are limited to MAX_CASES cases");
+    }
+    unsigned threads = m_settings.threads ? m_settings.threads : std::thread::hardware_concurrency();
+    threads = static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(std::max(threads, 1u), count)));
+
+    m_results.assign(count, CaseResult());
+    m_workers = std::vector<Worker>(threads);
+    for (unsigned w = 0; w < threads; ++w) {
+        m_workers[w].range.store(packRange(count * w / threads, count * (w + 1) / threads));
+        m_workers[w].cases = 0;
+        m_workers[w].steals = 0;
+        m_workers[w].seconds = 0.0;
+        m_workers[w].laneSteps = 0;
+        m_workers[w].occupiedLaneSteps = 0;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned w = 1; w < threads; ++w) {
+        pool.emplace_back(&MonteCarlo::work, this, w);
+    }
+    work(0);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    m_stats = Stats();
+    m_stats.cases = count;
+    m_stats.threads = threads;
+    m_stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t laneSteps = 0, occupiedLaneSteps = 0;
+    for (const Worker& worker : m_workers) {
+        laneSteps += worker.laneSteps;
+        occupiedLaneSteps += worker.occupiedLaneSteps;
+        m_stats.steals += worker.steals;
+        m_stats.threadCases.push_back(worker.cases);
+        m_stats.threadSeconds.push_back(worker.seconds);
+    }
+    for (const CaseResult& result : m_results) {
+        if (result.failed) ++m_stats.failedCases;
+    }
+    if (laneSteps) {
+        m_stats.laneOccupancy = double(occupiedLaneSteps) / laneSteps;
+    }
+    return m_results;
+}
+
+void MonteCarlo::work(size_t self) {
+    const auto start = std::chrono::steady_clock::now();
+    Worker& worker = m_workers[self];
+    switch (m_settings.lanes) {
+    case 4: workLanes<4>(self); break;
+    case 8: workLanes<8>(self); break;
+    case 16: workLanes<16>(self); break;
+    default: {
+        FlightSim sim(m_nominal, m_flight);
+        Rocket rocket = m_nominal;
+        FlightSim::Settings flight = m_flight;
+        uint64_t index = 0;
+        while (claim(self, index)) {
+            fly(sim, index, rocket, flight);
+            ++worker.cases;
+        }
+        break;
+    }
+    }
+    worker.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <size_t W>
+void MonteCarlo::workLanes(size_t self) {
+    Worker& worker = m_workers[self];
+    FlightSimLanes<W> lanes(m_flight.integrator);
+    lanes.setSimdLevel(m_settings.simdLevel);
+    lanes.run(
+        [this, self](uint64_t& index, Rocket& rocket, FlightSim::Settings& flight) {
+            if (!claim(self, index)) {
+                return false;
+            }
+            caseInputs(index, rocket, flight);
+            return true;
+        },
+        [this, &worker](uint64_t index, const FlightSim::Result* result) {
+            store(index, result);
+            ++worker.cases;
+        });
+    worker.laneSteps = lanes.getStats().steps * W;
+    worker.occupiedLaneSteps = lanes.getStats().laneSteps;
+}
+
+bool MonteCarlo::claim(size_t self, uint64_t& index) {
+    Worker& worker = m_workers[self];
+    for (;;) {
+        // Take the front of our range
+        uint64_t range = worker.range.load(std::memory_order_acquire);
+        while (rangeBegin(range) < rangeEnd(range)) {
+            if (worker.range.compare_exchange_weak(range, packRange(rangeBegin(range) + 1, rangeEnd(range)),
+                                                   std::memory_order_acq_rel, std::memory_order_acquire)) {
+                index = rangeBegin(range);
+                return true;
+            }
+        }
+        if (m_settings.schedule == Schedule::STATIC || !steal(self)) {
+            return false;
+        }
+    }
+}
+
+bool MonteCarlo::steal(size_t self) {
+    // Retry while any range has cases left. A range in flight between a
+    // victim and its thief is invisible for a moment, which at worst retires
+    // this worker slightly early; the thief still flies those cases.
+    for (;;) {
+        size_t victim = self;
+        uint64_t most = 0;
+        for (size_t w = 0; w < m_workers.size(); ++w) {
+            const uint64_t range = m_workers[w].range.load(std::memory_order_acquire);
+            const uint64_t left = rangeEnd(range) - std::min(rangeBegin(range), rangeEnd(range));
+            if (w != self && left > most) {
+                most = left;
+                victim = w;
+            }
+        }
+        if (victim == self) {
+            return false;
+        }
+
+        // Take the back half (all of a single case)
+        std::atomic<uint64_t>& target = m_workers[victim].range;
+        uint64_t range = target.load(std::memory_order_acquire);
+        while (rangeBegin(range) < rangeEnd(range)) {
+            const uint64_t middle = rangeBegin(range) + (rangeEnd(range) - rangeBegin(range)) / 2;
+            if (target.compare_exchange_weak(range, packRange(rangeBegin(range), middle),
+                                             std::memory_order_acq_rel, std::memory_order_acquire)) {
+                // Our range is empty, so no thief can change it under this store
+                m_workers[self].range.store(packRange(middle, rangeEnd(range)), std::memory_order_release);
+                ++m_workers[self].steals;
+                return true;
+            }
+        }
+    }
+}
+
+void MonteCarlo::fly(FlightSim& sim, uint64_t index, Rocket& rocket, FlightSim::Settings& flight) {
+    caseInputs(index, rocket, flight);
+    try {
+        sim.setRocket(rocket);
+        sim.setSettings(flight);
+    } catch (const std::invalid_argument&) {
+        store(index, nullptr);
+        return;
+    }
+    const FlightSim::Result result = sim.run();
+    store(index, &result);
+}
+
+void MonteCarlo::store(uint64_t index, const FlightSim::Result* result) {
+    CaseResult& out = m_results[index];
+    if (!result) {
+        out = CaseResult();
+        out.failed = true;
+        return;
+    }
+    out.apogee = result->apogee;
+    out.apogeeTime = result->apogeeTime;
+    out.maxSpeed = result->maxSpeed;
+    out.flightTime = result->flightTime;
+    out.landing[0] = result->landing[0];
+    out.landing[1] = result->landing[1];
+    out.steps = static_cast<uint32_t>(result->steps.steps);
+    out.impacted = result->impacted;
+    out.failed = false;
+}
@@ -0,0 +1,144 @@
+#ifndef MONTE_CARLO_H
+#define MONTE_CARLO_H
+
+#include "FlightSim.h"
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * MonteCarlo
+ *
+ * Flies dispersed copies of a nominal rocket on every core. Case i draws its
+ * dispersions from a generator seeded by (seed, i) alone and flies from a
+ * fresh start, so its result does not depend on the thread count or on which
+ * worker flies it.
+ *
+ * Cases are dealt out in contiguous ranges, one per worker. A worker takes
+ * cases from the front of its own range and, once that is empty, steals the
+ * back half of the largest range left, so workers that drew short flights
+ * (early impact) help those with long ones. Each range is one atomic word
+ * changed only by compare-and-swap: claiming and stealing never lock. Each
+ * worker keeps one FlightSim for all its cases; engine tables are shared.
+ *
+ * With Settings::lanes set, each worker flies its cases on a FlightSimLanes
+ * instead, claiming a case whenever a lane comes free. Results are the same
+ * as with one FlightSim per worker, RK4 being the only method lanes fly.
+ */
+class MonteCarlo {
+public:
+    enum class Schedule {
+        WORK_STEALING,
+        STATIC              // Fixed equal ranges, no stealing (for comparison)
+    };
+
+    // One standard deviation of each dispersion, relative to the nominal
+    // value unless a unit is given. Draws are truncated at 3 sigma.
+    struct Dispersions {
+        double throatArea;          // Scales the thrust curve if there is no engine
+        double tankPressure;        // Likewise
+        double pressureLoss;
+        double mixtureRatio;
+        double dragCoefficient;     // These two also scale a rocket's aero tables
+        double normalForceSlope;
+        double pitchDampingCoefficient;
+        double staticMargin;        // m
+        double wind;                // Each horizontal component, m/s
+        double launchAngle;         // rad
+
+        Dispersions();
+    };
+
+    struct Settings {
+        Dispersions dispersions;
+        uint64_t seed;
+        unsigned threads;           // 0 = one per hardware thread
+        Schedule schedule;
+        unsigned lanes;             // 0 = FlightSim; 4, 8 or 16 = FlightSimLanes of that width
+        RPATableInterpolator::SimdLevel simdLevel;  // Of the lanes' vector passes; defaults to the detected level
+
+        Settings();
+    };
+
+    struct CaseResult {
+        double apogee;              // m
+        double apogeeTime;          // s
+        double maxSpeed;            // m/s
+        double flightTime;          // s
+        double landing[2];          // Horizontal position at the end, m
+        uint32_t steps;
+        bool impacted;
+        bool failed;                // Dispersed inputs rejected by FlightSim
+    };
+
+    struct Stats {
+        uint64_t cases;
+        uint64_t failedCases;
+        uint64_t steals;            // Ranges taken from another worker
+        unsigned threads;
+        double seconds;             // Wall time of run()
+        std::vector<uint64_t> threadCases;
+        std::vector<double> threadSeconds;  // Until each worker ran out of cases
+        double laneOccupancy;       // With lanes, share of lane steps that advanced a case
+
+        Stats();
+    };
+
+    // Case indices share a 64-bit word with the end of their range
+    static const uint64_t MAX_CASES = 0xffffffffu;
+
+    /**
+     * @throws std::invalid_argument if the nominal rocket or flight settings
+     *         are rejected by FlightSim, or lanes are set to another width or
+     *         with a method other than RK4
+     */
+    MonteCarlo(const Rocket& nominal, const FlightSim::Settings& flight, const Settings& settings = Settings());
+
+    /**
+     * Fly cases 0 to count - 1
+     * @return Each case's result, by index
+     * @throws std::invalid_argument if count exceeds MAX_CASES
+     */
+    const std::vector<CaseResult>& run(uint64_t count);
+
+    /**
+     * Inputs of one case, e.g. to replay it with a FlightRecorder
+     */
+    void caseInputs(uint64_t index, Rocket& rocket, FlightSim::Settings& flight) const;
+
+    const std::vector<CaseResult>& getResults() const { return m_results; }
+    const Stats& getStats() const { return m_stats; }
+    const Settings& getSettings() const { return m_settings; }
+
+private:
+    // A worker's remaining cases, packed as begin << 32 | end
+    struct alignas(64) Worker {
+        std::atomic<uint64_t> range;
+        uint64_t cases;
+        uint64_t steals;
+        double seconds;
+        uint64_t laneSteps;         // Steps of every lane, with a case or not
+        uint64_t occupiedLaneSteps;
+    };
+
+    void work(size_t self);
+    template <size_t W> void workLanes(size_t self);
+
+    /**
+     * Claim the next case from our range, stealing once it is empty
+     * @return false when no case is left (or, with STATIC, our range is empty)
+     */
+    bool claim(size_t self, uint64_t& index);
+    bool steal(size_t self);
+    void fly(FlightSim& sim, uint64_t index, Rocket& rocket, FlightSim::Settings& flight);
+    void store(uint64_t index, const FlightSim::Result* result);
+
+    Rocket m_nominal;
+    FlightSim::Settings m_flight;
+    Settings m_settings;
+    std::vector<CaseResult> m_results;
+    std::vector<Worker> m_workers;
+    Stats m_stats;
+};
+
+#endif // MONTE_CARLO_H
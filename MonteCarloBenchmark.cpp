@@ -0,0 +1,308 @@
+/**
+ * MonteCarloBenchmark.cpp
+ *
+ * Scaling benchmark for MonteCarlo: flies the same dispersed cases at each
+ * thread count, with work stealing and with static partitioning, and reports
+ * wall time, cases per second, speedup and efficiency against one thread,
+ * the share of worker time left idle at the end of the run, and steals.
+ * Every run is checked to give bit-identical results to the first.
+ *
+ * Then, on one thread with RK4, it compares one FlightSim against
+ * FlightSimLanes of 4, 8 and 16 lanes at each SIMD level the CPU supports:
+ * cases per second, speedup, the share of lane steps that carried a case,
+ * and whether the results are bit-identical to FlightSim's.
+ *
+ * The rocket is the default Rocket with a PressureFedEngine on a shared
+ * performance table: --table (CSV or compiled, through
+ * PerformanceTableRegistry), or otherwise a synthetic table written to the
+ * temp directory. With --aero its drag and normal force come from a RASAero
+ * CSV export (see RasData).
+ *
+ * Usage:
+ *   monte_carlo_benchmark [--cases N] [--threads 1,2,4,...] [--method rk4|rk45]
+ *                         [--lanes 0|4|8|16] [--table file] [--aero file] [--seed N]
+ *
+ * --lanes flies the thread scaling runs on lanes (with --method rk4).
+ */
+
+#include "MonteCarlo.h"
+#include "PerformanceTableRegistry.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    struct Options {
+        uint64_t cases = 2000;
+        std::vector<unsigned> threads;
+        RigidBodyIntegrator::Method method = RigidBodyIntegrator::Method::RK45;
+        unsigned lanes = 0;
+        std::string table;
+        std::string aero;
+        uint64_t seed = 1;
+    };
+
+    void usage(const char* program) {
+        std::cerr << "Usage: " << program << " [--cases N] [--threads 1,2,4,...] [--method rk4|rk45]\n"
+                  << "       [--lanes 0|4|8|16] [--table file] [--aero file] [--seed N]" << std::endl;
+    }
+
+    bool parseThreads(const std::string& value, std::vector<unsigned>& threads) {
+        std::stringstream list(value);
+        std::string item;
+        while (std::getline(list, item, ',')) {
+            const int n = std::atoi(item.c_str());
+            if (n < 1) return false;
+            threads.push_back(static_cast<unsigned>(n));
+        }
+        return !threads.empty();
+    }
+
+    bool parseArgs(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            if (arg == "--cases") options.cases = std::strtoull(value.c_str(), nullptr, 10);
+            else if (arg == "--threads") {
+                if (!parseThreads(value, options.threads)) return false;
+            }
+            else if (arg == "--method") {
+                if (value == "rk4") options.method = RigidBodyIntegrator::Method::RK4;
+                else if (value == "rk45") options.method = RigidBodyIntegrator::Method::RK45;
+                else return false;
+            }
+            else if (arg == "--lanes") options.lanes = static_cast<unsigned>(std::atoi(value.c_str()));
+            else if (arg == "--table") options.table = value;
+            else if (arg == "--aero") options.aero = value;
+            else if (arg == "--seed") options.seed = std::strtoull(value.c_str(), nullptr, 10);
+            else return false;
+        }
+        return options.cases > 0;
+    }
+
+    /**
+     * Smooth stand-in for an RPA table over the engine's operating range
+     * (the closed-form model of RPABenchmark)
+     */
+    bool writeSyntheticTable(const std::string& filename) {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            return false;
+        }
+        const double areaRatio = 10.0;
+        file << "Pc_psi,OF,Pa_psi,Cf,Cstar_ms,Isp_s,Ve_ms,Pe_psi,Gamma\n";
+        file << std::setprecision(std::numeric_limits<double>::max_digits10);
+        for (int i = 0; i < 19; ++i) {
+            const double Pc = 50.0 + 25.0 * i;
+            for (int j = 0; j < 11; ++j) {
+                const double OF = 1.5 + 0.2 * j;
+                for (int k = 0; k < 8; ++k) {
+                    const double Pa = 14.7 * k / 7.0;
+                    const double Tc = 3450.0 * std::exp(-0.35 * (OF - 2.6) * (OF - 2.6));
+                    const double M = 18.0 + 3.0 * OF;
+                    const double g = 1.25 - 0.04 * (OF - 1.0) + 0.002 * std::log(Pc);
+                    const double Gamma = std::sqrt(g) * std::pow(2.0 / (g + 1.0), (g + 1.0) / (2.0 * (g - 1.0)));
+                    const double PeRatio = 0.012 * (1.0 + 0.5 * (g - 1.25));
+                    const double Cstar = std::sqrt(8314.462618 / M * Tc) / Gamma;
+                    const double Ve = Cstar * (1.62 + 0.03 * std::log(Pc / 100.0));
+                    const double Cf = Ve / Cstar + (PeRatio - Pa / Pc) * areaRatio;
+                    file << Pc << "," << OF << "," << Pa << "," << Cf << "," << Cstar << ","
+                         << Cf * Cstar / 9.80665 << "," << Ve << "," << PeRatio * Pc << "," << g << "\n";
+                }
+            }
+        }
+        return static_cast<bool>(file);
+    }
+
+    std::string tempPath(const std::string& name) {
+        const char* dir = std::getenv("TMPDIR");
+        return std::string(dir && *dir ? dir : "/tmp") + "/" + name;
+    }
+
+    bool sameResults(const std::vector<MonteCarlo::CaseResult>& a, const std::vector<MonteCarlo::CaseResult>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].apogee != b[i].apogee || a[i].apogeeTime != b[i].apogeeTime ||
+                a[i].maxSpeed != b[i].maxSpeed || a[i].flightTime != b[i].flightTime ||
+                a[i].landing[0] != b[i].landing[0] || a[i].landing[1] != b[i].landing[1] ||
+                a[i].steps != b[i].steps || a[i].impacted != b[i].impacted || a[i].failed != b[i].failed) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const char* simdName(RPATableInterpolator::SimdLevel level) {
+        switch (level) {
+        case RPATableInterpolator::SimdLevel::AVX512: return "avx512";
+        case RPATableInterpolator::SimdLevel::AVX2: return "avx2";
+        default: return "scalar";
+        }
+    }
+
+    /**
+     * One FlightSim, then lanes at each width and SIMD level, on one thread
+     */
+    void compareLanes(const Rocket& rocket, FlightSim::Settings flight, MonteCarlo::Settings settings,
+                      uint64_t cases) {
+        flight.integrator.method = RigidBodyIntegrator::Method::RK4;
+        settings.threads = 1;
+        settings.schedule = MonteCarlo::Schedule::WORK_STEALING;
+
+        std::cout << "\nLanes: " << cases << " cases, RK4, 1 thread" << std::endl;
+        std::cout << "lanes  simd       time (s)   cases/s  speedup  occupancy  identical" << std::endl;
+        std::vector<MonteCarlo::CaseResult> reference;
+        double baseline = 0.0;
+        const int levels = static_cast<int>(RPATableInterpolator::detectSimdLevel());
+        for (int level = -1; level <= levels; ++level) {
+            for (unsigned lanes : { 4u, 8u, 16u }) {
+                // First pass: one FlightSim
+                settings.lanes = level < 0 ? 0 : lanes;
+                settings.simdLevel = static_cast<RPATableInterpolator::SimdLevel>(std::max(level, 0));
+                MonteCarlo monteCarlo(rocket, flight, settings);
+                const std::vector<MonteCarlo::CaseResult>& results = monteCarlo.run(cases);
+                const MonteCarlo::Stats& stats = monteCarlo.getStats();
+                if (reference.empty()) {
+                    reference = results;
+                    baseline = stats.seconds;
+                }
+                std::cout << std::setw(5) << (level < 0 ? 1 : lanes) << "  " << std::left << std::setw(8)
+                          << (level < 0 ? "-" : simdName(settings.simdLevel)) << std::right
+                          << std::fixed << std::setprecision(3) << std::setw(11) << stats.seconds
+                          << std::setprecision(0) << std::setw(10) << cases / stats.seconds
+                          << std::setprecision(2) << std::setw(9) << baseline / stats.seconds
+                          << std::setprecision(0) << std::setw(10)
+                          << 100.0 * (level < 0 ? 1.0 : stats.laneOccupancy) << "%"
+                          << std::setw(11) << (sameResults(results, reference) ? "yes" : "NO")
+                          << std::defaultfloat << std::endl;
+                if (level < 0) break;
+            }
+        }
+    }
+
+    void printSummary(const std::vector<MonteCarlo::CaseResult>& results) {
+        double sum = 0.0, sumSquares = 0.0, lo = 0.0, hi = 0.0;
+        double steps = 0.0, shortest = 0.0, longest = 0.0;
+        size_t flown = 0;
+        for (const MonteCarlo::CaseResult& r : results) {
+            if (r.failed) continue;
+            lo = flown ? std::min(lo, r.apogee) : r.apogee;
+            hi = flown ? std::max(hi, r.apogee) : r.apogee;
+            shortest = flown ? std::min(shortest, r.flightTime) : r.flightTime;
+            longest = flown ? std::max(longest, r.flightTime) : r.flightTime;
+            sum += r.apogee;
+            sumSquares += r.apogee * r.apogee;
+            steps += r.steps;
+            ++flown;
+        }
+        if (flown == 0) return;
+        const double mean = sum / flown;
+        std::cout << std::fixed << std::setprecision(1)
+                  << "Apogee " << mean << " m +- " << std::sqrt(std::max(0.0, sumSquares / flown - mean * mean))
+                  << " (" << lo << " to " << hi << "), flight time " << shortest << " to " << longest
+                  << " s, " << std::setprecision(0) << steps / flown << " steps per case, "
+                  << results.size() - flown << " failed" << std::defaultfloat << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        usage(argv[0]);
+        return 1;
+    }
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    if (options.threads.empty()) {
+        for (unsigned n = 1; n < hardware; n *= 2) options.threads.push_back(n);
+        options.threads.push_back(hardware);
+    }
+
+    std::shared_ptr<const RPATableInterpolator> table;
+    std::string syntheticFile;
+    if (options.table.empty()) {
+        syntheticFile = tempPath("monte_carlo_benchmark.csv");
+        if (!writeSyntheticTable(syntheticFile)) {
+            std::cerr << "Error: Failed to write " << syntheticFile << std::endl;
+            return 1;
+        }
+        options.table = syntheticFile;
+    }
+    table = PerformanceTableRegistry::instance().acquire(options.table);
+    if (!syntheticFile.empty()) std::remove(syntheticFile.c_str());
+    if (!table) {
+        std::cerr << "Error: Failed to load " << options.table << std::endl;
+        return 1;
+    }
+
+    try {
+        Rocket rocket;
+        rocket.engine.table = table;
+        if (!options.aero.empty()) {
+            RasData ras;
+            if (!ras.load(options.aero)) {
+                std::cerr << "Error: Failed to load " << options.aero << std::endl;
+                return 1;
+            }
+            rocket.setAerodynamics(ras);
+        }
+        FlightSim::Settings flight;
+        flight.integrator.method = options.method;
+        MonteCarlo::Settings settings;
+        settings.seed = options.seed;
+        settings.lanes = options.lanes;
+
+        std::cout << options.cases << " cases, " << RigidBodyIntegrator::methodName(options.method) << ", "
+                  << hardware << " hardware threads";
+        if (options.lanes) std::cout << ", " << options.lanes << " lanes";
+        std::cout << std::endl;
+        std::cout << "threads  schedule     time (s)   cases/s  speedup  efficiency  idle  steals  identical" << std::endl;
+
+        std::vector<MonteCarlo::CaseResult> reference;
+        double baseline = 0.0;
+        for (unsigned threads : options.threads) {
+            for (MonteCarlo::Schedule schedule : { MonteCarlo::Schedule::WORK_STEALING, MonteCarlo::Schedule::STATIC }) {
+                if (threads == 1 && schedule == MonteCarlo::Schedule::STATIC) continue;
+                settings.threads = threads;
+                settings.schedule = schedule;
+                MonteCarlo monteCarlo(rocket, flight, settings);
+                const std::vector<MonteCarlo::CaseResult>& results = monteCarlo.run(options.cases);
+                const MonteCarlo::Stats& stats = monteCarlo.getStats();
+
+                if (reference.empty()) {
+                    reference = results;
+                    baseline = stats.seconds;
+                }
+                double busy = 0.0;
+                for (double seconds : stats.threadSeconds) busy += seconds;
+                const double speedup = baseline / stats.seconds;
+                std::cout << std::setw(7) << stats.threads << "  " << std::left << std::setw(11)
+                          << (schedule == MonteCarlo::Schedule::STATIC ? "static" : "stealing") << std::right
+                          << std::fixed << std::setprecision(3) << std::setw(10) << stats.seconds
+                          << std::setprecision(0) << std::setw(10) << options.cases / stats.seconds
+                          << std::setprecision(2) << std::setw(9) << speedup
+                          << std::setprecision(0) << std::setw(11) << 100.0 * speedup / stats.threads << "%"
+                          << std::setw(5) << 100.0 * (1.0 - busy / (stats.threads * stats.seconds)) << "%"
+                          << std::setw(8) << stats.steals
+                          << std::setw(11) << (sameResults(results, reference) ? "yes" : "NO")
+                          << std::defaultfloat << std::endl;
+            }
+        }
+        printSummary(reference);
+
+        settings.lanes = 0;
+        compareLanes(rocket, flight, settings, options.cases);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
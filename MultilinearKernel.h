@@ -0,0 +1,121 @@
+#ifndef MULTILINEAR_KERNEL_H
+#define MULTILINEAR_KERNEL_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/**
+ * MultilinearKernel
+ *
+ * Corner gather and multilinear blend for an N-dimensional grid cell, fully
+ * unrolled at compile time (no loops or branches on N or the corner index).
+ *
+ * Corner k of a cell is the upper breakpoint along axis a when bit (N-1-a)
+ * of k is set, so axis 0 is the most significant bit; in 3D the order is
+ * c000, c001, c010, ..., c111. The blend interpolates along axis 0 first,
+ * pairing corner i with corner i + 2^(N-1), then along axis 1, and so on.
+ * For N = 3 this is exactly the operation order of the original trilinear
+ * code, so results are bit-identical to it.
+ */
+template <size_t N>
+struct MultilinearKernel {
+    static_assert(N >= 1, "MultilinearKernel needs at least one axis");
+
+    static const size_t CORNERS = size_t(1) << N;
+
+    /**
+     * Read the 2^N corner values of a cell, widened to double
+     * @param base Lowest corner of the cell
+     * @param delta Offset to the upper corner along each axis (0 when clamped)
+     * @param out Output: corner values in the order described above
+     */
+    template <typename T>
+    static void gatherCorners(const T* base, const size_t delta[N], double out[CORNERS]) {
+        gather(base, delta, out, std::make_index_sequence<CORNERS>());
+    }
+
+    /**
+     * Multilinear interpolation of corner values
+     * @param c Corner values; overwritten with intermediate results
+     * @param t Interpolation factor [0,1] along each axis
+     */
+    static double blend(double c[CORNERS], const double t[N]) {
+        return blendFrom(c, t, Axis<0>());
+    }
+
+    /**
+     * Multilinear interpolation with derivatives by each interpolation factor
+     * The value is bit-identical to blend().
+     * @param c Corner values; overwritten with intermediate results
+     * @param dt Output: partial derivative by t[a] for each axis
+     */
+    static double gradient(double c[CORNERS], const double t[N], double dt[N]) {
+        gradientFrom(c, t, dt, Axis<0>());
+        return c[0];
+    }
+
+private:
+    template <size_t A>
+    using Axis = std::integral_constant<size_t, A>;
+
+    // Offset of corner K from the lowest corner
+    template <size_t K, size_t A>
+    static size_t cornerOffset(const size_t* delta, Axis<A>) {
+        return (((K >> (N - 1 - A)) & 1) ? delta[A] : 0) + cornerOffset<K>(delta, Axis<A + 1>());
+    }
+
+    template <size_t K>
+    static size_t cornerOffset(const size_t*, Axis<N>) {
+        return 0;
+    }
+
+    template <typename T, size_t... K>
+    static void gather(const T* base, const size_t* delta, double* out, std::index_sequence<K...>) {
+        const int unused[] = { (out[K] = base[cornerOffset<K>(delta, Axis<0>())], 0)... };
+        (void)unused;
+    }
+
+    // c[i] = lerp(c[i], c[i + half], t) for every i < half
+    template <size_t... I>
+    static void lerpPairs(double* c, double t, std::index_sequence<I...>) {
+        const size_t half = sizeof...(I);
+        const int unused[] = { (c[I] = c[I] * (1.0 - t) + c[I + half] * t, 0)... };
+        (void)unused;
+    }
+
+    // d[i] = c[i + half] - c[i] for every i < half
+    template <size_t... I>
+    static void differencePairs(const double* c, double* d, std::index_sequence<I...>) {
+        const size_t half = sizeof...(I);
+        const int unused[] = { (d[I] = c[I + half] - c[I], 0)... };
+        (void)unused;
+    }
+
+    // Blend axes A..N-1 of a 2^(N-A) value array
+    template <size_t A>
+    static double blendFrom(double* c, const double* t, Axis<A>) {
+        lerpPairs(c, t[A], std::make_index_sequence<(size_t(1) << (N - A - 1))>());
+        return blendFrom(c, t, Axis<A + 1>());
+    }
+
+    static double blendFrom(double* c, const double*, Axis<N>) {
+        return c[0];
+    }
+
+    // The derivative along axis A differences the corners along A after the
+    // axes before it are blended, then blends the axes after it
+    template <size_t A>
+    static void gradientFrom(double* c, const double* t, double* dt, Axis<A>) {
+        double d[size_t(1) << (N - A - 1)];
+        differencePairs(c, d, std::make_index_sequence<(size_t(1) << (N - A - 1))>());
+        dt[A] = blendFrom(d, t, Axis<A + 1>());
+        lerpPairs(c, t[A], std::make_index_sequence<(size_t(1) << (N - A - 1))>());
+        gradientFrom(c, t, dt, Axis<A + 1>());
+    }
+
+    static void gradientFrom(double*, const double*, double*, Axis<N>) {
+    }
+};
+
+#endif // MULTILINEAR_KERNEL_H
@@ -0,0 +1,144 @@
+#include "PerformanceTableRegistry.h"
+#include "MappedFile.h"
+#include <set>
+#include <iterator>
+
+PerformanceTableRegistry& PerformanceTableRegistry::instance() {
+    static PerformanceTableRegistry registry;
+    return registry;
+}
+
+PerformanceTableRegistry::TablePtr PerformanceTableRegistry::acquire(const std::string& filename,
+                                                                    RPATableInterpolator::StoragePrecision precision) {
+    Format format = FORMAT_CSV;
+    uint64_t hash = 0;
+    if (!identify(filename, hash, format)) {
+        return nullptr;
+    }
+    const Key key(filename, hash, precision);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Entry& entry = m_entries[key];
+
+    if (TablePtr table = entry.table.lock()) {
+        return table;
+    }
+
+    if (entry.pending.valid()) {
+        // Someone else is loading this table; wait for their result
+        std::shared_future<TablePtr> pending = entry.pending;
+        lock.unlock();
+        return pending.get();
+    }
+
+    std::promise<TablePtr> promise;
+    entry.pending = promise.get_future().share();
+    lock.unlock();
+
+    // Load outside the lock so other tables can be acquired meanwhile. If the
+    // load throws, waiters get the exception and the next acquire retries.
+    TablePtr table;
+    try {
+        table = loadTable(filename, format, precision);
+    } catch (...) {
+        lock.lock();
+        m_entries.erase(key);
+        lock.unlock();
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    lock.lock();
+    if (table) {
+        Entry& loaded = m_entries[key];
+        loaded.table = table;
+        loaded.pending = std::shared_future<TablePtr>();
+    } else {
+        m_entries.erase(key);
+    }
+    lock.unlock();
+
+    promise.set_value(table);
+    return table;
+}
+
+bool PerformanceTableRegistry::identify(const std::string& filename, uint64_t& hash, Format& format) {
+    uint64_t size = 0;
+    int64_t modified = 0;
+    const bool stamped = MappedFile::statFile(filename, size, modified);
+    if (stamped) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_stamps.find(filename);
+        if (it != m_stamps.end() && it->second.size == size && it->second.modified == modified) {
+            hash = it->second.hash;
+            format = it->second.format;
+            return true;
+        }
+    }
+
+    // Hash the current file contents so a regenerated table is a new key. A
+    // tiled table's header already covers its contents, so only that is read.
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    if (TiledGrid::fingerprint(file.data(), file.size(), hash)) {
+        format = FORMAT_TILED;
+    } else {
+        format = RPATableInterpolator::isCompiledFile(file.data(), file.size()) ? FORMAT_COMPILED : FORMAT_CSV;
+        hash = RPATableInterpolator::contentHash(file.data(), file.size());
+    }
+
+    if (stamped) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        FileStamp& stamp = m_stamps[filename];
+        stamp.size = size;
+        stamp.modified = modified;
+        stamp.hash = hash;
+        stamp.format = format;
+    }
+    return true;
+}
+
+PerformanceTableRegistry::TablePtr PerformanceTableRegistry::loadTable(const std::string& filename,
+                                                                       Format format,
+                                                                       RPATableInterpolator::StoragePrecision precision) {
+    std::shared_ptr<RPATableInterpolator> table = std::make_shared<RPATableInterpolator>();
+    table->setStoragePrecision(precision);
+    bool ok = false;
+    switch (format) {
+    case FORMAT_COMPILED: ok = table->loadCompiledTable(filename); break;
+    case FORMAT_TILED: ok = table->loadTiledTable(filename); break;
+    default: ok = table->loadTable(filename); break;
+    }
+    return ok ? table : nullptr;
+}
+
+size_t PerformanceTableRegistry::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t alive = 0;
+    for (const auto& entry : m_entries) {
+        if (!entry.second.table.expired()) {
+            ++alive;
+        }
+    }
+    return alive;
+}
+
+void PerformanceTableRegistry::purge() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.table.expired() && !it->second.pending.valid()) {
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    std::set<std::string> paths;
+    for (const auto& entry : m_entries) {
+        paths.insert(std::get<0>(entry.first));
+    }
+    for (auto it = m_stamps.begin(); it != m_stamps.end();) {
+        it = paths.count(it->first) ? std::next(it) : m_stamps.erase(it);
+    }
+}
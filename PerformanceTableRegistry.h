@@ -0,0 +1,109 @@
+#ifndef PERFORMANCE_TABLE_REGISTRY_H
+#define PERFORMANCE_TABLE_REGISTRY_H
+
+#include "RPATableInterpolator.h"
+#include <memory>
+#include <mutex>
+#include <future>
+#include <map>
+#include <string>
+#include <tuple>
+#include <cstdint>
+
+/**
+ * PerformanceTableRegistry
+ *
+ * Process-wide cache of loaded performance tables, so N calculators (or N
+ * Monte Carlo worker threads) using the same table share one immutable copy
+ * and pay for one parse.
+ *
+ * Tables are keyed by file path and a hash of the file contents, so editing or
+ * regenerating a table file on disk yields a fresh load. The contents are
+ * hashed again only when the file's size or modification time differs from
+ * the last acquire() of that path, so a cache hit costs a stat, not a read of
+ * the file. The registry only holds weak references: a table is freed when the last calculator using it
+ * goes away. Concurrent first requests for the same table wait on a single
+ * load instead of each parsing the file.
+ *
+ * The registry itself is locked only inside acquire(); queries on the returned
+ * tables are const and lock-free.
+ */
+class PerformanceTableRegistry {
+public:
+    typedef std::shared_ptr<const RPATableInterpolator> TablePtr;
+
+    /**
+     * The process-wide registry
+     */
+    static PerformanceTableRegistry& instance();
+
+    /**
+     * Get the shared table for a file, loading it on first use
+     * CSV, compiled (RPATableInterpolator::compileTable) and tiled
+     * (saveTiledTable) tables are accepted; the format is detected from the
+     * file contents. Tiled tables get the default brick cache and ignore
+     * the storage precision.
+     * @param filename Path to table file
+     * @param precision Grid storage precision; each precision of a file is
+     *                  a separate shared table
+     * @return Shared immutable table, or nullptr if the file cannot be loaded
+     */
+    TablePtr acquire(const std::string& filename,
+                     RPATableInterpolator::StoragePrecision precision =
+                         RPATableInterpolator::StoragePrecision::Double);
+
+    /**
+     * Number of tables currently alive in the registry
+     */
+    size_t size() const;
+
+    /**
+     * Drop registry entries whose tables have been released, and the file
+     * stamps of paths with no entry left
+     */
+    void purge();
+
+private:
+    PerformanceTableRegistry() {}
+    PerformanceTableRegistry(const PerformanceTableRegistry&) = delete;
+    PerformanceTableRegistry& operator=(const PerformanceTableRegistry&) = delete;
+
+    // (path, content hash, storage precision)
+    typedef std::tuple<std::string, uint64_t, RPATableInterpolator::StoragePrecision> Key;
+
+    struct Entry {
+        std::weak_ptr<const RPATableInterpolator> table;
+        std::shared_future<TablePtr> pending;  // Valid while a load is in flight
+    };
+
+    enum Format {
+        FORMAT_CSV,
+        FORMAT_COMPILED,
+        FORMAT_TILED
+    };
+
+    // A file's content hash and format, with the size and modification time
+    // it had when it was hashed
+    struct FileStamp {
+        uint64_t size;
+        int64_t modified;
+        uint64_t hash;
+        Format format;
+    };
+
+    /**
+     * Content hash and format of a file, reusing the last hash of the path
+     * while its size and modification time are unchanged
+     * @return false if the file cannot be read
+     */
+    bool identify(const std::string& filename, uint64_t& hash, Format& format);
+
+    static TablePtr loadTable(const std::string& filename, Format format,
+                              RPATableInterpolator::StoragePrecision precision);
+
+    mutable std::mutex m_mutex;
+    std::map<Key, Entry> m_entries;
+    std::map<std::string, FileStamp> m_stamps;
+};
+
+#endif // PERFORMANCE_TABLE_REGISTRY_H
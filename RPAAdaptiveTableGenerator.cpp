@@ -0,0 +1,187 @@
+/**
+ * RPAAdaptiveTableGenerator.cpp
+ *
+ * Generates a non-uniform performance table refined until interpolation
+ * error everywhere is within a tolerance (see AdaptiveTableGenerator).
+ *
+ * Oracles:
+ *   equilibrium  Native equilibrium/nozzle solver over thermo.inp (default)
+ *   analytic     Closed-form ideal rocket with frozen gamma; needs no data
+ *                files, for testing the refinement itself
+ *
+ * Usage:
+ *   rpa_adaptive_table_generator [--oracle equilibrium|analytic]
+ *       [--pc min,max,points] [--of min,max,points] [--pa min,max,points]
+ *       [--tolerance 1e-3] [--mode trilinear|tricubic] [--max-points N]
+ *       [--oxidizer N2O4(L)] [--fuel UDMH] [--expansion-ratio 10]
+ *       [--thermo RPA/2.3/standard/resources/thermo.inp]
+ *       [--output rpa_adaptive_tables.csv]
+ */
+
+#include "AdaptiveTableGenerator.h"
+#include "RocketPerformance.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <memory>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+    const double PSI_TO_BAR = 0.0689475729;
+
+    /**
+     * Equilibrium solver at fixed area ratio. Pa only enters the pressure
+     * thrust, so one solve per (Pc, O/F) serves every Pa; successive solves
+     * warm-start from the previous one.
+     */
+    class EquilibriumOracle : public AdaptiveTableGenerator::Oracle {
+    public:
+        EquilibriumOracle(const EquilibriumSolver& solver, double areaRatio)
+            : m_solver(solver), m_performance(solver), m_areaRatio(areaRatio) {}
+
+        bool sample(double Pc, double OF, double Pa, RPATableInterpolator::PerformanceData& out) override {
+            auto key = std::make_pair(Pc, OF);
+            auto it = m_results.find(key);
+            if (it == m_results.end()) {
+                EquilibriumSolver::Reactants reactants =
+                    m_solver.makeReactants({ OF / (1.0 + OF), 1.0 / (1.0 + OF) });
+                RocketPerformance::Result result;
+                if (!m_performance.solve(reactants, Pc * PSI_TO_BAR, m_areaRatio, m_warm, result)) {
+                    m_warm = RocketPerformance::WarmStart();
+                    return false;
+                }
+                it = m_results.insert(std::make_pair(key, result)).first;
+            }
+
+            const RocketPerformance::Result& r = it->second;
+            const double Pa_bar = Pa * PSI_TO_BAR;
+            out.Cf = r.thrustCoefficient(Pa_bar);
+            out.Cstar = r.Cstar;
+            out.Isp = r.specificImpulse(Pa_bar);
+            out.Ve = r.Ve;
+            out.Pe = r.Pe / PSI_TO_BAR;
+            out.gamma = r.gamma;
+            return true;
+        }
+
+    private:
+        const EquilibriumSolver& m_solver;
+        RocketPerformance m_performance;
+        double m_areaRatio;
+        RocketPerformance::WarmStart m_warm;
+        std::map<std::pair<double, double>, RocketPerformance::Result> m_results;
+    };
+
+    bool parseAxis(const std::string& text, AdaptiveTableGenerator::Axis& axis) {
+        std::istringstream ss(text);
+        char c1, c2;
+        return (ss >> axis.min >> c1 >> axis.max >> c2 >> axis.initialPoints) &&
+               c1 == ',' && c2 == ',' && axis.initialPoints > 0;
+    }
+
+    void usage(const char* program) {
+        std::cerr << "Usage: " << program << " [--oracle equilibrium|analytic]\n"
+                  << "       [--pc min,max,points] [--of min,max,points] [--pa min,max,points]\n"
+                  << "       [--tolerance rel] [--mode trilinear|tricubic] [--max-points N]\n"
+                  << "       [--oxidizer NAME] [--fuel NAME] [--expansion-ratio AeAt]\n"
+                  << "       [--thermo thermo.inp] [--output table.csv]" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    AdaptiveTableGenerator::Settings settings;
+    std::string oracleName = "equilibrium";
+    std::string oxidizer = "N2O4(L)", fuel = "UDMH";
+    std::string thermo = "RPA/2.3/standard/resources/thermo.inp";
+    std::string output = "rpa_adaptive_tables.csv";
+    double areaRatio = 10.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        bool ok = true;
+        if (arg == "--oracle") oracleName = value;
+        else if (arg == "--pc") ok = parseAxis(value, settings.Pc);
+        else if (arg == "--of") ok = parseAxis(value, settings.OF);
+        else if (arg == "--pa") ok = parseAxis(value, settings.Pa);
+        else if (arg == "--tolerance") settings.tolerance = std::atof(value.c_str());
+        else if (arg == "--max-points") settings.maxPoints = std::strtoul(value.c_str(), nullptr, 10);
+        else if (arg == "--oxidizer") oxidizer = value;
+        else if (arg == "--fuel") fuel = value;
+        else if (arg == "--expansion-ratio") areaRatio = std::atof(value.c_str());
+        else if (arg == "--thermo") thermo = value;
+        else if (arg == "--output") output = value;
+        else if (arg == "--mode") {
+            if (value == "trilinear") settings.mode = RPATableInterpolator::InterpolationMode::Trilinear;
+            else if (value == "tricubic") settings.mode = RPATableInterpolator::InterpolationMode::MonotoneTricubic;
+            else ok = false;
+        }
+        else ok = false;
+        if (!ok || !(settings.tolerance > 0.0) || !(areaRatio > 1.0)) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    ThermoDatabase db;
+    std::unique_ptr<EquilibriumSolver> solver;
+    std::unique_ptr<AdaptiveTableGenerator::Oracle> oracle;
+    if (oracleName == "analytic") {
+        oracle.reset(new AnalyticOracle(areaRatio));
+    } else if (oracleName == "equilibrium") {
+        if (!db.load(thermo)) {
+            std::cerr << "Error: Failed to load thermo database " << thermo << std::endl;
+            return 1;
+        }
+        try {
+            solver.reset(new EquilibriumSolver(db, { oxidizer, fuel }));
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        oracle.reset(new EquilibriumOracle(*solver, areaRatio));
+    } else {
+        usage(argv[0]);
+        return 1;
+    }
+
+    AdaptiveTableGenerator generator(settings);
+    if (!generator.generate(*oracle)) {
+        std::cerr << "Error: " << generator.getError() << std::endl;
+        return 1;
+    }
+    if (!generator.writeCsv(output)) {
+        std::cerr << "Error: Failed to write " << output << std::endl;
+        return 1;
+    }
+
+    const AdaptiveTableGenerator::Report& report = generator.getReport();
+    static const char* fields[RPATableInterpolator::NUM_FIELDS] = { "Cf", "Cstar", "Isp", "Ve", "Pe", "gamma" };
+    static const char* axes[3] = { "Pc", "O/F", "Pa" };
+
+    std::cout << (report.converged ? "Converged" : "NOT converged (point or pass budget reached)")
+              << " after " << report.passes << " passes" << std::endl;
+    std::cout << "Grid: " << report.axisPoints[0] << " x " << report.axisPoints[1] << " x "
+              << report.axisPoints[2] << " = " << report.gridPoints << " points ("
+              << report.oracleSamples << " oracle samples)" << std::endl;
+    for (int a = 0; a < 3; ++a) {
+        std::cout << "  " << axes[a] << ":";
+        for (double v : generator.getAxis(a)) std::cout << " " << v;
+        std::cout << std::endl;
+    }
+    std::cout << "Max error over " << report.midpointsChecked << " midpoints: "
+              << report.maxErrorRatio << " x tolerance" << std::endl;
+    for (int f = 0; f < RPATableInterpolator::NUM_FIELDS; ++f) {
+        if (settings.fields & (1u << f)) {
+            std::cout << "  " << std::setw(6) << std::left << fields[f] << std::right
+                      << " " << report.maxError[f] << std::endl;
+        }
+    }
+    std::cout << "Output file: " << output << std::endl;
+    return report.converged ? 0 : 1;
+}
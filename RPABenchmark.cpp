@@ -0,0 +1,743 @@
+/**
+ * RPABenchmark.cpp
+ *
+ * Microbenchmarks for table loading, interpolation (RPATableInterpolator,
+ * including tiled out-of-core tables, and the generic RPAPerformanceTable<N>)
+ * and the thrust path (ThrustCalculator
+ * and CompiledThrustModel), on a synthetic table of configurable size (a smooth closed-form engine model, so no RPA run or data
+ * files are needed).
+ *
+ * Query streams:
+ *   random      Uniform over the table; nearly every query lands in a new cell
+ *   trajectory  Smooth random walk, a few hundred queries per cell, like
+ *               successive timesteps of a simulation
+ *
+ * Each benchmark runs --repeat times and reports the fastest run as ns/query
+ * and queries/s. On Linux, cache misses (last level and L1D reads) per query
+ * are read from perf events, averaged over all runs; they show "-" when perf
+ * events are unavailable (e.g. kernel.perf_event_paranoid, containers).
+ *
+ * The batch/<simd> rows time getPerformanceBatch on each instruction set the
+ * CPU supports, after a pass that checks every output bit for bit against
+ * the scalar path.
+ *
+ * In a build with RPA_INSTRUMENTATION, --instrumentation text|json prints the
+ * event counters accumulated over the run (edge clamps, mass-flow solves).
+ *
+ * Usage:
+ *   rpa_benchmark [--pc N] [--of N] [--pa N] [--queries N] [--repeat N]
+ *                 [--filter substring] [--csv] [--instrumentation text|json]
+ */
+
+#include "ThrustCalculator.h"
+#include "RPATableInterpolator.h"
+#include "Instrumentation.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <random>
+#include <chrono>
+#include <vector>
+#include <array>
+#include <string>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const double PC_MIN = 100.0, PC_MAX = 1000.0;
+    const double OF_MIN = 1.0, OF_MAX = 3.5;
+    const double PA_MIN = 0.0, PA_MAX = 14.7;
+    const double AREA_RATIO_MIN = 6.0, AREA_RATIO_MAX = 14.0;
+    const size_t AREA_RATIO_STEPS = 5;      // Fourth axis of the N-dimensional table benchmark
+    const double THROAT_AREA = 5.5;         // in^2
+    const double FT_PER_M = 3.28084;
+    const double GC = 32.174;
+
+    // Trajectory speed: fraction of each axis range per query
+    const double TRAJECTORY_STEP = 2.0e-4;
+
+    const double BENCH_NAN = std::numeric_limits<double>::quiet_NaN();
+
+    struct Options {
+        size_t Pc, OF, Pa;
+        size_t queries;
+        int repeat;
+        std::string filter;
+        bool csv;
+        std::string instrumentation;    // Empty, "text" or "json"
+
+        Options() : Pc(20), OF(15), Pa(6), queries(1000000), repeat(5), csv(false) {}
+    };
+
+    struct Queries {
+        std::vector<double> Pc, OF, Pa;
+        std::vector<double> mdot;   // Mass flow that produces Pc (for the mass-flow solve)
+    };
+
+    /**
+     * Hardware cache-miss counters for the calling thread
+     */
+    class PerfCounters {
+    public:
+        enum Counter { CACHE_MISSES, L1D_READ_MISSES, NUM_COUNTERS };
+
+        PerfCounters() {
+            for (int c = 0; c < NUM_COUNTERS; ++c) m_fd[c] = -1;
+#ifdef __linux__
+            m_fd[CACHE_MISSES] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+            m_fd[L1D_READ_MISSES] = open(PERF_TYPE_HW_CACHE,
+                                         PERF_COUNT_HW_CACHE_L1D |
+                                         (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#endif
+        }
+
+        ~PerfCounters() {
+#ifdef __linux__
+            for (int c = 0; c < NUM_COUNTERS; ++c) {
+                if (m_fd[c] >= 0) close(m_fd[c]);
+            }
+#endif
+        }
+
+        bool available(Counter c) const { return m_fd[c] >= 0; }
+
+        void start() {
+#ifdef __linux__
+            for (int c = 0; c < NUM_COUNTERS; ++c) {
+                if (m_fd[c] < 0) continue;
+                ioctl(m_fd[c], PERF_EVENT_IOC_RESET, 0);
+                ioctl(m_fd[c], PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        /**
+         * Stop counting and add the counts (scaled for multiplexing) to totals
+         */
+        void stop(double totals[NUM_COUNTERS]) {
+#ifdef __linux__
+            for (int c = 0; c < NUM_COUNTERS; ++c) {
+                if (m_fd[c] < 0) continue;
+                ioctl(m_fd[c], PERF_EVENT_IOC_DISABLE, 0);
+                uint64_t values[3];     // value, time enabled, time running
+                if (read(m_fd[c], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+                    continue;
+                }
+                double scale = values[2] > 0 ? double(values[1]) / double(values[2]) : 0.0;
+                totals[c] += double(values[0]) * scale;
+            }
+#else
+            (void)totals;
+#endif
+        }
+
+    private:
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+#ifdef __linux__
+        static int open(uint32_t type, uint64_t config) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+
+        int m_fd[NUM_COUNTERS];
+    };
+
+    /**
+     * Smooth stand-in for an RPA table: chamber temperature peaking near
+     * stoichiometric O/F, gamma drifting with O/F and Pc
+     */
+    RPATableInterpolator::PerformanceData syntheticPoint(double Pc, double OF, double Pa, double areaRatio = 10.0) {
+        const double Tc = 3450.0 * std::exp(-0.35 * (OF - 2.6) * (OF - 2.6));
+        const double M = 18.0 + 3.0 * OF;
+        const double g = 1.25 - 0.04 * (OF - 1.0) + 0.002 * std::log(Pc);
+        const double Gamma = std::sqrt(g) * std::pow(2.0 / (g + 1.0), (g + 1.0) / (2.0 * (g - 1.0)));
+        const double PeRatio = 0.012 * (1.0 + 0.5 * (g - 1.25));
+
+        RPATableInterpolator::PerformanceData p;
+        p.Cstar = std::sqrt(8314.462618 / M * Tc) / Gamma;
+        p.Ve = p.Cstar * (1.62 + 0.03 * std::log(Pc / PC_MIN));
+        p.Cf = p.Ve / p.Cstar + (PeRatio - Pa / Pc) * areaRatio;
+        p.Isp = p.Cf * p.Cstar / 9.80665;
+        p.Pe = PeRatio * Pc;
+        p.gamma = g;
+        return p;
+    }
+
+    double axisValue(double lo, double hi, size_t i, size_t n) {
+        return n > 1 ? lo + (hi - lo) * double(i) / double(n - 1) : lo;
+    }
+
+    bool writeSyntheticTable(const Options& options, const std::string& filename) {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << "Pc_psi,OF,Pa_psi,Cf,Cstar_ms,Isp_s,Ve_ms,Pe_psi,Gamma\n";
+        file << std::setprecision(std::numeric_limits<double>::max_digits10);
+        for (size_t i = 0; i < options.Pc; ++i) {
+            double Pc = axisValue(PC_MIN, PC_MAX, i, options.Pc);
+            for (size_t j = 0; j < options.OF; ++j) {
+                double OF = axisValue(OF_MIN, OF_MAX, j, options.OF);
+                for (size_t k = 0; k < options.Pa; ++k) {
+                    double Pa = axisValue(PA_MIN, PA_MAX, k, options.Pa);
+                    RPATableInterpolator::PerformanceData p = syntheticPoint(Pc, OF, Pa);
+                    file << Pc << "," << OF << "," << Pa << ","
+                         << p.Cf << "," << p.Cstar << "," << p.Isp << ","
+                         << p.Ve << "," << p.Pe << "," << p.gamma << "\n";
+                }
+            }
+        }
+        return static_cast<bool>(file);
+    }
+
+    Queries randomQueries(size_t count, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<double> Pc(PC_MIN, PC_MAX), OF(OF_MIN, OF_MAX), Pa(PA_MIN, PA_MAX);
+        Queries q;
+        q.Pc.resize(count);
+        q.OF.resize(count);
+        q.Pa.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            q.Pc[i] = Pc(rng);
+            q.OF[i] = OF(rng);
+            q.Pa[i] = Pa(rng);
+        }
+        return q;
+    }
+
+    /**
+     * Random walk with momentum, reflected at the table edges
+     */
+    Queries trajectoryQueries(size_t count, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<double> start(0.0, 1.0), turn(-0.05, 0.05);
+        const double lo[3] = { PC_MIN, OF_MIN, PA_MIN };
+        const double hi[3] = { PC_MAX, OF_MAX, PA_MAX };
+        double x[3], v[3];
+        for (int a = 0; a < 3; ++a) {
+            x[a] = start(rng);
+            v[a] = start(rng) < 0.5 ? -1.0 : 1.0;
+        }
+
+        Queries q;
+        std::vector<double>* out[3] = { &q.Pc, &q.OF, &q.Pa };
+        for (int a = 0; a < 3; ++a) out[a]->resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            for (int a = 0; a < 3; ++a) {
+                v[a] = std::max(-1.0, std::min(1.0, v[a] + turn(rng)));
+                x[a] += v[a] * TRAJECTORY_STEP;
+                if (x[a] < 0.0) { x[a] = -x[a]; v[a] = -v[a]; }
+                if (x[a] > 1.0) { x[a] = 2.0 - x[a]; v[a] = -v[a]; }
+                (*out[a])[i] = lo[a] + (hi[a] - lo[a]) * x[a];
+            }
+        }
+        return q;
+    }
+
+    /**
+     * Mass flow through the throat at each query's Pc (from the table's C*)
+     */
+    void addMassFlow(const RPATableInterpolator& table, Queries& q) {
+        q.mdot.resize(q.Pc.size());
+        for (size_t i = 0; i < q.Pc.size(); ++i) {
+            double Cstar = table.getFields<RPATableInterpolator::MASK_CSTAR>(q.Pc[i], q.OF[i], q.Pa[i]).Cstar;
+            q.mdot[i] = q.Pc[i] * THROAT_AREA * GC / (Cstar * FT_PER_M);
+        }
+    }
+
+    class Runner {
+    public:
+        explicit Runner(const Options& options) : m_options(options), m_sink(0.0) {}
+
+        bool selected(const std::string& name) const {
+            return m_options.filter.empty() || name.find(m_options.filter) != std::string::npos;
+        }
+
+        /**
+         * Time `body` (which performs `queries` queries and returns a value to
+         * keep the work observable)
+         */
+        void run(const std::string& name, size_t queries, const std::function<double()>& body) {
+            if (!selected(name)) return;
+
+            body();     // Warm up caches, cursors and page mappings
+
+            double best = std::numeric_limits<double>::infinity();
+            double counts[PerfCounters::NUM_COUNTERS] = { 0.0, 0.0 };
+            for (int r = 0; r < m_options.repeat; ++r) {
+                m_counters.start();
+                auto begin = std::chrono::steady_clock::now();
+                m_sink += body();
+                auto end = std::chrono::steady_clock::now();
+                m_counters.stop(counts);
+                best = std::min(best, std::chrono::duration<double, std::nano>(end - begin).count());
+            }
+
+            const double total = double(queries) * m_options.repeat;
+            const double ns = best / double(queries);
+            double perQuery[PerfCounters::NUM_COUNTERS];
+            for (int c = 0; c < PerfCounters::NUM_COUNTERS; ++c) {
+                perQuery[c] = m_counters.available(static_cast<PerfCounters::Counter>(c))
+                            ? counts[c] / total : BENCH_NAN;
+            }
+            print(name, ns, perQuery);
+        }
+
+        void printHeader() const {
+            if (m_options.csv) {
+                std::cout << "benchmark,ns_per_query,queries_per_s,cache_misses_per_query,l1d_misses_per_query\n";
+                return;
+            }
+            std::cout << std::left << std::setw(48) << "benchmark" << std::right
+                      << std::setw(12) << "ns/query" << std::setw(14) << "queries/s"
+                      << std::setw(14) << "cache-miss/q" << std::setw(12) << "L1D-miss/q" << std::endl;
+        }
+
+        double sink() const { return m_sink; }
+
+    private:
+        void print(const std::string& name, double ns, const double perQuery[]) const {
+            std::ostringstream line;
+            if (m_options.csv) {
+                line << name << "," << ns << "," << 1.0e9 / ns;
+                for (int c = 0; c < PerfCounters::NUM_COUNTERS; ++c) {
+                    line << ",";
+                    if (!std::isnan(perQuery[c])) line << perQuery[c];
+                }
+            } else {
+                line << std::left << std::setw(48) << name << std::right << std::fixed
+                     << std::setw(12) << std::setprecision(2) << ns
+                     << std::setw(14) << std::setprecision(0) << 1.0e9 / ns;
+                const int width[PerfCounters::NUM_COUNTERS] = { 14, 12 };
+                for (int c = 0; c < PerfCounters::NUM_COUNTERS; ++c) {
+                    line << std::setw(width[c]);
+                    if (std::isnan(perQuery[c])) line << "-";
+                    else line << std::setprecision(3) << perQuery[c];
+                }
+            }
+            std::cout << line.str() << std::endl;
+        }
+
+        const Options& m_options;
+        PerfCounters m_counters;
+        double m_sink;
+    };
+
+    /**
+     * Sum of the selected fields, so the compiler cannot drop the work for
+     * any of them
+     */
+    template <unsigned Fields>
+    double consume(const RPATableInterpolator::PerformanceData& p) {
+        double sum = 0.0;
+        if (Fields & RPATableInterpolator::MASK_CF) sum += p.Cf;
+        if (Fields & RPATableInterpolator::MASK_CSTAR) sum += p.Cstar;
+        if (Fields & RPATableInterpolator::MASK_ISP) sum += p.Isp;
+        if (Fields & RPATableInterpolator::MASK_VE) sum += p.Ve;
+        if (Fields & RPATableInterpolator::MASK_PE) sum += p.Pe;
+        if (Fields & RPATableInterpolator::MASK_GAMMA) sum += p.gamma;
+        return sum;
+    }
+
+    /**
+     * Synthetic performance over the given axes (Pc, O/F, Pa[, area ratio])
+     * in RPAPerformanceTable point-major order
+     */
+    template <size_t N>
+    std::vector<double> syntheticValues(const std::array<std::vector<double>, N>& axes) {
+        std::vector<double> values;
+        const size_t areaRatios = N > 3 ? axes[N - 1].size() : 1;
+        for (double Pc : axes[0]) {
+            for (double OF : axes[1]) {
+                for (double Pa : axes[2]) {
+                    for (size_t r = 0; r < areaRatios; ++r) {
+                        RPATableInterpolator::PerformanceData p =
+                            N > 3 ? syntheticPoint(Pc, OF, Pa, axes[N - 1][r]) : syntheticPoint(Pc, OF, Pa);
+                        const double fields[RPATableInterpolator::NUM_FIELDS] = {
+                            p.Cf, p.Cstar, p.Isp, p.Ve, p.Pe, p.gamma
+                        };
+                        values.insert(values.end(), fields, fields + RPATableInterpolator::NUM_FIELDS);
+                    }
+                }
+            }
+        }
+        return values;
+    }
+
+    /**
+     * Query an N-dimensional table at (Pc, O/F, Pa), plus areaRatio[i] as the
+     * fourth coordinate when N is 4
+     */
+    template <size_t N>
+    double interpolateND(const RPAPerformanceTable<N>& table, const Queries& q,
+                         const std::vector<double>& areaRatio) {
+        double sum = 0.0;
+        double x[4];
+        double values[RPATableInterpolator::NUM_FIELDS];
+        for (size_t i = 0; i < q.Pc.size(); ++i) {
+            x[0] = q.Pc[i];
+            x[1] = q.OF[i];
+            x[2] = q.Pa[i];
+            if (N > 3) x[3] = areaRatio[i];
+            table.getValues(x, values);
+            for (double v : values) sum += v;
+        }
+        return sum;
+    }
+
+    template <unsigned Fields>
+    double interpolate(const RPATableInterpolator& table, const Queries& q) {
+        double sum = 0.0;
+        for (size_t i = 0; i < q.Pc.size(); ++i) {
+            sum += consume<Fields>(table.getFields<Fields>(q.Pc[i], q.OF[i], q.Pa[i]));
+        }
+        return sum;
+    }
+
+    template <unsigned Fields>
+    double interpolateWithCursor(const RPATableInterpolator& table, const Queries& q) {
+        InterpolationCursor cursor;
+        double sum = 0.0;
+        for (size_t i = 0; i < q.Pc.size(); ++i) {
+            sum += consume<Fields>(table.getFields<Fields>(q.Pc[i], q.OF[i], q.Pa[i], cursor));
+        }
+        return sum;
+    }
+
+    bool parseCount(const std::string& text, size_t& value) {
+        char* end = nullptr;
+        unsigned long long v = std::strtoull(text.c_str(), &end, 10);
+        if (end == text.c_str() || *end != '\0' || v == 0) return false;
+        value = static_cast<size_t>(v);
+        return true;
+    }
+
+    void usage(const char* program) {
+        std::cerr << "Usage: " << program << " [--pc N] [--of N] [--pa N] [--queries N] [--repeat N]\n"
+                  << "       [--filter substring] [--csv] [--instrumentation text|json]" << std::endl;
+    }
+
+    std::string tempPath(const std::string& name) {
+        const char* dir = std::getenv("TMPDIR");
+        return std::string(dir && *dir ? dir : "/tmp") + "/" + name;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--csv") {
+            options.csv = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        size_t count = 0;
+        bool ok = true;
+        if (arg == "--pc") ok = parseCount(value, options.Pc);
+        else if (arg == "--of") ok = parseCount(value, options.OF);
+        else if (arg == "--pa") ok = parseCount(value, options.Pa);
+        else if (arg == "--queries") ok = parseCount(value, options.queries);
+        else if (arg == "--repeat") {
+            ok = parseCount(value, count);
+            options.repeat = static_cast<int>(count);
+        }
+        else if (arg == "--filter") options.filter = value;
+        else if (arg == "--instrumentation") {
+            options.instrumentation = value;
+            ok = value == "text" || value == "json";
+        }
+        else ok = false;
+        if (!ok) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    const std::string stem = "rpa_benchmark_" + std::to_string(options.Pc) + "x" +
+                             std::to_string(options.OF) + "x" + std::to_string(options.Pa);
+    const std::string csvFile = tempPath(stem + ".csv");
+    const std::string compiledFile = tempPath(stem + ".rpat");
+    if (!writeSyntheticTable(options, csvFile)) {
+        std::cerr << "Error: Failed to write " << csvFile << std::endl;
+        return 1;
+    }
+
+    std::shared_ptr<RPATableInterpolator> table = std::make_shared<RPATableInterpolator>();
+    if (!table->loadTable(csvFile) || !table->saveCompiledTable(compiledFile)) {
+        std::cerr << "Error: Failed to load " << csvFile << std::endl;
+        std::remove(csvFile.c_str());
+        return 1;
+    }
+
+    const size_t gridPoints = options.Pc * options.OF * options.Pa;
+    if (!options.csv) {
+        std::cout << "Synthetic table " << options.Pc << " x " << options.OF << " x " << options.Pa
+                  << " (" << gridPoints << " points, "
+                  << gridPoints * RPATableInterpolator::NUM_FIELDS * sizeof(double) / 1024 << " KiB), "
+                  << options.queries << " queries, best of " << options.repeat << std::endl;
+    }
+
+    Runner runner(options);
+    runner.printHeader();
+
+    // Loading: one query is one load
+    runner.run("load/csv", 1, [&]() {
+        RPATableInterpolator t;
+        return t.loadTable(csvFile) ? 1.0 : 0.0;
+    });
+    runner.run("load/compiled", 1, [&]() {
+        RPATableInterpolator t;
+        return t.loadCompiledTable(compiledFile) ? 1.0 : 0.0;
+    });
+
+    Queries random = randomQueries(options.queries, 1);
+    Queries trajectory = trajectoryQueries(options.queries, 2);
+    addMassFlow(*table, random);
+    addMassFlow(*table, trajectory);
+
+    std::vector<double> out[RPATableInterpolator::NUM_FIELDS];
+    for (auto& v : out) v.resize(options.queries);
+    RPATableInterpolator::PerformanceBatch batch = {
+        out[0].data(), out[1].data(), out[2].data(), out[3].data(), out[4].data(), out[5].data()
+    };
+
+    const struct {
+        const char* name;
+        RPATableInterpolator::InterpolationMode mode;
+    } modes[] = {
+        { "trilinear", RPATableInterpolator::InterpolationMode::Trilinear },
+        { "tricubic", RPATableInterpolator::InterpolationMode::MonotoneTricubic }
+    };
+
+    const size_t n = options.queries;
+    for (const auto& m : modes) {
+        table->setInterpolationMode(m.mode);
+        const std::string prefix = std::string("getPerformance/") + m.name;
+        const RPATableInterpolator& t = *table;
+
+        runner.run(prefix + "/random", n, [&]() {
+            return interpolate<RPATableInterpolator::MASK_ALL>(t, random);
+        });
+        runner.run(prefix + "/trajectory", n, [&]() {
+            return interpolate<RPATableInterpolator::MASK_ALL>(t, trajectory);
+        });
+        runner.run(prefix + "/trajectory+cursor", n, [&]() {
+            return interpolateWithCursor<RPATableInterpolator::MASK_ALL>(t, trajectory);
+        });
+        runner.run(prefix + "/Cf/trajectory+cursor", n, [&]() {
+            return interpolateWithCursor<RPATableInterpolator::MASK_CF>(t, trajectory);
+        });
+        runner.run(prefix + "/batch/random", n, [&]() {
+            t.getPerformanceBatch(random.Pc.data(), random.OF.data(), random.Pa.data(), n, batch);
+            return out[0][n - 1];
+        });
+    }
+    table->setInterpolationMode(RPATableInterpolator::InterpolationMode::Trilinear);
+
+    // Batch kernels on each instruction set the CPU has. A first pass over
+    // both streams runs with verification on, so any output that differs in
+    // any bit from the scalar path stops the benchmark.
+    const struct {
+        const char* name;
+        RPATableInterpolator::SimdLevel level;
+    } levels[] = {
+        { "batch/scalar", RPATableInterpolator::SimdLevel::Scalar },
+        { "batch/avx2", RPATableInterpolator::SimdLevel::AVX2 },
+        { "batch/avx512", RPATableInterpolator::SimdLevel::AVX512 }
+    };
+    const RPATableInterpolator::SimdLevel detected = RPATableInterpolator::detectSimdLevel();
+    for (const auto& l : levels) {
+        if (static_cast<int>(l.level) > static_cast<int>(detected) || !runner.selected(l.name)) continue;
+        table->setSimdLevel(l.level);
+        const RPATableInterpolator& t = *table;
+        try {
+            table->setBatchVerification(true);
+            t.getPerformanceBatch(random.Pc.data(), random.OF.data(), random.Pa.data(), n, batch);
+            t.getPerformanceBatch(trajectory.Pc.data(), trajectory.OF.data(), trajectory.Pa.data(), n, batch);
+            table->setBatchVerification(false);
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << l.name << ": " << e.what() << std::endl;
+            return 1;
+        }
+        runner.run(std::string(l.name) + "/random", n, [&]() {
+            t.getPerformanceBatch(random.Pc.data(), random.OF.data(), random.Pa.data(), n, batch);
+            return out[0][n - 1];
+        });
+        runner.run(std::string(l.name) + "/trajectory", n, [&]() {
+            t.getPerformanceBatch(trajectory.Pc.data(), trajectory.OF.data(), trajectory.Pa.data(), n, batch);
+            return out[0][n - 1];
+        });
+    }
+    table->setSimdLevel(detected);
+
+    // Tiled table whose brick cache holds an eighth of the grid, so the
+    // trajectory keeps reading bricks back in (random queries would measure
+    // little but file reads)
+    const std::string tiledFile = tempPath(stem + ".rptl");
+    RPATableInterpolator tiled;
+    if (runner.selected("tiled/") && table->saveTiledTable(tiledFile) &&
+        tiled.loadTiledTable(tiledFile, table->getGridBytes() / 8)) {
+        const struct {
+            const char* name;
+            bool cursor;
+        } streams[] = {
+            { "tiled/trajectory", false },
+            { "tiled/trajectory+cursor", true }
+        };
+        for (const auto& s : streams) {
+            if (!runner.selected(s.name)) continue;
+            tiled.resetTileStats();
+            runner.run(s.name, n, [&]() {
+                return s.cursor ? interpolateWithCursor<RPATableInterpolator::MASK_ALL>(tiled, trajectory)
+                                : interpolate<RPATableInterpolator::MASK_ALL>(tiled, trajectory);
+            });
+            TiledGrid::Stats stats = tiled.getTileStats();
+            if (!options.csv) {
+                std::ostringstream line;
+                line << "  bricks: hit rate " << std::fixed << std::setprecision(4) << stats.hitRate()
+                     << ", " << stats.misses << " misses, " << stats.prefetched << " prefetched ("
+                     << stats.prefetchHits << " used), " << stats.residentBricks << "/"
+                     << stats.capacityBricks << " resident";
+                std::cout << line.str() << std::endl;
+            }
+        }
+    }
+    std::remove(tiledFile.c_str());
+
+    // Generic tables: the 3D instance on the same grid, and a 4D table with
+    // an area-ratio axis (a fixed ratio per trajectory, random per query)
+    const std::array<std::vector<double>, 3> axes3 = {
+        { table->getPcBreakpoints(), table->getOFBreakpoints(), table->getPaBreakpoints() }
+    };
+    std::array<std::vector<double>, 4> axes4 = { { axes3[0], axes3[1], axes3[2], std::vector<double>() } };
+    for (size_t r = 0; r < AREA_RATIO_STEPS; ++r) {
+        axes4[3].push_back(axisValue(AREA_RATIO_MIN, AREA_RATIO_MAX, r, AREA_RATIO_STEPS));
+    }
+    RPAPerformanceTable<3> table3;
+    RPAPerformanceTable<4> table4;
+    if (!table3.loadGrid(axes3, syntheticValues(axes3)) || !table4.loadGrid(axes4, syntheticValues(axes4))) {
+        std::cerr << "Error: Failed to build N-dimensional tables" << std::endl;
+        return 1;
+    }
+    std::vector<double> randomAreaRatio(n), trajectoryAreaRatio(n, 9.0);
+    std::mt19937_64 areaRng(3);
+    std::uniform_real_distribution<double> areaRatio(AREA_RATIO_MIN, AREA_RATIO_MAX);
+    for (double& r : randomAreaRatio) r = areaRatio(areaRng);
+
+    runner.run("RPAPerformanceTable<3>/random", n, [&]() {
+        return interpolateND(table3, random, randomAreaRatio);
+    });
+    runner.run("RPAPerformanceTable<3>/trajectory", n, [&]() {
+        return interpolateND(table3, trajectory, trajectoryAreaRatio);
+    });
+    runner.run("RPAPerformanceTable<4>/random", n, [&]() {
+        return interpolateND(table4, random, randomAreaRatio);
+    });
+    runner.run("RPAPerformanceTable<4>/trajectory", n, [&]() {
+        return interpolateND(table4, trajectory, trajectoryAreaRatio);
+    });
+
+    ThrustCalculator calculator(table);
+    calculator.setThroatArea(THROAT_AREA);
+
+    runner.run("calculateThrust/random", n, [&]() {
+        ThrustCalculator::QueryState state;
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            // Split the mass flow at the query's O/F
+            double mdot_fuel = random.mdot[i] / (1.0 + random.OF[i]);
+            sum += calculator.calculateThrust(random.Pc[i], random.mdot[i] - mdot_fuel, mdot_fuel,
+                                              random.Pa[i], state);
+        }
+        return sum;
+    });
+    runner.run("calculateThrust/trajectory", n, [&]() {
+        ThrustCalculator::QueryState state;
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double mdot_fuel = trajectory.mdot[i] / (1.0 + trajectory.OF[i]);
+            sum += calculator.calculateThrust(trajectory.Pc[i], trajectory.mdot[i] - mdot_fuel, mdot_fuel,
+                                              trajectory.Pa[i], state);
+        }
+        return sum;
+    });
+
+    const CompiledThrustModel model = calculator.compile();
+    auto compiledThrust = [&](const Queries& q) {
+        unsigned status = CompiledThrustModel::STATUS_OK;
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double mdot_fuel = q.mdot[i] / (1.0 + q.OF[i]);
+            sum += model.thrust(q.Pc[i], q.mdot[i] - mdot_fuel, mdot_fuel, q.Pa[i], status);
+        }
+        return status == CompiledThrustModel::STATUS_OK ? sum : 0.0;
+    };
+    runner.run("CompiledThrustModel/random", n, [&]() { return compiledThrust(random); });
+    runner.run("CompiledThrustModel/trajectory", n, [&]() { return compiledThrust(trajectory); });
+
+    auto massFlow = [&](const Queries& q) {
+        ThrustCalculator::QueryState state;
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += calculator.calculateThrustFromMassFlow(q.mdot[i], q.OF[i], q.Pa[i], state);
+        }
+        return sum;
+    };
+    runner.run("calculateThrustFromMassFlow/random", n, [&]() { return massFlow(random); });
+    runner.run("calculateThrustFromMassFlow/trajectory", n, [&]() { return massFlow(trajectory); });
+
+    if (runner.selected("calculateThrustFromMassFlow/inverse")) {
+        calculator.buildInverseTable();
+        runner.run("calculateThrustFromMassFlow/inverse/random", n, [&]() { return massFlow(random); });
+        runner.run("calculateThrustFromMassFlow/inverse/trajectory", n, [&]() { return massFlow(trajectory); });
+        calculator.clearInverseTable();
+    }
+
+    std::remove(csvFile.c_str());
+    std::remove(compiledFile.c_str());
+
+    if (options.instrumentation == "text") {
+        Instrumentation::snapshot().writeText(std::cout);
+    } else if (options.instrumentation == "json") {
+        Instrumentation::snapshot().writeJson(std::cout);
+        std::cout << std::endl;
+    }
+
+    // Keeps the measured work from being optimised away
+    if (std::isnan(runner.sink())) {
+        std::cerr << "(non-finite result)" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * RPATableCompiler.cpp
+ *
+ * Compiles a CSV table from generate_rpa_tables.js into the binary format read
+ * by RPATableInterpolator::loadCompiledTable, or with --tiled into the
+ * out-of-core format read by loadTiledTable (bricks of N cells per edge,
+ * default 16).
+ *
+ * Usage:
+ *   rpa_table_compiler [--tiled[=N]] rpa_thrust_tables.csv rpa_thrust_tables.rpat [reference.csv]
+ *
+ * With a reference table (a denser grid over the same space) the compiler
+ * also prints the maximum interpolation error of the compiled table in each
+ * interpolation mode.
+ */
+
+#include "RPATableInterpolator.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+namespace {
+    void printErrorReport(const char* name, const RPATableInterpolator::ErrorReport& report) {
+        static const char* fields[RPATableInterpolator::NUM_FIELDS] = {
+            "Cf", "Cstar", "Isp", "Ve", "Pe", "gamma"
+        };
+        std::cout << "  " << name << " (" << report.pointsCompared << " reference points)" << std::endl;
+        for (int f = 0; f < RPATableInterpolator::NUM_FIELDS; ++f) {
+            const RPATableInterpolator::FieldError& e = report.fields[f];
+            std::cout << "    " << std::setw(6) << std::left << fields[f] << std::right
+                      << " max abs " << std::setw(11) << std::setprecision(4) << e.maxAbsError
+                      << "  max rel " << std::setw(11) << e.maxRelError
+                      << "  at Pc=" << e.Pc << " O/F=" << e.OF << " Pa=" << e.Pa << std::endl;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    bool tiled = false;
+    size_t brickCells = TiledGrid::DEFAULT_BRICK_CELLS;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--tiled") {
+            tiled = true;
+        } else if (arg.compare(0, 8, "--tiled=") == 0) {
+            tiled = true;
+            brickCells = std::strtoul(arg.c_str() + 8, nullptr, 10);
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if ((files.size() != 2 && files.size() != 3) || brickCells == 0) {
+        std::cerr << "Usage: " << argv[0] << " [--tiled[=N]] <input.csv> <output.rpat> [reference.csv]"
+                  << std::endl;
+        return 1;
+    }
+    const std::string& input = files[0];
+    const std::string& output = files[1];
+
+    RPATableInterpolator table;
+    if (!table.loadTable(input)) {
+        std::cerr << "Error: Failed to load " << input << std::endl;
+        table.getLoadReport().write(std::cerr);
+        return 1;
+    }
+    if (!table.getLoadReport().clean()) {
+        std::cerr << "Warning: " << input << " has problems" << std::endl;
+        table.getLoadReport().write(std::cerr);
+    }
+
+    if (!(tiled ? table.saveTiledTable(output, brickCells) : table.saveCompiledTable(output))) {
+        std::cerr << "Error: Failed to write " << output << std::endl;
+        return 1;
+    }
+
+    // Re-open the output to make sure it round-trips
+    RPATableInterpolator compiled;
+    if (!(tiled ? compiled.loadTiledTable(output) : compiled.loadCompiledTable(output))) {
+        std::cerr << "Error: " << output << " failed verification" << std::endl;
+        return 1;
+    }
+
+    double Pc_min, Pc_max, OF_min, OF_max, Pa_min, Pa_max;
+    compiled.getBounds(Pc_min, Pc_max, OF_min, OF_max, Pa_min, Pa_max);
+    std::cout << (tiled ? "Tiled " : "Compiled ") << input << " -> " << output << std::endl;
+    std::cout << "  Pc: " << Pc_min << " - " << Pc_max << " psi" << std::endl;
+    std::cout << "  O/F: " << OF_min << " - " << OF_max << std::endl;
+    std::cout << "  Pa: " << Pa_min << " - " << Pa_max << " psi" << std::endl;
+
+    if (tiled) {
+        TiledGrid::Stats stats = compiled.getTileStats();
+        std::cout << "  Bricks: " << stats.brickBytes / 1024 << " KiB each, "
+                  << stats.capacityBricks << " cached by default" << std::endl;
+    }
+
+    if (files.size() == 3) {
+        RPATableInterpolator reference;
+        if (!reference.loadTable(files[2])) {
+            std::cerr << "Error: Failed to load reference " << files[2] << std::endl;
+            return 1;
+        }
+
+        // Tiled tables are trilinear only; the in-memory table has the same values
+        std::cout << "Interpolation error against " << files[2] << ":" << std::endl;
+        printErrorReport("trilinear", compiled.compareWithReference(reference));
+        RPATableInterpolator& cubic = tiled ? table : compiled;
+        cubic.setInterpolationMode(RPATableInterpolator::InterpolationMode::MonotoneTricubic);
+        printErrorReport("monotone tricubic", cubic.compareWithReference(reference));
+    }
+    return 0;
+}
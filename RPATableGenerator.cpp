@@ -0,0 +1,245 @@
+/**
+ * RPATableGenerator.cpp
+ *
+ * Native replacement for running generate_rpa_tables.js under rpas.exe.
+ * Solves chamber equilibrium and shifting-equilibrium nozzle expansion with
+ * the bundled NASA thermodynamic database and writes the same CSV table
+ * (Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma) that RPATableInterpolator loads.
+ *
+ * Defaults match CONFIG in generate_rpa_tables.js.
+ *
+ * Usage:
+ *   rpa_table_generator [--oxidizer N2O4(L)] [--fuel UDMH]
+ *                       [--pc min,max,steps] [--of min,max,steps] [--pa min,max,steps]
+ *                       [--expansion-ratio 10 | --optimal-expansion]
+ *                       [--thermo RPA/2.3/standard/resources/thermo.inp]
+ *                       [--threads N] [--output rpa_thrust_tables.csv]
+ */
+
+#include "RocketPerformance.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <cstdlib>
+
+namespace {
+    const double PSI_TO_BAR = 0.0689475729;
+
+    // Pc points per work item (see main)
+    const size_t RUN_LENGTH = 4;
+
+    struct Range {
+        double min, max;
+        int steps;
+    };
+
+    struct Config {
+        std::string oxidizer = "N2O4(L)";
+        std::string fuel = "UDMH";
+        Range Pc = { 100.0, 1000.0, 20 };   // psi
+        Range OF = { 1.0, 3.5, 15 };
+        Range Pa = { 0.0, 14.7, 6 };        // psi
+        double expansionRatio = 10.0;       // <= 0 for optimal expansion
+        std::string thermo = "RPA/2.3/standard/resources/thermo.inp";
+        unsigned threads = 0;               // 0 = all cores
+        std::string output = "rpa_thrust_tables.csv";
+    };
+
+    // Same spacing as linspace() in generate_rpa_tables.js
+    std::vector<double> linspace(const Range& r) {
+        std::vector<double> values;
+        double step = r.steps > 1 ? (r.max - r.min) / (r.steps - 1) : 0.0;
+        for (int i = 0; i < r.steps; ++i) {
+            values.push_back(r.min + step * i);
+        }
+        return values;
+    }
+
+    bool parseRange(const std::string& text, Range& r) {
+        std::istringstream ss(text);
+        char c1, c2;
+        return (ss >> r.min >> c1 >> r.max >> c2 >> r.steps) && c1 == ',' && c2 == ',' && r.steps > 0;
+    }
+
+    void usage(const char* program) {
+        std::cerr << "Usage: " << program << " [--oxidizer NAME] [--fuel NAME]\n"
+                  << "       [--pc min,max,steps] [--of min,max,steps] [--pa min,max,steps]\n"
+                  << "       [--expansion-ratio AeAt | --optimal-expansion]\n"
+                  << "       [--thermo thermo.inp] [--threads N] [--output table.csv]" << std::endl;
+    }
+
+    bool parseArgs(int argc, char** argv, Config& config) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--optimal-expansion") {
+                config.expansionRatio = 0.0;
+                continue;
+            }
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            if (arg == "--oxidizer") config.oxidizer = value;
+            else if (arg == "--fuel") config.fuel = value;
+            else if (arg == "--pc") { if (!parseRange(value, config.Pc)) return false; }
+            else if (arg == "--of") { if (!parseRange(value, config.OF)) return false; }
+            else if (arg == "--pa") { if (!parseRange(value, config.Pa)) return false; }
+            else if (arg == "--expansion-ratio") config.expansionRatio = std::atof(value.c_str());
+            else if (arg == "--thermo") config.thermo = value;
+            else if (arg == "--threads") config.threads = static_cast<unsigned>(std::atoi(value.c_str()));
+            else if (arg == "--output") config.output = value;
+            else return false;
+        }
+        return true;
+    }
+
+    // Table row results for one grid point
+    struct Row {
+        bool valid;
+        double Cf, Cstar, Isp, Ve, Pe, gamma;
+    };
+}
+
+int main(int argc, char** argv) {
+    Config config;
+    if (!parseArgs(argc, argv, config)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    ThermoDatabase db;
+    if (!db.load(config.thermo)) {
+        std::cerr << "Error: Failed to load thermo database " << config.thermo << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<EquilibriumSolver> solver;
+    try {
+        solver.reset(new EquilibriumSolver(db, { config.oxidizer, config.fuel }));
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    RocketPerformance performance(*solver);
+
+    const std::vector<double> Pc_range = linspace(config.Pc);
+    const std::vector<double> OF_range = linspace(config.OF);
+    const std::vector<double> Pa_range = linspace(config.Pa);
+    const size_t nPc = Pc_range.size(), nOF = OF_range.size(), nPa = Pa_range.size();
+
+    std::cout << "Generating RPA thrust tables..." << std::endl;
+    std::cout << "Propellants: " << config.oxidizer << " / " << config.fuel
+              << " (" << solver->productCount() << " gaseous product species)" << std::endl;
+    std::cout << "Total calculations: " << nPc * nOF * nPa << std::endl;
+
+    unsigned threads = config.threads ? config.threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, threads);
+
+    // Work items are runs of consecutive Pc at one O/F. Within a run every
+    // solve starts from the previous point's converged chamber composition
+    // and nozzle pressure ratios, so only the first point of a run starts
+    // cold. The run length does not depend on the thread count, so the
+    // table is identical however many cores generate it.
+    const size_t runLength = RUN_LENGTH;
+    const size_t runsPerRow = (nPc + runLength - 1) / runLength;
+    const size_t numItems = nOF * runsPerRow;
+
+    std::vector<Row> rows(nPc * nOF * nPa);
+    std::atomic<size_t> nextItem(0);
+    std::atomic<size_t> failures(0);
+
+    auto worker = [&]() {
+        for (size_t item = nextItem++; item < numItems; item = nextItem++) {
+            size_t j = item / runsPerRow;
+            size_t iBegin = (item % runsPerRow) * runLength;
+            size_t iEnd = std::min(nPc, iBegin + runLength);
+
+            const double OF = OF_range[j];
+            EquilibriumSolver::Reactants reactants = solver->makeReactants({ OF / (1.0 + OF), 1.0 / (1.0 + OF) });
+            RocketPerformance::WarmStart warm;
+
+            for (size_t i = iBegin; i < iEnd; ++i) {
+                const double Pc = Pc_range[i] * PSI_TO_BAR;
+                RocketPerformance::Result result;
+                bool fixedOk = config.expansionRatio > 0.0 &&
+                               performance.solve(reactants, Pc, config.expansionRatio, warm, result);
+
+                for (size_t k = 0; k < nPa; ++k) {
+                    const double Pa = Pa_range[k] * PSI_TO_BAR;
+                    bool ok = fixedOk;
+                    if (config.expansionRatio <= 0.0) {
+                        ok = performance.solveOptimal(reactants, Pc, Pa, warm, result);
+                    }
+
+                    Row& row = rows[(i * nOF + j) * nPa + k];
+                    row.valid = ok;
+                    if (!ok) {
+                        ++failures;
+                        continue;
+                    }
+                    row.Cf = result.thrustCoefficient(Pa);
+                    row.Cstar = result.Cstar;
+                    row.Isp = result.specificImpulse(Pa);
+                    row.Ve = result.Ve;
+                    row.Pe = result.Pe / PSI_TO_BAR;
+                    row.gamma = result.gamma;
+                }
+
+                if (!fixedOk && config.expansionRatio > 0.0) {
+                    // Do not warm-start the next point from a failed solve
+                    warm = RocketPerformance::WarmStart();
+                }
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : pool) {
+        t.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream file(config.output);
+    if (!file.is_open()) {
+        std::cerr << "Error: Failed to open " << config.output << std::endl;
+        return 1;
+    }
+    file << "Pc_psi,OF,Pa_psi,Cf,Cstar_ms,Isp_s,Ve_ms,Pe_psi,Gamma\n";
+    file << std::setprecision(15);
+
+    size_t count = 0;
+    for (size_t i = 0; i < nPc; ++i) {
+        for (size_t j = 0; j < nOF; ++j) {
+            for (size_t k = 0; k < nPa; ++k) {
+                const Row& row = rows[(i * nOF + j) * nPa + k];
+                if (!row.valid) {
+                    std::cout << "Warning: Failed at Pc=" << Pc_range[i] << ", OF=" << OF_range[j]
+                              << ", Pa=" << Pa_range[k] << std::endl;
+                    continue;
+                }
+                file << Pc_range[i] << "," << OF_range[j] << "," << Pa_range[k] << ","
+                     << row.Cf << "," << row.Cstar << "," << row.Isp << ","
+                     << row.Ve << "," << row.Pe << "," << row.gamma << "\n";
+                ++count;
+            }
+        }
+    }
+
+    std::cout << "\nTable generation complete!" << std::endl;
+    std::cout << "Total entries: " << count << " (" << failures.load() << " failed)" << std::endl;
+    std::cout << "Threads: " << threads << ", time: " << std::fixed << std::setprecision(2)
+              << seconds << " s" << std::endl;
+    std::cout << "Output file: " << config.output << std::endl;
+    return failures.load() == 0 ? 0 : 1;
+}
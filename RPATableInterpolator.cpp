@@ -1,234 +1,943 @@
 #include "RPATableInterpolator.h"
+#include "MappedFile.h"
 #include <fstream>
-#include <sstream>
 #include <algorithm>
 #include <stdexcept>
 #include <cmath>
-#include <set>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <atomic>
+
+namespace {
+    // Largest 16-bit fixed-point code; codes span each field's [min, max]
+    const double FIXED16_LEVELS = 65535.0;
+
+    /**
+     * Compiled table layout (native byte order, all offsets in bytes):
+     *
+     *   CompiledTableHeader
+     *   double Pc[axisSize[0]], OF[axisSize[1]], Pa[axisSize[2]]   at axisOffset
+     *   double grid[numFields][numPoints]                           at gridOffset
+     *
+     * gridOffset is 64-byte aligned so mapped field blocks start on a cache line.
+     * The checksum is FNV-1a over every byte after the header.
+     */
+    const char COMPILED_MAGIC[8] = { 'R', 'P', 'A', 'T', 'B', 'L', '\0', '\0' };
+    const uint32_t COMPILED_VERSION = 1;
+    const uint32_t COMPILED_ENDIAN_TAG = 0x01020304;
+    const uint64_t COMPILED_ALIGNMENT = 64;
+
+    struct CompiledTableHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t endianTag;
+        uint32_t headerSize;
+        uint32_t numFields;
+        uint32_t axisSize[3];       // Pc, OF, Pa
+        uint32_t reserved;
+        uint64_t axisOffset;
+        uint64_t gridOffset;
+        uint64_t fileSize;
+        uint64_t checksum;
+    };
+
+    uint64_t fnv1a(const unsigned char* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Table generations are unique process-wide, so a cursor cannot mistake a
+    // new table at a recycled address for the one it last used
+    std::atomic<uint64_t> s_nextGeneration(1);
+
+    /**
+     * Visit the first grid index of every line running along one axis
+     * @param count Breakpoints on the axis
+     * @param stride Grid stride of the axis
+     */
+    template <typename Visit>
+    void forEachGridLine(size_t numPoints, size_t count, size_t stride, Visit visit) {
+        for (size_t g = 0; g < numPoints; ++g) {
+            if ((g / stride) % count == 0) visit(g);
+        }
+    }
+
+    // One-sided three-point slope at an axis end (h0, d0 are the end interval)
+    double endSlope(double h0, double h1, double d0, double d1) {
+        return ((2.0 * h0 + h1) * d0 - h0 * d1) / (h0 + h1);
+    }
+
+    /**
+     * Derivative along one grid line, y and m strided through the grid
+     * Three-point differences; with monotone set they pass through Hyman's
+     * filter: where the data is monotone the slope keeps its sign and is
+     * capped at three times the smaller adjacent secant (the Fritsch-Carlson
+     * bound), so the cubic cannot overshoot, while slopes at data extrema
+     * are left alone so smooth peaks (Cstar near stoichiometric O/F) keep
+     * full accuracy.
+     */
+    void lineSlopes(const TableAxis& axis, const double* y, size_t stride, bool monotone, double* m) {
+        const size_t n = axis.size();
+        if (n < 2) {
+            m[0] = 0.0;
+            return;
+        }
+
+        std::vector<double> h(n - 1), d(n - 1);
+        for (size_t k = 0; k + 1 < n; ++k) {
+            h[k] = axis[k + 1] - axis[k];
+            d[k] = (y[(k + 1) * stride] - y[k * stride]) / h[k];
+        }
+
+        if (n == 2) {
+            m[0] = m[stride] = d[0];
+            return;
+        }
+
+        auto limit = [](double slope, double d0, double d1) {
+            if (d0 * d1 <= 0.0) return slope;
+            double cap = 3.0 * std::min(std::abs(d0), std::abs(d1));
+            if (slope * d0 <= 0.0) return 0.0;
+            return std::abs(slope) > cap ? std::copysign(cap, slope) : slope;
+        };
+
+        for (size_t k = 1; k + 1 < n; ++k) {
+            double slope = (d[k - 1] * h[k] + d[k] * h[k - 1]) / (h[k - 1] + h[k]);
+            m[k * stride] = monotone ? limit(slope, d[k - 1], d[k]) : slope;
+        }
 
-RPATableInterpolator::RPATableInterpolator() : m_isLoaded(false) {
+        // Ends: one-sided three-point estimate, held to the end secant's sign
+        // and magnitude bound
+        double first = endSlope(h[0], h[1], d[0], d[1]);
+        double last = endSlope(h[n - 2], h[n - 3], d[n - 2], d[n - 3]);
+        if (monotone) {
+            first = limit(first, d[0], d[0]);
+            last = limit(last, d[n - 2], d[n - 2]);
+        }
+        m[0] = first;
+        m[(n - 1) * stride] = last;
+    }
+}
+
+RPATableInterpolator::RPATableInterpolator()
+    : m_gridData(nullptr)
+    , m_tilePrefetch(true)
+    , m_precision(StoragePrecision::Double)
+    , m_storage(StoragePrecision::Double)
+    , m_numPoints(0)
+    , m_stridePc(0)
+    , m_strideOF(0)
+    , m_isLoaded(false)
+    , m_generation(0)
+    , m_simdLevel(detectSimdLevel())
+    , m_verifyBatch(false)
+    , m_mode(InterpolationMode::Trilinear) {
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        m_fixedScale[f] = 0.0;
+        m_fixedOffset[f] = 0.0;
+    }
+    m_quantizationError = ErrorReport();
 }
 
 RPATableInterpolator::~RPATableInterpolator() {
 }
 
 bool RPATableInterpolator::loadTable(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    clearTable();
+
+    // Columns: Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma; later columns are ignored
+    TableCsvReader::Settings settings;
+    settings.axisColumns = 3;
+    settings.valueColumns = NUM_FIELDS;
+    settings.allowExtraColumns = true;
+
+    TableCsvReader reader(settings);
+    bool ok = reader.read(filename);
+    m_loadReport = reader.getReport();
+    if (!ok) {
         return false;
     }
 
-    m_table.clear();
-    m_Pc_values.clear();
-    m_OF_values.clear();
-    m_Pa_values.clear();
-    m_indexMap.clear();
+    m_Pc_axis.assign(reader.getAxis(0));
+    m_OF_axis.assign(reader.getAxis(1));
+    m_Pa_axis.assign(reader.getAxis(2));
+    setGridShape();
+    reader.takeGrid(m_ownedGrid);
+    m_gridData = m_ownedGrid.data();
+
+    applyStoragePrecision();
+    if (m_mode == InterpolationMode::MonotoneTricubic) {
+        buildHermiteData();
+    }
+
+    m_isLoaded = true;
+    return true;
+}
+
+bool RPATableInterpolator::loadGrid(const std::vector<double>& Pc, const std::vector<double>& OF,
+                                    const std::vector<double>& Pa, const std::vector<PerformanceData>& points) {
+    clearTable();
+
+    const std::vector<double>* axisValues[3] = { &Pc, &OF, &Pa };
+    for (int a = 0; a < 3; ++a) {
+        const std::vector<double>& values = *axisValues[a];
+        if (values.empty()) {
+            return false;
+        }
+        for (size_t i = 1; i < values.size(); ++i) {
+            if (!(values[i] > values[i - 1])) {
+                return false;
+            }
+        }
+    }
+    if (points.size() != Pc.size() * OF.size() * Pa.size()) {
+        return false;
+    }
+
+    m_Pc_axis.assign(Pc);
+    m_OF_axis.assign(OF);
+    m_Pa_axis.assign(Pa);
+    setGridShape();
+
+    m_ownedGrid.resize(NUM_FIELDS * m_numPoints);
+    for (size_t i = 0; i < m_numPoints; ++i) {
+        const PerformanceData& p = points[i];
+        m_ownedGrid[FIELD_CF * m_numPoints + i] = p.Cf;
+        m_ownedGrid[FIELD_CSTAR * m_numPoints + i] = p.Cstar;
+        m_ownedGrid[FIELD_ISP * m_numPoints + i] = p.Isp;
+        m_ownedGrid[FIELD_VE * m_numPoints + i] = p.Ve;
+        m_ownedGrid[FIELD_PE * m_numPoints + i] = p.Pe;
+        m_ownedGrid[FIELD_GAMMA * m_numPoints + i] = p.gamma;
+    }
+    m_gridData = m_ownedGrid.data();
+
+    applyStoragePrecision();
+    if (m_mode == InterpolationMode::MonotoneTricubic) {
+        buildHermiteData();
+    }
+
+    m_isLoaded = true;
+    return true;
+}
+
+void RPATableInterpolator::clearTable() {
+    m_isLoaded = false;
+    m_generation = s_nextGeneration.fetch_add(1, std::memory_order_relaxed);
+    m_Pc_axis.clear();
+    m_OF_axis.clear();
+    m_Pa_axis.clear();
+    m_gridData = nullptr;
+    m_ownedGrid.clear();
+    m_mappedFile.reset();
+    m_tiles.reset();
+    m_floatGrid.clear();
+    m_fixedGrid.clear();
+    m_storage = StoragePrecision::Double;
+    m_quantizationError = ErrorReport();
+    m_hermite.clear();
+    m_numPoints = 0;
+    m_stridePc = 0;
+    m_strideOF = 0;
+    m_loadReport = TableCsvReader::Report();
+}
+
+void RPATableInterpolator::setGridShape() {
+    // Row-major strides: Pa varies fastest, so the 8 corners of a cell sit in
+    // four pairs of adjacent values
+    m_strideOF = m_Pa_axis.size();
+    m_stridePc = m_OF_axis.size() * m_strideOF;
+    m_numPoints = m_Pc_axis.size() * m_stridePc;
+}
+
+void RPATableInterpolator::setStoragePrecision(StoragePrecision precision) {
+    m_precision = precision;
+    if (m_isLoaded && precision != m_storage) {
+        m_generation = s_nextGeneration.fetch_add(1, std::memory_order_relaxed);
+        applyStoragePrecision();
+        if (m_mode == InterpolationMode::MonotoneTricubic) buildHermiteData();
+    }
+}
+
+size_t RPATableInterpolator::getGridBytes() const {
+    if (m_tiles) {
+        TiledGrid::Stats stats = m_tiles->getStats();
+        return stats.residentBricks * stats.brickBytes;
+    }
+    switch (m_storage) {
+    case StoragePrecision::Float32: return m_floatGrid.size() * sizeof(float);
+    case StoragePrecision::Fixed16: return m_fixedGrid.size() * sizeof(uint16_t);
+    default: return m_gridData ? NUM_FIELDS * m_numPoints * sizeof(double) : 0;
+    }
+}
+
+double RPATableInterpolator::storedValue(size_t index) const {
+    if (m_tiles) {
+        const size_t point = index % m_numPoints;
+        const size_t grid[3] = { point / m_stridePc, (point % m_stridePc) / m_strideOF, point % m_strideOF };
+        return m_tiles->value(index / m_numPoints, grid);
+    }
+    switch (m_storage) {
+    case StoragePrecision::Float32:
+        return m_floatGrid[index];
+    case StoragePrecision::Fixed16: {
+        size_t f = index / m_numPoints;
+        return m_fixedOffset[f] + m_fixedScale[f] * m_fixedGrid[index];
+    }
+    default:
+        return m_gridData[index];
+    }
+}
+
+const double* RPATableInterpolator::fieldValues(Field field, std::vector<double>& scratch) const {
+    if (m_storage == StoragePrecision::Double && !m_tiles) {
+        return fieldData(field);
+    }
+    scratch.resize(m_numPoints);
+    const size_t base = field * m_numPoints;
+    for (size_t i = 0; i < m_numPoints; ++i) {
+        scratch[i] = storedValue(base + i);
+    }
+    return scratch.data();
+}
+
+void RPATableInterpolator::applyStoragePrecision() {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    m_quantizationError = ErrorReport();
+    m_quantizationError.pointsCompared = m_numPoints;
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        FieldError& e = m_quantizationError.fields[f];
+        e.Pc = e.OF = e.Pa = nan;
+    }
+    if (m_precision == m_storage || m_tiles) {
+        return;
+    }
+
+    const size_t N = m_numPoints;
+    std::vector<float> floatGrid;
+    std::vector<uint16_t> fixedGrid;
+    std::vector<double> doubleGrid;
+    double scale[NUM_FIELDS], offset[NUM_FIELDS];
+    if (m_precision == StoragePrecision::Float32) floatGrid.resize(NUM_FIELDS * N);
+    if (m_precision == StoragePrecision::Fixed16) fixedGrid.assign(NUM_FIELDS * N + 1, 0);
+    if (m_precision == StoragePrecision::Double) doubleGrid.resize(NUM_FIELDS * N);
+
+    std::vector<double> scratch;
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        const double* values = fieldValues(static_cast<Field>(f), scratch);
+        const size_t base = f * N;
+
+        scale[f] = 0.0;
+        offset[f] = 0.0;
+        if (m_precision == StoragePrecision::Fixed16) {
+            double lo = *std::min_element(values, values + N);
+            double hi = *std::max_element(values, values + N);
+            offset[f] = lo;
+            scale[f] = (hi - lo) / FIXED16_LEVELS;
+        }
+
+        FieldError& e = m_quantizationError.fields[f];
+        for (size_t i = 0; i < N; ++i) {
+            double v = values[i];
+            double stored = v;
+            switch (m_precision) {
+            case StoragePrecision::Float32:
+                floatGrid[base + i] = static_cast<float>(v);
+                stored = floatGrid[base + i];
+                break;
+            case StoragePrecision::Fixed16: {
+                double q = scale[f] > 0.0 ? std::round((v - offset[f]) / scale[f]) : 0.0;
+                q = std::min(std::max(q, 0.0), FIXED16_LEVELS);
+                fixedGrid[base + i] = static_cast<uint16_t>(q);
+                stored = offset[f] + scale[f] * fixedGrid[base + i];
+                break;
+            }
+            default:
+                doubleGrid[base + i] = v;
+                break;
+            }
+
+            double err = std::abs(stored - v);
+            if (err > e.maxAbsError) {
+                e.maxAbsError = err;
+                e.Pc = m_Pc_axis[i / m_stridePc];
+                e.OF = m_OF_axis[(i / m_strideOF) % m_OF_axis.size()];
+                e.Pa = m_Pa_axis[i % m_Pa_axis.size()];
+            }
+            if (v != 0.0 && err / std::abs(v) > e.maxRelError) {
+                e.maxRelError = err / std::abs(v);
+            }
+        }
+    }
+
+    // Drop the previous storage, including a mapping
+    m_mappedFile.reset();
+    m_ownedGrid.swap(doubleGrid);
+    m_floatGrid.swap(floatGrid);
+    m_fixedGrid.swap(fixedGrid);
+    m_gridData = m_precision == StoragePrecision::Double ? m_ownedGrid.data() : nullptr;
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        m_fixedScale[f] = scale[f];
+        m_fixedOffset[f] = offset[f];
+    }
+    m_storage = m_precision;
+}
+
+void RPATableInterpolator::buildHermiteData() {
+    const size_t N = m_numPoints;
+    m_hermite.assign(NUM_FIELDS * N * HERMITE_STRIDE, 0.0);
+
+    // Derivative planes of one field, in grid order
+    std::vector<double> fx(N), fy(N), fz(N), fxy(N), fxz(N), fyz(N), fxyz(N);
+    std::vector<double> scratch;
+
+    auto differentiate = [&](const TableAxis& axis, size_t stride, const double* src,
+                             bool monotone, double* dst) {
+        forEachGridLine(N, axis.size(), stride, [&](size_t g) {
+            lineSlopes(axis, src + g, stride, monotone, dst + g);
+        });
+    };
+
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        const double* values = fieldValues(static_cast<Field>(f), scratch);
+
+        // First derivatives are limited so every grid line stays monotone
+        // between breakpoints; cross derivatives only shape cell interiors
+        // and are taken unlimited for accuracy
+        differentiate(m_Pc_axis, m_stridePc, values, true, fx.data());
+        differentiate(m_OF_axis, m_strideOF, values, true, fy.data());
+        differentiate(m_Pa_axis, 1, values, true, fz.data());
+        differentiate(m_OF_axis, m_strideOF, fx.data(), false, fxy.data());
+        differentiate(m_Pa_axis, 1, fx.data(), false, fxz.data());
+        differentiate(m_Pa_axis, 1, fy.data(), false, fyz.data());
+        differentiate(m_Pa_axis, 1, fxy.data(), false, fxyz.data());
+
+        double* out = m_hermite.data() + f * N * HERMITE_STRIDE;
+        for (size_t g = 0; g < N; ++g, out += HERMITE_STRIDE) {
+            out[0] = values[g];
+            out[1] = fx[g];
+            out[2] = fy[g];
+            out[3] = fz[g];
+            out[4] = fxy[g];
+            out[5] = fxz[g];
+            out[6] = fyz[g];
+            out[7] = fxyz[g];
+        }
+    }
+}
+
+void RPATableInterpolator::setInterpolationMode(InterpolationMode mode) {
+    if (mode == m_mode) {
+        return;
+    }
+    if (mode == InterpolationMode::MonotoneTricubic && m_tiles) {
+        throw std::invalid_argument("Tiled tables support trilinear interpolation only");
+    }
+    m_mode = mode;
+    if (mode == InterpolationMode::MonotoneTricubic) {
+        if (m_isLoaded) buildHermiteData();
+    } else {
+        std::vector<double>().swap(m_hermite);
+    }
+}
+
+RPATableInterpolator::ErrorReport
+RPATableInterpolator::compareWithReference(const RPATableInterpolator& reference) const {
+    if (!m_isLoaded || !reference.m_isLoaded) {
+        throw std::runtime_error("RPA table not loaded");
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    ErrorReport report;
+    report.pointsCompared = 0;
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        FieldError& e = report.fields[f];
+        e.maxAbsError = 0.0;
+        e.maxRelError = 0.0;
+        e.Pc = e.OF = e.Pa = nan;
+    }
+
+    const TableAxis& rPc = reference.m_Pc_axis;
+    const TableAxis& rOF = reference.m_OF_axis;
+    const TableAxis& rPa = reference.m_Pa_axis;
+
+    for (size_t i = 0; i < rPc.size(); ++i) {
+        if (rPc[i] < m_Pc_axis.front() || rPc[i] > m_Pc_axis.back()) continue;
+        for (size_t j = 0; j < rOF.size(); ++j) {
+            if (rOF[j] < m_OF_axis.front() || rOF[j] > m_OF_axis.back()) continue;
+            for (size_t k = 0; k < rPa.size(); ++k) {
+                if (rPa[k] < m_Pa_axis.front() || rPa[k] > m_Pa_axis.back()) continue;
+
+                PerformanceData p = getPerformance(rPc[i], rOF[j], rPa[k]);
+                const double got[NUM_FIELDS] = { p.Cf, p.Cstar, p.Isp, p.Ve, p.Pe, p.gamma };
+                size_t idx = reference.gridIndex(i, j, k);
+
+                for (int f = 0; f < NUM_FIELDS; ++f) {
+                    double expected = reference.storedValue(f * reference.m_numPoints + idx);
+                    double err = std::abs(got[f] - expected);
+                    FieldError& e = report.fields[f];
+                    if (err > e.maxAbsError) {
+                        e.maxAbsError = err;
+                        e.Pc = rPc[i];
+                        e.OF = rOF[j];
+                        e.Pa = rPa[k];
+                    }
+                    if (expected != 0.0 && err / std::abs(expected) > e.maxRelError) {
+                        e.maxRelError = err / std::abs(expected);
+                    }
+                }
+                ++report.pointsCompared;
+            }
+        }
+    }
+    return report;
+}
+
+bool RPATableInterpolator::loadCompiledTable(const std::string& filename, bool verifyChecksum) {
+    clearTable();
+
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+    if (!mapped->open(filename) || mapped->size() < sizeof(CompiledTableHeader)) {
+        return false;
+    }
 
-    std::string line;
+    CompiledTableHeader header;
+    std::memcpy(&header, mapped->data(), sizeof(header));
 
-    // Skip header line
-    std::getline(file, line);
+    if (std::memcmp(header.magic, COMPILED_MAGIC, sizeof(COMPILED_MAGIC)) != 0 ||
+        header.version != COMPILED_VERSION ||
+        header.endianTag != COMPILED_ENDIAN_TAG ||
+        header.headerSize != sizeof(CompiledTableHeader) ||
+        header.numFields != NUM_FIELDS ||
+        header.fileSize != mapped->size()) {
+        return false;
+    }
 
-    // Read data lines
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
+    // Validate the layout before trusting any offset
+    uint64_t axisCount = uint64_t(header.axisSize[0]) + header.axisSize[1] + header.axisSize[2];
+    uint64_t numPoints = uint64_t(header.axisSize[0]) * header.axisSize[1] * header.axisSize[2];
+    if (numPoints == 0 ||
+        header.axisOffset < header.headerSize ||
+        header.axisOffset + axisCount * sizeof(double) > header.gridOffset ||
+        header.gridOffset % COMPILED_ALIGNMENT != 0 ||
+        header.gridOffset + NUM_FIELDS * numPoints * sizeof(double) != header.fileSize) {
+        return false;
+    }
 
-        std::istringstream ss(line);
-        std::string token;
-        std::vector<double> values;
+    if (verifyChecksum &&
+        fnv1a(mapped->data() + header.headerSize, mapped->size() - header.headerSize) != header.checksum) {
+        return false;
+    }
 
-        // Parse CSV line
-        while (std::getline(ss, token, ',')) {
-            try {
-                values.push_back(std::stod(token));
-            } catch (...) {
-                continue; // Skip malformed lines
+    // Axes are tiny; copy them so TableAxis can own its lookup index
+    const double* axisData = reinterpret_cast<const double*>(mapped->data() + header.axisOffset);
+    TableAxis* axes[3] = { &m_Pc_axis, &m_OF_axis, &m_Pa_axis };
+    for (int a = 0; a < 3; ++a) {
+        std::vector<double> values(axisData, axisData + header.axisSize[a]);
+        for (size_t i = 1; i < values.size(); ++i) {
+            if (!(values[i] > values[i - 1])) {
+                clearTable();
+                return false;
             }
         }
+        axes[a]->assign(values);
+        axisData += header.axisSize[a];
+    }
+
+    setGridShape();
+
+    // Interpolate directly from the mapped pages
+    m_gridData = reinterpret_cast<const double*>(mapped->data() + header.gridOffset);
+    m_mappedFile = std::move(mapped);
+
+    applyStoragePrecision();
+    if (m_mode == InterpolationMode::MonotoneTricubic) {
+        buildHermiteData();
+    }
+
+    m_isLoaded = true;
+    return true;
+}
+
+bool RPATableInterpolator::saveCompiledTable(const std::string& filename) const {
+    if (!m_isLoaded) {
+        return false;
+    }
 
-        // Expected format: Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma
-        if (values.size() < 9) continue;
+    CompiledTableHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, COMPILED_MAGIC, sizeof(COMPILED_MAGIC));
+    header.version = COMPILED_VERSION;
+    header.endianTag = COMPILED_ENDIAN_TAG;
+    header.headerSize = sizeof(CompiledTableHeader);
+    header.numFields = NUM_FIELDS;
+    header.axisSize[0] = static_cast<uint32_t>(m_Pc_axis.size());
+    header.axisSize[1] = static_cast<uint32_t>(m_OF_axis.size());
+    header.axisSize[2] = static_cast<uint32_t>(m_Pa_axis.size());
+
+    uint64_t axisCount = m_Pc_axis.size() + m_OF_axis.size() + m_Pa_axis.size();
+    header.axisOffset = header.headerSize;
+    header.gridOffset = alignUp(header.axisOffset + axisCount * sizeof(double), COMPILED_ALIGNMENT);
+    header.fileSize = header.gridOffset + NUM_FIELDS * m_numPoints * sizeof(double);
+
+    // Assemble the payload (everything after the header) to checksum it
+    std::vector<unsigned char> payload(header.fileSize - header.headerSize, 0);
+    unsigned char* axisOut = payload.data() + (header.axisOffset - header.headerSize);
+    const TableAxis* axes[3] = { &m_Pc_axis, &m_OF_axis, &m_Pa_axis };
+    for (int a = 0; a < 3; ++a) {
+        size_t bytes = axes[a]->size() * sizeof(double);
+        std::memcpy(axisOut, axes[a]->data(), bytes);
+        axisOut += bytes;
+    }
+    // Reduced-precision grids are written widened, so the format is unchanged
+    unsigned char* gridOut = payload.data() + (header.gridOffset - header.headerSize);
+    std::vector<double> scratch;
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        std::memcpy(gridOut + f * m_numPoints * sizeof(double),
+                    fieldValues(static_cast<Field>(f), scratch), m_numPoints * sizeof(double));
+    }
 
-        TableEntry entry;
-        entry.Pc = values[0];
-        entry.OF = values[1];
-        entry.Pa = values[2];
-        entry.data.Cf = values[3];
-        entry.data.Cstar = values[4];
-        entry.data.Isp = values[5];
-        entry.data.Ve = values[6];
-        entry.data.Pe = values[7];
-        entry.data.gamma = values[8];
+    header.checksum = fnv1a(payload.data(), payload.size());
 
-        m_table.push_back(entry);
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
     }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    return static_cast<bool>(file);
+}
+
+bool RPATableInterpolator::compileTable(const std::string& csv_filename,
+                                        const std::string& compiled_filename) {
+    RPATableInterpolator table;
+    return table.loadTable(csv_filename) && table.saveCompiledTable(compiled_filename);
+}
+
+bool RPATableInterpolator::isCompiledFile(const unsigned char* data, size_t size) {
+    return size >= sizeof(COMPILED_MAGIC) && std::memcmp(data, COMPILED_MAGIC, sizeof(COMPILED_MAGIC)) == 0;
+}
+
+uint64_t RPATableInterpolator::contentHash(const unsigned char* data, size_t size) {
+    return fnv1a(data, size);
+}
+
 
-    file.close();
+bool RPATableInterpolator::isMemoryMapped() const {
+    return m_mappedFile && m_mappedFile->isMapped();
+}
+
+bool RPATableInterpolator::loadTiledTable(const std::string& filename, size_t cacheBytes) {
+    if (m_mode == InterpolationMode::MonotoneTricubic) {
+        throw std::invalid_argument("Tiled tables support trilinear interpolation only");
+    }
+    clearTable();
 
-    if (m_table.empty()) {
+    std::unique_ptr<TiledGrid> tiles(new TiledGrid());
+    tiles->setPrefetch(m_tilePrefetch);
+    if (!tiles->open(filename, NUM_FIELDS, cacheBytes)) {
         return false;
     }
 
-    // Build interpolation structure
-    buildInterpolationStructure();
+    m_Pc_axis.assign(tiles->getAxis(0));
+    m_OF_axis.assign(tiles->getAxis(1));
+    m_Pa_axis.assign(tiles->getAxis(2));
+    setGridShape();
+    m_tiles = std::move(tiles);
 
+    applyStoragePrecision();
     m_isLoaded = true;
     return true;
 }
 
-void RPATableInterpolator::buildInterpolationStructure() {
-    // Extract unique sorted values for each axis
-    std::set<double> Pc_set, OF_set, Pa_set;
+bool RPATableInterpolator::saveTiledTable(const std::string& filename, size_t brickCells) const {
+    if (!m_isLoaded) {
+        return false;
+    }
 
-    for (const auto& entry : m_table) {
-        Pc_set.insert(entry.Pc);
-        OF_set.insert(entry.OF);
-        Pa_set.insert(entry.Pa);
+    std::vector<double> scratch[NUM_FIELDS];
+    const double* fields[NUM_FIELDS];
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        fields[f] = fieldValues(static_cast<Field>(f), scratch[f]);
     }
+    const std::vector<double> axes[3] = { m_Pc_axis.values(), m_OF_axis.values(), m_Pa_axis.values() };
+    return TiledGrid::write(filename, axes, fields, NUM_FIELDS, brickCells);
+}
 
-    m_Pc_values.assign(Pc_set.begin(), Pc_set.end());
-    m_OF_values.assign(OF_set.begin(), OF_set.end());
-    m_Pa_values.assign(Pa_set.begin(), Pa_set.end());
+TiledGrid::Stats RPATableInterpolator::getTileStats() const {
+    return m_tiles ? m_tiles->getStats() : TiledGrid::Stats();
+}
 
-    // Build index map for fast lookup
-    for (size_t i = 0; i < m_table.size(); ++i) {
-        const auto& entry = m_table[i];
+void RPATableInterpolator::resetTileStats() {
+    if (m_tiles) m_tiles->resetStats();
+}
 
-        // Find indices
-        auto it_Pc = std::lower_bound(m_Pc_values.begin(), m_Pc_values.end(), entry.Pc);
-        auto it_OF = std::lower_bound(m_OF_values.begin(), m_OF_values.end(), entry.OF);
-        auto it_Pa = std::lower_bound(m_Pa_values.begin(), m_Pa_values.end(), entry.Pa);
+void RPATableInterpolator::setTilePrefetch(bool enabled) {
+    m_tilePrefetch = enabled;
+    if (m_tiles) m_tiles->setPrefetch(enabled);
+}
 
-        int Pc_idx = std::distance(m_Pc_values.begin(), it_Pc);
-        int OF_idx = std::distance(m_OF_values.begin(), it_OF);
-        int Pa_idx = std::distance(m_Pa_values.begin(), it_Pa);
+void RPATableInterpolator::cellIndices(const CellLocation& cell, size_t lower[3], size_t step[3]) const {
+    lower[0] = cell.i000 / m_stridePc;
+    lower[1] = (cell.i000 % m_stridePc) / m_strideOF;
+    lower[2] = cell.i000 % m_strideOF;
+    step[0] = cell.dPc ? 1 : 0;
+    step[1] = cell.dOF ? 1 : 0;
+    step[2] = cell.dPa ? 1 : 0;
+}
 
-        m_indexMap[{Pc_idx, OF_idx, Pa_idx}] = i;
+void RPATableInterpolator::fetchTiledCorners(unsigned fields, const CellLocation& cell,
+                                             double out[NUM_FIELDS][8]) const {
+    size_t lower[3], step[3];
+    cellIndices(cell, lower, step);
+
+    // Bricks overlap by one plane of points, so the whole cell is in one brick
+    TiledGrid::Cell brick;
+    m_tiles->locate(lower, step, brick);
+    const double* values = brick.brick->data() + brick.base;
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        if (fields & (1u << f)) Kernel::gatherCorners(values + f * brick.fieldStride, brick.delta, out[f]);
     }
 }
 
-void RPATableInterpolator::findBounds(const std::vector<double>& values, double value,
-                                      int& idx0, int& idx1, double& t) const {
-    // Clamp to table bounds
-    if (value <= values.front()) {
-        idx0 = idx1 = 0;
-        t = 0.0;
-        return;
+RPATableInterpolator::PerformanceData RPATableInterpolator::getPerformance(double Pc, double OF, double Pa) const {
+    return getFields<MASK_ALL>(Pc, OF, Pa);
+}
+
+void RPATableInterpolator::seatAxisCell(const TableAxis& axis, int cell, AxisCell& a) {
+    const int n = static_cast<int>(axis.size());
+    const double inf = std::numeric_limits<double>::infinity();
+
+    a.cell = cell;
+    if (cell <= 0) {
+        // Clamped low: value <= front
+        a.idx0 = a.idx1 = 0;
+        a.lo = -inf;
+        a.hi = std::nextafter(axis.front(), inf);
+    } else if (cell >= n) {
+        // Clamped high: value >= back
+        a.idx0 = a.idx1 = n - 1;
+        a.lo = axis.back();
+        a.hi = inf;
+    } else {
+        // Interior: values[cell-1] <= value < values[cell], and value > front
+        a.idx0 = cell - 1;
+        a.idx1 = cell;
+        a.lo = (cell == 1) ? std::nextafter(axis.front(), inf) : axis[cell - 1];
+        a.hi = axis[cell];
     }
-    if (value >= values.back()) {
-        idx0 = idx1 = values.size() - 1;
-        t = 0.0;
-        return;
+    a.v0 = axis[a.idx0];
+    a.width = axis[a.idx1] - axis[a.idx0];
+}
+
+int RPATableInterpolator::findAxisCell(const TableAxis& axis, double value) {
+    int idx0, idx1;
+    double t;
+    axis.findBounds(value, idx0, idx1, t);
+    if (idx0 != idx1) {
+        return idx1;
+    }
+    return (idx0 == 0 && !(value >= axis.back())) ? 0 : static_cast<int>(axis.size());
+}
+
+InterpolationCursor::InterpolationCursor()
+    : m_table(nullptr)
+    , m_generation(0)
+    , m_loadedFields(0) {
+    resetStats();
+}
+
+void InterpolationCursor::resetStats() {
+    m_stats.queries = 0;
+    m_stats.cellHits = 0;
+    m_stats.neighbourHits = 0;
+    m_stats.fullSearches = 0;
+}
+
+void RPATableInterpolator::moveCursor(InterpolationCursor& cursor, double Pc, double OF, double Pa) const {
+    const TableAxis* axes[3] = { &m_Pc_axis, &m_OF_axis, &m_Pa_axis };
+    const double values[3] = { Pc, OF, Pa };
+    bool fullSearch = false;
+    const bool moving = cursor.m_table == this && cursor.m_generation == m_generation;
+    int previous[3] = { 0, 0, 0 };
+    if (moving) {
+        for (int a = 0; a < 3; ++a) previous[a] = cursor.m_axis[a].cell;
+    }
+
+    if (!moving) {
+        // New table (or reloaded one): search every axis
+        for (int a = 0; a < 3; ++a) {
+            seatAxisCell(*axes[a], findAxisCell(*axes[a], values[a]), cursor.m_axis[a]);
+        }
+        cursor.m_table = this;
+        cursor.m_generation = m_generation;
+        fullSearch = true;
+    } else {
+        for (int a = 0; a < 3; ++a) {
+            AxisCell& cell = cursor.m_axis[a];
+            if (cell.contains(values[a])) {
+                continue;
+            }
+
+            // Try the neighbouring cell in the direction of travel first
+            int step = (values[a] >= cell.hi) ? 1 : -1;
+            AxisCell next;
+            seatAxisCell(*axes[a], cell.cell + step, next);
+            if (next.contains(values[a])) {
+                cell = next;
+            } else {
+                seatAxisCell(*axes[a], findAxisCell(*axes[a], values[a]), cell);
+                fullSearch = true;
+            }
+        }
     }
 
-    // Binary search for upper bound
-    auto it = std::upper_bound(values.begin(), values.end(), value);
-    idx1 = std::distance(values.begin(), it);
-    idx0 = idx1 - 1;
+    if (fullSearch) {
+        ++cursor.m_stats.fullSearches;
+    } else {
+        ++cursor.m_stats.neighbourHits;
+    }
 
-    // Calculate interpolation factor
-    double v0 = values[idx0];
-    double v1 = values[idx1];
-    t = (value - v0) / (v1 - v0);
+    const AxisCell* axis = cursor.m_axis;
+    CellLocation& loc = cursor.m_cell;
+    loc.i000 = gridIndex(axis[0].idx0, axis[1].idx0, axis[2].idx0);
+    loc.dPc = (axis[0].idx1 - axis[0].idx0) * m_stridePc;
+    loc.dOF = (axis[1].idx1 - axis[1].idx0) * m_strideOF;
+    loc.dPa = axis[2].idx1 - axis[2].idx0;
+    cursor.m_loadedFields = 0;
+
+    // Read bricks ahead of the trajectory
+    if (m_tiles && moving) {
+        size_t lower[3], step[3];
+        cellIndices(loc, lower, step);
+        int direction[3];
+        for (int a = 0; a < 3; ++a) {
+            direction[a] = (axis[a].cell > previous[a]) - (axis[a].cell < previous[a]);
+        }
+        m_tiles->prefetchAhead(lower, direction);
+    }
 }
 
-double RPATableInterpolator::trilinearInterp(double c000, double c001, double c010, double c011,
-                                             double c100, double c101, double c110, double c111,
-                                             double tx, double ty, double tz) const {
-    // Interpolate along x (Pc)
-    double c00 = c000 * (1.0 - tx) + c100 * tx;
-    double c01 = c001 * (1.0 - tx) + c101 * tx;
-    double c10 = c010 * (1.0 - tx) + c110 * tx;
-    double c11 = c011 * (1.0 - tx) + c111 * tx;
+void RPATableInterpolator::cubicCellFromCursor(const InterpolationCursor& cursor,
+                                               double Pc, double OF, double Pa,
+                                               CubicLocation& cell) const {
+    const AxisCell* axis = cursor.m_axis;
+    int Pc_idx, OF_idx, Pa_idx;
+
+    cell.dPc = cubicAxisWeights(m_Pc_axis, axis[0].idx0, axis[0].idx1, axis[0].factor(Pc),
+                                Pc_idx, cell.wx) * m_stridePc;
+    cell.dOF = cubicAxisWeights(m_OF_axis, axis[1].idx0, axis[1].idx1, axis[1].factor(OF),
+                                OF_idx, cell.wy) * m_strideOF;
+    cell.dPa = cubicAxisWeights(m_Pa_axis, axis[2].idx0, axis[2].idx1, axis[2].factor(Pa),
+                                Pa_idx, cell.wz);
+    cell.i000 = gridIndex(Pc_idx, OF_idx, Pa_idx);
+}
 
-    // Interpolate along y (OF)
-    double c0 = c00 * (1.0 - ty) + c10 * ty;
-    double c1 = c01 * (1.0 - ty) + c11 * ty;
+void RPATableInterpolator::locateCell(double Pc, double OF, double Pa, CellLocation& cell,
+                                      double width[3]) const {
+    const TableAxis* axes[3] = { &m_Pc_axis, &m_OF_axis, &m_Pa_axis };
+    const double values[3] = { Pc, OF, Pa };
+    double* t[3] = { &cell.tx, &cell.ty, &cell.tz };
+    int idx0[3], idx1[3];
 
-    // Interpolate along z (Pa)
-    double c = c0 * (1.0 - tz) + c1 * tz;
+    for (int a = 0; a < 3; ++a) {
+        axes[a]->findBounds(values[a], idx0[a], idx1[a], *t[a]);
+        width[a] = (*axes[a])[idx1[a]] - (*axes[a])[idx0[a]];
+    }
 
-    return c;
+    cell.i000 = gridIndex(idx0[0], idx0[1], idx0[2]);
+    cell.dPc = (idx1[0] - idx0[0]) * m_stridePc;
+    cell.dOF = (idx1[1] - idx0[1]) * m_strideOF;
+    cell.dPa = idx1[2] - idx0[2];
 }
 
-const RPATableInterpolator::TableEntry* RPATableInterpolator::getEntry(int Pc_idx, int OF_idx, int Pa_idx) const {
-    auto it = m_indexMap.find({Pc_idx, OF_idx, Pa_idx});
-    if (it != m_indexMap.end()) {
-        return &m_table[it->second];
+void RPATableInterpolator::cubicSlopeCells(const CubicLocation& cell, const int idx0[3], const int idx1[3],
+                                           const double t[3], CubicLocation slopes[3]) const {
+    const TableAxis* axes[3] = { &m_Pc_axis, &m_OF_axis, &m_Pa_axis };
+    for (int a = 0; a < 3; ++a) {
+        slopes[a] = cell;
+        double (*w)[2] = (a == 0) ? slopes[a].wx : (a == 1) ? slopes[a].wy : slopes[a].wz;
+        cubicAxisSlopeWeights(*axes[a], idx0[a], idx1[a], t[a], w);
     }
-    return nullptr;
 }
 
-RPATableInterpolator::PerformanceData RPATableInterpolator::getPerformance(double Pc, double OF, double Pa) const {
+void RPATableInterpolator::locateCubicGradient(double Pc, double OF, double Pa,
+                                               CubicLocation& cell, CubicLocation slopes[3]) const {
+    int idx0[3], idx1[3], Pc_idx, OF_idx, Pa_idx;
+    double t[3];
+
+    m_Pc_axis.findBounds(Pc, idx0[0], idx1[0], t[0]);
+    cell.dPc = cubicAxisWeights(m_Pc_axis, idx0[0], idx1[0], t[0], Pc_idx, cell.wx) * m_stridePc;
+    m_OF_axis.findBounds(OF, idx0[1], idx1[1], t[1]);
+    cell.dOF = cubicAxisWeights(m_OF_axis, idx0[1], idx1[1], t[1], OF_idx, cell.wy) * m_strideOF;
+    m_Pa_axis.findBounds(Pa, idx0[2], idx1[2], t[2]);
+    cell.dPa = cubicAxisWeights(m_Pa_axis, idx0[2], idx1[2], t[2], Pa_idx, cell.wz);
+    cell.i000 = gridIndex(Pc_idx, OF_idx, Pa_idx);
+
+    cubicSlopeCells(cell, idx0, idx1, t, slopes);
+}
+
+void RPATableInterpolator::cubicGradientFromCursor(const InterpolationCursor& cursor,
+                                                   double Pc, double OF, double Pa,
+                                                   CubicLocation& cell, CubicLocation slopes[3]) const {
+    const AxisCell* axis = cursor.m_axis;
+    const int idx0[3] = { axis[0].idx0, axis[1].idx0, axis[2].idx0 };
+    const int idx1[3] = { axis[0].idx1, axis[1].idx1, axis[2].idx1 };
+    const double t[3] = { axis[0].factor(Pc), axis[1].factor(OF), axis[2].factor(Pa) };
+
+    cubicCellFromCursor(cursor, Pc, OF, Pa, cell);
+    cubicSlopeCells(cell, idx0, idx1, t, slopes);
+}
+
+void RPATableInterpolator::getPerformanceBatch(const double* Pc, const double* OF, const double* Pa,
+                                               size_t count, const PerformanceBatch& out) const {
     if (!m_isLoaded) {
         throw std::runtime_error("RPA table not loaded");
     }
 
-    // Find bounding indices and interpolation factors
-    int Pc_idx0, Pc_idx1, OF_idx0, OF_idx1, Pa_idx0, Pa_idx1;
-    double tx, ty, tz;
-
-    findBounds(m_Pc_values, Pc, Pc_idx0, Pc_idx1, tx);
-    findBounds(m_OF_values, OF, OF_idx0, OF_idx1, ty);
-    findBounds(m_Pa_values, Pa, Pa_idx0, Pa_idx1, tz);
-
-    // Get 8 corner values (vertices of the interpolation cube)
-    const TableEntry* e000 = getEntry(Pc_idx0, OF_idx0, Pa_idx0);
-    const TableEntry* e001 = getEntry(Pc_idx0, OF_idx0, Pa_idx1);
-    const TableEntry* e010 = getEntry(Pc_idx0, OF_idx1, Pa_idx0);
-    const TableEntry* e011 = getEntry(Pc_idx0, OF_idx1, Pa_idx1);
-    const TableEntry* e100 = getEntry(Pc_idx1, OF_idx0, Pa_idx0);
-    const TableEntry* e101 = getEntry(Pc_idx1, OF_idx0, Pa_idx1);
-    const TableEntry* e110 = getEntry(Pc_idx1, OF_idx1, Pa_idx0);
-    const TableEntry* e111 = getEntry(Pc_idx1, OF_idx1, Pa_idx1);
-
-    // Check if all corners exist (handle edge cases)
-    if (!e000 || !e001 || !e010 || !e011 || !e100 || !e101 || !e110 || !e111) {
-        // Fallback: return nearest neighbor
-        if (e000) return e000->data;
-        throw std::runtime_error("Unable to interpolate: missing table entries");
-    }
-
-    // Perform trilinear interpolation for each parameter
-    PerformanceData result;
-
-    result.Cf = trilinearInterp(
-        e000->data.Cf, e001->data.Cf, e010->data.Cf, e011->data.Cf,
-        e100->data.Cf, e101->data.Cf, e110->data.Cf, e111->data.Cf,
-        tx, ty, tz
-    );
-
-    result.Cstar = trilinearInterp(
-        e000->data.Cstar, e001->data.Cstar, e010->data.Cstar, e011->data.Cstar,
-        e100->data.Cstar, e101->data.Cstar, e110->data.Cstar, e111->data.Cstar,
-        tx, ty, tz
-    );
-
-    result.Isp = trilinearInterp(
-        e000->data.Isp, e001->data.Isp, e010->data.Isp, e011->data.Isp,
-        e100->data.Isp, e101->data.Isp, e110->data.Isp, e111->data.Isp,
-        tx, ty, tz
-    );
-
-    result.Ve = trilinearInterp(
-        e000->data.Ve, e001->data.Ve, e010->data.Ve, e011->data.Ve,
-        e100->data.Ve, e101->data.Ve, e110->data.Ve, e111->data.Ve,
-        tx, ty, tz
-    );
-
-    result.Pe = trilinearInterp(
-        e000->data.Pe, e001->data.Pe, e010->data.Pe, e011->data.Pe,
-        e100->data.Pe, e101->data.Pe, e110->data.Pe, e111->data.Pe,
-        tx, ty, tz
-    );
-
-    result.gamma = trilinearInterp(
-        e000->data.gamma, e001->data.gamma, e010->data.gamma, e011->data.gamma,
-        e100->data.gamma, e101->data.gamma, e110->data.gamma, e111->data.gamma,
-        tx, ty, tz
-    );
-
-    return result;
+    // The vector kernels implement the trilinear scheme over an in-memory grid only
+    SimdLevel level = (m_mode == InterpolationMode::Trilinear && !m_tiles) ? m_simdLevel : SimdLevel::Scalar;
+
+    switch (level) {
+    case SimdLevel::AVX512:
+        getPerformanceBatchAVX512(Pc, OF, Pa, count, out);
+        break;
+    case SimdLevel::AVX2:
+        getPerformanceBatchAVX2(Pc, OF, Pa, count, out);
+        break;
+    default:
+        getPerformanceBatchScalar(Pc, OF, Pa, 0, count, out);
+        break;
+    }
+
+    if (!m_verifyBatch) {
+        return;
+    }
+
+    // Re-evaluate every point on the scalar path and compare bit patterns
+    for (size_t i = 0; i < count; ++i) {
+        PerformanceData ref = getPerformance(Pc[i], OF[i], Pa[i]);
+        double got[NUM_FIELDS] = { out.Cf[i], out.Cstar[i], out.Isp[i],
+                                   out.Ve[i], out.Pe[i], out.gamma[i] };
+        double expected[NUM_FIELDS] = { ref.Cf, ref.Cstar, ref.Isp,
+                                        ref.Ve, ref.Pe, ref.gamma };
+        if (std::memcmp(got, expected, sizeof(got)) != 0) {
+            throw std::runtime_error("Batched interpolation differs from scalar at point " +
+                                     std::to_string(i));
+        }
+    }
+}
+
+void RPATableInterpolator::setSimdLevel(SimdLevel level) {
+    SimdLevel supported = detectSimdLevel();
+    m_simdLevel = (static_cast<int>(level) > static_cast<int>(supported)) ? supported : level;
 }
 
 void RPATableInterpolator::getBounds(double& Pc_min, double& Pc_max,
@@ -238,10 +947,10 @@ void RPATableInterpolator::getBounds(double& Pc_min, double& Pc_max,
         throw std::runtime_error("RPA table not loaded");
     }
 
-    Pc_min = m_Pc_values.front();
-    Pc_max = m_Pc_values.back();
-    OF_min = m_OF_values.front();
-    OF_max = m_OF_values.back();
-    Pa_min = m_Pa_values.front();
-    Pa_max = m_Pa_values.back();
+    Pc_min = m_Pc_axis.front();
+    Pc_max = m_Pc_axis.back();
+    OF_min = m_OF_axis.front();
+    OF_max = m_OF_axis.back();
+    Pa_min = m_Pa_axis.front();
+    Pa_max = m_Pa_axis.back();
 }
@@ -1,16 +1,35 @@
 #ifndef RPA_TABLE_INTERPOLATOR_H
 #define RPA_TABLE_INTERPOLATOR_H
 
+#include "TableAxis.h"
+#include "MultilinearKernel.h"
+#include "TableInterpolatorND.h"
+#include "TableCsvReader.h"
+#include "TiledGrid.h"
+#include "Instrumentation.h"
 #include <vector>
 #include <string>
-#include <map>
-#include <array>
+#include <memory>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+class MappedFile;
+class InterpolationCursor;
 
 /**
  * RPATableInterpolator
  *
  * Loads and interpolates RPA performance tables generated by generate_rpa_tables.js
- * Uses trilinear interpolation for 3D lookup (Pc, O/F, Pa)
+ * Uses trilinear interpolation for 3D lookup (Pc, O/F, Pa), or optionally a
+ * monotone tricubic Hermite interpolant that reaches the same accuracy on a
+ * much coarser grid
+ *
+ * The trilinear path is the 3D instance of MultilinearKernel; tables with
+ * further axes (area ratio, propellant temperature) use RPAPerformanceTable<N>.
  */
 class RPATableInterpolator {
 public:
@@ -24,16 +43,189 @@ public:
         double gamma;       // Ratio of specific heats
     };
 
+    // Performance fields, in the order they are stored in the dense grid
+    enum Field {
+        FIELD_CF = 0,
+        FIELD_CSTAR,
+        FIELD_ISP,
+        FIELD_VE,
+        FIELD_PE,
+        FIELD_GAMMA,
+        NUM_FIELDS
+    };
+
+    // Field sets for getFields, combined with |
+    enum FieldMask : unsigned {
+        MASK_CF = 1u << FIELD_CF,
+        MASK_CSTAR = 1u << FIELD_CSTAR,
+        MASK_ISP = 1u << FIELD_ISP,
+        MASK_VE = 1u << FIELD_VE,
+        MASK_PE = 1u << FIELD_PE,
+        MASK_GAMMA = 1u << FIELD_GAMMA,
+        MASK_ALL = (1u << NUM_FIELDS) - 1
+    };
+
+    /**
+     * Structure-of-arrays output for getPerformanceBatch
+     * Each pointer must reference at least `count` writable doubles
+     */
+    struct PerformanceBatch {
+        double* Cf;
+        double* Cstar;
+        double* Isp;
+        double* Ve;
+        double* Pe;
+        double* gamma;
+    };
+
+    // Instruction set used by the batched kernels
+    enum class SimdLevel {
+        Scalar,
+        AVX2,
+        AVX512
+    };
+
+    // Interpolation scheme used by every query path
+    enum class InterpolationMode {
+        Trilinear,          // Exact at grid points, C0 between cells
+        MonotoneTricubic    // Tensor-product cubic Hermite, C1, no overshoot along grid lines
+    };
+
+    // Storage format of the dense grid; interpolation always runs in double
+    enum class StoragePrecision {
+        Double,     // 8 bytes per value
+        Float32,    // 4 bytes per value, about 7 significant digits
+        Fixed16     // 2 bytes per value, 65536 levels spanning each field's range
+    };
+
+    // Largest deviation of one field from a reference table (see compareWithReference)
+    struct FieldError {
+        double maxAbsError;
+        double maxRelError;     // Relative to |reference|, skipping zero references
+        double Pc, OF, Pa;      // Where maxAbsError occurred
+    };
+
+    struct ErrorReport {
+        FieldError fields[NUM_FIELDS];
+        size_t pointsCompared;
+    };
+
+    // Partial derivatives of every field (see getPerformanceWithGradient)
+    struct PerformanceGradient {
+        PerformanceData dPc;    // Per psi
+        PerformanceData dOF;    // Per unit mixture ratio
+        PerformanceData dPa;    // Per psi
+    };
+
     RPATableInterpolator();
     ~RPATableInterpolator();
 
+    // Grid storage may point into a memory-mapped file, so tables are not copied
+    RPATableInterpolator(const RPATableInterpolator&) = delete;
+    RPATableInterpolator& operator=(const RPATableInterpolator&) = delete;
+
     /**
      * Load RPA table from CSV file
+     * The table must cover the full (Pc, O/F, Pa) grid; a table with missing
+     * grid points is rejected here rather than at query time. The file is
+     * parsed in parallel (see TableCsvReader); getLoadReport() lists rows
+     * skipped, grid points repeated and grid points missing.
      * @param filename Path to CSV file generated by generate_rpa_tables.js
      * @return true if successful, false otherwise
      */
     bool loadTable(const std::string& filename);
 
+    /**
+     * Load a table from values already in memory
+     * @param Pc, OF, Pa Strictly increasing breakpoints of each axis
+     * @param points One entry per grid point, ordered [Pc][OF][Pa] with Pa
+     *               varying fastest
+     * @return false if an axis is empty or not increasing, or the point
+     *         count does not match the axes
+     */
+    bool loadGrid(const std::vector<double>& Pc, const std::vector<double>& OF,
+                  const std::vector<double>& Pa, const std::vector<PerformanceData>& points);
+
+    /**
+     * Load a compiled binary table (see compileTable)
+     * The file is memory-mapped and queries read the grid straight from the
+     * mapped pages, so worker processes loading the same file share one
+     * physical copy. Only the (small) axis breakpoints are copied.
+     * @param filename Path to compiled table
+     * @param verifyChecksum Check the payload checksum (touches every page once)
+     * @return true if successful, false if missing, corrupt or wrong version
+     */
+    bool loadCompiledTable(const std::string& filename, bool verifyChecksum = true);
+
+    /**
+     * Write the loaded table in the compiled binary format
+     * @param filename Output path
+     * @return true if successful
+     */
+    bool saveCompiledTable(const std::string& filename) const;
+
+    /**
+     * Convert a CSV table to the compiled binary format
+     * @param csv_filename CSV generated by generate_rpa_tables.js
+     * @param compiled_filename Output path for the compiled table
+     * @return true if successful
+     */
+    static bool compileTable(const std::string& csv_filename, const std::string& compiled_filename);
+
+    /**
+     * True if file contents start like a compiled table
+     */
+    static bool isCompiledFile(const unsigned char* data, size_t size);
+
+    /**
+     * FNV-1a hash of file contents, as used for compiled table checksums
+     */
+    static uint64_t contentHash(const unsigned char* data, size_t size);
+
+
+    /**
+     * True if the grid is served from a memory-mapped compiled table
+     */
+    bool isMemoryMapped() const;
+
+    /**
+     * Load a tiled table (see saveTiledTable) for out-of-core use
+     * Only the axes and brick index are read here; bricks are read on demand
+     * into an LRU cache of at most cacheBytes, shared by every thread
+     * querying this table, so memory follows the region queries visit.
+     * Queries through an InterpolationCursor read bricks ahead along the
+     * cursor's direction of travel. Tiled tables are held in Double and
+     * interpolated trilinearly; the batch runs on the scalar path.
+     * @param cacheBytes Brick cache budget (at least one brick is kept)
+     * @return true if successful, false if missing, corrupt or wrong version
+     * @throws std::invalid_argument in MonotoneTricubic mode
+     */
+    bool loadTiledTable(const std::string& filename, size_t cacheBytes = TiledGrid::DEFAULT_CACHE_BYTES);
+
+    /**
+     * Write the loaded table as bricks of brickCells cells per edge (fewer
+     * along shorter axes)
+     * @return true if successful
+     */
+    bool saveTiledTable(const std::string& filename, size_t brickCells = TiledGrid::DEFAULT_BRICK_CELLS) const;
+
+    /**
+     * True if the grid is served from a tiled table's brick cache
+     */
+    bool isTiled() const { return m_tiles != nullptr; }
+
+    /**
+     * Brick cache hits, misses, prefetches and occupancy (zero unless tiled)
+     */
+    TiledGrid::Stats getTileStats() const;
+    void resetTileStats();
+
+    /**
+     * Read bricks ahead of cursors (default on), for the loaded tiled table
+     * and later loads; not to be changed while other threads query
+     */
+    void setTilePrefetch(bool enabled);
+
     /**
      * Get performance data at specific operating conditions using trilinear interpolation
      * @param Pc Chamber pressure (psi)
@@ -43,6 +235,141 @@ public:
      */
     PerformanceData getPerformance(double Pc, double OF, double Pa) const;
 
+    /**
+     * Select the interpolation scheme
+     * MonotoneTricubic derives limited (Fritsch-Carlson) slopes and cross
+     * derivatives at every grid point, now and on every later load, and keeps
+     * them next to the grid; the cubic then needs only the 8 cell corners.
+     * Trilinear results are unchanged by switching modes.
+     * @param mode Scheme for getPerformance, getFields and getPerformanceBatch
+     * @throws std::invalid_argument for MonotoneTricubic with a tiled table loaded
+     */
+    void setInterpolationMode(InterpolationMode mode);
+    InterpolationMode getInterpolationMode() const { return m_mode; }
+
+    /**
+     * Select how grid values are stored
+     * Reduced precision halves (Float32) or quarters (Fixed16, with a
+     * per-field scale and offset) the grid's memory and cache footprint.
+     * Corner values are widened to double before interpolating. Applies to
+     * the loaded table now and to every later load; a compiled table is
+     * then converted into owned memory rather than served from the mapping.
+     * Tiled tables are not converted.
+     * Precision lost to an earlier, coarser setting is only recovered by
+     * reloading.
+     */
+    void setStoragePrecision(StoragePrecision precision);
+    StoragePrecision getStoragePrecision() const { return m_precision; }
+
+    /**
+     * Worst quantisation error per field from the last conversion to the
+     * current storage precision (zero in Double), measured against the
+     * values before conversion, with the grid point where it occurred
+     */
+    const ErrorReport& getQuantizationError() const { return m_quantizationError; }
+
+    /**
+     * Bytes used by the grid values in the current storage precision (for a
+     * tiled table, by the bricks now in its cache)
+     */
+    size_t getGridBytes() const;
+
+    /**
+     * Measure interpolation error against a denser reference table
+     * Interpolates this table (in the current mode) at every reference grid
+     * point inside this table's bounds and records the worst deviation per field.
+     * @param reference Table sampled more finely over the same space
+     */
+    ErrorReport compareWithReference(const RPATableInterpolator& reference) const;
+
+    /**
+     * Interpolate only the fields selected at compile time
+     * Only the selected fields' grid blocks are read and blended, e.g.
+     * getFields<MASK_CF>() does a sixth of the work of getPerformance().
+     * Selected fields are bit-identical to getPerformance; the rest are NaN.
+     * @tparam Fields Combination of FieldMask values
+     * @param Pc Chamber pressure (psi)
+     * @param OF Mixture ratio (oxidizer/fuel mass ratio)
+     * @param Pa Ambient pressure (psi)
+     */
+    template <unsigned Fields>
+    PerformanceData getFields(double Pc, double OF, double Pa) const;
+
+    /**
+     * Interpolate through a per-trajectory cursor
+     * The cursor remembers the last cell and its corner values; if the point
+     * is still in that cell (or one step away along each axis) no search or
+     * corner fetch is repeated. Results are bit-identical to the cursor-free
+     * calls.
+     * @param cursor Cursor owned by the calling trajectory (not thread-safe)
+     */
+    template <unsigned Fields>
+    PerformanceData getFields(double Pc, double OF, double Pa, InterpolationCursor& cursor) const;
+
+    PerformanceData getPerformance(double Pc, double OF, double Pa, InterpolationCursor& cursor) const {
+        return getFields<MASK_ALL>(Pc, OF, Pa, cursor);
+    }
+
+    /**
+     * Interpolate with the exact partial derivatives of the interpolant
+     * Derivatives are those of the cell the point falls in (at a breakpoint,
+     * the cell above it), in the current interpolation mode. Along an axis
+     * where the point is clamped to the table edge they are zero, matching
+     * the constant extrapolation. Values are bit-identical to getPerformance.
+     * @param gradient Output: d(field)/dPc, d(field)/dOF and d(field)/dPa
+     */
+    PerformanceData getPerformanceWithGradient(double Pc, double OF, double Pa,
+                                               PerformanceGradient& gradient) const {
+        return getFieldsWithGradient<MASK_ALL>(Pc, OF, Pa, gradient);
+    }
+
+    /**
+     * Values and partial derivatives of the fields selected at compile time
+     * (the rest, and their derivatives, are NaN)
+     */
+    template <unsigned Fields>
+    PerformanceData getFieldsWithGradient(double Pc, double OF, double Pa,
+                                          PerformanceGradient& gradient) const;
+
+    template <unsigned Fields>
+    PerformanceData getFieldsWithGradient(double Pc, double OF, double Pa,
+                                          PerformanceGradient& gradient, InterpolationCursor& cursor) const;
+
+    /**
+     * Evaluate many operating points in one call
+     * Inputs and outputs are structure-of-arrays; point i is (Pc[i], OF[i], Pa[i]).
+     * Results are bit-identical to calling getPerformance for each point.
+     * The SIMD kernels are trilinear; in MonotoneTricubic mode the batch runs
+     * on the scalar path.
+     * @param Pc Chamber pressures (psi)
+     * @param OF Mixture ratios
+     * @param Pa Ambient pressures (psi)
+     * @param count Number of points
+     * @param out Output arrays, each with room for count values
+     */
+    void getPerformanceBatch(const double* Pc, const double* OF, const double* Pa,
+                             size_t count, const PerformanceBatch& out) const;
+
+    /**
+     * Widest SIMD level supported by the running CPU
+     */
+    static SimdLevel detectSimdLevel();
+
+    /**
+     * Select the kernel used by getPerformanceBatch
+     * Requests above detectSimdLevel() are lowered to the supported level.
+     * Defaults to the detected level.
+     */
+    void setSimdLevel(SimdLevel level);
+    SimdLevel getSimdLevel() const { return m_simdLevel; }
+
+    /**
+     * Bit-exact verification mode for getPerformanceBatch
+     * When enabled, every batch is also evaluated with the scalar path and a
+     * std::runtime_error is thrown if any output differs in any bit.
+     */
+    void setBatchVerification(bool enabled) { m_verifyBatch = enabled; }
+
     /**
      * Check if table is loaded and valid
      */
@@ -55,41 +382,179 @@ public:
                    double& OF_min, double& OF_max,
                    double& Pa_min, double& Pa_max) const;
 
+    /**
+     * Axis breakpoints of the loaded table
+     */
+    const std::vector<double>& getPcBreakpoints() const { return m_Pc_axis.values(); }
+    const std::vector<double>& getOFBreakpoints() const { return m_OF_axis.values(); }
+    const std::vector<double>& getPaBreakpoints() const { return m_Pa_axis.values(); }
+
+    /**
+     * Number of grid points missing from the last table passed to loadTable
+     * (zero when the load succeeded)
+     */
+    size_t getMissingPointCount() const { return m_loadReport.holeCount; }
+
+    /**
+     * Diagnostics from the last loadTable (empty after the other loaders)
+     */
+    const TableCsvReader::Report& getLoadReport() const { return m_loadReport; }
+
 private:
-    // Table entry structure
-    struct TableEntry {
-        double Pc;          // Chamber pressure (psi)
-        double OF;          // Mixture ratio
-        double Pa;          // Ambient pressure (psi)
-        PerformanceData data;
+    typedef MultilinearKernel<3> Kernel;    // Axes Pc, OF, Pa
+
+    // Unique sorted axis values for interpolation, with O(1) cell lookup
+    TableAxis m_Pc_axis;
+    TableAxis m_OF_axis;
+    TableAxis m_Pa_axis;
+
+    // Dense grid storage: NUM_FIELDS contiguous blocks of m_numPoints values,
+    // each laid out [Pc_idx][OF_idx][Pa_idx] in row-major order. In Double
+    // storage m_gridData points either at m_ownedGrid (CSV load) or into
+    // m_mappedFile; reduced precisions keep the same layout in m_floatGrid or
+    // m_fixedGrid, where value = offset + scale * stored.
+    const double* m_gridData;
+    std::vector<double> m_ownedGrid;
+    std::unique_ptr<MappedFile> m_mappedFile;
+    std::unique_ptr<TiledGrid> m_tiles;     // Tiled table; m_gridData is then null
+    bool m_tilePrefetch;
+    StoragePrecision m_precision;   // Requested for this and later loads
+    StoragePrecision m_storage;     // Format the grid is held in now
+    std::vector<float> m_floatGrid;
+    std::vector<uint16_t> m_fixedGrid;  // One padding value at the end for 32-bit vector gathers
+    double m_fixedScale[NUM_FIELDS];
+    double m_fixedOffset[NUM_FIELDS];
+    ErrorReport m_quantizationError;
+    size_t m_numPoints;
+    size_t m_stridePc;      // Pa stride is 1, OF stride is m_Pa_axis.size()
+    size_t m_strideOF;
+    TableCsvReader::Report m_loadReport;
+
+    bool m_isLoaded;
+    uint64_t m_generation;  // Unique per load so cursors notice stale cells
+
+    SimdLevel m_simdLevel;
+    bool m_verifyBatch;
+
+    // Hermite data for MonotoneTricubic: NUM_FIELDS blocks of m_numPoints
+    // records, each HERMITE_STRIDE values {f, f_Pc, f_OF, f_Pa, f_PcOF,
+    // f_PcPa, f_OFPa, f_PcOFPa} (derivatives in axis units), so one cell
+    // corner is one cache line
+    static const size_t HERMITE_STRIDE = 8;
+    InterpolationMode m_mode;
+    std::vector<double> m_hermite;
+
+    // Cell containing a query point: lowest corner and the offsets to the
+    // upper corner along each axis (zero when clamped to that edge)
+    struct CellLocation {
+        size_t i000;
+        size_t dPc;
+        size_t dOF;
+        size_t dPa;
+        double tx, ty, tz;  // Interpolation factors [0,1]
     };
 
-    // Storage
-    std::vector<TableEntry> m_table;
+    // Cursor cell along one axis. cell is 0 when clamped low, size() when
+    // clamped high, otherwise the upper breakpoint index. The cell covers
+    // values in [lo, hi).
+    struct AxisCell {
+        int cell;
+        int idx0, idx1;
+        double lo, hi;
+        double v0, width;
 
-    // Unique sorted axis values for interpolation
-    std::vector<double> m_Pc_values;
-    std::vector<double> m_OF_values;
-    std::vector<double> m_Pa_values;
+        bool contains(double value) const {
+            return value >= lo && value < hi;
+        }
 
-    // 3D index lookup: [Pc_idx][OF_idx][Pa_idx] -> table entry index
-    std::map<std::array<int, 3>, size_t> m_indexMap;
+        double factor(double value) const {
+            // Same expression as TableAxis::findBounds
+            return idx0 == idx1 ? 0.0 : (value - v0) / width;
+        }
+    };
 
-    bool m_isLoaded;
+    // Cubic cell: lowest corner, offsets to the upper corner (zero only for
+    // single-point axes) and per-axis Hermite weights, where w[i][0] weighs
+    // the value and w[i][1] the slope at corner i of that axis
+    struct CubicLocation {
+        size_t i000;
+        size_t dPc;
+        size_t dOF;
+        size_t dPa;
+        double wx[2][2], wy[2][2], wz[2][2];
+    };
+
+    /**
+     * Instrumentation: count evaluated points, non-finite coordinates and
+     * coordinates clamped at each table edge (no-ops unless
+     * RPA_INSTRUMENTATION is defined)
+     */
+    void countQuery(double Pc, double OF, double Pa) const;
+    void countQueries(const double* Pc, const double* OF, const double* Pa, size_t count) const;
 
     // Helper functions
-    void buildInterpolationStructure();
+    void clearTable();
+    void setGridShape();
+    void buildHermiteData();
+
+    /**
+     * Convert the grid from its current storage to m_precision and record
+     * the quantisation error
+     */
+    void applyStoragePrecision();
+
+    /**
+     * Grid value (widened to double) at an offset into the field blocks
+     */
+    double storedValue(size_t index) const;
 
     /**
-     * Find bounding indices for a value in a sorted array
-     * @param values Sorted array of values
-     * @param value Value to find bounds for
-     * @param idx0 Output: lower bound index
-     * @param idx1 Output: upper bound index
-     * @param t Output: interpolation factor [0,1]
+     * One field's values as doubles: the grid block itself in Double
+     * storage, otherwise widened into scratch
      */
-    void findBounds(const std::vector<double>& values, double value,
-                    int& idx0, int& idx1, double& t) const;
+    const double* fieldValues(Field field, std::vector<double>& scratch) const;
+
+    /**
+     * Hermite weights along one axis from a bounds lookup; clamped points
+     * use the end cell with t = 0 or 1 so they reproduce the edge values
+     * @return Offset of the upper corner in breakpoints (0 or 1)
+     */
+    static int cubicAxisWeights(const TableAxis& axis, int idx0, int idx1, double t,
+                                int& lower, double w[2][2]);
+
+    /**
+     * Find the cubic cell for a query point
+     */
+    void locateCubicCell(double Pc, double OF, double Pa, CubicLocation& cell) const;
+
+    /**
+     * Cubic cell from a cursor's axis cells
+     */
+    void cubicCellFromCursor(const InterpolationCursor& cursor, double Pc, double OF, double Pa,
+                             CubicLocation& cell) const;
+
+    /**
+     * Derivative of the Hermite weights along one axis, per unit of the
+     * axis variable (zero when clamped or for a single-point axis)
+     */
+    static void cubicAxisSlopeWeights(const TableAxis& axis, int idx0, int idx1, double t,
+                                      double dw[2][2]);
+
+    /**
+     * Cubic cell plus, for each axis, a copy whose weights along that axis
+     * are differentiated; interpolating over slopes[a] gives d/d(axis a)
+     */
+    void locateCubicGradient(double Pc, double OF, double Pa,
+                             CubicLocation& cell, CubicLocation slopes[3]) const;
+    void cubicGradientFromCursor(const InterpolationCursor& cursor, double Pc, double OF, double Pa,
+                                 CubicLocation& cell, CubicLocation slopes[3]) const;
+    void cubicSlopeCells(const CubicLocation& cell, const int idx0[3], const int idx1[3],
+                         const double t[3], CubicLocation slopes[3]) const;
+
+    /**
+     * Tricubic Hermite interpolation of one field over a located cell
+     */
+    double interpolateFieldCubic(Field field, const CubicLocation& cell) const;
 
     /**
      * Trilinear interpolation
@@ -101,10 +566,575 @@ private:
                           double tx, double ty, double tz) const;
 
     /**
-     * Get table entry at specific grid indices
-     * Returns nullptr if indices are out of bounds
+     * Trilinear interpolation with derivatives by tx, ty and tz
+     * @param c Corner values in trilinearInterp order
+     * @param dt Output: partial derivatives by each interpolation factor
+     * @return Same value as trilinearInterp
+     */
+    static double trilinearGradient(const double c[8], double tx, double ty, double tz, double dt[3]);
+
+    /**
+     * Offset of a grid point within a field block
+     */
+    size_t gridIndex(int Pc_idx, int OF_idx, int Pa_idx) const {
+        return Pc_idx * m_stridePc + OF_idx * m_strideOF + Pa_idx;
+    }
+
+    /**
+     * Start of the contiguous block holding one field (Double storage)
+     */
+    const double* fieldData(Field field) const {
+        return m_gridData + field * m_numPoints;
+    }
+    const float* floatFieldData(Field field) const {
+        return m_floatGrid.data() + field * m_numPoints;
+    }
+    const uint16_t* fixedFieldData(Field field) const {
+        return m_fixedGrid.data() + field * m_numPoints;
+    }
+
+    /**
+     * The 8 corner values of one field over a located cell, widened to
+     * double, in trilinearInterp argument order
+     */
+    template <typename T>
+    static void readCorners(const T* c, const CellLocation& cell, double out[8]) {
+        const size_t delta[3] = { cell.dPc, cell.dOF, cell.dPa };
+        Kernel::gatherCorners(c, delta, out);
+    }
+    void fetchCorners(Field field, const CellLocation& cell, double out[8]) const;
+
+    /**
+     * Corner values of the selected fields from a tiled table, with one
+     * brick lookup for all of them
+     */
+    void fetchTiledCorners(unsigned fields, const CellLocation& cell, double out[NUM_FIELDS][8]) const;
+
+    /**
+     * Grid indices of a cell's lowest corner and its extent (0 or 1) along
+     * each axis
+     */
+    void cellIndices(const CellLocation& cell, size_t lower[3], size_t step[3]) const;
+
+    /**
+     * Find the cell and interpolation factors for a query point
+     */
+    void locateCell(double Pc, double OF, double Pa, CellLocation& cell) const;
+
+    /**
+     * Find the cell for a query point, plus its width along each axis
+     * (0 where the point is clamped to the table edge)
+     */
+    void locateCell(double Pc, double OF, double Pa, CellLocation& cell, double width[3]) const;
+
+    /**
+     * Trilinear interpolation of one field over a located cell
+     */
+    double interpolateField(Field field, const CellLocation& cell) const;
+
+    /**
+     * Count a cursor query and move the cursor if the point left its cell
+     */
+    void seatCursor(InterpolationCursor& cursor, double Pc, double OF, double Pa) const;
+
+    /**
+     * Fetch the corner values of the selected fields not yet in the cursor
+     */
+    void loadCursorCorners(InterpolationCursor& cursor, unsigned fields) const;
+
+    static PerformanceData makePerformanceData(const double values[NUM_FIELDS]) {
+        PerformanceData result = { values[FIELD_CF], values[FIELD_CSTAR], values[FIELD_ISP],
+                                   values[FIELD_VE], values[FIELD_PE], values[FIELD_GAMMA] };
+        return result;
+    }
+
+    /**
+     * Re-seat a cursor whose cached cell does not contain the query point
+     */
+    void moveCursor(InterpolationCursor& cursor, double Pc, double OF, double Pa) const;
+
+    /**
+     * Cursor cell code of a value along one axis (see InterpolationCursor)
+     */
+    static int findAxisCell(const TableAxis& axis, double value);
+
+    /**
+     * Fill a cursor axis for a cell code, including the value range it covers
+     */
+    static void seatAxisCell(const TableAxis& axis, int cell, AxisCell& a);
+
+    friend class InterpolationCursor;
+
+    // Batched kernels (RPATableInterpolatorSimd.cpp); each handles every
+    // point and falls back to the scalar path for the tail
+    void getPerformanceBatchScalar(const double* Pc, const double* OF, const double* Pa,
+                                   size_t begin, size_t end, const PerformanceBatch& out) const;
+    void getPerformanceBatchAVX2(const double* Pc, const double* OF, const double* Pa,
+                                 size_t count, const PerformanceBatch& out) const;
+    void getPerformanceBatchAVX512(const double* Pc, const double* OF, const double* Pa,
+                                   size_t count, const PerformanceBatch& out) const;
+};
+
+/**
+ * InterpolationCursor
+ *
+ * Per-trajectory lookup state for RPATableInterpolator. Successive timesteps
+ * of one trajectory usually land in the same (Pc, O/F, Pa) cell or the one
+ * next to it, so the cursor keeps the last cell's axis bounds and corner
+ * values and only falls back to a full axis lookup when the point has moved
+ * further than one cell.
+ *
+ * A cursor is cheap to copy and must not be shared between threads.
+ */
+class InterpolationCursor {
+public:
+    // Lookup outcome counters
+    struct Stats {
+        uint64_t queries;       // Total queries through this cursor
+        uint64_t cellHits;      // Point was still in the cached cell
+        uint64_t neighbourHits; // Resolved by stepping to adjacent cells
+        uint64_t fullSearches;  // At least one axis needed a full lookup
+    };
+
+    InterpolationCursor();
+
+    /**
+     * Forget the cached cell (statistics are kept)
      */
-    const TableEntry* getEntry(int Pc_idx, int OF_idx, int Pa_idx) const;
+    void invalidate() { m_table = nullptr; }
+
+    const Stats& getStats() const { return m_stats; }
+    void resetStats();
+
+    /**
+     * Fraction of queries answered from the cached cell without any search
+     */
+    double getHitRate() const {
+        return m_stats.queries ? double(m_stats.cellHits) / m_stats.queries : 0.0;
+    }
+
+private:
+    friend class RPATableInterpolator;
+
+    const RPATableInterpolator* m_table;
+    uint64_t m_generation;
+    RPATableInterpolator::AxisCell m_axis[3];     // Pc, OF, Pa
+    RPATableInterpolator::CellLocation m_cell;
+    unsigned m_loadedFields;
+    double m_corners[RPATableInterpolator::NUM_FIELDS][8];
+    Stats m_stats;
+};
+
+/**
+ * Field set of RPATableInterpolator, for tables with more axes than
+ * (Pc, O/F, Pa): RPAPerformanceTable<4> over (Pc, O/F, Pa, Ae/At) reads the
+ * CSV that generate_rpa_tables.js writes for a list of expansion ratios.
+ * Fields are indexed by RPATableInterpolator::Field.
+ */
+struct RPAPerformanceFields {
+    static const size_t COUNT = RPATableInterpolator::NUM_FIELDS;
 };
 
+template <size_t N>
+using RPAPerformanceTable = TableInterpolatorND<N, RPAPerformanceFields>;
+
+// ================================================================
+// Inline query path
+// ================================================================
+
+inline double RPATableInterpolator::trilinearInterp(double c000, double c001, double c010, double c011,
+                                                    double c100, double c101, double c110, double c111,
+                                                    double tx, double ty, double tz) const {
+    // Interpolate along x (Pc), then y (OF), then z (Pa)
+    double c[8] = { c000, c001, c010, c011, c100, c101, c110, c111 };
+    const double t[3] = { tx, ty, tz };
+    return Kernel::blend(c, t);
+}
+
+inline double RPATableInterpolator::trilinearGradient(const double c[8], double tx, double ty, double tz,
+                                                      double dt[3]) {
+    // Same operations as trilinearInterp for the value
+    double corners[8] = { c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7] };
+    const double t[3] = { tx, ty, tz };
+    return Kernel::gradient(corners, t, dt);
+}
+
+inline void RPATableInterpolator::countQuery(double Pc, double OF, double Pa) const {
+#ifdef RPA_INSTRUMENTATION
+    RPA_COUNT(INTERPOLATOR_QUERIES);
+    if (!std::isfinite(Pc) || !std::isfinite(OF) || !std::isfinite(Pa)) RPA_COUNT(NON_FINITE_QUERIES);
+    if (Pc < m_Pc_axis.front()) RPA_COUNT(PC_BELOW_TABLE);
+    else if (Pc > m_Pc_axis.back()) RPA_COUNT(PC_ABOVE_TABLE);
+    if (OF < m_OF_axis.front()) RPA_COUNT(OF_BELOW_TABLE);
+    else if (OF > m_OF_axis.back()) RPA_COUNT(OF_ABOVE_TABLE);
+    if (Pa < m_Pa_axis.front()) RPA_COUNT(PA_BELOW_TABLE);
+    else if (Pa > m_Pa_axis.back()) RPA_COUNT(PA_ABOVE_TABLE);
+#else
+    (void)Pc;
+    (void)OF;
+    (void)Pa;
+#endif
+}
+
+inline void RPATableInterpolator::countQueries(const double* Pc, const double* OF, const double* Pa,
+                                               size_t count) const {
+#ifdef RPA_INSTRUMENTATION
+    for (size_t i = 0; i < count; ++i) countQuery(Pc[i], OF[i], Pa[i]);
+#else
+    (void)Pc;
+    (void)OF;
+    (void)Pa;
+    (void)count;
+#endif
+}
+
+inline void RPATableInterpolator::locateCell(double Pc, double OF, double Pa, CellLocation& cell) const {
+    // Find bounding indices and interpolation factors
+    int Pc_idx0, Pc_idx1, OF_idx0, OF_idx1, Pa_idx0, Pa_idx1;
+
+    m_Pc_axis.findBounds(Pc, Pc_idx0, Pc_idx1, cell.tx);
+    m_OF_axis.findBounds(OF, OF_idx0, OF_idx1, cell.ty);
+    m_Pa_axis.findBounds(Pa, Pa_idx0, Pa_idx1, cell.tz);
+
+    cell.i000 = gridIndex(Pc_idx0, OF_idx0, Pa_idx0);
+    cell.dPc = (Pc_idx1 - Pc_idx0) * m_stridePc;
+    cell.dOF = (OF_idx1 - OF_idx0) * m_strideOF;
+    cell.dPa = Pa_idx1 - Pa_idx0;
+}
+
+inline void RPATableInterpolator::fetchCorners(Field field, const CellLocation& cell, double out[8]) const {
+    if (m_tiles) {
+        double corners[NUM_FIELDS][8];
+        fetchTiledCorners(1u << field, cell, corners);
+        std::copy(corners[field], corners[field] + 8, out);
+        return;
+    }
+    switch (m_storage) {
+    case StoragePrecision::Float32:
+        readCorners(floatFieldData(field) + cell.i000, cell, out);
+        break;
+    case StoragePrecision::Fixed16: {
+        readCorners(fixedFieldData(field) + cell.i000, cell, out);
+        const double offset = m_fixedOffset[field];
+        const double scale = m_fixedScale[field];
+        for (int i = 0; i < 8; ++i) out[i] = offset + scale * out[i];
+        break;
+    }
+    default:
+        readCorners(fieldData(field) + cell.i000, cell, out);
+        break;
+    }
+}
+
+inline double RPATableInterpolator::interpolateField(Field field, const CellLocation& cell) const {
+    double c[8];
+    fetchCorners(field, cell, c);
+    return trilinearInterp(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], cell.tx, cell.ty, cell.tz);
+}
+
+inline int RPATableInterpolator::cubicAxisWeights(const TableAxis& axis, int idx0, int idx1, double t,
+                                                  int& lower, double w[2][2]) {
+    const int n = static_cast<int>(axis.size());
+    if (n < 2) {
+        // Single breakpoint: constant along this axis
+        lower = 0;
+        w[0][0] = 1.0; w[0][1] = 0.0;
+        w[1][0] = 0.0; w[1][1] = 0.0;
+        return 0;
+    }
+    if (idx0 == idx1) {
+        // Clamped: evaluate the end cell at its edge
+        if (idx0 == 0) {
+            t = 0.0;
+        } else {
+            idx0 = n - 2;
+            t = 1.0;
+        }
+    }
+    lower = idx0;
+
+    const double h = axis[idx0 + 1] - axis[idx0];
+    const double t2 = t * t;
+    const double t3 = t2 * t;
+    w[0][0] = 2.0 * t3 - 3.0 * t2 + 1.0;
+    w[0][1] = h * (t3 - 2.0 * t2 + t);
+    w[1][0] = 3.0 * t2 - 2.0 * t3;
+    w[1][1] = h * (t3 - t2);
+    return 1;
+}
+
+inline void RPATableInterpolator::cubicAxisSlopeWeights(const TableAxis& axis, int idx0, int idx1, double t,
+                                                       double dw[2][2]) {
+    if (axis.size() < 2 || idx0 == idx1) {
+        // Constant along this axis (single point, or clamped to an edge)
+        dw[0][0] = dw[0][1] = dw[1][0] = dw[1][1] = 0.0;
+        return;
+    }
+    const double h = axis[idx1] - axis[idx0];
+    const double t2 = t * t;
+    dw[0][0] = 6.0 * (t2 - t) / h;
+    dw[0][1] = 3.0 * t2 - 4.0 * t + 1.0;
+    dw[1][0] = 6.0 * (t - t2) / h;
+    dw[1][1] = 3.0 * t2 - 2.0 * t;
+}
+
+inline void RPATableInterpolator::locateCubicCell(double Pc, double OF, double Pa, CubicLocation& cell) const {
+    int idx0, idx1, Pc_idx, OF_idx, Pa_idx;
+    double t;
+
+    m_Pc_axis.findBounds(Pc, idx0, idx1, t);
+    cell.dPc = cubicAxisWeights(m_Pc_axis, idx0, idx1, t, Pc_idx, cell.wx) * m_stridePc;
+    m_OF_axis.findBounds(OF, idx0, idx1, t);
+    cell.dOF = cubicAxisWeights(m_OF_axis, idx0, idx1, t, OF_idx, cell.wy) * m_strideOF;
+    m_Pa_axis.findBounds(Pa, idx0, idx1, t);
+    cell.dPa = cubicAxisWeights(m_Pa_axis, idx0, idx1, t, Pa_idx, cell.wz);
+
+    cell.i000 = gridIndex(Pc_idx, OF_idx, Pa_idx);
+}
+
+inline double RPATableInterpolator::interpolateFieldCubic(Field field, const CubicLocation& cell) const {
+    const double* base = m_hermite.data() + (field * m_numPoints + cell.i000) * HERMITE_STRIDE;
+    const size_t offsets[2][3] = { { 0, 0, 0 }, { cell.dPc, cell.dOF, cell.dPa } };
+
+    // Sum of w_x * w_y * w_z * derivative over the 8 corners and the 8
+    // derivative combinations at each corner
+    double sum = 0.0;
+    for (int i = 0; i < 2; ++i) {
+        const double* wx = cell.wx[i];
+        for (int j = 0; j < 2; ++j) {
+            const double* wy = cell.wy[j];
+            for (int k = 0; k < 2; ++k) {
+                const double* wz = cell.wz[k];
+                const double* d = base + (offsets[i][0] + offsets[j][1] + offsets[k][2]) * HERMITE_STRIDE;
+                double y0 = wy[0] * (wz[0] * d[0] + wz[1] * d[3]) + wy[1] * (wz[0] * d[2] + wz[1] * d[6]);
+                double y1 = wy[0] * (wz[0] * d[1] + wz[1] * d[5]) + wy[1] * (wz[0] * d[4] + wz[1] * d[7]);
+                sum += wx[0] * y0 + wx[1] * y1;
+            }
+        }
+    }
+    return sum;
+}
+
+template <unsigned Fields>
+RPATableInterpolator::PerformanceData RPATableInterpolator::getFields(double Pc, double OF, double Pa) const {
+    static_assert(Fields != 0 && (Fields & ~static_cast<unsigned>(MASK_ALL)) == 0,
+                  "getFields needs a non-empty combination of FieldMask values");
+
+    if (!m_isLoaded) {
+        throw std::runtime_error("RPA table not loaded");
+    }
+    countQuery(Pc, OF, Pa);
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    PerformanceData result = { nan, nan, nan, nan, nan, nan };
+
+    if (m_mode == InterpolationMode::MonotoneTricubic) {
+        CubicLocation cubic;
+        locateCubicCell(Pc, OF, Pa, cubic);
+        if (Fields & MASK_CF) result.Cf = interpolateFieldCubic(FIELD_CF, cubic);
+        if (Fields & MASK_CSTAR) result.Cstar = interpolateFieldCubic(FIELD_CSTAR, cubic);
+        if (Fields & MASK_ISP) result.Isp = interpolateFieldCubic(FIELD_ISP, cubic);
+        if (Fields & MASK_VE) result.Ve = interpolateFieldCubic(FIELD_VE, cubic);
+        if (Fields & MASK_PE) result.Pe = interpolateFieldCubic(FIELD_PE, cubic);
+        if (Fields & MASK_GAMMA) result.gamma = interpolateFieldCubic(FIELD_GAMMA, cubic);
+        return result;
+    }
+
+    CellLocation cell;
+    locateCell(Pc, OF, Pa, cell);
+
+    if (m_tiles) {
+        double c[NUM_FIELDS][8];
+        double values[NUM_FIELDS] = { nan, nan, nan, nan, nan, nan };
+        fetchTiledCorners(Fields, cell, c);
+        for (int f = 0; f < NUM_FIELDS; ++f) {
+            if (!(Fields & (1u << f))) continue;
+            values[f] = trilinearInterp(c[f][0], c[f][1], c[f][2], c[f][3], c[f][4], c[f][5], c[f][6], c[f][7],
+                                        cell.tx, cell.ty, cell.tz);
+        }
+        return makePerformanceData(values);
+    }
+
+    if (Fields & MASK_CF) result.Cf = interpolateField(FIELD_CF, cell);
+    if (Fields & MASK_CSTAR) result.Cstar = interpolateField(FIELD_CSTAR, cell);
+    if (Fields & MASK_ISP) result.Isp = interpolateField(FIELD_ISP, cell);
+    if (Fields & MASK_VE) result.Ve = interpolateField(FIELD_VE, cell);
+    if (Fields & MASK_PE) result.Pe = interpolateField(FIELD_PE, cell);
+    if (Fields & MASK_GAMMA) result.gamma = interpolateField(FIELD_GAMMA, cell);
+
+    return result;
+}
+
+inline void RPATableInterpolator::seatCursor(InterpolationCursor& cursor, double Pc, double OF, double Pa) const {
+    ++cursor.m_stats.queries;
+    if (cursor.m_table == this && cursor.m_generation == m_generation &&
+        cursor.m_axis[0].contains(Pc) &&
+        cursor.m_axis[1].contains(OF) &&
+        cursor.m_axis[2].contains(Pa)) {
+        ++cursor.m_stats.cellHits;
+    } else {
+        moveCursor(cursor, Pc, OF, Pa);
+    }
+}
+
+inline void RPATableInterpolator::loadCursorCorners(InterpolationCursor& cursor, unsigned fields) const {
+    unsigned missing = fields & ~cursor.m_loadedFields;
+    if (!missing) {
+        return;
+    }
+    if (m_tiles) {
+        fetchTiledCorners(missing, cursor.m_cell, cursor.m_corners);
+        cursor.m_loadedFields |= missing;
+        return;
+    }
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        if (!(missing & (1u << f))) continue;
+        fetchCorners(static_cast<Field>(f), cursor.m_cell, cursor.m_corners[f]);
+    }
+    cursor.m_loadedFields |= missing;
+}
+
+template <unsigned Fields>
+RPATableInterpolator::PerformanceData RPATableInterpolator::getFields(double Pc, double OF, double Pa,
+                                                                      InterpolationCursor& cursor) const {
+    static_assert(Fields != 0 && (Fields & ~static_cast<unsigned>(MASK_ALL)) == 0,
+                  "getFields needs a non-empty combination of FieldMask values");
+
+    if (!m_isLoaded) {
+        throw std::runtime_error("RPA table not loaded");
+    }
+    countQuery(Pc, OF, Pa);
+
+    seatCursor(cursor, Pc, OF, Pa);
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double values[NUM_FIELDS] = { nan, nan, nan, nan, nan, nan };
+
+    if (m_mode == InterpolationMode::MonotoneTricubic) {
+        // Corner records are read in place; the cursor only saves the search
+        CubicLocation cubic;
+        cubicCellFromCursor(cursor, Pc, OF, Pa, cubic);
+        for (int f = 0; f < NUM_FIELDS; ++f) {
+            if (Fields & (1u << f)) values[f] = interpolateFieldCubic(static_cast<Field>(f), cubic);
+        }
+        PerformanceData result = { values[FIELD_CF], values[FIELD_CSTAR], values[FIELD_ISP],
+                                   values[FIELD_VE], values[FIELD_PE], values[FIELD_GAMMA] };
+        return result;
+    }
+
+    // Fetch corners of any field this cell has not needed yet
+    const AxisCell* axis = cursor.m_axis;
+    loadCursorCorners(cursor, Fields);
+
+    const double tx = axis[0].factor(Pc);
+    const double ty = axis[1].factor(OF);
+    const double tz = axis[2].factor(Pa);
+
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        if (!(Fields & (1u << f))) continue;
+        const double* c = cursor.m_corners[f];
+        values[f] = trilinearInterp(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], tx, ty, tz);
+    }
+
+    PerformanceData result = { values[FIELD_CF], values[FIELD_CSTAR], values[FIELD_ISP],
+                               values[FIELD_VE], values[FIELD_PE], values[FIELD_GAMMA] };
+    return result;
+}
+
+template <unsigned Fields>
+RPATableInterpolator::PerformanceData RPATableInterpolator::getFieldsWithGradient(
+        double Pc, double OF, double Pa, PerformanceGradient& gradient) const {
+    static_assert(Fields != 0 && (Fields & ~static_cast<unsigned>(MASK_ALL)) == 0,
+                  "getFieldsWithGradient needs a non-empty combination of FieldMask values");
+
+    if (!m_isLoaded) {
+        throw std::runtime_error("RPA table not loaded");
+    }
+    countQuery(Pc, OF, Pa);
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double values[NUM_FIELDS], slopes[3][NUM_FIELDS];
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        values[f] = slopes[0][f] = slopes[1][f] = slopes[2][f] = nan;
+    }
+
+    if (m_mode == InterpolationMode::MonotoneTricubic) {
+        CubicLocation cubic, slopeCells[3];
+        locateCubicGradient(Pc, OF, Pa, cubic, slopeCells);
+        for (int f = 0; f < NUM_FIELDS; ++f) {
+            if (!(Fields & (1u << f))) continue;
+            values[f] = interpolateFieldCubic(static_cast<Field>(f), cubic);
+            for (int a = 0; a < 3; ++a) {
+                slopes[a][f] = interpolateFieldCubic(static_cast<Field>(f), slopeCells[a]);
+            }
+        }
+    } else {
+        CellLocation cell;
+        double width[3];
+        locateCell(Pc, OF, Pa, cell, width);
+        for (int f = 0; f < NUM_FIELDS; ++f) {
+            if (!(Fields & (1u << f))) continue;
+            double c[8];
+            fetchCorners(static_cast<Field>(f), cell, c);
+            double dt[3];
+            values[f] = trilinearGradient(c, cell.tx, cell.ty, cell.tz, dt);
+            for (int a = 0; a < 3; ++a) slopes[a][f] = width[a] == 0.0 ? 0.0 : dt[a] / width[a];
+        }
+    }
+
+    gradient.dPc = makePerformanceData(slopes[0]);
+    gradient.dOF = makePerformanceData(slopes[1]);
+    gradient.dPa = makePerformanceData(slopes[2]);
+    return makePerformanceData(values);
+}
+
+template <unsigned Fields>
+RPATableInterpolator::PerformanceData RPATableInterpolator::getFieldsWithGradient(
+        double Pc, double OF, double Pa, PerformanceGradient& gradient, InterpolationCursor& cursor) const {
+    static_assert(Fields != 0 && (Fields & ~static_cast<unsigned>(MASK_ALL)) == 0,
+                  "getFieldsWithGradient needs a non-empty combination of FieldMask values");
+
+    if (!m_isLoaded) {
+        throw std::runtime_error("RPA table not loaded");
+    }
+    countQuery(Pc, OF, Pa);
+
+    seatCursor(cursor, Pc, OF, Pa);
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double values[NUM_FIELDS], slopes[3][NUM_FIELDS];
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        values[f] = slopes[0][f] = slopes[1][f] = slopes[2][f] = nan;
+    }
+
+    if (m_mode == InterpolationMode::MonotoneTricubic) {
+        CubicLocation cubic, slopeCells[3];
+        cubicGradientFromCursor(cursor, Pc, OF, Pa, cubic, slopeCells);
+        for (int f = 0; f < NUM_FIELDS; ++f) {
+            if (!(Fields & (1u << f))) continue;
+            values[f] = interpolateFieldCubic(static_cast<Field>(f), cubic);
+            for (int a = 0; a < 3; ++a) {
+                slopes[a][f] = interpolateFieldCubic(static_cast<Field>(f), slopeCells[a]);
+            }
+        }
+    } else {
+        loadCursorCorners(cursor, Fields);
+        const AxisCell* axis = cursor.m_axis;
+        const double t[3] = { axis[0].factor(Pc), axis[1].factor(OF), axis[2].factor(Pa) };
+        for (int f = 0; f < NUM_FIELDS; ++f) {
+            if (!(Fields & (1u << f))) continue;
+            double dt[3];
+            values[f] = trilinearGradient(cursor.m_corners[f], t[0], t[1], t[2], dt);
+            for (int a = 0; a < 3; ++a) {
+                slopes[a][f] = axis[a].idx0 == axis[a].idx1 ? 0.0 : dt[a] / axis[a].width;
+            }
+        }
+    }
+
+    gradient.dPc = makePerformanceData(slopes[0]);
+    gradient.dOF = makePerformanceData(slopes[1]);
+    gradient.dPa = makePerformanceData(slopes[2]);
+    return makePerformanceData(values);
+}
+
 #endif // RPA_TABLE_INTERPOLATOR_H
@@ -0,0 +1,431 @@
+/**
+ * RPATableInterpolatorSimd.cpp
+ *
+ * Batched kernels for RPATableInterpolator::getPerformanceBatch.
+ *
+ * The AVX2 and AVX-512 kernels are compiled with per-function target
+ * attributes and selected at runtime, so the rest of the build does not need
+ * -mavx2. They perform exactly the same IEEE operations in the same order as
+ * the scalar path (no FMA), which keeps the results bit-identical to
+ * getPerformance as long as the scalar code is also built without FP
+ * contraction (-ffp-contract=off).
+ */
+
+#include "RPATableInterpolator.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define RPA_HAVE_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define RPA_HAVE_X86_KERNELS 0
+#endif
+
+// GCC contracts separate intrinsic multiplies and adds into FMA by default,
+// and -mavx512f implies FMA; keep the kernels' rounding identical to scalar
+#if defined(__GNUC__) && !defined(__clang__)
+#define RPA_NO_CONTRACT , optimize("fp-contract=off")
+#else
+#define RPA_NO_CONTRACT
+#endif
+
+RPATableInterpolator::SimdLevel RPATableInterpolator::detectSimdLevel() {
+#if RPA_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+void RPATableInterpolator::getPerformanceBatchScalar(const double* Pc, const double* OF, const double* Pa,
+                                                     size_t begin, size_t end,
+                                                     const PerformanceBatch& out) const {
+    for (size_t i = begin; i < end; ++i) {
+        PerformanceData p = getPerformance(Pc[i], OF[i], Pa[i]);
+        out.Cf[i] = p.Cf;
+        out.Cstar[i] = p.Cstar;
+        out.Isp[i] = p.Isp;
+        out.Ve[i] = p.Ve;
+        out.Pe[i] = p.Pe;
+        out.gamma[i] = p.gamma;
+    }
+}
+
+#if RPA_HAVE_X86_KERNELS
+
+namespace {
+
+// ================================================================
+// AVX2: 4 lanes, 64-bit indices
+// ================================================================
+
+#define RPA_TARGET_AVX2 __attribute__((target("avx2") RPA_NO_CONTRACT))
+
+/**
+ * Vector version of TableAxis::findBounds
+ * Same bucket guess and correction as the scalar lookup, with the same
+ * clamping rules; lanes that clamp get idx0 == idx1 and t == 0.
+ */
+RPA_TARGET_AVX2 inline void findBoundsAVX2(const TableAxis& axis, __m256d v,
+                                           __m256i& idx0, __m256i& idx1, __m256d& t) {
+    const double* values = axis.data();
+    const long long n = static_cast<long long>(axis.size());
+
+    if (n < 2) {
+        idx0 = idx1 = _mm256_setzero_si256();
+        t = _mm256_setzero_pd();
+        return;
+    }
+
+    __m256d low = _mm256_cmp_pd(v, _mm256_set1_pd(values[0]), _CMP_NGT_UQ);
+    __m256d high = _mm256_cmp_pd(v, _mm256_set1_pd(values[n - 1]), _CMP_GE_OQ);
+    __m256d clamped = _mm256_or_pd(low, high);
+
+    // Bucket position, clamped in floating point like TableAxis::upperBound
+    __m256d g = _mm256_mul_pd(_mm256_sub_pd(v, _mm256_set1_pd(values[0])),
+                              _mm256_set1_pd(axis.bucketScale()));
+    g = _mm256_max_pd(g, _mm256_setzero_pd());
+    g = _mm256_min_pd(g, _mm256_set1_pd(axis.maxBucket()));
+    __m128i b = _mm256_cvttpd_epi32(g);
+
+    __m256i one = _mm256_set1_epi64x(1);
+    __m256i last = _mm256_set1_epi64x(n - 1);
+    __m256i upper = axis.isUniform()
+        ? _mm256_add_epi64(_mm256_cvtepi32_epi64(b), one)
+        : _mm256_cvtepi32_epi64(_mm_i32gather_epi32(axis.buckets(), b, 4));
+
+    // Correct the guess on lanes that did not clamp
+    __m256i active = _mm256_castpd_si256(_mm256_xor_pd(clamped, _mm256_castsi256_pd(_mm256_set1_epi64x(-1))));
+    for (;;) {
+        __m256d prev = _mm256_i64gather_pd(values, _mm256_sub_epi64(upper, one), 8);
+        __m256i m = _mm256_and_si256(_mm256_and_si256(active, _mm256_cmpgt_epi64(upper, one)),
+                                     _mm256_castpd_si256(_mm256_cmp_pd(prev, v, _CMP_GT_OQ)));
+        if (_mm256_testz_si256(m, m)) break;
+        upper = _mm256_sub_epi64(upper, _mm256_and_si256(m, one));
+    }
+    for (;;) {
+        __m256d cur = _mm256_i64gather_pd(values, upper, 8);
+        __m256i m = _mm256_and_si256(active, _mm256_castpd_si256(_mm256_cmp_pd(cur, v, _CMP_LE_OQ)));
+        if (_mm256_testz_si256(m, m)) break;
+        upper = _mm256_add_epi64(upper, _mm256_and_si256(m, one));
+    }
+    __m256i lower = _mm256_sub_epi64(upper, one);
+
+    // Clamped lanes collapse onto the edge
+    __m256i zero = _mm256_setzero_si256();
+    __m256i lowMask = _mm256_castpd_si256(low);
+    __m256i highMask = _mm256_castpd_si256(high);
+    lower = _mm256_blendv_epi8(_mm256_blendv_epi8(lower, zero, lowMask), last, highMask);
+    upper = _mm256_blendv_epi8(_mm256_blendv_epi8(upper, zero, lowMask), last, highMask);
+
+    __m256d v0 = _mm256_i64gather_pd(values, lower, 8);
+    __m256d v1 = _mm256_i64gather_pd(values, upper, 8);
+    __m256d frac = _mm256_div_pd(_mm256_sub_pd(v, v0), _mm256_sub_pd(v1, v0));
+    t = _mm256_blendv_pd(frac, _mm256_setzero_pd(), clamped);
+
+    idx0 = lower;
+    idx1 = upper;
+}
+
+RPA_TARGET_AVX2 inline __m256d lerpAVX2(__m256d a, __m256d b, __m256d t, __m256d oneMinusT) {
+    return _mm256_add_pd(_mm256_mul_pd(a, oneMinusT), _mm256_mul_pd(b, t));
+}
+
+/**
+ * Corner gathers for each storage precision, widened to double exactly as
+ * fetchCorners() does. A 16-bit code is fetched with a 32-bit gather (the
+ * grid carries one padding value) and masked.
+ */
+struct FixedField {
+    const uint16_t* codes;
+    double offset;
+    double scale;
+};
+
+RPA_TARGET_AVX2 inline __m256d gatherAVX2(const double* field, __m256i idx) {
+    return _mm256_i64gather_pd(field, idx, 8);
+}
+
+RPA_TARGET_AVX2 inline __m256d gatherAVX2(const float* field, __m256i idx) {
+    return _mm256_cvtps_pd(_mm256_i64gather_ps(field, idx, 4));
+}
+
+RPA_TARGET_AVX2 inline __m256d gatherAVX2(const FixedField& field, __m256i idx) {
+    __m128i q = _mm256_i64gather_epi32(reinterpret_cast<const int*>(field.codes), idx, 2);
+    q = _mm_and_si128(q, _mm_set1_epi32(0xFFFF));
+    return _mm256_add_pd(_mm256_set1_pd(field.offset),
+                         _mm256_mul_pd(_mm256_set1_pd(field.scale), _mm256_cvtepi32_pd(q)));
+}
+
+/**
+ * Vector version of trilinearInterp over one field; the argument order of
+ * each lerp mirrors the scalar code
+ */
+template <typename FieldStorage>
+RPA_TARGET_AVX2 inline __m256d trilinearAVX2(const FieldStorage& field, __m256i i000,
+                                             __m256i dPc, __m256i dOF, __m256i dPa,
+                                             __m256d tx, __m256d ty, __m256d tz) {
+    __m256i i001 = _mm256_add_epi64(i000, dPa);
+    __m256i i010 = _mm256_add_epi64(i000, dOF);
+    __m256i i011 = _mm256_add_epi64(i010, dPa);
+    __m256i i100 = _mm256_add_epi64(i000, dPc);
+    __m256i i101 = _mm256_add_epi64(i100, dPa);
+    __m256i i110 = _mm256_add_epi64(i100, dOF);
+    __m256i i111 = _mm256_add_epi64(i110, dPa);
+
+    __m256d c000 = gatherAVX2(field, i000);
+    __m256d c001 = gatherAVX2(field, i001);
+    __m256d c010 = gatherAVX2(field, i010);
+    __m256d c011 = gatherAVX2(field, i011);
+    __m256d c100 = gatherAVX2(field, i100);
+    __m256d c101 = gatherAVX2(field, i101);
+    __m256d c110 = gatherAVX2(field, i110);
+    __m256d c111 = gatherAVX2(field, i111);
+
+    __m256d one = _mm256_set1_pd(1.0);
+    __m256d ux = _mm256_sub_pd(one, tx);
+    __m256d uy = _mm256_sub_pd(one, ty);
+    __m256d uz = _mm256_sub_pd(one, tz);
+
+    __m256d c00 = lerpAVX2(c000, c100, tx, ux);
+    __m256d c01 = lerpAVX2(c001, c101, tx, ux);
+    __m256d c10 = lerpAVX2(c010, c110, tx, ux);
+    __m256d c11 = lerpAVX2(c011, c111, tx, ux);
+
+    __m256d c0 = lerpAVX2(c00, c10, ty, uy);
+    __m256d c1 = lerpAVX2(c01, c11, ty, uy);
+
+    return lerpAVX2(c0, c1, tz, uz);
+}
+
+// ================================================================
+// AVX-512: 8 lanes, 64-bit indices
+// ================================================================
+
+#define RPA_TARGET_AVX512 __attribute__((target("avx512f") RPA_NO_CONTRACT))
+
+RPA_TARGET_AVX512 inline void findBoundsAVX512(const TableAxis& axis, __m512d v,
+                                               __m512i& idx0, __m512i& idx1, __m512d& t) {
+    const double* values = axis.data();
+    const long long n = static_cast<long long>(axis.size());
+
+    if (n < 2) {
+        idx0 = idx1 = _mm512_setzero_si512();
+        t = _mm512_setzero_pd();
+        return;
+    }
+
+    __mmask8 low = _mm512_cmp_pd_mask(v, _mm512_set1_pd(values[0]), _CMP_NGT_UQ);
+    __mmask8 high = _mm512_cmp_pd_mask(v, _mm512_set1_pd(values[n - 1]), _CMP_GE_OQ);
+    __mmask8 active = static_cast<__mmask8>(~(low | high));
+
+    __m512d g = _mm512_mul_pd(_mm512_sub_pd(v, _mm512_set1_pd(values[0])),
+                              _mm512_set1_pd(axis.bucketScale()));
+    g = _mm512_max_pd(g, _mm512_setzero_pd());
+    g = _mm512_min_pd(g, _mm512_set1_pd(axis.maxBucket()));
+    __m256i b = _mm512_cvttpd_epi32(g);
+
+    __m512i one = _mm512_set1_epi64(1);
+    __m512i last = _mm512_set1_epi64(n - 1);
+    __m512i upper = axis.isUniform()
+        ? _mm512_add_epi64(_mm512_cvtepi32_epi64(b), one)
+        : _mm512_cvtepi32_epi64(_mm256_i32gather_epi32(axis.buckets(), b, 4));
+
+    for (;;) {
+        __m512d prev = _mm512_i64gather_pd(_mm512_sub_epi64(upper, one), values, 8);
+        __mmask8 m = active & _mm512_cmpgt_epi64_mask(upper, one) &
+                     _mm512_cmp_pd_mask(prev, v, _CMP_GT_OQ);
+        if (!m) break;
+        upper = _mm512_mask_sub_epi64(upper, m, upper, one);
+    }
+    for (;;) {
+        __m512d cur = _mm512_i64gather_pd(upper, values, 8);
+        __mmask8 m = active & _mm512_cmp_pd_mask(cur, v, _CMP_LE_OQ);
+        if (!m) break;
+        upper = _mm512_mask_add_epi64(upper, m, upper, one);
+    }
+    __m512i lower = _mm512_sub_epi64(upper, one);
+
+    __m512i zero = _mm512_setzero_si512();
+    lower = _mm512_mask_blend_epi64(high, _mm512_mask_blend_epi64(low, lower, zero), last);
+    upper = _mm512_mask_blend_epi64(high, _mm512_mask_blend_epi64(low, upper, zero), last);
+
+    __m512d v0 = _mm512_i64gather_pd(lower, values, 8);
+    __m512d v1 = _mm512_i64gather_pd(upper, values, 8);
+    __m512d frac = _mm512_div_pd(_mm512_sub_pd(v, v0), _mm512_sub_pd(v1, v0));
+    t = _mm512_mask_blend_pd(static_cast<__mmask8>(~active), frac, _mm512_setzero_pd());
+
+    idx0 = lower;
+    idx1 = upper;
+}
+
+RPA_TARGET_AVX512 inline __m512d lerpAVX512(__m512d a, __m512d b, __m512d t, __m512d oneMinusT) {
+    return _mm512_add_pd(_mm512_mul_pd(a, oneMinusT), _mm512_mul_pd(b, t));
+}
+
+RPA_TARGET_AVX512 inline __m512d gatherAVX512(const double* field, __m512i idx) {
+    return _mm512_i64gather_pd(idx, field, 8);
+}
+
+RPA_TARGET_AVX512 inline __m512d gatherAVX512(const float* field, __m512i idx) {
+    return _mm512_cvtps_pd(_mm512_i64gather_ps(idx, field, 4));
+}
+
+RPA_TARGET_AVX512 inline __m512d gatherAVX512(const FixedField& field, __m512i idx) {
+    __m256i q = _mm512_i64gather_epi32(idx, field.codes, 2);
+    q = _mm256_and_si256(q, _mm256_set1_epi32(0xFFFF));
+    return _mm512_add_pd(_mm512_set1_pd(field.offset),
+                         _mm512_mul_pd(_mm512_set1_pd(field.scale), _mm512_cvtepi32_pd(q)));
+}
+
+template <typename FieldStorage>
+RPA_TARGET_AVX512 inline __m512d trilinearAVX512(const FieldStorage& field, __m512i i000,
+                                                 __m512i dPc, __m512i dOF, __m512i dPa,
+                                                 __m512d tx, __m512d ty, __m512d tz) {
+    __m512i i001 = _mm512_add_epi64(i000, dPa);
+    __m512i i010 = _mm512_add_epi64(i000, dOF);
+    __m512i i011 = _mm512_add_epi64(i010, dPa);
+    __m512i i100 = _mm512_add_epi64(i000, dPc);
+    __m512i i101 = _mm512_add_epi64(i100, dPa);
+    __m512i i110 = _mm512_add_epi64(i100, dOF);
+    __m512i i111 = _mm512_add_epi64(i110, dPa);
+
+    __m512d c000 = gatherAVX512(field, i000);
+    __m512d c001 = gatherAVX512(field, i001);
+    __m512d c010 = gatherAVX512(field, i010);
+    __m512d c011 = gatherAVX512(field, i011);
+    __m512d c100 = gatherAVX512(field, i100);
+    __m512d c101 = gatherAVX512(field, i101);
+    __m512d c110 = gatherAVX512(field, i110);
+    __m512d c111 = gatherAVX512(field, i111);
+
+    __m512d one = _mm512_set1_pd(1.0);
+    __m512d ux = _mm512_sub_pd(one, tx);
+    __m512d uy = _mm512_sub_pd(one, ty);
+    __m512d uz = _mm512_sub_pd(one, tz);
+
+    __m512d c00 = lerpAVX512(c000, c100, tx, ux);
+    __m512d c01 = lerpAVX512(c001, c101, tx, ux);
+    __m512d c10 = lerpAVX512(c010, c110, tx, ux);
+    __m512d c11 = lerpAVX512(c011, c111, tx, ux);
+
+    __m512d c0 = lerpAVX512(c00, c10, ty, uy);
+    __m512d c1 = lerpAVX512(c01, c11, ty, uy);
+
+    return lerpAVX512(c0, c1, tz, uz);
+}
+
+} // namespace
+
+RPA_TARGET_AVX2
+void RPATableInterpolator::getPerformanceBatchAVX2(const double* Pc, const double* OF, const double* Pa,
+                                                   size_t count, const PerformanceBatch& out) const {
+    const size_t width = 4;
+    const size_t vecEnd = count - count % width;
+    countQueries(Pc, OF, Pa, vecEnd);   // The scalar tail counts its own points
+
+    const __m256i stridePc = _mm256_set1_epi64x(static_cast<long long>(m_stridePc));
+    const __m256i strideOF = _mm256_set1_epi64x(static_cast<long long>(m_strideOF));
+    double* outputs[NUM_FIELDS] = { out.Cf, out.Cstar, out.Isp, out.Ve, out.Pe, out.gamma };
+
+    for (size_t i = 0; i < vecEnd; i += width) {
+        __m256i Pc0, Pc1, OF0, OF1, Pa0, Pa1;
+        __m256d tx, ty, tz;
+        findBoundsAVX2(m_Pc_axis, _mm256_loadu_pd(Pc + i), Pc0, Pc1, tx);
+        findBoundsAVX2(m_OF_axis, _mm256_loadu_pd(OF + i), OF0, OF1, ty);
+        findBoundsAVX2(m_Pa_axis, _mm256_loadu_pd(Pa + i), Pa0, Pa1, tz);
+
+        // Index arithmetic matches gridIndex(); _mm256_mul_epu32 is exact
+        // because indices and strides fit in 32 bits
+        __m256i i000 = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(Pc0, stridePc),
+                                                         _mm256_mul_epu32(OF0, strideOF)), Pa0);
+        __m256i dPc = _mm256_mul_epu32(_mm256_sub_epi64(Pc1, Pc0), stridePc);
+        __m256i dOF = _mm256_mul_epu32(_mm256_sub_epi64(OF1, OF0), strideOF);
+        __m256i dPa = _mm256_sub_epi64(Pa1, Pa0);
+
+        for (int f = 0; f < NUM_FIELDS; ++f) {
+            const Field field = static_cast<Field>(f);
+            __m256d r;
+            switch (m_storage) {
+            case StoragePrecision::Float32:
+                r = trilinearAVX2(floatFieldData(field), i000, dPc, dOF, dPa, tx, ty, tz);
+                break;
+            case StoragePrecision::Fixed16:
+                r = trilinearAVX2(FixedField{ fixedFieldData(field), m_fixedOffset[f], m_fixedScale[f] },
+                                  i000, dPc, dOF, dPa, tx, ty, tz);
+                break;
+            default:
+                r = trilinearAVX2(fieldData(field), i000, dPc, dOF, dPa, tx, ty, tz);
+                break;
+            }
+            _mm256_storeu_pd(outputs[f] + i, r);
+        }
+    }
+
+    getPerformanceBatchScalar(Pc, OF, Pa, vecEnd, count, out);
+}
+
+RPA_TARGET_AVX512
+void RPATableInterpolator::getPerformanceBatchAVX512(const double* Pc, const double* OF, const double* Pa,
+                                                     size_t count, const PerformanceBatch& out) const {
+    const size_t width = 8;
+    const size_t vecEnd = count - count % width;
+    countQueries(Pc, OF, Pa, vecEnd);   // The scalar tail counts its own points
+
+    const __m512i stridePc = _mm512_set1_epi64(static_cast<long long>(m_stridePc));
+    const __m512i strideOF = _mm512_set1_epi64(static_cast<long long>(m_strideOF));
+    double* outputs[NUM_FIELDS] = { out.Cf, out.Cstar, out.Isp, out.Ve, out.Pe, out.gamma };
+
+    for (size_t i = 0; i < vecEnd; i += width) {
+        __m512i Pc0, Pc1, OF0, OF1, Pa0, Pa1;
+        __m512d tx, ty, tz;
+        findBoundsAVX512(m_Pc_axis, _mm512_loadu_pd(Pc + i), Pc0, Pc1, tx);
+        findBoundsAVX512(m_OF_axis, _mm512_loadu_pd(OF + i), OF0, OF1, ty);
+        findBoundsAVX512(m_Pa_axis, _mm512_loadu_pd(Pa + i), Pa0, Pa1, tz);
+
+        __m512i i000 = _mm512_add_epi64(_mm512_add_epi64(_mm512_mul_epu32(Pc0, stridePc),
+                                                         _mm512_mul_epu32(OF0, strideOF)), Pa0);
+        __m512i dPc = _mm512_mul_epu32(_mm512_sub_epi64(Pc1, Pc0), stridePc);
+        __m512i dOF = _mm512_mul_epu32(_mm512_sub_epi64(OF1, OF0), strideOF);
+        __m512i dPa = _mm512_sub_epi64(Pa1, Pa0);
+
+        for (int f = 0; f < NUM_FIELDS; ++f) {
+            const Field field = static_cast<Field>(f);
+            __m512d r;
+            switch (m_storage) {
+            case StoragePrecision::Float32:
+                r = trilinearAVX512(floatFieldData(field), i000, dPc, dOF, dPa, tx, ty, tz);
+                break;
+            case StoragePrecision::Fixed16:
+                r = trilinearAVX512(FixedField{ fixedFieldData(field), m_fixedOffset[f], m_fixedScale[f] },
+                                    i000, dPc, dOF, dPa, tx, ty, tz);
+                break;
+            default:
+                r = trilinearAVX512(fieldData(field), i000, dPc, dOF, dPa, tx, ty, tz);
+                break;
+            }
+            _mm512_storeu_pd(outputs[f] + i, r);
+        }
+    }
+
+    getPerformanceBatchScalar(Pc, OF, Pa, vecEnd, count, out);
+}
+
+#else
+
+// Non-x86 builds only have the scalar kernel; setSimdLevel never selects these
+void RPATableInterpolator::getPerformanceBatchAVX2(const double* Pc, const double* OF, const double* Pa,
+                                                   size_t count, const PerformanceBatch& out) const {
+    getPerformanceBatchScalar(Pc, OF, Pa, 0, count, out);
+}
+
+void RPATableInterpolator::getPerformanceBatchAVX512(const double* Pc, const double* OF, const double* Pa,
+                                                     size_t count, const PerformanceBatch& out) const {
+    getPerformanceBatchScalar(Pc, OF, Pa, 0, count, out);
+}
+
+#endif
@@ -0,0 +1,156 @@
+#include "RasData.h"
+#include <algorithm>
+#include <stdexcept>
+#include <fstream>
+#include <cctype>
+
+namespace {
+    const double PI = 3.14159265358979323846;
+    const size_t NONE = static_cast<size_t>(-1);
+
+    // Column name reduced to lower-case letters and digits: "CD Power-Off" -> "cdpoweroff"
+    std::string columnKey(const std::string& name) {
+        std::string key;
+        for (char c : name) {
+            if (std::isalnum(static_cast<unsigned char>(c))) {
+                key += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+        }
+        return key;
+    }
+
+    bool readHeader(const std::string& filename, std::vector<std::string>& keys) {
+        std::ifstream in(filename);
+        std::string line;
+        if (!in || !std::getline(in, line)) {
+            return false;
+        }
+        size_t begin = 0;
+        for (;;) {
+            const size_t comma = line.find(',', begin);
+            keys.push_back(columnKey(line.substr(begin, comma == std::string::npos ? std::string::npos : comma - begin)));
+            if (comma == std::string::npos) {
+                return true;
+            }
+            begin = comma + 1;
+        }
+    }
+
+    size_t findColumn(const std::vector<std::string>& keys, const char* key) {
+        const auto it = std::find(keys.begin(), keys.end(), key);
+        return it == keys.end() ? NONE : static_cast<size_t>(it - keys.begin());
+    }
+
+    bool increasing(const std::vector<double>& values) {
+        for (size_t i = 1; i < values.size(); ++i) {
+            if (!(values[i] > values[i - 1])) return false;
+        }
+        return !values.empty();
+    }
+}
+
+RasData::RasData()
+    : m_isLoaded(false) {
+}
+
+void RasData::clear() {
+    m_isLoaded = false;
+    m_mach.clear();
+    m_alpha.clear();
+    m_cd[0].clear();
+    m_cd[1].clear();
+    m_cn.clear();
+    m_loadReport = TableCsvReader::Report();
+}
+
+bool RasData::load(const std::string& filename) {
+    clear();
+
+    std::vector<std::string> keys;
+    if (!readHeader(filename, keys) || keys.size() < 3 || keys[0] != "mach" || keys[1] != "alpha") {
+        return false;
+    }
+    size_t cdOff = findColumn(keys, "cdpoweroff");
+    size_t cdOn = findColumn(keys, "cdpoweron");
+    if (cdOff == NONE) {
+        cdOff = findColumn(keys, "cd");
+    }
+    if (cdOn == NONE) {
+        cdOn = cdOff;
+    }
+    const size_t cn = findColumn(keys, "cn");
+    if (cdOff == NONE || cn == NONE) {
+        return false;
+    }
+
+    // Read up to the last column used; the rest of each row is ignored
+    TableCsvReader::Settings settings;
+    settings.axisColumns = 2;
+    settings.valueColumns = std::max(std::max(cdOff, cdOn), cn) - 1;
+    settings.allowExtraColumns = true;
+
+    TableCsvReader reader(settings);
+    const bool ok = reader.read(filename);
+    m_loadReport = reader.getReport();
+    if (!ok) {
+        return false;
+    }
+
+    std::vector<double> alpha = reader.getAxis(1);
+    for (double& a : alpha) {
+        a *= PI / 180.0;
+    }
+    std::vector<double> grid;
+    reader.takeGrid(grid);
+    const size_t points = reader.getAxis(0).size() * alpha.size();
+    const auto column = [&](size_t c) {
+        const auto first = grid.begin() + (c - 2) * points;
+        return std::vector<double>(first, first + points);
+    };
+    return assignGrid(reader.getAxis(0), alpha, column(cdOff), column(cdOn), column(cn));
+}
+
+bool RasData::loadGrid(const std::vector<double>& mach, const std::vector<double>& alpha,
+                       const std::vector<double>& cdOff, const std::vector<double>& cdOn,
+                       const std::vector<double>& cn) {
+    clear();
+    return assignGrid(mach, alpha, cdOff, cdOn, cn);
+}
+
+bool RasData::assignGrid(const std::vector<double>& mach, const std::vector<double>& alpha,
+                         const std::vector<double>& cdOff, const std::vector<double>& cdOn,
+                         const std::vector<double>& cn) {
+    const size_t points = mach.size() * alpha.size();
+    if (!increasing(mach) || !increasing(alpha) ||
+        cdOff.size() != points || cdOn.size() != points || cn.size() != points) {
+        return false;
+    }
+    m_mach.assign(mach);
+    m_alpha.assign(alpha);
+    m_cd[static_cast<size_t>(Power::OFF)] = cdOff;
+    m_cd[static_cast<size_t>(Power::ON)] = cdOn;
+    m_cn = cn;
+    m_isLoaded = true;
+    return true;
+}
+
+CoeffData::CoeffData(const RasData& ras, double referenceArea)
+    : m_referenceArea(referenceArea) {
+    if (!ras.isLoaded() || !(referenceArea > 0.0)) {
+        throw std::invalid_argument("Aerodynamic coefficients need loaded RASAero data and a positive reference area");
+    }
+    m_mach = ras.getMachAxis();
+    m_alpha = ras.getAlphaAxis();
+
+    // Scaled once here, so a lookup is only the interpolation
+    const RasData::Power powers[2] = { RasData::Power::OFF, RasData::Power::ON };
+    m_values.reserve(2 * m_mach.size() * m_alpha.size() * 2);
+    for (RasData::Power power : powers) {
+        for (size_t i = 0; i < m_mach.size(); ++i) {
+            for (size_t j = 0; j < m_alpha.size(); ++j) {
+                m_values.push_back(ras.dragCoefficient(power, i, j) * referenceArea);
+                m_values.push_back(ras.normalCoefficient(i, j) * referenceArea);
+            }
+        }
+    }
+}
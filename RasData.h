@@ -0,0 +1,152 @@
+#ifndef RAS_DATA_H
+#define RAS_DATA_H
+
+#include "TableAxis.h"
+#include "MultilinearKernel.h"
+#include "TableCsvReader.h"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+/**
+ * RasData
+ *
+ * Aerodynamic coefficients of a rocket as exported by RASAero II (Aero
+ * Plots, File > Export to CSV): drag and normal force coefficients on a dense
+ * grid over Mach number and angle of attack, with separate power-off and
+ * power-on drag.
+ *
+ * The file must start with the Mach and Alpha (degrees) columns. The other
+ * columns are found by name: "CD Power-Off" and "CD Power-On" (or a single
+ * "CD" for both), and "CN". Other columns are ignored. The rows are read by
+ * TableCsvReader, so a file with missing grid points is rejected and
+ * getLoadReport() lists what was wrong.
+ *
+ * The coefficients are not tied to a reference area. CoeffData scales them
+ * for one rocket.
+ */
+class RasData {
+public:
+    enum class Power {
+        OFF,
+        ON
+    };
+
+    RasData();
+
+    /**
+     * Load a RASAero CSV export
+     * @return false if the file cannot be read, lacks a needed column, or
+     *         leaves grid points without a value
+     */
+    bool load(const std::string& filename);
+
+    /**
+     * Load coefficients already in memory
+     * @param mach Strictly increasing Mach numbers
+     * @param alpha Strictly increasing angles of attack, rad
+     * @param cdOff, cdOn, cn One value per grid point, Mach-major
+     * @return false if an axis is empty or not increasing, or a value
+     *         count does not match the axes
+     */
+    bool loadGrid(const std::vector<double>& mach, const std::vector<double>& alpha,
+                  const std::vector<double>& cdOff, const std::vector<double>& cdOn,
+                  const std::vector<double>& cn);
+
+    bool isLoaded() const { return m_isLoaded; }
+
+    const TableAxis& getMachAxis() const { return m_mach; }
+    const TableAxis& getAlphaAxis() const { return m_alpha; }  // rad
+
+    /**
+     * Diagnostics from the last load
+     */
+    const TableCsvReader::Report& getLoadReport() const { return m_loadReport; }
+
+    /**
+     * Grid values at Mach index i and alpha index j
+     */
+    double dragCoefficient(Power power, size_t i, size_t j) const {
+        return m_cd[static_cast<size_t>(power)][i * m_alpha.size() + j];
+    }
+    double normalCoefficient(size_t i, size_t j) const { return m_cn[i * m_alpha.size() + j]; }
+
+private:
+    void clear();
+    bool assignGrid(const std::vector<double>& mach, const std::vector<double>& alpha,
+                    const std::vector<double>& cdOff, const std::vector<double>& cdOn,
+                    const std::vector<double>& cn);
+
+    TableAxis m_mach;
+    TableAxis m_alpha;
+    std::vector<double> m_cd[2];    // By Power
+    std::vector<double> m_cn;
+    bool m_isLoaded;
+    TableCsvReader::Report m_loadReport;
+};
+
+/**
+ * CoeffData
+ *
+ * RasData scaled to one rocket's reference area: drag area CdA and normal
+ * force area CnA (m^2) over (Mach, alpha), for power off and on. Both are
+ * stored together at each grid point, so one bilinear interpolation gives
+ * the loads per unit dynamic pressure. Cell lookup is O(1) (TableAxis), and
+ * queries clamp to the table edges.
+ *
+ * A CoeffData does not change after it is built, so any number of flights
+ * and threads can share it (Rocket holds it by shared_ptr).
+ */
+class CoeffData {
+public:
+    struct Coefficients {
+        double dragArea;            // CdA, m^2
+        double normalArea;          // CnA, m^2
+    };
+
+    /**
+     * @throws std::invalid_argument if the data is not loaded or the
+     *         reference area is not positive
+     */
+    CoeffData(const RasData& ras, double referenceArea);
+
+    double getReferenceArea() const { return m_referenceArea; }
+    const TableAxis& getMachAxis() const { return m_mach; }
+    const TableAxis& getAlphaAxis() const { return m_alpha; }
+
+    /**
+     * Drag and normal force areas at a Mach number and angle of attack (rad),
+     * times a rocket's own scale factors (Rocket::aeroDragScale and
+     * aeroNormalScale, 1 for the tables as they are)
+     */
+    Coefficients lookup(RasData::Power power, double mach, double alpha,
+                        double dragScale, double normalScale) const {
+        int i0, i1, j0, j1;
+        double t[2];
+        m_mach.findBounds(mach, i0, i1, t[0]);
+        m_alpha.findBounds(alpha, j0, j1, t[1]);
+        const size_t plane = static_cast<size_t>(power) * m_mach.size();
+        const double* base = &m_values[((plane + i0) * m_alpha.size() + j0) * 2];
+        const size_t delta[2] = { static_cast<size_t>(i1 - i0) * m_alpha.size() * 2, static_cast<size_t>(j1 - j0) * 2 };
+
+        double value[2];
+        for (size_t k = 0; k < 2; ++k) {
+            double corners[MultilinearKernel<2>::CORNERS];
+            MultilinearKernel<2>::gatherCorners(base + k, delta, corners);
+            value[k] = MultilinearKernel<2>::blend(corners, t);
+        }
+        Coefficients c;
+        c.dragArea = value[0] * dragScale;
+        c.normalArea = value[1] * normalScale;
+        return c;
+    }
+
+private:
+    TableAxis m_mach;
+    TableAxis m_alpha;
+    double m_referenceArea;
+    // (CdA, CnA) pairs, by power, then Mach, then alpha
+    std::vector<double> m_values;
+};
+
+#endif // RAS_DATA_H
@@ -0,0 +1,231 @@
+#include "RigidBodyIntegrator.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+namespace {
+    const size_t N = RigidBodyState::SIZE;
+
+    // Dormand-Prince 5(4) tableau. Row i holds the weights of stages 0..i-1
+    // for stage i; the last row is also the 5th-order solution (FSAL).
+    const double DP_C[7] = { 0.0, 1.0 / 5, 3.0 / 10, 4.0 / 5, 8.0 / 9, 1.0, 1.0 };
+    const double DP_A[7][6] = {
+        { 0, 0, 0, 0, 0, 0 },
+        { 1.0 / 5, 0, 0, 0, 0, 0 },
+        { 3.0 / 40, 9.0 / 40, 0, 0, 0, 0 },
+        { 44.0 / 45, -56.0 / 15, 32.0 / 9, 0, 0, 0 },
+        { 19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729, 0, 0 },
+        { 9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176, -5103.0 / 18656, 0 },
+        { 35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84 }
+    };
+    // 5th- minus 4th-order weights: the local error estimate
+    const double DP_E[7] = {
+        71.0 / 57600, 0, -71.0 / 16695, 71.0 / 1920, -17253.0 / 339200, 22.0 / 525, -1.0 / 40
+    };
+
+    // Step size control (PI, as in Hairer's DOPRI5): new step = old * SAFETY
+    // * error^-(1/5 - 0.75 PI_BETA) * previous error^PI_BETA, within
+    // [MIN_FACTOR, MAX_FACTOR] of the old one. The previous error term damps
+    // the step oscillation a plain error^(-1/5) rule shows when the error
+    // grows steadily from step to step.
+    const double SAFETY = 0.9;
+    const double PI_BETA = 0.04;
+    const double PI_ALPHA = 0.2 - 0.75 * PI_BETA;
+    const double MIN_ERROR = 1e-4;      // Previous error floor, so one tiny error does not stall growth
+    const double MIN_FACTOR = 0.2;
+    const double MAX_FACTOR = 5.0;
+}
+
+const size_t RigidBodyState::SIZE;
+
+void RigidBodyState::normalizeAttitude() {
+    double* q = attitude();
+    const double norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    if (norm > 0.0) {
+        for (size_t i = 0; i < 4; ++i) q[i] /= norm;
+    }
+}
+
+RigidBodyIntegrator::Settings::Settings()
+    : method(Method::RK45)
+    , step(0.05)
+    , relativeTolerance(1e-6)
+    , absoluteTolerance(1e-6)
+    , minStep(1e-6)
+    , maxStep(10.0) {
+}
+
+RigidBodyIntegrator::Stats::Stats()
+    : steps(0)
+    , rejectedSteps(0)
+    , evaluations(0)
+    , minStepTaken(0.0)
+    , maxStepTaken(0.0) {
+}
+
+RigidBodyIntegrator::RigidBodyIntegrator(const Settings& settings)
+    : m_nextStep(0.0)
+    , m_previousError(MIN_ERROR)
+    , m_firstStageValid(false) {
+    setSettings(settings);
+}
+
+void RigidBodyIntegrator::setSettings(const Settings& settings) {
+    if (!(settings.step > 0.0) || !(settings.relativeTolerance > 0.0) ||
+        !(settings.absoluteTolerance > 0.0) || !(settings.minStep > 0.0) ||
+        !(settings.minStep <= settings.maxStep)) {
+        throw std::invalid_argument("Integrator steps and tolerances must be positive, with minStep <= maxStep");
+    }
+    m_settings = settings;
+    restart();
+}
+
+void RigidBodyIntegrator::restart() {
+    m_nextStep = 0.0;
+    m_previousError = MIN_ERROR;
+    m_firstStageValid = false;
+}
+
+const char* RigidBodyIntegrator::methodName(Method method) {
+    switch (method) {
+    case Method::RK4: return "RK4";
+    case Method::RK45: return "RK45";
+    }
+    return "unknown";
+}
+
+double RigidBodyIntegrator::step(RigidBodyDynamics& dynamics, double& t, RigidBodyState& state, double tEnd) {
+    if (!(tEnd > t)) {
+        return 0.0;
+    }
+    if (m_settings.method == Method::RK4) {
+        // Stretch the last step slightly rather than leave a rounding-error sliver
+        const double remaining = tEnd - t;
+        return stepRK4(dynamics, t, state, remaining <= m_settings.step * (1.0 + 1e-6) ? remaining : m_settings.step);
+    }
+    return stepRK45(dynamics, t, state, tEnd);
+}
+
+void RigidBodyIntegrator::combine(const RigidBodyState& state, double h, const double* a, size_t stages) {
+    for (size_t i = 0; i < N; ++i) {
+        double sum = 0.0;
+        for (size_t s = 0; s < stages; ++s) sum += a[s] * m_k[s].x[i];
+        m_stage.x[i] = state.x[i] + h * sum;
+    }
+}
+
+void RigidBodyIntegrator::recordStep(double h) {
+    m_stats.minStepTaken = m_stats.steps ? std::min(m_stats.minStepTaken, h) : h;
+    m_stats.maxStepTaken = std::max(m_stats.maxStepTaken, h);
+    ++m_stats.steps;
+}
+
+double RigidBodyIntegrator::startingStep(RigidBodyDynamics& dynamics, double t, const RigidBodyState& state) {
+    // Scaled RMS norms of the state, its derivative, and the derivative's
+    // change over a trial step h0; the step then keeps the 5th-order error
+    // term near 1% of tolerance
+    double d0 = 0.0, d1 = 0.0;
+    for (size_t i = 0; i < N; ++i) {
+        const double scale = m_settings.absoluteTolerance + m_settings.relativeTolerance * std::fabs(state.x[i]);
+        d0 += (state.x[i] / scale) * (state.x[i] / scale);
+        d1 += (m_k[0].x[i] / scale) * (m_k[0].x[i] / scale);
+    }
+    d0 = std::sqrt(d0 / N);
+    d1 = std::sqrt(d1 / N);
+    double h0 = d0 < 1e-5 || d1 < 1e-5 ? 1e-6 : 0.01 * d0 / d1;
+    h0 = std::min(h0, m_settings.step);
+
+    const double a[1] = { 1.0 };
+    combine(state, h0, a, 1);
+    dynamics.derivative(t + h0, m_stage, m_k[1]);
+    ++m_stats.evaluations;
+    double d2 = 0.0;
+    for (size_t i = 0; i < N; ++i) {
+        const double scale = m_settings.absoluteTolerance + m_settings.relativeTolerance * std::fabs(state.x[i]);
+        const double change = (m_k[1].x[i] - m_k[0].x[i]) / scale;
+        d2 += change * change;
+    }
+    d2 = std::sqrt(d2 / N) / h0;
+
+    const double d = std::max(d1, d2);
+    const double h1 = d <= 1e-15 ? std::max(1e-6, h0 * 1e-3) : std::pow(0.01 / d, 0.2);
+    return std::min(std::min(100.0 * h0, h1), m_settings.step);
+}
+
+double RigidBodyIntegrator::stepRK4(RigidBodyDynamics& dynamics, double& t, RigidBodyState& state, double h) {
+    static const double A[4][3] = { { 0, 0, 0 }, { 0.5, 0, 0 }, { 0, 0.5, 0 }, { 0, 0, 1.0 } };
+    static const double C[4] = { 0.0, 0.5, 0.5, 1.0 };
+
+    dynamics.derivative(t, state, m_k[0]);
+    for (size_t s = 1; s < 4; ++s) {
+        combine(state, h, A[s], s);
+        dynamics.derivative(t + C[s] * h, m_stage, m_k[s]);
+    }
+    m_stats.evaluations += 4;
+
+    for (size_t i = 0; i < N; ++i) {
+        state.x[i] += h / 6.0 * (m_k[0].x[i] + 2.0 * (m_k[1].x[i] + m_k[2].x[i]) + m_k[3].x[i]);
+    }
+    state.normalizeAttitude();
+    t += h;
+    recordStep(h);
+    m_firstStageValid = false;
+    return h;
+}
+
+double RigidBodyIntegrator::stepRK45(RigidBodyDynamics& dynamics, double& t, RigidBodyState& state, double tEnd) {
+    if (!m_firstStageValid) {
+        dynamics.derivative(t, state, m_k[0]);
+        ++m_stats.evaluations;
+        m_firstStageValid = true;
+    }
+    double h = m_nextStep > 0.0 ? m_nextStep : startingStep(dynamics, t, state);
+    h = std::min(std::max(h, m_settings.minStep), m_settings.maxStep);
+    bool rejected = false;
+
+    for (;;) {
+        // Land exactly on tEnd rather than leaving a sliver of a step
+        const bool last = h >= tEnd - t;
+        if (last) h = tEnd - t;
+
+        for (size_t s = 1; s < 7; ++s) {
+            combine(state, h, DP_A[s], s);
+            dynamics.derivative(t + DP_C[s] * h, m_stage, m_k[s]);
+        }
+        m_stats.evaluations += 6;
+
+        // The 5th-order solution is the last stage's state; its error
+        // estimate is scaled per component and combined as an RMS norm
+        double sumSquares = 0.0;
+        for (size_t i = 0; i < N; ++i) {
+            double e = 0.0;
+            for (size_t s = 0; s < 7; ++s) e += DP_E[s] * m_k[s].x[i];
+            const double scale = m_settings.absoluteTolerance +
+                                 m_settings.relativeTolerance * std::max(std::fabs(state.x[i]), std::fabs(m_stage.x[i]));
+            const double ratio = h * e / scale;
+            sumSquares += ratio * ratio;
+        }
+        const double error = std::sqrt(sumSquares / N);
+
+        double factor = error > 0.0 ? SAFETY * std::pow(error, -PI_ALPHA) * std::pow(m_previousError, PI_BETA)
+                                    : MAX_FACTOR;
+        if (error <= 1.0 || h <= m_settings.minStep) {
+            // Do not grow straight after a rejection, or the step oscillates
+            if (rejected) factor = std::min(factor, 1.0);
+            state = m_stage;
+            state.normalizeAttitude();
+            m_k[0] = m_k[6];
+            t = last ? tEnd : t + h;
+            recordStep(h);
+            m_previousError = std::max(error, MIN_ERROR);
+            // A step cut short by tEnd says nothing about the next one
+            const double grown = h * std::min(MAX_FACTOR, factor);
+            m_nextStep = last ? std::max(m_nextStep, grown) : grown;
+            return h;
+        }
+
+        ++m_stats.rejectedSteps;
+        rejected = true;
+        h = std::max(m_settings.minStep, h * std::max(MIN_FACTOR, factor));
+    }
+}
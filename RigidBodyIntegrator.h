@@ -0,0 +1,157 @@
+#ifndef RIGID_BODY_INTEGRATOR_H
+#define RIGID_BODY_INTEGRATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 6-DOF rigid-body state packed into one fixed-size array, so integrator
+ * stages are plain loops over SIZE doubles
+ *
+ * Position and velocity are inertial; the attitude quaternion (w, x, y, z)
+ * rotates body axes into inertial axes; the angular rate is in body axes.
+ */
+struct RigidBodyState {
+    static const size_t SIZE = 14;
+
+    // Offsets into x
+    enum Offset {
+        POSITION = 0,
+        VELOCITY = 3,
+        ATTITUDE = 6,
+        ANGULAR_RATE = 10,
+        MASS = 13
+    };
+
+    double x[SIZE];
+
+    double* position() { return x + POSITION; }
+    double* velocity() { return x + VELOCITY; }
+    double* attitude() { return x + ATTITUDE; }
+    double* angularRate() { return x + ANGULAR_RATE; }
+    double& mass() { return x[MASS]; }
+    const double* position() const { return x + POSITION; }
+    const double* velocity() const { return x + VELOCITY; }
+    const double* attitude() const { return x + ATTITUDE; }
+    const double* angularRate() const { return x + ANGULAR_RATE; }
+    double mass() const { return x[MASS]; }
+
+    /**
+     * Rescale the attitude quaternion to unit length
+     */
+    void normalizeAttitude();
+};
+
+/**
+ * Equations of motion for RigidBodyIntegrator
+ */
+class RigidBodyDynamics {
+public:
+    virtual ~RigidBodyDynamics() {}
+
+    /**
+     * Time derivative of the state (called once per integrator stage, so it
+     * should not allocate)
+     */
+    virtual void derivative(double t, const RigidBodyState& state, RigidBodyState& rate) = 0;
+};
+
+/**
+ * RigidBodyIntegrator
+ *
+ * Explicit Runge-Kutta integration of a RigidBodyState: classic RK4 with a
+ * fixed step, or the embedded Dormand-Prince 5(4) pair (RK45) choosing each
+ * step so the local error estimate stays within tolerance. RK45 reuses its
+ * last stage as the next step's first (FSAL), so an accepted step costs six
+ * derivative evaluations against RK4's four.
+ *
+ * All stage buffers are members; stepping never allocates. The attitude
+ * quaternion is renormalised after every step.
+ */
+class RigidBodyIntegrator {
+public:
+    enum class Method {
+        RK4,
+        RK45
+    };
+
+    struct Settings {
+        Method method;
+        double step;                // RK4 step; RK45 largest first step (s)
+        double relativeTolerance;   // RK45 error control, per state component
+        double absoluteTolerance;
+        double minStep;             // RK45 accepts a step this small whatever its error
+        double maxStep;
+
+        Settings();
+    };
+
+    struct Stats {
+        uint64_t steps;             // Accepted steps
+        uint64_t rejectedSteps;     // RK45 steps retried with a smaller step
+        uint64_t evaluations;       // Derivative evaluations
+        double minStepTaken;
+        double maxStepTaken;
+
+        Stats();
+    };
+
+    explicit RigidBodyIntegrator(const Settings& settings = Settings());
+
+    /**
+     * @throws std::invalid_argument if a step or tolerance is not positive
+     *         or minStep exceeds maxStep
+     */
+    void setSettings(const Settings& settings);
+    const Settings& getSettings() const { return m_settings; }
+
+    /**
+     * Take one accepted step from t, ending no later than tEnd
+     * Stepping exactly to a discontinuity in the dynamics (burnout, staging)
+     * and calling restart() there keeps RK45 from straddling it.
+     * @param t Time, advanced by the step taken
+     * @param state Advanced in place
+     * @return The step taken (s)
+     */
+    double step(RigidBodyDynamics& dynamics, double& t, RigidBodyState& state, double tEnd);
+
+    /**
+     * Forget the stored first stage and step size, e.g. after the state or
+     * the dynamics change outside the integrator
+     */
+    void restart();
+
+    const Stats& getStats() const { return m_stats; }
+    void resetStats() { m_stats = Stats(); }
+
+    static const char* methodName(Method method);
+
+private:
+    double stepRK4(RigidBodyDynamics& dynamics, double& t, RigidBodyState& state, double h);
+    double stepRK45(RigidBodyDynamics& dynamics, double& t, RigidBodyState& state, double tEnd);
+
+    /**
+     * m_stage = state + h * sum(a[i] * m_k[i]) for i < stages
+     */
+    void combine(const RigidBodyState& state, double h, const double* a, size_t stages);
+
+    /**
+     * RK45 step to try after a restart, from how fast the derivative
+     * changes over a trial step (Hairer's starting step; one evaluation)
+     */
+    double startingStep(RigidBodyDynamics& dynamics, double t, const RigidBodyState& state);
+
+    void recordStep(double h);
+
+    Settings m_settings;
+    Stats m_stats;
+    double m_nextStep;          // RK45 step to try next (0 = estimate one)
+    double m_previousError;     // RK45 error of the last accepted step
+    bool m_firstStageValid;     // m_k[0] holds the derivative at the current state
+
+    RigidBodyState m_k[7];      // Stage derivatives
+    RigidBodyState m_stage;     // State at which a stage is evaluated; after an
+                                // RK45 step, the candidate end state
+};
+
+#endif // RIGID_BODY_INTEGRATOR_H
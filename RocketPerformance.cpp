@@ -0,0 +1,203 @@
+#include "RocketPerformance.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    const double G0 = 9.80665;              // m/s^2
+    const double BAR_TO_PA = 1.0e5;
+
+    // Half-width of the ln P step used to differentiate the chamber isentrope
+    const double GAMMA_STEP = 0.01;
+
+    // Search interval for ln(Pc/Pt); the throat of any realistic propellant
+    // lies near ln(1.75) ~ 0.56
+    const double THROAT_MIN = 0.1;
+    const double THROAT_MAX = 1.5;
+    const double THROAT_WARM_BRACKET = 0.02;
+    const double THROAT_TOLERANCE = 1.0e-5;
+
+    const double EXIT_TOLERANCE = 1.0e-12;
+    const int MAX_EXIT_ITERATIONS = 60;
+
+    // 1/golden ratio
+    const double INV_PHI = 0.6180339887498949;
+}
+
+double RocketPerformance::Result::specificImpulse(double Pa) const {
+    return thrustCoefficient(Pa) * Cstar / G0;
+}
+
+RocketPerformance::RocketPerformance(const EquilibriumSolver& solver)
+    : m_solver(solver) {
+}
+
+double RocketPerformance::massFlux(const Expansion& expansion, double lnRatio,
+                                   EquilibriumSolver::State& state, double& velocity) const {
+    double P = expansion.Pc * std::exp(-lnRatio);
+    if (!m_solver.solveSP(*expansion.reactants, P, expansion.entropy, state)) {
+        return -1.0;
+    }
+    double dh = std::max(expansion.reactants->enthalpy - state.enthalpy, 0.0);
+    velocity = std::sqrt(2.0 * dh);
+    return state.density() * velocity;
+}
+
+bool RocketPerformance::solveChamber(const EquilibriumSolver::Reactants& reactants, double Pc,
+                                     WarmStart& warm, Result& result, Expansion& expansion) const {
+    if (!m_solver.solveHP(reactants, Pc, warm.chamber)) {
+        return false;
+    }
+    const EquilibriumSolver::State& chamber = warm.chamber;
+
+    result.Pc = Pc;
+    result.Tc = chamber.T;
+    expansion.reactants = &reactants;
+    expansion.Pc = Pc;
+    expansion.entropy = chamber.entropy;
+
+    // Isentropic exponent d(ln P)/d(ln rho) along the equilibrium isentrope
+    EquilibriumSolver::State probe = chamber;
+    double lnRho[2];
+    for (int i = 0; i < 2; ++i) {
+        double P = Pc * std::exp(i == 0 ? GAMMA_STEP : -GAMMA_STEP);
+        if (!m_solver.solveSP(reactants, P, chamber.entropy, probe)) {
+            return false;
+        }
+        lnRho[i] = std::log(probe.density());
+    }
+    result.gamma = 2.0 * GAMMA_STEP / (lnRho[0] - lnRho[1]);
+
+    // Throat: golden-section search for the maximum mass flux, first in a
+    // narrow bracket around the neighbouring point's throat
+    EquilibriumSolver::State& state = warm.nozzle;
+    state = chamber;
+    double u;
+    double x = 0.0, flux = -1.0;
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool narrow = attempt == 0 && warm.throatLnRatio > 0.0;
+        if (attempt == 0 && !narrow) continue;
+        double a = narrow ? warm.throatLnRatio - THROAT_WARM_BRACKET : THROAT_MIN;
+        double b = narrow ? warm.throatLnRatio + THROAT_WARM_BRACKET : THROAT_MAX;
+
+        double c = b - INV_PHI * (b - a);
+        double d = a + INV_PHI * (b - a);
+        double fc = massFlux(expansion, c, state, u);
+        double fd = massFlux(expansion, d, state, u);
+        while (b - a > THROAT_TOLERANCE) {
+            if (fc < 0.0 || fd < 0.0) return false;
+            if (fc > fd) {
+                b = d; d = c; fd = fc;
+                c = b - INV_PHI * (b - a);
+                fc = massFlux(expansion, c, state, u);
+            } else {
+                a = c; c = d; fc = fd;
+                d = a + INV_PHI * (b - a);
+                fd = massFlux(expansion, d, state, u);
+            }
+        }
+        x = 0.5 * (a + b);
+        flux = massFlux(expansion, x, state, u);
+
+        // A maximum on the edge of the narrow bracket means the throat moved
+        bool onEdge = narrow && (x - (warm.throatLnRatio - THROAT_WARM_BRACKET) < 10 * THROAT_TOLERANCE ||
+                                 (warm.throatLnRatio + THROAT_WARM_BRACKET) - x < 10 * THROAT_TOLERANCE);
+        if (!onEdge) break;
+    }
+    if (flux <= 0.0) {
+        return false;
+    }
+
+    warm.throatLnRatio = x;
+    expansion.throatFlux = flux;
+    result.Pt = Pc * std::exp(-x);
+    result.Cstar = Pc * BAR_TO_PA / flux;
+    return true;
+}
+
+bool RocketPerformance::solveExit(const Expansion& expansion, double lnRatio,
+                                  EquilibriumSolver::State& state, Result& result) const {
+    double u;
+    double flux = massFlux(expansion, lnRatio, state, u);
+    if (flux <= 0.0) {
+        return false;
+    }
+    result.Pe = expansion.Pc * std::exp(-lnRatio);
+    result.Ve = u;
+    result.areaRatio = expansion.throatFlux / flux;
+    return true;
+}
+
+bool RocketPerformance::solve(const EquilibriumSolver::Reactants& reactants, double Pc, double areaRatio,
+                              WarmStart& warm, Result& result) const {
+    if (!(areaRatio > 1.0)) {
+        return false;
+    }
+
+    Expansion expansion;
+    if (!solveChamber(reactants, Pc, warm, result, expansion)) {
+        return false;
+    }
+
+    // Supersonic branch: ln(Ae/At) grows with ln(Pc/Pe). Bracket the root
+    // starting from the neighbouring point's exit ratio, then Illinois
+    EquilibriumSolver::State& state = warm.nozzle;
+    const double lnEps = std::log(areaRatio);
+    auto residual = [&](double x, double& f) {
+        if (!solveExit(expansion, x, state, result)) return false;
+        f = std::log(result.areaRatio) - lnEps;
+        return true;
+    };
+
+    double lo = warm.throatLnRatio;
+    double flo = -lnEps;
+    double x = (warm.exitLnRatio > lo) ? warm.exitLnRatio : lo + 2.0;
+    double f;
+    if (!residual(x, f)) return false;
+    while (f < 0.0) {
+        lo = x;
+        flo = f;
+        x += 1.0;
+        if (x > lo + 40.0 || !residual(x, f)) return false;
+    }
+    double hi = x;
+    double fhi = f;
+
+    int side = 0;
+    for (int iter = 0; iter < MAX_EXIT_ITERATIONS && std::abs(f) > EXIT_TOLERANCE; ++iter) {
+        x = (lo * fhi - hi * flo) / (fhi - flo);
+        if (!residual(x, f)) return false;
+        if (f > 0.0) {
+            hi = x;
+            fhi = f;
+            if (side == 1) flo *= 0.5;
+            side = 1;
+        } else {
+            lo = x;
+            flo = f;
+            if (side == -1) fhi *= 0.5;
+            side = -1;
+        }
+        if (hi - lo <= EXIT_TOLERANCE * hi) break;
+    }
+
+    warm.exitLnRatio = x;
+    return true;
+}
+
+bool RocketPerformance::solveOptimal(const EquilibriumSolver::Reactants& reactants, double Pc, double Pe,
+                                     WarmStart& warm, Result& result) const {
+    Expansion expansion;
+    if (!(Pe > 0.0) || !solveChamber(reactants, Pc, warm, result, expansion)) {
+        return false;
+    }
+
+    double x = std::log(Pc / Pe);
+    if (x <= warm.throatLnRatio) {
+        return false;
+    }
+    if (!solveExit(expansion, x, warm.nozzle, result)) {
+        return false;
+    }
+    warm.exitLnRatio = x;
+    return true;
+}
@@ -0,0 +1,105 @@
+#ifndef ROCKET_PERFORMANCE_H
+#define ROCKET_PERFORMANCE_H
+
+#include "EquilibriumSolver.h"
+
+/**
+ * RocketPerformance
+ *
+ * Ideal rocket performance with shifting-equilibrium expansion, the native
+ * counterpart of RPA's Performance object as used by generate_rpa_tables.js:
+ *
+ *  - chamber: equilibrium at the chamber pressure and propellant enthalpy
+ *  - throat:  isentropic expansion to the pressure of maximum mass flux
+ *  - exit:    isentropic expansion to a fixed area ratio, or to an assigned
+ *             exit pressure for optimal expansion
+ *
+ * Every pressure is in bar. A RocketPerformance holds no per-solve state,
+ * so threads may share one; each passes its own WarmStart.
+ */
+class RocketPerformance {
+public:
+    struct Result {
+        double Pc;          // Chamber pressure (bar)
+        double Tc;          // Chamber temperature (K)
+        double gamma;       // Chamber isentropic exponent (equilibrium)
+        double Cstar;       // Characteristic velocity (m/s)
+        double Pt;          // Throat pressure (bar)
+        double Pe;          // Exit pressure (bar)
+        double Ve;          // Exit velocity (m/s)
+        double areaRatio;   // Ae/At
+
+        /**
+         * Thrust coefficient at an ambient pressure (bar)
+         */
+        double thrustCoefficient(double Pa) const {
+            return Ve / Cstar + (Pe - Pa) / Pc * areaRatio;
+        }
+
+        /**
+         * Specific impulse at an ambient pressure (s)
+         */
+        double specificImpulse(double Pa) const;
+    };
+
+    /**
+     * Solver states carried between neighbouring operating points; the
+     * converged chamber composition and exit pressure ratio of one point are
+     * the starting guesses for the next
+     */
+    struct WarmStart {
+        EquilibriumSolver::State chamber;
+        EquilibriumSolver::State nozzle;
+        double throatLnRatio;   // ln(Pc/Pt), 0 if unknown
+        double exitLnRatio;     // ln(Pc/Pe), 0 if unknown
+
+        WarmStart() : throatLnRatio(0.0), exitLnRatio(0.0) {}
+    };
+
+    explicit RocketPerformance(const EquilibriumSolver& solver);
+
+    /**
+     * Performance of a fixed-geometry nozzle
+     * @param areaRatio Ae/At (> 1)
+     * @return false if any equilibrium solve failed
+     */
+    bool solve(const EquilibriumSolver::Reactants& reactants, double Pc, double areaRatio,
+               WarmStart& warm, Result& result) const;
+
+    /**
+     * Performance of a nozzle expanded to an assigned exit pressure
+     * @param Pe Exit pressure (below the throat pressure)
+     */
+    bool solveOptimal(const EquilibriumSolver::Reactants& reactants, double Pc, double Pe,
+                      WarmStart& warm, Result& result) const;
+
+    const EquilibriumSolver& solver() const { return m_solver; }
+
+private:
+    // Stagnation conditions of the expansion being solved
+    struct Expansion {
+        const EquilibriumSolver::Reactants* reactants;
+        double Pc;          // bar
+        double entropy;     // J/kg/K
+        double throatFlux;  // kg/m^2/s
+    };
+
+    // Chamber and throat; fills Pc, Tc, gamma, Cstar, Pt
+    bool solveChamber(const EquilibriumSolver::Reactants& reactants, double Pc,
+                      WarmStart& warm, Result& result, Expansion& expansion) const;
+
+    /**
+     * Isentropic expansion from the chamber to Pc * exp(-lnRatio)
+     * @return Mass flux rho*u (kg/m^2/s), or a negative value on failure
+     */
+    double massFlux(const Expansion& expansion, double lnRatio,
+                    EquilibriumSolver::State& state, double& velocity) const;
+
+    // Exit state at Pc * exp(-lnRatio); fills Pe, Ve, areaRatio
+    bool solveExit(const Expansion& expansion, double lnRatio,
+                   EquilibriumSolver::State& state, Result& result) const;
+
+    const EquilibriumSolver& m_solver;
+};
+
+#endif // ROCKET_PERFORMANCE_H
@@ -0,0 +1,74 @@
+#include "TableAxis.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Relative deviation from an exact linspace still treated as uniform
+    const double UNIFORM_TOLERANCE = 1e-9;
+
+    // Upper limit on bucket count, as a multiple of the breakpoint count,
+    // for axes with a few very closely spaced breakpoints
+    const size_t MAX_BUCKETS_PER_POINT = 64;
+}
+
+TableAxis::TableAxis()
+    : m_uniform(false)
+    , m_bucketScale(0.0)
+    , m_maxBucket(0.0) {
+}
+
+void TableAxis::clear() {
+    m_values.clear();
+    m_buckets.clear();
+    m_uniform = false;
+    m_bucketScale = 0.0;
+    m_maxBucket = 0.0;
+}
+
+void TableAxis::assign(const std::vector<double>& values) {
+    clear();
+    m_values = values;
+
+    const size_t n = m_values.size();
+    if (n < 2) {
+        // Every query clamps; no cells to index
+        return;
+    }
+
+    const double span = m_values.back() - m_values.front();
+    const double step = span / (n - 1);
+
+    // Detect linspace-style axes
+    m_uniform = true;
+    double minGap = span;
+    for (size_t i = 1; i < n; ++i) {
+        double expected = m_values.front() + step * i;
+        if (std::abs(m_values[i] - expected) > UNIFORM_TOLERANCE * span) {
+            m_uniform = false;
+        }
+        minGap = std::min(minGap, m_values[i] - m_values[i - 1]);
+    }
+
+    if (m_uniform) {
+        // One bucket per cell; the cell index is the bucket index
+        m_bucketScale = (n - 1) / span;
+        m_maxBucket = static_cast<double>(n - 2);
+        return;
+    }
+
+    // Buckets no wider than the smallest gap hold at most one breakpoint each
+    size_t numBuckets = static_cast<size_t>(std::ceil(span / minGap));
+    numBuckets = std::max(numBuckets, n - 1);
+    numBuckets = std::min(numBuckets, MAX_BUCKETS_PER_POINT * n);
+
+    m_bucketScale = numBuckets / span;
+    m_maxBucket = static_cast<double>(numBuckets - 1);
+    m_buckets.resize(numBuckets);
+
+    for (size_t b = 0; b < numBuckets; ++b) {
+        double edge = m_values.front() + b / m_bucketScale;
+        auto it = std::upper_bound(m_values.begin(), m_values.end(), edge);
+        int idx = static_cast<int>(std::distance(m_values.begin(), it));
+        m_buckets[b] = std::min(std::max(idx, 1), static_cast<int>(n) - 1);
+    }
+}
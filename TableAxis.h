@@ -0,0 +1,113 @@
+#ifndef TABLE_AXIS_H
+#define TABLE_AXIS_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * TableAxis
+ *
+ * Sorted breakpoints of one table axis plus a lookup-acceleration index, so
+ * finding the cell that contains a value costs O(1) instead of a binary search.
+ *
+ *  - Uniformly spaced axes (every axis written by generate_rpa_tables.js) map a
+ *    value to its cell arithmetically.
+ *  - Other axes use a bucket index: the axis range is cut into equal-width
+ *    buckets no wider than the smallest breakpoint gap, and each bucket stores
+ *    the first candidate cell.
+ *
+ * Either way the guess is corrected against the actual breakpoints, so the
+ * result is always identical to std::upper_bound.
+ */
+class TableAxis {
+public:
+    TableAxis();
+
+    /**
+     * Set breakpoints and build the acceleration index
+     * @param values Strictly increasing breakpoint values
+     */
+    void assign(const std::vector<double>& values);
+    void clear();
+
+    const std::vector<double>& values() const { return m_values; }
+    const double* data() const { return m_values.data(); }
+    size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+    double front() const { return m_values.front(); }
+    double back() const { return m_values.back(); }
+    double operator[](size_t i) const { return m_values[i]; }
+
+    /**
+     * True if the breakpoints are evenly spaced (to rounding)
+     */
+    bool isUniform() const { return m_uniform; }
+
+    /**
+     * Find bounding indices for a value, clamping to the axis ends
+     * Values at or below front() (and NaN) give idx0 = idx1 = 0, values at or
+     * above back() give idx0 = idx1 = size()-1; both with t = 0.
+     * @param value Value to find bounds for
+     * @param idx0 Output: lower bound index
+     * @param idx1 Output: upper bound index
+     * @param t Output: interpolation factor [0,1]
+     */
+    void findBounds(double value, int& idx0, int& idx1, double& t) const {
+        // Clamp to table bounds
+        if (!(value > m_values.front())) {
+            idx0 = idx1 = 0;
+            t = 0.0;
+            return;
+        }
+        if (value >= m_values.back()) {
+            idx0 = idx1 = static_cast<int>(m_values.size()) - 1;
+            t = 0.0;
+            return;
+        }
+
+        idx1 = upperBound(value);
+        idx0 = idx1 - 1;
+
+        // Calculate interpolation factor
+        double v0 = m_values[idx0];
+        double v1 = m_values[idx1];
+        t = (value - v0) / (v1 - v0);
+    }
+
+    /**
+     * Index of the first breakpoint greater than value
+     * Only valid for front() < value < back(); result is in [1, size()-1].
+     */
+    int upperBound(double value) const {
+        const double* v = m_values.data();
+
+        // Position in bucket units, clamped in floating point so rounding at
+        // the ends stays in range
+        double g = (value - m_values.front()) * m_bucketScale;
+        if (!(g >= 0.0)) g = 0.0;
+        if (g > m_maxBucket) g = m_maxBucket;
+        int b = static_cast<int>(g);
+
+        int idx = m_uniform ? b + 1 : m_buckets[b];
+
+        // Correct the guess against the breakpoints (at most a step or two)
+        while (idx > 1 && v[idx - 1] > value) --idx;
+        while (v[idx] <= value) ++idx;
+        return idx;
+    }
+
+    // Acceleration index, exposed for the vectorised batch kernels
+    double bucketScale() const { return m_bucketScale; }
+    double maxBucket() const { return m_maxBucket; }
+    const int* buckets() const { return m_buckets.data(); }
+
+private:
+    std::vector<double> m_values;
+    bool m_uniform;
+
+    double m_bucketScale;       // Buckets per unit of the axis variable
+    double m_maxBucket;         // Index of the last bucket
+    std::vector<int> m_buckets; // First candidate upper index per bucket (non-uniform axes)
+};
+
+#endif // TABLE_AXIS_H
@@ -0,0 +1,327 @@
+#include "TableCsvReader.h"
+#include "MappedFile.h"
+#include <charconv>
+#include <algorithm>
+#include <thread>
+#include <cstring>
+#include <cmath>
+
+namespace {
+    // Smallest chunk worth a thread of its own
+    const size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+    bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    const char* skipBlanks(const char* p, const char* end) {
+        while (p < end && isBlank(*p)) ++p;
+        return p;
+    }
+
+    const char* nextLine(const char* p, const char* end) {
+        const void* newline = std::memchr(p, '\n', end - p);
+        return newline ? static_cast<const char*>(newline) + 1 : end;
+    }
+}
+
+const size_t TableCsvReader::MAX_LISTED;
+
+TableCsvReader::Settings::Settings()
+    : axisColumns(3)
+    , valueColumns(6)
+    , allowExtraColumns(false)
+    , threads(0) {
+}
+
+TableCsvReader::Report::Report()
+    : dataRows(0)
+    , loadedRows(0)
+    , skippedRowCount(0)
+    , duplicateCount(0)
+    , holeCount(0)
+    , threads(0) {
+}
+
+TableCsvReader::TableCsvReader(const Settings& settings)
+    : m_settings(settings) {
+}
+
+const char* TableCsvReader::skipReasonName(SkipReason reason) {
+    switch (reason) {
+    case SKIP_TOO_FEW_COLUMNS: return "too few columns";
+    case SKIP_TOO_MANY_COLUMNS: return "too many columns";
+    case SKIP_MALFORMED_VALUE: return "malformed value";
+    case SKIP_NON_FINITE_COORDINATE: return "non-finite coordinate";
+    }
+    return "unknown";
+}
+
+bool TableCsvReader::read(const std::string& filename) {
+    m_report = Report();
+    m_axes.assign(m_settings.axisColumns, std::vector<double>());
+    m_grid.clear();
+
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    const char* data = reinterpret_cast<const char*>(file.data());
+    const char* end = data + file.size();
+
+    // Skip header line
+    const char* body = nextLine(data, end);
+
+    // Split the body into chunks that start at line boundaries
+    unsigned threads = m_settings.threads ? m_settings.threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>((end - body) / MIN_CHUNK_BYTES)));
+
+    std::vector<Chunk> chunks(threads);
+    const char* p = body;
+    for (unsigned t = 0; t < threads; ++t) {
+        chunks[t].begin = p;
+        p = t + 1 == threads ? end : nextLine(std::max(p, body + (end - body) * (t + 1) / threads), end);
+        chunks[t].end = p;
+    }
+    m_report.threads = threads;
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back([this, &chunks, t]() { parseChunk(chunks[t]); });
+    }
+    parseChunk(chunks[0]);
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    buildGrid(chunks);
+    return m_report.loadedRows > 0 && m_report.holeCount == 0;
+}
+
+void TableCsvReader::parseChunk(Chunk& chunk) const {
+    // Size the output from the line count so no row reallocates it
+    const size_t lineEstimate = std::count(chunk.begin, chunk.end, '\n') + 1;
+    chunk.values.clear();
+    chunk.values.reserve(lineEstimate * columns());
+    chunk.rowLines.clear();
+    chunk.rowLines.reserve(lineEstimate);
+    chunk.skipped.clear();
+    chunk.skippedCount = 0;
+    chunk.dataRows = 0;
+    chunk.lines = 0;
+
+    std::vector<double> row(columns());
+    for (const char* line = chunk.begin; line < chunk.end;) {
+        const char* next = nextLine(line, chunk.end);
+        const char* lineEnd = next > line && next[-1] == '\n' ? next - 1 : next;
+        ++chunk.lines;
+
+        if (skipBlanks(line, lineEnd) != lineEnd) {
+            ++chunk.dataRows;
+            SkipReason reason;
+            size_t column;
+            if (parseRow(line, lineEnd, row.data(), reason, column)) {
+                chunk.values.insert(chunk.values.end(), row.begin(), row.end());
+                chunk.rowLines.push_back(chunk.lines);
+            } else {
+                ++chunk.skippedCount;
+                if (chunk.skipped.size() < MAX_LISTED) {
+                    SkippedRow skipped = { chunk.lines, reason, column };
+                    chunk.skipped.push_back(skipped);
+                }
+            }
+        }
+        line = next;
+    }
+
+    // Breakpoint candidates: this chunk's unique coordinates on each axis.
+    // Skipping repeats of the previous row first leaves little to sort on
+    // the slower-varying axes.
+    const size_t width = columns();
+    const size_t rows = chunk.rowLines.size();
+    chunk.axisValues.assign(m_settings.axisColumns, std::vector<double>());
+    for (size_t a = 0; a < m_settings.axisColumns; ++a) {
+        std::vector<double>& values = chunk.axisValues[a];
+        for (size_t r = 0; r < rows; ++r) {
+            const double v = chunk.values[r * width + a];
+            if (values.empty() || v != values.back()) values.push_back(v);
+        }
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+    }
+}
+
+bool TableCsvReader::parseRow(const char* p, const char* end, double* row,
+                              SkipReason& reason, size_t& column) const {
+    const size_t needed = columns();
+    for (size_t c = 0; c < needed; ++c) {
+        column = c + 1;
+        p = skipBlanks(p, end);
+        if (p == end) {
+            column = 0;
+            reason = SKIP_TOO_FEW_COLUMNS;
+            return false;
+        }
+        if (*p == '+') ++p;     // from_chars does not accept a leading '+'
+
+        std::from_chars_result parsed = std::from_chars(p, end, row[c]);
+        if (parsed.ec != std::errc()) {
+            reason = SKIP_MALFORMED_VALUE;
+            return false;
+        }
+        p = skipBlanks(parsed.ptr, end);
+
+        if (p == end) {
+            if (c + 1 < needed) {
+                column = 0;
+                reason = SKIP_TOO_FEW_COLUMNS;
+                return false;
+            }
+        } else if (*p != ',') {
+            reason = SKIP_MALFORMED_VALUE;
+            return false;
+        } else {
+            ++p;
+        }
+    }
+
+    // Anything after the last value is an extra column
+    if (p != end && !m_settings.allowExtraColumns) {
+        column = needed + 1;
+        reason = SKIP_TOO_MANY_COLUMNS;
+        return false;
+    }
+
+    for (size_t a = 0; a < m_settings.axisColumns; ++a) {
+        if (!std::isfinite(row[a])) {
+            column = a + 1;
+            reason = SKIP_NON_FINITE_COORDINATE;
+            return false;
+        }
+    }
+    return true;
+}
+
+void TableCsvReader::buildGrid(const std::vector<Chunk>& chunks) {
+    const size_t axes = m_settings.axisColumns;
+    const size_t width = columns();
+
+    // Line number of each chunk's first line (the header is line 1)
+    std::vector<size_t> firstLine(chunks.size());
+    size_t lines = 1;
+    size_t rows = 0;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        firstLine[c] = lines;
+        lines += chunks[c].lines;
+        rows += chunks[c].rowLines.size();
+
+        m_report.dataRows += chunks[c].dataRows;
+        m_report.skippedRowCount += chunks[c].skippedCount;
+        for (const SkippedRow& s : chunks[c].skipped) {
+            if (m_report.skippedRows.size() == MAX_LISTED) break;
+            SkippedRow global = { firstLine[c] + s.line, s.reason, s.column };
+            m_report.skippedRows.push_back(global);
+        }
+    }
+    m_report.loadedRows = rows;
+    if (rows == 0) {
+        return;
+    }
+
+    // Axes: sorted unique coordinates of each axis column, merged from the
+    // chunks
+    size_t points = 1;
+    std::vector<size_t> strides(axes);
+    for (size_t a = 0; a < axes; ++a) {
+        std::vector<double>& axis = m_axes[a];
+        for (const Chunk& chunk : chunks) {
+            axis.insert(axis.end(), chunk.axisValues[a].begin(), chunk.axisValues[a].end());
+        }
+        std::sort(axis.begin(), axis.end());
+        axis.erase(std::unique(axis.begin(), axis.end()), axis.end());
+        m_report.axisPoints.push_back(axis.size());
+    }
+    for (size_t a = axes; a-- > 0;) {
+        strides[a] = points;
+        points *= m_axes[a].size();
+    }
+
+    // Scatter each row into its grid slot, in file order so later rows win
+    const size_t fields = m_settings.valueColumns;
+    m_grid.assign(fields * points, 0.0);
+    std::vector<size_t> owner(points, 0);   // Line that set each point (0 = none)
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        const Chunk& chunk = chunks[c];
+        for (size_t r = 0; r < chunk.rowLines.size(); ++r) {
+            const double* row = &chunk.values[r * width];
+            size_t idx = 0;
+            for (size_t a = 0; a < axes; ++a) {
+                const std::vector<double>& axis = m_axes[a];
+                idx += (std::lower_bound(axis.begin(), axis.end(), row[a]) - axis.begin()) * strides[a];
+            }
+
+            const size_t line = firstLine[c] + chunk.rowLines[r];
+            if (owner[idx] != 0) {
+                ++m_report.duplicateCount;
+                if (m_report.duplicates.size() < MAX_LISTED) {
+                    DuplicatePoint duplicate = { line, owner[idx] };
+                    m_report.duplicates.push_back(duplicate);
+                }
+            }
+            owner[idx] = line;
+            for (size_t f = 0; f < fields; ++f) {
+                m_grid[f * points + idx] = row[axes + f];
+            }
+        }
+    }
+
+    // Every grid point must be present for interpolation to be well defined
+    for (size_t idx = 0; idx < points; ++idx) {
+        if (owner[idx] != 0) continue;
+        ++m_report.holeCount;
+        if (m_report.holes.size() < MAX_LISTED) {
+            std::vector<double> coords(axes);
+            for (size_t a = 0; a < axes; ++a) coords[a] = m_axes[a][(idx / strides[a]) % m_axes[a].size()];
+            m_report.holes.push_back(coords);
+        }
+    }
+}
+
+void TableCsvReader::Report::write(std::ostream& out) const {
+    out << "Loaded " << loadedRows << " of " << dataRows << " rows";
+    if (!axisPoints.empty()) {
+        out << " into a ";
+        for (size_t a = 0; a < axisPoints.size(); ++a) out << (a ? " x " : "") << axisPoints[a];
+        out << " grid";
+    }
+    out << " (" << threads << (threads == 1 ? " thread)" : " threads)") << "\n";
+
+    if (skippedRowCount) {
+        out << "Skipped rows: " << skippedRowCount << "\n";
+        for (const SkippedRow& s : skippedRows) {
+            out << "  line " << s.line << ": " << skipReasonName(s.reason);
+            if (s.column) out << " (column " << s.column << ")";
+            out << "\n";
+        }
+    }
+    if (duplicateCount) {
+        out << "Duplicate grid points: " << duplicateCount << " (later rows win)\n";
+        for (const DuplicatePoint& d : duplicates) {
+            out << "  line " << d.line << " repeats line " << d.firstLine << "\n";
+        }
+    }
+    if (holeCount) {
+        out << "Missing grid points: " << holeCount << "\n";
+        for (const std::vector<double>& h : holes) {
+            out << "  (";
+            for (size_t a = 0; a < h.size(); ++a) out << (a ? ", " : "") << h[a];
+            out << ")\n";
+        }
+    }
+    size_t unlisted = skippedRowCount - skippedRows.size() + duplicateCount - duplicates.size() +
+                      holeCount - holes.size();
+    if (unlisted) {
+        out << "  (" << unlisted << " more not listed)\n";
+    }
+    out.flush();
+}
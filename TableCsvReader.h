@@ -0,0 +1,138 @@
+#ifndef TABLE_CSV_READER_H
+#define TABLE_CSV_READER_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstddef>
+
+/**
+ * TableCsvReader
+ *
+ * Reads a performance table CSV (a header line, then one row per grid point:
+ * the axis coordinates followed by the field values) into a dense grid.
+ *
+ * The file is mapped in one pass and split at line boundaries into chunks
+ * that are parsed in parallel with std::from_chars, with no per-line
+ * allocation. Axes are the sorted unique coordinates of each axis column.
+ * Every problem found on the way is listed in a Report: rows skipped (and
+ * why), rows repeating a grid point (the later row wins) and grid points no
+ * row provides.
+ */
+class TableCsvReader {
+public:
+    enum SkipReason {
+        SKIP_TOO_FEW_COLUMNS,
+        SKIP_TOO_MANY_COLUMNS,          // Only when extra columns are not allowed
+        SKIP_MALFORMED_VALUE,
+        SKIP_NON_FINITE_COORDINATE
+    };
+
+    struct SkippedRow {
+        size_t line;            // 1-based line number in the file
+        SkipReason reason;
+        size_t column;          // 1-based column of the bad value (0 if none)
+    };
+
+    struct DuplicatePoint {
+        size_t line;            // Row that replaced the earlier value
+        size_t firstLine;       // Row that first provided the grid point
+    };
+
+    struct Report {
+        size_t dataRows;                // Non-blank lines after the header
+        size_t loadedRows;              // Rows placed into the grid
+        size_t skippedRowCount;
+        size_t duplicateCount;
+        size_t holeCount;               // Grid points no row provides
+        std::vector<size_t> axisPoints; // Breakpoints found on each axis
+        unsigned threads;               // Chunks parsed in parallel
+
+        // The first MAX_LISTED of each kind
+        std::vector<SkippedRow> skippedRows;
+        std::vector<DuplicatePoint> duplicates;
+        std::vector<std::vector<double>> holes;     // Coordinates of each missing point
+
+        Report();
+
+        /**
+         * True if nothing was skipped, repeated or missing
+         */
+        bool clean() const { return skippedRowCount == 0 && duplicateCount == 0 && holeCount == 0; }
+
+        /**
+         * Human-readable summary followed by the listed problems
+         */
+        void write(std::ostream& out) const;
+    };
+
+    static const size_t MAX_LISTED = 1000;
+
+    struct Settings {
+        size_t axisColumns;
+        size_t valueColumns;
+        // Ignore columns after the values; otherwise such rows are skipped
+        bool allowExtraColumns;
+        // Parsing threads (0 = all cores); small files always use one
+        unsigned threads;
+
+        Settings();
+    };
+
+    explicit TableCsvReader(const Settings& settings);
+
+    /**
+     * Read a table
+     * @return false if the file cannot be read, has no usable rows, or
+     *         leaves grid points without a value (see getReport)
+     */
+    bool read(const std::string& filename);
+
+    const Report& getReport() const { return m_report; }
+
+    /**
+     * Breakpoints of one axis (strictly increasing)
+     */
+    const std::vector<double>& getAxis(size_t axis) const { return m_axes[axis]; }
+
+    /**
+     * Move the grid out of the reader: valueColumns contiguous blocks, each
+     * in row-major order over the axes with the last axis varying fastest
+     */
+    void takeGrid(std::vector<double>& grid) { grid.swap(m_grid); }
+
+    static const char* skipReasonName(SkipReason reason);
+
+private:
+    // Rows parsed from one chunk of the file
+    struct Chunk {
+        const char* begin;
+        const char* end;
+        size_t lines;                   // Lines in the chunk, blank ones included
+        std::vector<double> values;     // columns() values per parsed row
+        std::vector<size_t> rowLines;   // Line of each parsed row, within the chunk
+        std::vector<std::vector<double>> axisValues;    // Sorted unique coordinates per axis
+        std::vector<SkippedRow> skipped;    // Line within the chunk
+        size_t skippedCount;
+        size_t dataRows;
+    };
+
+    size_t columns() const { return m_settings.axisColumns + m_settings.valueColumns; }
+
+    void parseChunk(Chunk& chunk) const;
+
+    /**
+     * Parse one line (without its terminator) into row
+     * @return true if the row is usable; otherwise reason and column say why
+     */
+    bool parseRow(const char* p, const char* end, double* row, SkipReason& reason, size_t& column) const;
+
+    void buildGrid(const std::vector<Chunk>& chunks);
+
+    Settings m_settings;
+    Report m_report;
+    std::vector<std::vector<double>> m_axes;
+    std::vector<double> m_grid;
+};
+
+#endif // TABLE_CSV_READER_H
@@ -0,0 +1,300 @@
+#ifndef TABLE_INTERPOLATOR_ND_H
+#define TABLE_INTERPOLATOR_ND_H
+
+#include "TableAxis.h"
+#include "MultilinearKernel.h"
+#include "TableCsvReader.h"
+#include <array>
+#include <vector>
+#include <string>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * TableInterpolatorND
+ *
+ * Dense N-dimensional table of a fixed set of fields with multilinear
+ * interpolation, for performance tables with more axes than (Pc, O/F, Pa),
+ * such as nozzle area ratio or propellant temperature, so a sweep over those
+ * runs from one table instead of one file per value.
+ *
+ * @tparam N Number of axes
+ * @tparam FieldSet Type describing the stored fields; it must define
+ *         `static const size_t COUNT`. RPAPerformanceFields (in
+ *         RPATableInterpolator.h) holds the RPATableInterpolator::Field set.
+ *
+ * The grid is stored as FieldSet::COUNT contiguous blocks, each in row-major
+ * order with the last axis varying fastest. Cell lookup uses TableAxis on
+ * every axis and clamps to the table edges; the corner gather and blend are
+ * MultilinearKernel<N>, unrolled at compile time. RPATableInterpolator's
+ * trilinear path runs the same kernel with N = 3.
+ */
+template <size_t N, typename FieldSet>
+class TableInterpolatorND {
+public:
+    static const size_t DIMENSIONS = N;
+    static const size_t NUM_FIELDS = FieldSet::COUNT;
+    static const unsigned MASK_ALL = (1u << NUM_FIELDS) - 1;
+
+    typedef MultilinearKernel<N> Kernel;
+
+    // Cell containing a query point
+    struct Cell {
+        size_t base;            // Offset of the lowest corner within a field block
+        size_t delta[N];        // Offset to the upper corner along each axis (0 when clamped)
+        double t[N];            // Interpolation factors [0,1]
+    };
+
+    TableInterpolatorND();
+
+    /**
+     * Load a table from values already in memory
+     * @param axes Strictly increasing breakpoints of each axis
+     * @param values NUM_FIELDS values per grid point, points in row-major
+     *               order with the last axis varying fastest
+     * @return false if an axis is empty or not increasing, or the value
+     *         count does not match the axes
+     */
+    bool loadGrid(const std::array<std::vector<double>, N>& axes, const std::vector<double>& values);
+
+    /**
+     * Load a table from CSV
+     * Each data row holds exactly the N axis values followed by the
+     * NUM_FIELDS field values (the first line is a header); other rows are
+     * skipped. As with RPATableInterpolator, a table with missing grid
+     * points is rejected, and getLoadReport() lists what was wrong.
+     * @return true if successful, false otherwise
+     */
+    bool loadTable(const std::string& filename);
+
+    bool isValid() const { return m_isLoaded; }
+
+    const TableAxis& getAxis(size_t axis) const { return m_axes[axis]; }
+    size_t getNumPoints() const { return m_numPoints; }
+
+    /**
+     * Number of grid points missing from the last table passed to loadTable
+     */
+    size_t getMissingPointCount() const { return m_loadReport.holeCount; }
+
+    /**
+     * Diagnostics from the last loadTable
+     */
+    const TableCsvReader::Report& getLoadReport() const { return m_loadReport; }
+
+    /**
+     * Find the cell and interpolation factors for a query point
+     */
+    void locate(const double x[N], Cell& cell) const;
+
+    /**
+     * Multilinear interpolation of one field over a located cell
+     */
+    double interpolate(size_t field, const Cell& cell) const {
+        double c[Kernel::CORNERS];
+        Kernel::gatherCorners(fieldData(field) + cell.base, cell.delta, c);
+        return Kernel::blend(c, cell.t);
+    }
+
+    /**
+     * Interpolate the fields selected at compile time (bit i selects field
+     * i); the rest are NaN
+     * @param x Query point, one coordinate per axis
+     * @param out Output: NUM_FIELDS values
+     */
+    template <unsigned Fields>
+    void getFields(const double x[N], double out[NUM_FIELDS]) const;
+
+    void getValues(const double x[N], double out[NUM_FIELDS]) const {
+        getFields<MASK_ALL>(x, out);
+    }
+
+    /**
+     * Values and partial derivatives of the selected fields
+     * Derivatives are those of the cell the point falls in and zero along
+     * an axis where the point is clamped, as in RPATableInterpolator.
+     * @param gradient Output: gradient[a][f] = d(field f)/d(axis a)
+     */
+    template <unsigned Fields>
+    void getFieldsWithGradient(const double x[N], double out[NUM_FIELDS],
+                               double gradient[N][NUM_FIELDS]) const;
+
+private:
+    TableAxis m_axes[N];
+    size_t m_strides[N];        // Last axis has stride 1
+    size_t m_numPoints;
+    TableCsvReader::Report m_loadReport;
+    std::vector<double> m_grid; // NUM_FIELDS blocks of m_numPoints values
+    bool m_isLoaded;
+
+    void clearTable();
+    void setGridShape();
+
+    const double* fieldData(size_t field) const {
+        return m_grid.data() + field * m_numPoints;
+    }
+
+    void checkLoaded() const {
+        if (!m_isLoaded) {
+            throw std::runtime_error("Performance table not loaded");
+        }
+    }
+};
+
+// ================================================================
+// Implementation
+// ================================================================
+
+template <size_t N, typename FieldSet>
+TableInterpolatorND<N, FieldSet>::TableInterpolatorND()
+    : m_numPoints(0)
+    , m_isLoaded(false) {
+    std::fill(m_strides, m_strides + N, size_t(0));
+}
+
+template <size_t N, typename FieldSet>
+void TableInterpolatorND<N, FieldSet>::clearTable() {
+    m_isLoaded = false;
+    for (size_t a = 0; a < N; ++a) {
+        m_axes[a].clear();
+        m_strides[a] = 0;
+    }
+    m_grid.clear();
+    m_numPoints = 0;
+    m_loadReport = TableCsvReader::Report();
+}
+
+template <size_t N, typename FieldSet>
+void TableInterpolatorND<N, FieldSet>::setGridShape() {
+    size_t stride = 1;
+    for (size_t a = N; a-- > 0;) {
+        m_strides[a] = stride;
+        stride *= m_axes[a].size();
+    }
+    m_numPoints = stride;
+}
+
+template <size_t N, typename FieldSet>
+bool TableInterpolatorND<N, FieldSet>::loadGrid(const std::array<std::vector<double>, N>& axes,
+                                                const std::vector<double>& values) {
+    clearTable();
+
+    for (size_t a = 0; a < N; ++a) {
+        if (axes[a].empty()) {
+            return false;
+        }
+        for (size_t i = 1; i < axes[a].size(); ++i) {
+            if (!(axes[a][i] > axes[a][i - 1])) {
+                return false;
+            }
+        }
+    }
+    size_t points = 1;
+    for (size_t a = 0; a < N; ++a) points *= axes[a].size();
+    if (values.size() != points * NUM_FIELDS) {
+        return false;
+    }
+
+    for (size_t a = 0; a < N; ++a) m_axes[a].assign(axes[a]);
+    setGridShape();
+
+    // Point-major input to one block per field
+    m_grid.resize(NUM_FIELDS * m_numPoints);
+    for (size_t i = 0; i < m_numPoints; ++i) {
+        for (size_t f = 0; f < NUM_FIELDS; ++f) {
+            m_grid[f * m_numPoints + i] = values[i * NUM_FIELDS + f];
+        }
+    }
+
+    m_isLoaded = true;
+    return true;
+}
+
+template <size_t N, typename FieldSet>
+bool TableInterpolatorND<N, FieldSet>::loadTable(const std::string& filename) {
+    clearTable();
+
+    TableCsvReader::Settings settings;
+    settings.axisColumns = N;
+    settings.valueColumns = NUM_FIELDS;
+    settings.allowExtraColumns = false;
+
+    TableCsvReader reader(settings);
+    bool ok = reader.read(filename);
+    m_loadReport = reader.getReport();
+    if (!ok) {
+        return false;
+    }
+
+    for (size_t a = 0; a < N; ++a) m_axes[a].assign(reader.getAxis(a));
+    setGridShape();
+    reader.takeGrid(m_grid);
+
+    m_isLoaded = true;
+    return true;
+}
+
+template <size_t N, typename FieldSet>
+inline void TableInterpolatorND<N, FieldSet>::locate(const double x[N], Cell& cell) const {
+    cell.base = 0;
+    for (size_t a = 0; a < N; ++a) {
+        int idx0, idx1;
+        m_axes[a].findBounds(x[a], idx0, idx1, cell.t[a]);
+        cell.base += idx0 * m_strides[a];
+        cell.delta[a] = (idx1 - idx0) * m_strides[a];
+    }
+}
+
+template <size_t N, typename FieldSet>
+template <unsigned Fields>
+void TableInterpolatorND<N, FieldSet>::getFields(const double x[N], double out[NUM_FIELDS]) const {
+    static_assert(Fields != 0 && (Fields & ~MASK_ALL) == 0,
+                  "getFields needs a non-empty subset of the table's fields");
+
+    checkLoaded();
+
+    Cell cell;
+    locate(x, cell);
+    for (size_t f = 0; f < NUM_FIELDS; ++f) {
+        out[f] = (Fields & (1u << f)) ? interpolate(f, cell) : std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+template <size_t N, typename FieldSet>
+template <unsigned Fields>
+void TableInterpolatorND<N, FieldSet>::getFieldsWithGradient(const double x[N], double out[NUM_FIELDS],
+                                                             double gradient[N][NUM_FIELDS]) const {
+    static_assert(Fields != 0 && (Fields & ~MASK_ALL) == 0,
+                  "getFieldsWithGradient needs a non-empty subset of the table's fields");
+
+    checkLoaded();
+
+    Cell cell;
+    locate(x, cell);
+
+    // Cell width along each axis (0 where clamped)
+    double width[N];
+    for (size_t a = 0; a < N; ++a) {
+        const double* v = m_axes[a].data();
+        const size_t lower = (cell.base / m_strides[a]) % m_axes[a].size();
+        width[a] = cell.delta[a] ? v[lower + 1] - v[lower] : 0.0;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (size_t f = 0; f < NUM_FIELDS; ++f) {
+        if (!(Fields & (1u << f))) {
+            out[f] = nan;
+            for (size_t a = 0; a < N; ++a) gradient[a][f] = nan;
+            continue;
+        }
+        double c[Kernel::CORNERS];
+        double dt[N];
+        Kernel::gatherCorners(fieldData(f) + cell.base, cell.delta, c);
+        out[f] = Kernel::gradient(c, cell.t, dt);
+        for (size_t a = 0; a < N; ++a) gradient[a][f] = width[a] == 0.0 ? 0.0 : dt[a] / width[a];
+    }
+}
+
+#endif // TABLE_INTERPOLATOR_ND_H
@@ -0,0 +1,191 @@
+#include "ThermoDatabase.h"
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+    // Exponents of the standard 9-coefficient form; other fits are skipped
+    const double NASA9_EXPONENTS[7] = { -2.0, -1.0, 0.0, 1.0, 2.0, 3.0, 4.0 };
+
+    // Gas constant (J/mol/K)
+    const double R_UNIVERSAL = 8.314462618;
+
+    std::string trim(const std::string& s) {
+        size_t b = s.find_first_not_of(" \t\r\n");
+        if (b == std::string::npos) return std::string();
+        size_t e = s.find_last_not_of(" \t\r\n");
+        return s.substr(b, e - b + 1);
+    }
+
+    std::string upper(std::string s) {
+        std::transform(s.begin(), s.end(), s.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        return s;
+    }
+
+    /**
+     * Fixed-width Fortran field; accepts D exponents, blank is zero
+     */
+    double field(const std::string& line, size_t begin, size_t width) {
+        if (begin >= line.size()) return 0.0;
+        std::string s = line.substr(begin, width);
+        std::replace(s.begin(), s.end(), 'D', 'E');
+        std::replace(s.begin(), s.end(), 'd', 'e');
+        s = trim(s);
+        return s.empty() ? 0.0 : std::strtod(s.c_str(), nullptr);
+    }
+
+    const ThermoDatabase::Interval& intervalFor(const std::vector<ThermoDatabase::Interval>& intervals,
+                                                double T) {
+        for (const auto& in : intervals) {
+            if (T <= in.Thigh) return in;
+        }
+        return intervals.back();
+    }
+}
+
+void ThermoDatabase::Species::evaluate(double T, double& cp, double& h, double& s) const {
+    if (intervals.empty()) {
+        // Reactant with an assigned enthalpy only
+        cp = 0.0;
+        h = enthalpy / (R_UNIVERSAL * T);
+        s = 0.0;
+        return;
+    }
+
+    const Interval& in = intervalFor(intervals, T);
+    const double* a = in.a;
+    const double lnT = std::log(T);
+    const double T2 = T * T;
+    const double T3 = T2 * T;
+    const double T4 = T3 * T;
+
+    cp = a[0] / T2 + a[1] / T + a[2] + a[3] * T + a[4] * T2 + a[5] * T3 + a[6] * T4;
+    h = -a[0] / T2 + a[1] * lnT / T + a[2] + a[3] * T / 2.0 + a[4] * T2 / 3.0 +
+        a[5] * T3 / 4.0 + a[6] * T4 / 5.0 + in.b[0] / T;
+    s = -a[0] / (2.0 * T2) - a[1] / T + a[2] * lnT + a[3] * T + a[4] * T2 / 2.0 +
+        a[5] * T3 / 3.0 + a[6] * T4 / 4.0 + in.b[1];
+}
+
+double ThermoDatabase::Species::enthalpyAt(double T) const {
+    if (intervals.empty()) {
+        return enthalpy;
+    }
+    double cp, h, s;
+    evaluate(T, cp, h, s);
+    return h * R_UNIVERSAL * T;
+}
+
+double ThermoDatabase::Species::atoms(const std::string& element) const {
+    for (const auto& f : formula) {
+        if (f.first == element) return f.second;
+    }
+    return 0.0;
+}
+
+bool ThermoDatabase::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    m_species.clear();
+    m_index.clear();
+
+    std::string line;
+    bool inData = false;
+    bool products = true;
+
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::string t = trim(line);
+        if (t.empty() || line[0] == '!') continue;
+
+        if (!inData) {
+            // Header: "thermo", then the default temperature ranges
+            if (upper(t).compare(0, 6, "THERMO") == 0) {
+                std::getline(file, line);
+                inData = true;
+            }
+            continue;
+        }
+
+        std::string key = upper(t);
+        if (key.compare(0, 12, "END PRODUCTS") == 0) {
+            products = false;
+            continue;
+        }
+        if (key.compare(0, 13, "END REACTANTS") == 0) {
+            break;
+        }
+
+        // Record line 1: name; line 2: intervals, formula, phase, weight, enthalpy
+        Species sp;
+        sp.name = t.substr(0, t.find_first_of(" \t"));
+        sp.product = products;
+
+        std::string header;
+        if (!std::getline(file, header)) break;
+
+        int numIntervals = static_cast<int>(field(header, 0, 2));
+        for (int e = 0; e < 5; ++e) {
+            std::string symbol = trim(header.size() > size_t(10 + 8 * e) ? header.substr(10 + 8 * e, 2) : "");
+            double count = field(header, 12 + 8 * e, 6);
+            if (!symbol.empty() && count != 0.0) {
+                sp.formula.push_back(std::make_pair(upper(symbol), count));
+            }
+        }
+        sp.condensed = field(header, 50, 2) != 0.0;
+        sp.molWeight = field(header, 52, 13);
+        sp.enthalpy = field(header, 65, 15);
+        sp.referenceT = 298.15;
+
+        bool valid = sp.molWeight > 0.0;
+        if (numIntervals == 0) {
+            // Assigned-enthalpy reactant: one line with its temperature
+            if (!std::getline(file, line)) break;
+            sp.referenceT = field(line, 0, 11);
+        }
+        for (int i = 0; i < numIntervals; ++i) {
+            std::string range, c1, c2;
+            if (!std::getline(file, range) || !std::getline(file, c1) || !std::getline(file, c2)) {
+                valid = false;
+                break;
+            }
+
+            Interval in;
+            in.Tlow = field(range, 0, 11);
+            in.Thigh = field(range, 11, 11);
+            for (int k = 0; k < 7; ++k) {
+                if (field(range, 23 + 5 * k, 5) != NASA9_EXPONENTS[k]) valid = false;
+            }
+            for (int k = 0; k < 5; ++k) in.a[k] = field(c1, 16 * k, 16);
+            in.a[5] = field(c2, 0, 16);
+            in.a[6] = field(c2, 16, 16);
+            in.b[0] = field(c2, 48, 16);
+            in.b[1] = field(c2, 64, 16);
+            sp.intervals.push_back(in);
+        }
+        if (!valid) continue;
+
+        // First entry wins; aliases after a comma (but not concentrations or
+        // temperatures such as "98%" or "298.15K") are also indexed
+        size_t id = m_species.size();
+        m_index.insert(std::make_pair(upper(sp.name), id));
+        size_t comma = sp.name.rfind(',');
+        if (comma != std::string::npos && comma + 1 < sp.name.size() &&
+            !std::isdigit(static_cast<unsigned char>(sp.name[comma + 1]))) {
+            m_index.insert(std::make_pair(upper(sp.name.substr(comma + 1)), id));
+        }
+        m_species.push_back(sp);
+    }
+
+    return !m_species.empty();
+}
+
+const ThermoDatabase::Species* ThermoDatabase::find(const std::string& name) const {
+    auto it = m_index.find(upper(name));
+    return it == m_index.end() ? nullptr : &m_species[it->second];
+}
@@ -0,0 +1,79 @@
+#ifndef THERMO_DATABASE_H
+#define THERMO_DATABASE_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <map>
+
+/**
+ * ThermoDatabase
+ *
+ * Reads the NASA Glenn (CEA) thermodynamic database shipped with RPA as
+ * RPA/2.3/standard/resources/thermo.inp: 9-coefficient Cp polynomials per
+ * temperature interval for every product species, plus the assigned
+ * enthalpies of the propellant reactants.
+ */
+class ThermoDatabase {
+public:
+    // One temperature interval of a NASA 9-coefficient fit:
+    // Cp/R = a0/T^2 + a1/T + a2 + a3*T + a4*T^2 + a5*T^3 + a6*T^4
+    struct Interval {
+        double Tlow, Thigh; // K
+        double a[7];
+        double b[2];        // Integration constants for H and S
+    };
+
+    struct Species {
+        std::string name;
+        std::vector<std::pair<std::string, double>> formula;  // Element symbol, atoms per molecule
+        bool condensed;
+        bool product;       // Listed before END PRODUCTS
+        double molWeight;   // g/mol
+        double enthalpy;    // J/mol: heat of formation at 298.15 K, or the
+                            // assigned enthalpy at referenceT for reactants
+                            // without a Cp fit
+        double referenceT;  // K
+        std::vector<Interval> intervals;
+
+        /**
+         * Dimensionless properties at T (fits are extrapolated outside
+         * their range from the nearest interval)
+         * @param cp Output: Cp/R
+         * @param h Output: H/RT
+         * @param s Output: S/R at 1 bar
+         */
+        void evaluate(double T, double& cp, double& h, double& s) const;
+
+        /**
+         * Molar enthalpy at T in J/mol (assigned enthalpy if there is no fit)
+         */
+        double enthalpyAt(double T) const;
+
+        /**
+         * Atoms of an element per molecule (0 if absent)
+         */
+        double atoms(const std::string& element) const;
+    };
+
+    /**
+     * Load a thermo.inp file
+     * @return false if the file is missing or contains no species
+     */
+    bool load(const std::string& filename);
+
+    /**
+     * Find a species by name, case-insensitively
+     * Also matches the alias after a comma, e.g. "UDMH" for "C2H8N2(L),UDMH".
+     * @return nullptr if not found
+     */
+    const Species* find(const std::string& name) const;
+
+    const std::vector<Species>& species() const { return m_species; }
+
+private:
+    std::vector<Species> m_species;
+    std::map<std::string, size_t> m_index;  // Upper-cased name and alias -> species
+};
+
+#endif // THERMO_DATABASE_H
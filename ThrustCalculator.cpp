@@ -1,18 +1,53 @@
 #include "ThrustCalculator.h"
+#include "Instrumentation.h"
+#include "MultilinearKernel.h"
 #include <stdexcept>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
 #include <cmath>
 
+namespace {
+    const double FT_PER_M = 3.28084;
+    const double GC = 32.174;               // lbm·ft/(lbf·s^2)
+
+    // Mass-flow solve: relative Pc residual, and table evaluations allowed
+    const double MASS_FLOW_TOLERANCE = 1.0e-9;
+    const int MAX_MASS_FLOW_EVALUATIONS = 20;
+
+    // Default inverse-table breakpoints along mdot per Pc interval
+    const size_t INVERSE_POINTS_PER_PC_INTERVAL = 8;
+}
+
 ThrustCalculator::ThrustCalculator()
     : m_tableInterpolator(nullptr)
-    , m_At_in2(0.0) {
+    , m_At_in2(0.0)
+    , m_inverseEnabled(false)
+    , m_inverseMassFlowPoints(0)
+    , m_inverseReport() {
+}
+
+ThrustCalculator::ThrustCalculator(std::shared_ptr<const RPATableInterpolator> table)
+    : m_tableInterpolator(std::move(table))
+    , m_At_in2(0.0)
+    , m_inverseEnabled(false)
+    , m_inverseMassFlowPoints(0)
+    , m_inverseReport() {
 }
 
 ThrustCalculator::~ThrustCalculator() {
 }
 
 bool ThrustCalculator::loadPerformanceTable(const std::string& table_filename) {
-    m_tableInterpolator = std::make_unique<RPATableInterpolator>();
-    return m_tableInterpolator->loadTable(table_filename);
+    setPerformanceTable(PerformanceTableRegistry::instance().acquire(table_filename));
+    return m_tableInterpolator != nullptr;
+}
+
+void ThrustCalculator::setPerformanceTable(std::shared_ptr<const RPATableInterpolator> table) {
+    m_tableInterpolator = std::move(table);
+    m_state = QueryState();
+    updateInverseTable();
 }
 
 void ThrustCalculator::setThroatArea(double At_in2) {
@@ -20,6 +55,7 @@ void ThrustCalculator::setThroatArea(double At_in2) {
         throw std::invalid_argument("Throat area must be positive");
     }
     m_At_in2 = At_in2;
+    updateInverseTable();
 }
 
 void ThrustCalculator::sizeEngineFromDesignPoint(double F_design, double Pc_design,
@@ -29,83 +65,321 @@ void ThrustCalculator::sizeEngineFromDesignPoint(double F_design, double Pc_desi
     }
 
     // Get Cf at design point
-    auto perf = m_tableInterpolator->getPerformance(Pc_design, OF_design, Pa_design);
+    auto perf = m_tableInterpolator->getFields<RPATableInterpolator::MASK_CF>(Pc_design, OF_design, Pa_design);
     double Cf_design = perf.Cf;
 
     // Calculate required throat area
     // F = Cf × Pc × At
     // At = F / (Cf × Pc)
     m_At_in2 = F_design / (Cf_design * Pc_design);
+    updateInverseTable();
 }
 
 double ThrustCalculator::calculateThrust(double Pc, double mdot_ox, double mdot_fuel, double Pa) {
+    return calculateThrust(Pc, mdot_ox, mdot_fuel, Pa, m_state);
+}
+
+double ThrustCalculator::calculateThrust(double Pc, double mdot_ox, double mdot_fuel, double Pa,
+                                         QueryState& state) const {
     if (!isReady()) {
         throw std::runtime_error("ThrustCalculator not ready: load table and set throat area");
     }
 
     // Calculate mixture ratio
-    double mdot_total = mdot_ox + mdot_fuel;
     if (mdot_fuel <= 0.0) {
         throw std::invalid_argument("Fuel mass flow rate must be positive");
     }
     double OF = mdot_ox / mdot_fuel;
 
-    // Get performance data from tables
-    m_lastPerformance = m_tableInterpolator->getPerformance(Pc, OF, Pa);
+    RPA_COUNT(THRUST_QUERIES);
+
+    // Only Cf is needed for the thrust equation
+    auto perf = m_tableInterpolator->getFields<RPATableInterpolator::MASK_CF>(Pc, OF, Pa, state.cursor);
+    state.hasLastPoint = true;
+    state.lastPc = Pc;
+    state.lastOF = OF;
+    state.lastPa = Pa;
 
     // Calculate thrust using chamber pressure equation
     // F = Cf × Pc × At
-    double F_lbf = m_lastPerformance.Cf * Pc * m_At_in2;
+    double F_lbf = perf.Cf * Pc * m_At_in2;
 
     return F_lbf;
 }
 
+CompiledThrustModel ThrustCalculator::compile() const {
+    if (!isReady()) {
+        throw std::runtime_error("ThrustCalculator not ready: load table and set throat area");
+    }
+    if (m_tableInterpolator->getInterpolationMode() != RPATableInterpolator::InterpolationMode::Trilinear) {
+        throw std::runtime_error("ThrustCalculator::compile needs a trilinear performance table");
+    }
+    return CompiledThrustModel(*m_tableInterpolator, m_At_in2);
+}
+
 double ThrustCalculator::calculateThrustFromMassFlow(double mdot_total, double OF, double Pa) {
+    return calculateThrustFromMassFlow(mdot_total, OF, Pa, m_state);
+}
+
+double ThrustCalculator::calculateThrustFromMassFlow(double mdot_total, double OF, double Pa,
+                                                     QueryState& state) const {
     if (!isReady()) {
         throw std::runtime_error("ThrustCalculator not ready: load table and set throat area");
     }
 
-    // For mass flow based calculation, we need to estimate Pc
-    // This is an iterative problem, but we can use a typical Pc or
-    // calculate it from the relationship: Pc = mdot × C* / At
+    if (!(mdot_total > 0.0)) {
+        throw std::invalid_argument("Total mass flow rate must be positive");
+    }
 
-    // We'll use a reference Pc (middle of table range) to get C* and Cf
-    double Pc_min, Pc_max, OF_min, OF_max, Pa_min, Pa_max;
-    m_tableInterpolator->getBounds(Pc_min, Pc_max, OF_min, OF_max, Pa_min, Pa_max);
+    RPA_TIME(MASS_FLOW_LATENCY_NS);
+    RPA_COUNT(MASS_FLOW_QUERIES);
+
+    double Pc, F_lbf;
+    int evaluations = 0;
+
+    if (m_inverseTable && m_inverseTable->contains(mdot_total)) {
+        // Single interpolation, no iteration
+        RPA_COUNT(MASS_FLOW_INVERSE_HITS);
+        m_inverseTable->evaluate(mdot_total, OF, Pa, Pc, F_lbf);
+    } else {
+        RPATableInterpolator::PerformanceData perf;
+        Pc = solveMassFlow(mdot_total, OF, Pa, state, perf, evaluations);
+        RPA_COUNT(MASS_FLOW_SOLVES);
+        RPA_RECORD(MASS_FLOW_EVALUATIONS, static_cast<uint64_t>(evaluations));
 
-    // Start with mid-range Pc as initial guess
-    double Pc_guess = (Pc_min + Pc_max) / 2.0;
+        // Calculate thrust: F = Cf × Pc × At
+        F_lbf = perf.Cf * Pc * m_At_in2;
+    }
+
+    state.hasLastPoint = true;
+    state.lastPc = Pc;
+    state.lastOF = OF;
+    state.lastPa = Pa;
+    state.lastEvaluations = evaluations;
+
+    return F_lbf;
+}
 
-    // Iterate to find consistent Pc
-    // Equation: Pc × At = mdot × C*
-    const int max_iterations = 10;
-    const double tolerance = 0.01; // 1% tolerance
+double ThrustCalculator::solveMassFlow(double mdot_total, double OF, double Pa, QueryState& state,
+                                       RPATableInterpolator::PerformanceData& perf, int& evaluations) const {
+    // Pc follows from the mass flow and C*: Pc = mdot × C* / At
+    // Units: C* is in m/s, mdot in lbm/s, At in in^2
+    //        1 lbf = 1 lbm × 1 ft/s^2 / 32.174, 1 psi = 1 lbf/in^2
+    // so Pc (psi) = k × C* (m/s) with
+    const double k = mdot_total * FT_PER_M / (GC * m_At_in2);
 
-    for (int i = 0; i < max_iterations; ++i) {
-        m_lastPerformance = m_tableInterpolator->getPerformance(Pc_guess, OF, Pa);
+    // Newton on g(Pc) = Pc - k × C*(Pc), with g' = 1 - k × dC*/dPc from the
+    // interpolant's exact gradient. C* varies slowly with Pc, so g' is near 1
+    // and a solve warm-started from the previous timestep typically needs
+    // one or two evaluations. g(0) < 0 since C* > 0; a bracket [lo, hi] on
+    // the root guards against steps across kinks in the interpolant.
+    double Pc;
+    if (state.hasLastPoint && state.lastPc > 0.0) {
+        Pc = state.lastPc;
+    } else {
+        double Pc_min, Pc_max, OF_min, OF_max, Pa_min, Pa_max;
+        m_tableInterpolator->getBounds(Pc_min, Pc_max, OF_min, OF_max, Pa_min, Pa_max);
+        Pc = (Pc_min + Pc_max) / 2.0;
+    }
 
-        // Calculate Pc from mass flow and C*
-        // Pc = mdot × C* / At
-        // Note: Need to handle unit conversion: C* is in m/s, mdot in lbm/s, At in in^2
-        // Using: 1 lbf = 1 lbm × 1 ft/s^2 / 32.174
-        //        1 psi = 1 lbf/in^2
+    double lo = 0.0;
+    double hi = std::numeric_limits<double>::infinity();
+    RPATableInterpolator::PerformanceGradient gradient;
+    evaluations = 0;
 
-        double Cstar_fts = m_lastPerformance.Cstar * 3.28084;  // m/s to ft/s
-        double Pc_calculated = (mdot_total * Cstar_fts) / (32.174 * m_At_in2);
+    while (true) {
+        perf = m_tableInterpolator->getFieldsWithGradient<RPATableInterpolator::MASK_CF |
+                                                          RPATableInterpolator::MASK_CSTAR>(
+            Pc, OF, Pa, gradient, state.cursor);
+        ++evaluations;
 
-        // Check convergence
-        double error = std::abs(Pc_calculated - Pc_guess) / Pc_guess;
-        if (error < tolerance) {
-            Pc_guess = Pc_calculated;
+        double g = Pc - k * perf.Cstar;
+        if (std::abs(g) <= MASS_FLOW_TOLERANCE * Pc) {
             break;
         }
+        if (evaluations == MAX_MASS_FLOW_EVALUATIONS) {
+            RPA_COUNT(MASS_FLOW_UNCONVERGED);
+            break;
+        }
+        if (g < 0.0) {
+            lo = Pc;
+        } else {
+            hi = Pc;
+        }
 
-        // Update guess (simple averaging)
-        Pc_guess = 0.5 * (Pc_guess + Pc_calculated);
+        double slope = 1.0 - k * gradient.dPc.Cstar;
+        double next = Pc - g / slope;
+        if (!(slope > 0.0) || !(next > lo && next < hi)) {
+            // Newton left the bracket: bisect it, or take the fixed-point
+            // step while there is no upper bound yet
+            next = std::isinf(hi) ? k * perf.Cstar : 0.5 * (lo + hi);
+        }
+        Pc = next;
     }
 
-    // Calculate thrust: F = Cf × Pc × At
-    double F_lbf = m_lastPerformance.Cf * Pc_guess * m_At_in2;
+    return Pc;
+}
 
-    return F_lbf;
+RPATableInterpolator::PerformanceData ThrustCalculator::getLastPerformanceData() const {
+    return getLastPerformanceData(m_state);
 }
+
+RPATableInterpolator::PerformanceData ThrustCalculator::getLastPerformanceData(const QueryState& state) const {
+    if (!state.hasLastPoint || !m_tableInterpolator) {
+        return RPATableInterpolator::PerformanceData();
+    }
+    return m_tableInterpolator->getPerformance(state.lastPc, state.lastOF, state.lastPa);
+}
+
+bool ThrustCalculator::buildInverseTable(size_t massFlowPoints) {
+    m_inverseEnabled = true;
+    m_inverseMassFlowPoints = massFlowPoints;
+    updateInverseTable();
+    return m_inverseTable != nullptr;
+}
+
+void ThrustCalculator::clearInverseTable() {
+    m_inverseEnabled = false;
+    m_inverseTable.reset();
+    m_inverseReport = InverseTableReport();
+}
+
+void ThrustCalculator::updateInverseTable() {
+    m_inverseTable.reset();
+    m_inverseReport = InverseTableReport();
+    if (!m_inverseEnabled || !isReady()) {
+        return;
+    }
+
+    const RPATableInterpolator& table = *m_tableInterpolator;
+    double Pc_min, Pc_max, OF_min, OF_max, Pa_min, Pa_max;
+    table.getBounds(Pc_min, Pc_max, OF_min, OF_max, Pa_min, Pa_max);
+
+    // O/F and Pa keep the performance table's breakpoints
+    const std::vector<double>& OF_axis = table.getOFBreakpoints();
+    const std::vector<double>& Pa_axis = table.getPaBreakpoints();
+
+    // mdot range over which every (O/F, Pa) column stays inside the table's
+    // Pc range (mdot = Pc × At × gc / C*); beyond the table edge the clamped
+    // Cf puts a kink in thrust that the grid would smear, so those mass
+    // flows keep using the iterative solve
+    double mdot_min = 0.0;
+    double mdot_max = std::numeric_limits<double>::infinity();
+    for (double OF : OF_axis) {
+        for (double Pa : Pa_axis) {
+            double lo = Pc_min * GC * m_At_in2 /
+                        (FT_PER_M * table.getFields<RPATableInterpolator::MASK_CSTAR>(Pc_min, OF, Pa).Cstar);
+            double hi = Pc_max * GC * m_At_in2 /
+                        (FT_PER_M * table.getFields<RPATableInterpolator::MASK_CSTAR>(Pc_max, OF, Pa).Cstar);
+            mdot_min = std::max(mdot_min, lo);
+            mdot_max = std::min(mdot_max, hi);
+        }
+    }
+    if (!(mdot_max > mdot_min)) {
+        return;
+    }
+
+    size_t n = m_inverseMassFlowPoints;
+    if (n < 2) {
+        n = std::max<size_t>(2, INVERSE_POINTS_PER_PC_INTERVAL * (table.getPcBreakpoints().size() - 1) + 1);
+    }
+    std::vector<double> mdot_axis(n);
+    for (size_t i = 0; i < n; ++i) {
+        mdot_axis[i] = (i + 1 == n) ? mdot_max : mdot_min + (mdot_max - mdot_min) * i / (n - 1);
+    }
+
+    auto inverse = std::make_shared<InverseTable>();
+    inverse->mdot.assign(mdot_axis);
+    inverse->OF.assign(OF_axis);
+    inverse->Pa.assign(Pa_axis);
+    inverse->Pc.resize(n * OF_axis.size() * Pa_axis.size());
+    inverse->F.resize(inverse->Pc.size());
+
+    // Solve every node, sweeping mdot upwards so each solve warm-starts
+    // from the previous one
+    for (size_t j = 0; j < OF_axis.size(); ++j) {
+        for (size_t k = 0; k < Pa_axis.size(); ++k) {
+            QueryState state;
+            for (size_t i = 0; i < n; ++i) {
+                RPATableInterpolator::PerformanceData perf;
+                int evaluations;
+                double Pc = solveMassFlow(mdot_axis[i], OF_axis[j], Pa_axis[k], state, perf, evaluations);
+                state.hasLastPoint = true;
+                state.lastPc = Pc;
+
+                size_t index = (i * OF_axis.size() + j) * Pa_axis.size() + k;
+                inverse->Pc[index] = Pc;
+                inverse->F[index] = perf.Cf * Pc * m_At_in2;
+            }
+        }
+    }
+
+    // Compare with the iterative solve at every cell centre
+    InverseTableReport report = InverseTableReport();
+    report.massFlowPoints = n;
+    report.mdotMin = mdot_min;
+    report.mdotMax = mdot_max;
+    auto centres = [](const std::vector<double>& axis) {
+        std::vector<double> c;
+        for (size_t i = 0; i + 1 < axis.size(); ++i) c.push_back(0.5 * (axis[i] + axis[i + 1]));
+        if (c.empty()) c.push_back(axis[0]);
+        return c;
+    };
+    const std::vector<double> mdot_centres = centres(mdot_axis);
+    const std::vector<double> OF_centres = centres(OF_axis);
+    const std::vector<double> Pa_centres = centres(Pa_axis);
+    for (double OF : OF_centres) {
+        for (double Pa : Pa_centres) {
+            QueryState state;
+            for (double mdot : mdot_centres) {
+                RPATableInterpolator::PerformanceData exact;
+                int evaluations;
+                double Pc = solveMassFlow(mdot, OF, Pa, state, exact, evaluations);
+                state.hasLastPoint = true;
+                state.lastPc = Pc;
+                double F = exact.Cf * Pc * m_At_in2;
+
+                double Pc_inverse, F_inverse;
+                inverse->evaluate(mdot, OF, Pa, Pc_inverse, F_inverse);
+
+                double dF = std::abs(F_inverse - F) / std::abs(F);
+                double dPc = std::abs(Pc_inverse - Pc) / Pc;
+                if (dF > report.maxThrustDeviation) {
+                    report.maxThrustDeviation = dF;
+                    report.mdot = mdot;
+                    report.OF = OF;
+                    report.Pa = Pa;
+                }
+                report.maxPcDeviation = std::max(report.maxPcDeviation, dPc);
+                ++report.pointsCompared;
+            }
+        }
+    }
+
+    m_inverseTable = inverse;
+    m_inverseReport = report;
+}
+
+void ThrustCalculator::InverseTable::evaluate(double mdot_total, double OF_value, double Pa_value,
+                                              double& Pc_out, double& F_out) const {
+    int i0, i1, j0, j1, k0, k1;
+    double tx, ty, tz;
+    mdot.findBounds(mdot_total, i0, i1, tx);
+    OF.findBounds(OF_value, j0, j1, ty);
+    Pa.findBounds(Pa_value, k0, k1, tz);
+
+    const size_t nOF = OF.size(), nPa = Pa.size();
+    const size_t base = (i0 * nOF + j0) * nPa + k0;
+    const size_t delta[3] = {
+        static_cast<size_t>(i1 - i0) * nOF * nPa, static_cast<size_t>(j1 - j0) * nPa, static_cast<size_t>(k1 - k0)
+    };
+
+    const double t[3] = { tx, ty, tz };
+
+    double c[MultilinearKernel<3>::CORNERS];
+    MultilinearKernel<3>::gatherCorners(Pc.data() + base, delta, c);
+    Pc_out = MultilinearKernel<3>::blend(c, t);
+    MultilinearKernel<3>::gatherCorners(F.data() + base, delta, c);
+    F_out = MultilinearKernel<3>::blend(c, t);
+}
+
@@ -2,7 +2,11 @@
 #define THRUST_CALCULATOR_H
 
 #include "RPATableInterpolator.h"
+#include "CompiledThrustModel.h"
+#include "PerformanceTableRegistry.h"
+#include "TableAxis.h"
 #include <memory>
+#include <vector>
 
 /**
  * ThrustCalculator
@@ -21,19 +25,64 @@
  *   1. Size the engine (set throat area) based on design requirements
  *   2. Load RPA performance tables
  *   3. Each timestep: provide Pc, mdot_ox, mdot_fuel, Pa -> get thrust
+ *
+ * Threading: the performance table is shared and immutable, so calculators
+ * are cheap handles. The const overloads that take a QueryState are
+ * reentrant and lock-free; give each thread (or trajectory) its own
+ * QueryState. The overloads without one use the calculator's built-in state
+ * and are for single-threaded use.
  */
 class ThrustCalculator {
 public:
+    /**
+     * Per-trajectory query state: the interpolation cursor and the operating
+     * point of the last calculation
+     */
+    struct QueryState {
+        InterpolationCursor cursor;
+        bool hasLastPoint;
+        double lastPc;
+        double lastOF;
+        double lastPa;
+        int lastEvaluations;    // Table evaluations used by the last mass-flow solve (0 if
+                                // answered from the inverse table)
+
+        QueryState() : hasLastPoint(false), lastPc(0.0), lastOF(0.0), lastPa(0.0), lastEvaluations(0) {}
+    };
+
+    /**
+     * Accuracy of the inverse table against the iterative mass-flow solve,
+     * measured at the centre of every inverse-table cell
+     */
+    struct InverseTableReport {
+        size_t massFlowPoints;
+        double mdotMin, mdotMax;        // Mass flow range covered (lbm/s)
+        size_t pointsCompared;
+        double maxThrustDeviation;      // Relative to the iterative thrust
+        double maxPcDeviation;          // Relative to the iterative Pc
+        double mdot, OF, Pa;            // Where maxThrustDeviation occurred
+    };
+
     ThrustCalculator();
+    explicit ThrustCalculator(std::shared_ptr<const RPATableInterpolator> table);
     ~ThrustCalculator();
 
     /**
      * Load RPA performance table
+     * Tables come from PerformanceTableRegistry, so calculators loading the
+     * same file share one parsed copy.
      * @param table_filename Path to CSV file generated by generate_rpa_tables.js
+     *                       (or a compiled table)
      * @return true if successful
      */
     bool loadPerformanceTable(const std::string& table_filename);
 
+    /**
+     * Use an already loaded (shared) performance table
+     */
+    void setPerformanceTable(std::shared_ptr<const RPATableInterpolator> table);
+    std::shared_ptr<const RPATableInterpolator> getPerformanceTable() const { return m_tableInterpolator; }
+
     /**
      * Set engine throat area (from engine sizing)
      * @param At_in2 Throat area in square inches
@@ -64,11 +113,18 @@ public:
     double calculateThrust(double Pc, double mdot_ox, double mdot_fuel, double Pa);
 
     /**
-     * Get the current performance data from last calculation
+     * Calculate thrust with caller-owned query state (reentrant)
      */
-    RPATableInterpolator::PerformanceData getLastPerformanceData() const {
-        return m_lastPerformance;
-    }
+    double calculateThrust(double Pc, double mdot_ox, double mdot_fuel, double Pa,
+                           QueryState& state) const;
+
+    /**
+     * Get the full performance data at the operating point of the last calculation
+     * The thrust calculations only interpolate the fields they need, so the
+     * remaining fields are interpolated here on demand.
+     */
+    RPATableInterpolator::PerformanceData getLastPerformanceData() const;
+    RPATableInterpolator::PerformanceData getLastPerformanceData(const QueryState& state) const;
 
     /**
      * Get throat area (in^2)
@@ -79,8 +135,52 @@ public:
      * Alternative thrust calculation using mass flow and C*
      * F = mdot × C* × Cf
      * Useful for verification or when you trust mdot more than Pc
+     * Solves Pc × At = mdot × C*(Pc) by safeguarded Newton iteration on the
+     * table gradient, starting from the Pc of the previous calculation
      */
     double calculateThrustFromMassFlow(double mdot_total, double OF, double Pa);
+    double calculateThrustFromMassFlow(double mdot_total, double OF, double Pa,
+                                       QueryState& state) const;
+
+    /**
+     * Precompute the mass-flow inverse of the performance table
+     * Solves Pc × At = mdot × C*(Pc) once per node of a grid over
+     * (mdot_total, O/F, Pa), so calculateThrustFromMassFlow becomes a single
+     * interpolation for mass flows inside the grid (it falls back to the
+     * iterative solve outside). The grid is rebuilt whenever the table or
+     * the throat area changes, until clearInverseTable().
+     * @param massFlowPoints Breakpoints along mdot (0: 8 per Pc interval of
+     *                       the performance table)
+     * @return false if the calculator is not ready yet (the grid is then
+     *         built as soon as it is)
+     */
+    bool buildInverseTable(size_t massFlowPoints = 0);
+    void clearInverseTable();
+
+    bool hasInverseTable() const { return m_inverseTable != nullptr; }
+
+    /**
+     * Deviation of the current inverse table from the iterative solve
+     */
+    const InverseTableReport& getInverseTableReport() const { return m_inverseReport; }
+
+    /**
+     * Validate the calculator once and fold Cf × At into an immutable
+     * thrust-per-psi surface for the simulation step loop
+     * The model's queries are noexcept and check-free, and flag bad inputs
+     * in a status word instead of throwing. Later changes to this calculator
+     * do not affect an already compiled model.
+     * @throws std::runtime_error if the calculator is not ready or the table
+     *         is not in trilinear mode
+     */
+    CompiledThrustModel compile() const;
+
+    /**
+     * Lookup statistics of the calculator's own cursor
+     * (cell hit rate across successive timesteps)
+     */
+    const InterpolationCursor::Stats& getCursorStats() const { return m_state.cursor.getStats(); }
+    void resetCursorStats() { m_state.cursor.resetStats(); }
 
     /**
      * Check if calculator is ready to use
@@ -90,9 +190,41 @@ public:
     }
 
 private:
-    std::unique_ptr<RPATableInterpolator> m_tableInterpolator;
+    /**
+     * Iterative mass-flow solve on the performance table
+     * @param perf Output: Cf and C* at the returned Pc
+     * @param evaluations Output: table evaluations used
+     * @return Chamber pressure (psi)
+     */
+    double solveMassFlow(double mdot_total, double OF, double Pa, QueryState& state,
+                         RPATableInterpolator::PerformanceData& perf, int& evaluations) const;
+
+    // Rebuild (or drop) the inverse table after the table or At changed
+    void updateInverseTable();
+
+    std::shared_ptr<const RPATableInterpolator> m_tableInterpolator;
     double m_At_in2;  // Throat area (square inches)
-    RPATableInterpolator::PerformanceData m_lastPerformance;
+    QueryState m_state;  // State for the overloads without a QueryState
+
+    /**
+     * Solved Pc and thrust over (mdot_total, O/F, Pa), trilinear. Thrust is
+     * nearly linear in mdot (F = mdot × C* × Cf_vac - Pa × Ae), so it is
+     * interpolated directly rather than through Cf.
+     */
+    struct InverseTable {
+        TableAxis mdot, OF, Pa;
+        std::vector<double> Pc, F;      // [mdot][OF][Pa], Pa fastest
+
+        bool contains(double mdot_total) const {
+            return mdot_total >= mdot.front() && mdot_total <= mdot.back();
+        }
+        void evaluate(double mdot_total, double OF_value, double Pa_value, double& Pc_out, double& F_out) const;
+    };
+
+    bool m_inverseEnabled;
+    size_t m_inverseMassFlowPoints;
+    std::shared_ptr<const InverseTable> m_inverseTable;
+    InverseTableReport m_inverseReport;
 };
 
 #endif // THRUST_CALCULATOR_H
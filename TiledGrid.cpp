@@ -0,0 +1,593 @@
+#include "TiledGrid.h"
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TILED_GRID_POSIX 1
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#define TILED_GRID_POSIX 0
+#endif
+
+namespace {
+    /**
+     * Tiled table layout (native byte order, all offsets in bytes):
+     *
+     *   TiledHeader
+     *   double Pc[axisSize[0]], OF[axisSize[1]], Pa[axisSize[2]]   at axisOffset
+     *   uint64_t brickChecksum[numBricks]                          at indexOffset
+     *   brick[numBricks], each brickBytes                          at brickOffset
+     *
+     * Bricks are numbered row-major over (Pc, OF, Pa) brick coordinates. Each
+     * holds (brickCells + 1) points along every axis, field by field in
+     * row-major order; points past the end of an axis are zero. Checksums are
+     * FNV-1a over 64-bit words: one per brick, and the header's over the
+     * axes and the brick checksums.
+     */
+    const char TILED_MAGIC[8] = { 'R', 'P', 'A', 'T', 'I', 'L', 'E', '\0' };
+    const uint32_t TILED_VERSION = 1;
+    const uint32_t TILED_ENDIAN_TAG = 0x01020304;
+    const uint64_t TILED_ALIGNMENT = 64;
+
+    struct TiledHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t endianTag;
+        uint32_t headerSize;
+        uint32_t numFields;
+        uint32_t axisSize[3];       // Pc, OF, Pa
+        uint32_t brickCells[3];
+        uint32_t brickCount[3];
+        uint32_t reserved;
+        uint64_t axisOffset;
+        uint64_t indexOffset;
+        uint64_t brickOffset;
+        uint64_t brickBytes;
+        uint64_t fileSize;
+        uint64_t checksum;
+    };
+
+    // Bricks waiting for the prefetch thread; older requests are dropped
+    const size_t MAX_PREFETCH_QUEUE = 64;
+
+    // Smallest cache that reads ahead: room for the brick in use and the
+    // seven one step ahead of it, so prefetching cannot evict the brick
+    // being queried
+    const size_t MIN_PREFETCH_CAPACITY = 8;
+
+    const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    const uint64_t FNV_PRIME = 1099511628211ULL;
+
+    uint64_t hashWords(const void* data, size_t bytes, uint64_t hash = FNV_OFFSET) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, p + i, sizeof(word));
+            hash ^= word;
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Cells per brick along an axis of n breakpoints: short axes get one brick
+    size_t brickCellsFor(size_t n, size_t brickCells) {
+        return std::max<size_t>(1, std::min(brickCells, n - 1));
+    }
+
+    size_t brickCountFor(size_t n, size_t cells) {
+        return std::max<size_t>(1, (n - 1 + cells - 1) / cells);
+    }
+}
+
+const size_t TiledGrid::DEFAULT_BRICK_CELLS;
+const size_t TiledGrid::DEFAULT_CACHE_BYTES;
+
+struct TiledGrid::File {
+#if TILED_GRID_POSIX
+    int fd;
+
+    File() : fd(-1), size(0) {}
+    ~File() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool open(const std::string& filename) {
+        fd = ::open(filename.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            return false;
+        }
+        size = static_cast<uint64_t>(st.st_size);
+        return true;
+    }
+
+    bool read(uint64_t offset, void* out, size_t bytes) {
+        char* p = static_cast<char*>(out);
+        while (bytes > 0) {
+            ssize_t got = ::pread(fd, p, bytes, static_cast<off_t>(offset));
+            if (got <= 0) {
+                return false;
+            }
+            p += got;
+            offset += got;
+            bytes -= static_cast<size_t>(got);
+        }
+        return true;
+    }
+#else
+    std::mutex mutex;       // One stream position shared by every reader
+    std::ifstream stream;
+
+    File() : size(0) {}
+
+    bool open(const std::string& filename) {
+        stream.open(filename, std::ios::binary | std::ios::ate);
+        if (!stream.is_open()) {
+            return false;
+        }
+        size = static_cast<uint64_t>(stream.tellg());
+        return true;
+    }
+
+    bool read(uint64_t offset, void* out, size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stream.clear();
+        stream.seekg(static_cast<std::streamoff>(offset));
+        return static_cast<bool>(stream.read(static_cast<char*>(out), static_cast<std::streamsize>(bytes)));
+    }
+#endif
+
+    uint64_t size;
+};
+
+TiledGrid::Stats::Stats()
+    : hits(0)
+    , misses(0)
+    , prefetched(0)
+    , prefetchHits(0)
+    , evictions(0)
+    , residentBricks(0)
+    , capacityBricks(0)
+    , brickBytes(0) {
+}
+
+TiledGrid::TiledGrid()
+    : m_numFields(0)
+    , m_brickPoints(0)
+    , m_brickOffset(0)
+    , m_brickBytes(0)
+    , m_capacity(0)
+    , m_prefetchEnabled(true)
+    , m_stopping(false) {
+    for (int a = 0; a < 3; ++a) {
+        m_brickCells[a] = 0;
+        m_brickCount[a] = 0;
+        m_brickStride[a] = 0;
+    }
+}
+
+TiledGrid::~TiledGrid() {
+    close();
+}
+
+bool TiledGrid::open(const std::string& filename, size_t numFields, size_t cacheBytes) {
+    close();
+
+    std::unique_ptr<File> file(new File());
+    TiledHeader header;
+    if (!file->open(filename) || file->size < sizeof(header) || !file->read(0, &header, sizeof(header))) {
+        return false;
+    }
+
+    if (std::memcmp(header.magic, TILED_MAGIC, sizeof(TILED_MAGIC)) != 0 ||
+        header.version != TILED_VERSION ||
+        header.endianTag != TILED_ENDIAN_TAG ||
+        header.headerSize != sizeof(TiledHeader) ||
+        header.numFields != numFields ||
+        header.fileSize != file->size) {
+        return false;
+    }
+
+    // Validate the layout before trusting any offset
+    uint64_t axisCount = 0;
+    uint64_t numBricks = 1;
+    uint64_t brickPoints = 1;
+    for (int a = 0; a < 3; ++a) {
+        const size_t n = header.axisSize[a];
+        if (n == 0 ||
+            header.brickCells[a] != brickCellsFor(n, header.brickCells[a]) ||
+            header.brickCount[a] != brickCountFor(n, header.brickCells[a])) {
+            return false;
+        }
+        axisCount += n;
+        numBricks *= header.brickCount[a];
+        brickPoints *= header.brickCells[a] + 1;
+    }
+    if (header.axisOffset != header.headerSize ||
+        header.indexOffset != header.axisOffset + axisCount * sizeof(double) ||
+        header.brickOffset < header.indexOffset + numBricks * sizeof(uint64_t) ||
+        header.brickOffset % TILED_ALIGNMENT != 0 ||
+        header.brickBytes != numFields * brickPoints * sizeof(double) ||
+        header.brickOffset + numBricks * header.brickBytes != header.fileSize) {
+        return false;
+    }
+
+    // Axes and brick index, checked against the header checksum
+    std::vector<double> axisData(axisCount);
+    std::vector<uint64_t> checksums(numBricks);
+    if (!file->read(header.axisOffset, axisData.data(), axisCount * sizeof(double)) ||
+        !file->read(header.indexOffset, checksums.data(), numBricks * sizeof(uint64_t))) {
+        return false;
+    }
+    uint64_t hash = hashWords(axisData.data(), axisCount * sizeof(double));
+    if (hashWords(checksums.data(), numBricks * sizeof(uint64_t), hash) != header.checksum) {
+        return false;
+    }
+
+    const double* axis = axisData.data();
+    for (int a = 0; a < 3; ++a) {
+        std::vector<double> values(axis, axis + header.axisSize[a]);
+        for (size_t i = 1; i < values.size(); ++i) {
+            if (!(values[i] > values[i - 1])) {
+                return false;
+            }
+        }
+        m_axes[a].swap(values);
+        axis += header.axisSize[a];
+    }
+
+    m_numFields = numFields;
+    for (int a = 0; a < 3; ++a) {
+        m_brickCells[a] = header.brickCells[a];
+        m_brickCount[a] = header.brickCount[a];
+    }
+    m_brickStride[2] = 1;
+    m_brickStride[1] = m_brickCells[2] + 1;
+    m_brickStride[0] = (m_brickCells[1] + 1) * m_brickStride[1];
+    m_brickPoints = static_cast<size_t>(brickPoints);
+    m_brickOffset = header.brickOffset;
+    m_brickBytes = header.brickBytes;
+    m_checksums.swap(checksums);
+    m_capacity = std::max<size_t>(1, cacheBytes / m_brickBytes);
+    m_stats = Stats();
+    m_file = std::move(file);
+
+    if (m_prefetchEnabled) {
+        m_prefetcher = std::thread(&TiledGrid::prefetchLoop, this);
+    }
+    return true;
+}
+
+void TiledGrid::close() {
+    stopPrefetcher();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_slots.clear();
+    m_lru.clear();
+    m_prefetchQueue.clear();
+    m_checksums.clear();
+    for (int a = 0; a < 3; ++a) m_axes[a].clear();
+    m_file.reset();
+}
+
+void TiledGrid::brickOf(size_t axis, size_t index, size_t& brick, size_t& local) const {
+    // The last point of an axis belongs to the last brick, not one past it
+    brick = std::min(index / m_brickCells[axis], m_brickCount[axis] - 1);
+    local = index - brick * m_brickCells[axis];
+}
+
+void TiledGrid::locate(const size_t lower[3], const size_t step[3], Cell& cell) const {
+    size_t brick[3];
+    cell.base = 0;
+    for (int a = 0; a < 3; ++a) {
+        size_t local;
+        brickOf(a, lower[a], brick[a], local);
+        cell.base += local * m_brickStride[a];
+        cell.delta[a] = step[a] * m_brickStride[a];
+    }
+    cell.fieldStride = m_brickPoints;
+    cell.brick = acquire(brickId(brick));
+}
+
+double TiledGrid::value(size_t field, const size_t index[3]) const {
+    const size_t step[3] = { 0, 0, 0 };
+    Cell cell;
+    locate(index, step, cell);
+    return (*cell.brick)[field * cell.fieldStride + cell.base];
+}
+
+std::shared_ptr<const std::vector<double>> TiledGrid::acquire(size_t id) const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        auto it = m_slots.find(id);
+        if (it == m_slots.end()) {
+            break;
+        }
+        Slot& slot = it->second;
+        if (slot.brick) {
+            ++m_stats.hits;
+            if (slot.prefetched) {
+                ++m_stats.prefetchHits;
+                slot.prefetched = false;
+            }
+            m_lru.splice(m_lru.begin(), m_lru, slot.lru);
+            return slot.brick;
+        }
+        // Another thread is reading it; if that read fails the slot is gone
+        // and this thread tries itself
+        m_brickReady.wait(lock);
+    }
+
+    ++m_stats.misses;
+    m_slots[id].prefetched = false;
+    lock.unlock();
+
+    std::shared_ptr<std::vector<double>> brick = std::make_shared<std::vector<double>>();
+    const bool ok = readBrick(id, *brick);
+
+    lock.lock();
+    if (!ok) {
+        m_slots.erase(id);
+        m_brickReady.notify_all();
+        throw std::runtime_error("Tiled table brick " + std::to_string(id) + " is unreadable or corrupt");
+    }
+    insertBrick(id, brick);
+    m_brickReady.notify_all();
+    return brick;
+}
+
+bool TiledGrid::readBrick(size_t id, std::vector<double>& values) const {
+    values.resize(m_numFields * m_brickPoints);
+    return m_file->read(m_brickOffset + id * m_brickBytes, values.data(), m_brickBytes) &&
+           hashWords(values.data(), m_brickBytes) == m_checksums[id];
+}
+
+void TiledGrid::insertBrick(size_t id, const std::shared_ptr<const std::vector<double>>& brick) const {
+    Slot& slot = m_slots[id];
+    slot.brick = brick;
+    m_lru.push_front(id);
+    slot.lru = m_lru.begin();
+
+    // Evicted bricks stay alive while a Cell still holds them
+    while (m_lru.size() > m_capacity) {
+        m_slots.erase(m_lru.back());
+        m_lru.pop_back();
+        ++m_stats.evictions;
+    }
+}
+
+void TiledGrid::prefetchAhead(const size_t lower[3], const int direction[3]) const {
+    if (!m_prefetchEnabled || !m_file || m_capacity < MIN_PREFETCH_CAPACITY) {
+        return;
+    }
+
+    // Bricks one step ahead along each axis whose far face is near
+    size_t brick[3], ahead[3];
+    bool nearFace[3];
+    bool any = false;
+    for (int a = 0; a < 3; ++a) {
+        size_t local;
+        brickOf(a, lower[a], brick[a], local);
+        const size_t margin = std::max<size_t>(1, m_brickCells[a] / 4);
+        nearFace[a] = false;
+        if (direction[a] > 0 && brick[a] + 1 < m_brickCount[a] && local + margin >= m_brickCells[a]) {
+            ahead[a] = brick[a] + 1;
+            nearFace[a] = true;
+        } else if (direction[a] < 0 && brick[a] > 0 && local < margin) {
+            ahead[a] = brick[a] - 1;
+            nearFace[a] = true;
+        }
+        any = any || nearFace[a];
+    }
+    if (!any) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (unsigned mask = 1; mask < 8; ++mask) {
+        size_t target[3];
+        bool valid = true;
+        for (int a = 0; a < 3; ++a) {
+            const bool move = (mask >> a) & 1;
+            valid = valid && (!move || nearFace[a]);
+            target[a] = move ? ahead[a] : brick[a];
+        }
+        if (!valid) continue;
+
+        const size_t id = brickId(target);
+        if (m_slots.count(id) ||
+            std::find(m_prefetchQueue.begin(), m_prefetchQueue.end(), id) != m_prefetchQueue.end()) {
+            continue;
+        }
+        if (m_prefetchQueue.size() == MAX_PREFETCH_QUEUE) {
+            m_prefetchQueue.pop_front();
+        }
+        m_prefetchQueue.push_back(id);
+    }
+    m_prefetchWake.notify_one();
+}
+
+void TiledGrid::prefetchLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_prefetchWake.wait(lock, [this]() { return m_stopping || !m_prefetchQueue.empty(); });
+        if (m_stopping) {
+            return;
+        }
+        const size_t id = m_prefetchQueue.front();
+        m_prefetchQueue.pop_front();
+        if (m_slots.count(id)) {
+            continue;
+        }
+        m_slots[id].prefetched = true;
+        lock.unlock();
+
+        std::shared_ptr<std::vector<double>> brick = std::make_shared<std::vector<double>>();
+        const bool ok = readBrick(id, *brick);
+
+        lock.lock();
+        if (ok) {
+            insertBrick(id, brick);
+            ++m_stats.prefetched;
+        } else {
+            // Leave the error to the query that needs the brick
+            m_slots.erase(id);
+        }
+        m_brickReady.notify_all();
+    }
+}
+
+void TiledGrid::stopPrefetcher() {
+    if (!m_prefetcher.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_prefetchQueue.clear();
+    }
+    m_prefetchWake.notify_all();
+    m_prefetcher.join();
+    m_stopping = false;
+}
+
+void TiledGrid::setPrefetch(bool enabled) {
+    if (!enabled) {
+        stopPrefetcher();
+    }
+    m_prefetchEnabled = enabled;
+    if (enabled && m_file && !m_prefetcher.joinable()) {
+        m_prefetcher = std::thread(&TiledGrid::prefetchLoop, this);
+    }
+}
+
+TiledGrid::Stats TiledGrid::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.residentBricks = m_lru.size();
+    stats.capacityBricks = m_capacity;
+    stats.brickBytes = static_cast<size_t>(m_brickBytes);
+    return stats;
+}
+
+void TiledGrid::resetStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats = Stats();
+}
+
+bool TiledGrid::write(const std::string& filename, const std::vector<double> axes[3],
+                      const double* const* fields, size_t numFields, size_t brickCells) {
+    if (brickCells == 0 || numFields == 0) {
+        return false;
+    }
+
+    TiledHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TILED_MAGIC, sizeof(TILED_MAGIC));
+    header.version = TILED_VERSION;
+    header.endianTag = TILED_ENDIAN_TAG;
+    header.headerSize = sizeof(TiledHeader);
+    header.numFields = static_cast<uint32_t>(numFields);
+
+    size_t cells[3], counts[3], strides[3];
+    uint64_t axisCount = 0;
+    uint64_t numBricks = 1;
+    uint64_t brickPoints = 1;
+    for (int a = 0; a < 3; ++a) {
+        const size_t n = axes[a].size();
+        if (n == 0) {
+            return false;
+        }
+        cells[a] = brickCellsFor(n, brickCells);
+        counts[a] = brickCountFor(n, cells[a]);
+        header.axisSize[a] = static_cast<uint32_t>(n);
+        header.brickCells[a] = static_cast<uint32_t>(cells[a]);
+        header.brickCount[a] = static_cast<uint32_t>(counts[a]);
+        axisCount += n;
+        numBricks *= counts[a];
+        brickPoints *= cells[a] + 1;
+    }
+    strides[2] = 1;
+    strides[1] = axes[2].size();
+    strides[0] = axes[1].size() * strides[1];
+
+    header.axisOffset = header.headerSize;
+    header.indexOffset = header.axisOffset + axisCount * sizeof(double);
+    header.brickOffset = alignUp(header.indexOffset + numBricks * sizeof(uint64_t), TILED_ALIGNMENT);
+    header.brickBytes = numFields * brickPoints * sizeof(double);
+    header.fileSize = header.brickOffset + numBricks * header.brickBytes;
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Header and index are rewritten once the brick checksums are known
+    std::vector<char> prefix(header.brickOffset, 0);
+    file.write(prefix.data(), prefix.size());
+
+    std::vector<uint64_t> checksums(numBricks);
+    std::vector<double> brick(numFields * brickPoints);
+    const size_t local[3] = { cells[0] + 1, cells[1] + 1, cells[2] + 1 };
+    size_t id = 0;
+    for (size_t bi = 0; bi < counts[0]; ++bi) {
+        for (size_t bj = 0; bj < counts[1]; ++bj) {
+            for (size_t bk = 0; bk < counts[2]; ++bk, ++id) {
+                std::fill(brick.begin(), brick.end(), 0.0);
+                double* out = brick.data();
+                for (size_t f = 0; f < numFields; ++f) {
+                    for (size_t li = 0; li < local[0]; ++li) {
+                        const size_t i = bi * cells[0] + li;
+                        for (size_t lj = 0; lj < local[1]; ++lj) {
+                            const size_t j = bj * cells[1] + lj;
+                            for (size_t lk = 0; lk < local[2]; ++lk, ++out) {
+                                const size_t k = bk * cells[2] + lk;
+                                if (i < axes[0].size() && j < axes[1].size() && k < axes[2].size()) {
+                                    *out = fields[f][i * strides[0] + j * strides[1] + k];
+                                }
+                            }
+                        }
+                    }
+                }
+                checksums[id] = hashWords(brick.data(), header.brickBytes);
+                file.write(reinterpret_cast<const char*>(brick.data()), header.brickBytes);
+            }
+        }
+    }
+
+    uint64_t hash = FNV_OFFSET;
+    for (int a = 0; a < 3; ++a) {
+        hash = hashWords(axes[a].data(), axes[a].size() * sizeof(double), hash);
+    }
+    header.checksum = hashWords(checksums.data(), numBricks * sizeof(uint64_t), hash);
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int a = 0; a < 3; ++a) {
+        file.write(reinterpret_cast<const char*>(axes[a].data()), axes[a].size() * sizeof(double));
+    }
+    file.write(reinterpret_cast<const char*>(checksums.data()), numBricks * sizeof(uint64_t));
+    return static_cast<bool>(file);
+}
+
+bool TiledGrid::isTiledFile(const unsigned char* data, size_t size) {
+    return size >= sizeof(TILED_MAGIC) && std::memcmp(data, TILED_MAGIC, sizeof(TILED_MAGIC)) == 0;
+}
+
+bool TiledGrid::fingerprint(const unsigned char* data, size_t size, uint64_t& hash) {
+    if (size < sizeof(TiledHeader) || !isTiledFile(data, size)) {
+        return false;
+    }
+    TiledHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    hash = header.checksum;
+    return true;
+}
@@ -0,0 +1,207 @@
+#ifndef TILED_GRID_H
+#define TILED_GRID_H
+
+#include <vector>
+#include <string>
+#include <list>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * TiledGrid
+ *
+ * Out-of-core storage for a dense 3D grid of fields, for tables too large to
+ * hold in every worker's memory. The grid is cut into fixed-size bricks kept
+ * in a file; bricks are read on demand into a bounded, thread-safe LRU cache,
+ * so resident memory follows the region queries actually visit rather than
+ * the size of the table.
+ *
+ * Neighbouring bricks share their boundary plane of grid points, so every
+ * interpolation cell lies entirely inside one brick and a query touches one
+ * brick. A background thread reads bricks ahead of a moving query point
+ * (see prefetchAhead).
+ *
+ * Bricks are stored as doubles, one block per field in the same row-major
+ * order as the dense grid, and checksummed individually; a brick is verified
+ * each time it is read.
+ */
+class TiledGrid {
+public:
+    // Cache counters; hits and misses count brick lookups by queries
+    struct Stats {
+        uint64_t hits;              // Brick was resident (or already being read)
+        uint64_t misses;            // Query had to read the brick itself
+        uint64_t prefetched;        // Bricks read ahead by the prefetch thread
+        uint64_t prefetchHits;      // First use of a prefetched brick
+        uint64_t evictions;
+        size_t residentBricks;
+        size_t capacityBricks;
+        size_t brickBytes;
+
+        Stats();
+
+        double hitRate() const {
+            return hits + misses ? double(hits) / (hits + misses) : 0.0;
+        }
+    };
+
+    // One brick lookup: the cell's lowest corner within a resident brick
+    struct Cell {
+        std::shared_ptr<const std::vector<double>> brick;   // Keeps the brick alive after eviction
+        size_t base;                // Offset of the lowest corner in a field block
+        size_t delta[3];            // Offset to the upper corner along each axis
+        size_t fieldStride;         // Values per field block
+    };
+
+    static const size_t DEFAULT_BRICK_CELLS = 16;
+    static const size_t DEFAULT_CACHE_BYTES = size_t(64) << 20;
+
+    TiledGrid();
+    ~TiledGrid();
+
+    TiledGrid(const TiledGrid&) = delete;
+    TiledGrid& operator=(const TiledGrid&) = delete;
+
+    /**
+     * Open a tiled file; only the header, axes and brick index are read
+     * @param numFields Fields per grid point the caller expects
+     * @param cacheBytes Brick cache budget (at least one brick is kept)
+     * @return false if the file is missing, corrupt or of another layout
+     */
+    bool open(const std::string& filename, size_t numFields, size_t cacheBytes);
+    void close();
+
+    bool isOpen() const { return m_file != nullptr; }
+
+    /**
+     * Breakpoints of axis a (0..2)
+     */
+    const std::vector<double>& getAxis(size_t a) const { return m_axes[a]; }
+
+    /**
+     * Find the brick holding a cell and read it in if needed
+     * @param lower Grid indices of the cell's lowest corner
+     * @param step Per axis, 1 if the cell spans to the next breakpoint, 0
+     *             if it is clamped to that point
+     * @throws std::runtime_error if the brick cannot be read or is corrupt
+     */
+    void locate(const size_t lower[3], const size_t step[3], Cell& cell) const;
+
+    /**
+     * One grid value (a brick lookup per call; for bulk conversions)
+     */
+    double value(size_t field, const size_t index[3]) const;
+
+    /**
+     * Queue bricks ahead of a moving query point for the prefetch thread
+     * When the cell is within a quarter brick of a brick face it is moving
+     * towards, the brick beyond that face (and, when several faces are
+     * near, the bricks beyond their edges and corner) is read in the
+     * background. Caches of fewer than 8 bricks do not read ahead.
+     * @param lower Lowest corner of the cell just entered
+     * @param direction Per axis -1, 0 or +1: how the cell index changed
+     */
+    void prefetchAhead(const size_t lower[3], const int direction[3]) const;
+
+    /**
+     * Enable or disable read-ahead (enabled by default)
+     */
+    void setPrefetch(bool enabled);
+
+    Stats getStats() const;
+    void resetStats();
+
+    /**
+     * Write a dense grid as a tiled file
+     * @param axes Breakpoints of the three axes
+     * @param fields numFields pointers, each to one field's row-major block
+     * @param brickCells Cells per brick edge (smaller for short axes)
+     * @return true if successful
+     */
+    static bool write(const std::string& filename, const std::vector<double> axes[3],
+                      const double* const* fields, size_t numFields, size_t brickCells);
+
+    /**
+     * True if a file starts like a tiled grid
+     */
+    static bool isTiledFile(const unsigned char* data, size_t size);
+
+    /**
+     * Content fingerprint of a tiled file from its header alone (it covers
+     * the axes and every brick checksum), so the file need not be read
+     * @return false if the data is not a tiled grid header
+     */
+    static bool fingerprint(const unsigned char* data, size_t size, uint64_t& hash);
+
+private:
+    struct File;            // Positioned reads (pread where available)
+
+    struct Slot {
+        std::shared_ptr<const std::vector<double>> brick;  // Null while being read
+        std::list<size_t>::iterator lru;
+        bool prefetched;    // Read ahead and not used yet
+    };
+
+    std::unique_ptr<File> m_file;
+    std::vector<double> m_axes[3];
+    size_t m_numFields;
+    size_t m_brickCells[3];         // Cells per brick along each axis
+    size_t m_brickCount[3];
+    size_t m_brickStride[3];        // Local strides within a brick field block
+    size_t m_brickPoints;           // Points per brick field block
+    uint64_t m_brickOffset;         // File offset of brick 0
+    uint64_t m_brickBytes;
+    std::vector<uint64_t> m_checksums;
+    size_t m_capacity;
+
+    // Cache state, guarded by m_mutex. m_lru holds resident bricks, most
+    // recently used first; bricks being read are in m_slots only.
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_brickReady;
+    mutable std::unordered_map<size_t, Slot> m_slots;
+    mutable std::list<size_t> m_lru;
+    mutable Stats m_stats;
+
+    // Prefetch thread and its queue (also guarded by m_mutex)
+    mutable std::deque<size_t> m_prefetchQueue;
+    mutable std::condition_variable m_prefetchWake;
+    std::thread m_prefetcher;
+    bool m_prefetchEnabled;
+    bool m_stopping;
+
+    size_t brickId(const size_t brick[3]) const {
+        return (brick[0] * m_brickCount[1] + brick[1]) * m_brickCount[2] + brick[2];
+    }
+
+    /**
+     * Brick holding a grid point along one axis, and the point's local index
+     */
+    void brickOf(size_t axis, size_t index, size_t& brick, size_t& local) const;
+
+    /**
+     * Resident brick, reading it first if needed
+     */
+    std::shared_ptr<const std::vector<double>> acquire(size_t id) const;
+
+    /**
+     * Read and verify one brick from the file
+     */
+    bool readBrick(size_t id, std::vector<double>& values) const;
+
+    /**
+     * Make a freshly read brick resident and evict beyond capacity
+     * (m_mutex held)
+     */
+    void insertBrick(size_t id, const std::shared_ptr<const std::vector<double>>& brick) const;
+
+    void prefetchLoop();
+    void stopPrefetcher();
+};
+
+#endif // TILED_GRID_H
@@ -12,8 +12,11 @@
  - Chamber pressure (Pc)
  - Mixture ratio (O/F)
  - Ambient pressure (Pa)
+ - Optionally, nozzle area ratio (Ae/At)
 
- Output: CSV file with columns: Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe
+ Output: CSV file with columns: Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma
+ (Pc,OF,Pa,AeAt,Cf,... when sweeping area ratio; load that table with
+ RPAPerformanceTable<4>)
 ****************************************************/
 
 // Configuration - MODIFY THESE FOR YOUR PROPELLANTS AND RANGES
@@ -36,7 +39,8 @@ var CONFIG = {
     Pa_steps: 6,
 
     // Engine geometry (if you want fixed geometry)
-    // Leave null to recalculate optimal expansion for each condition
+    // Leave null to recalculate optimal expansion for each condition, or
+    // give a list (e.g. [6, 8, 10, 12]) to add area ratio as a fourth axis
     expansion_ratio: 10.0,         // Area ratio (Ae/At)
 
     // Output file
@@ -64,16 +68,20 @@ function generateTables() {
     var Pc_range = linspace(CONFIG.Pc_min, CONFIG.Pc_max, CONFIG.Pc_steps);
     var OF_range = linspace(CONFIG.OF_min, CONFIG.OF_max, CONFIG.OF_steps);
     var Pa_range = linspace(CONFIG.Pa_min, CONFIG.Pa_max, CONFIG.Pa_steps);
+    var sweepAeAt = CONFIG.expansion_ratio instanceof Array;
+    var AeAt_range = sweepAeAt ? CONFIG.expansion_ratio : [CONFIG.expansion_ratio];
 
     // Open output file
     var file = new File(CONFIG.output_file);
     file.open(File.WriteOnly);
 
     // Write header
-    file.writeLine("Pc_psi,OF,Pa_psi,Cf,Cstar_ms,Isp_s,Ve_ms,Pe_psi,Gamma");
+    file.writeLine("Pc_psi,OF,Pa_psi," + (sweepAeAt ? "AeAt," : "") +
+                   "Cf,Cstar_ms,Isp_s,Ve_ms,Pe_psi,Gamma");
 
     print("Generating RPA thrust tables...");
-    print("Total calculations: " + (Pc_range.length * OF_range.length * Pa_range.length));
+    print("Total calculations: " +
+          (Pc_range.length * OF_range.length * Pa_range.length * AeAt_range.length));
 
     var count = 0;
 
@@ -87,64 +95,69 @@ function generateTables() {
             for (var k = 0; k < Pa_range.length; k++) {
                 var Pa = Pa_range[k];
 
-                // Create performance object for this condition
-                var perf = Performance();
-
-                // Set propellants
-                var prop = Propellant();
-                prop.setOxidizer(CONFIG.oxidizer);
-                prop.setFuel(CONFIG.fuel);
-                prop.setMr(OF);
-                perf.setPropellant(prop);
-
-                // Set chamber conditions
-                var chamber = Chamber();
-                chamber.setP(Pc, "psi");
-                perf.setChamber(chamber);
-
-                // Set nozzle conditions
-                var nozzle = Nozzle();
-                nozzle.setModel(Nozzle.SHIFTING);
-
-                if (CONFIG.expansion_ratio !== null) {
-                    nozzle.setAeAt(CONFIG.expansion_ratio);
-                } else {
-                    // Optimal expansion for this ambient pressure
-                    nozzle.setOptimization(true);
-                }
-
-                nozzle.setPa(Pa, "psi");
-                perf.setNozzle(nozzle);
-
-                // Solve performance
-                try {
-                    perf.solve();
-
-                    // Extract results
-                    var chamber_result = perf.getChamber();
-                    var nozzle_result = perf.getNozzle();
-
-                    var Cf = perf.getCf();
-                    var Cstar = chamber_result.getReaction(0).getCstar("m/s");
-                    var Isp = perf.getIsp("s");
-                    var Ve = nozzle_result.getSection(1).getV("m/s");
-                    var Pe = nozzle_result.getSection(1).getP("psi");
-                    var gamma = chamber_result.getReaction(0).getK();
-
-                    // Write to file
-                    var line = Pc + "," + OF + "," + Pa + "," +
-                               Cf + "," + Cstar + "," + Isp + "," +
-                               Ve + "," + Pe + "," + gamma;
-                    file.writeLine(line);
-
-                    count++;
-                    if (count % 100 == 0) {
-                        print("Completed: " + count + " calculations");
+                for (var m = 0; m < AeAt_range.length; m++) {
+                    var AeAt = AeAt_range[m];
+
+                    // Create performance object for this condition
+                    var perf = Performance();
+
+                    // Set propellants
+                    var prop = Propellant();
+                    prop.setOxidizer(CONFIG.oxidizer);
+                    prop.setFuel(CONFIG.fuel);
+                    prop.setMr(OF);
+                    perf.setPropellant(prop);
+
+                    // Set chamber conditions
+                    var chamber = Chamber();
+                    chamber.setP(Pc, "psi");
+                    perf.setChamber(chamber);
+
+                    // Set nozzle conditions
+                    var nozzle = Nozzle();
+                    nozzle.setModel(Nozzle.SHIFTING);
+
+                    if (AeAt !== null) {
+                        nozzle.setAeAt(AeAt);
+                    } else {
+                        // Optimal expansion for this ambient pressure
+                        nozzle.setOptimization(true);
                     }
 
-                } catch (e) {
-                    print("Warning: Failed at Pc=" + Pc + ", OF=" + OF + ", Pa=" + Pa);
-                    print("Error: " + e);
+                    nozzle.setPa(Pa, "psi");
+                    perf.setNozzle(nozzle);
+
+                    // Solve performance
+                    try {
+                        perf.solve();
+
+                        // Extract results
+                        var chamber_result = perf.getChamber();
+                        var nozzle_result = perf.getNozzle();
+
+                        var Cf = perf.getCf();
+                        var Cstar = chamber_result.getReaction(0).getCstar("m/s");
+                        var Isp = perf.getIsp("s");
+                        var Ve = nozzle_result.getSection(1).getV("m/s");
+                        var Pe = nozzle_result.getSection(1).getP("psi");
+                        var gamma = chamber_result.getReaction(0).getK();
+
+                        // Write to file
+                        var line = Pc + "," + OF + "," + Pa + "," +
+                                   (sweepAeAt ? AeAt + "," : "") + Cf + "," + Cstar + "," + Isp + "," +
+                                   Ve + "," + Pe + "," + gamma;
+                        file.writeLine(line);
+
+                        count++;
+                        if (count % 100 == 0) {
+                            print("Completed: " + count + " calculations");
+                        }
+
+                    } catch (e) {
+                        print("Warning: Failed at Pc=" + Pc + ", OF=" + OF + ", Pa=" + Pa +
+                              (sweepAeAt ? ", AeAt=" + AeAt : ""));
+                        print("Error: " + e);
+                    }
                 }
             }
         }
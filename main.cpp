@@ -1,11 +1,185 @@
+/**
+ * main.cpp
+ *
+ * Flies the default Rocket (see FlightSim.h) with each integration method
+ * and compares them: steps (in total, and during boost and coast to
+ * apogee), rejected steps, derivative evaluations, apogee, flight time and
+ * integration speed in steps per second (best of --repeat runs).
+ *
+ * With --record, each method then flies once more into a FlightRecorder log
+ * <prefix>.<method>.flog, keeping every --decimate'th step plus every step
+ * within --event-window seconds of rail exit, burnout, apogee and impact.
+ * The log is mapped back with FlightLog and summarised.
+ *
+ * With --aero, drag and normal force come from a RASAero CSV export (see
+ * RasData) instead of the rocket's constant coefficients.
+ *
+ * Usage:
+ *   flight_sim [--method rk4|rk45|both] [--dt 0.05] [--rtol 1e-6] [--atol 1e-6]
+ *              [--max-step 10] [--repeat N] [--aero rasaero.csv]
+ *              [--record prefix] [--decimate N] [--event-window s]
+ */
+
+#include "FlightSim.h"
+#include "FlightRecorder.h"
 #include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
 
+namespace {
+    struct Config {
+        bool rk4 = true;
+        bool rk45 = true;
+        RigidBodyIntegrator::Settings integrator;
+        int repeat = 20;
+        std::string aeroFile;
+        Rocket rocket;
+        std::string recordPrefix;
+        FlightRecorder::Settings recorder;
+    };
 
-int main() {
-    
-    
-    
-    return 0;
+    void usage(const char* program) {
+        std::cerr << "Usage: " << program << " [--method rk4|rk45|both] [--dt s]\n"
+                  << "       [--rtol r] [--atol a] [--max-step s] [--repeat N] [--aero rasaero.csv]\n"
+                  << "       [--record prefix] [--decimate N] [--event-window s]" << std::endl;
+    }
+
+    bool parseArgs(int argc, char** argv, Config& config) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            if (arg == "--method") {
+                config.rk4 = value == "rk4" || value == "both";
+                config.rk45 = value == "rk45" || value == "both";
+                if (!config.rk4 && !config.rk45) return false;
+            }
+            else if (arg == "--dt") config.integrator.step = std::atof(value.c_str());
+            else if (arg == "--rtol") config.integrator.relativeTolerance = std::atof(value.c_str());
+            else if (arg == "--atol") config.integrator.absoluteTolerance = std::atof(value.c_str());
+            else if (arg == "--max-step") config.integrator.maxStep = std::atof(value.c_str());
+            else if (arg == "--repeat") config.repeat = std::max(1, std::atoi(value.c_str()));
+            else if (arg == "--aero") config.aeroFile = value;
+            else if (arg == "--record") config.recordPrefix = value;
+            else if (arg == "--decimate") config.recorder.decimation = std::max(1, std::atoi(value.c_str()));
+            else if (arg == "--event-window") config.recorder.eventWindow = std::max(0.0, std::atof(value.c_str()));
+            else return false;
+        }
+        return true;
+    }
+
+    void fly(const Config& config, RigidBodyIntegrator::Method method) {
+        FlightSim::Settings settings;
+        settings.integrator = config.integrator;
+        settings.integrator.method = method;
+        FlightSim sim(config.rocket, settings);
+
+        FlightSim::Result result;
+        double best = 0.0;
+        for (int r = 0; r < config.repeat; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            result = sim.run();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (r == 0 || seconds < best) best = seconds;
+        }
+
+        const RigidBodyIntegrator::Stats& steps = result.steps;
+        std::cout << std::left << std::setw(6) << RigidBodyIntegrator::methodName(method) << std::right
+                  << std::setw(8) << steps.steps
+                  << std::setw(7) << result.boostSteps
+                  << std::setw(7) << result.coastSteps
+                  << std::setw(10) << steps.rejectedSteps
+                  << std::setw(8) << steps.evaluations
+                  << std::fixed << std::setprecision(4)
+                  << std::setw(10) << steps.minStepTaken
+                  << std::setw(10) << steps.maxStepTaken
+                  << std::setprecision(2)
+                  << std::setw(11) << result.apogee
+                  << std::setw(9) << result.flightTime
+                  << std::setw(10) << best * 1e6
+                  << std::setw(13) << std::setprecision(0) << steps.steps / best
+                  << std::defaultfloat << std::endl;
+    }
+
+    void record(const Config& config, RigidBodyIntegrator::Method method) {
+        FlightSim::Settings settings;
+        settings.integrator = config.integrator;
+        settings.integrator.method = method;
+        FlightSim sim(config.rocket, settings);
+
+        const std::string filename = config.recordPrefix + (method == RigidBodyIntegrator::Method::RK4 ? ".rk4" : ".rk45") + ".flog";
+        // Hold back enough fixed steps to cover the window before an event
+        FlightRecorder::Settings recording = config.recorder;
+        if (method == RigidBodyIntegrator::Method::RK4) {
+            const size_t windowSteps = static_cast<size_t>(std::ceil(recording.eventWindow / settings.integrator.step)) + 2;
+            recording.preEventRows = std::max(recording.preEventRows, windowSteps);
+        }
+        FlightRecorder recorder;
+        if (!recorder.open(filename, FlightSim::recordColumns(), recording)) {
+            throw std::runtime_error("Cannot create " + filename);
+        }
+        sim.setRecorder(&recorder);
+        const auto start = std::chrono::steady_clock::now();
+        const FlightSim::Result result = sim.run();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!recorder.close()) {
+            throw std::runtime_error("Failed writing " + filename);
+        }
+
+        FlightLog log;
+        if (!log.open(filename)) {
+            throw std::runtime_error("Cannot read back " + filename);
+        }
+        std::vector<double> z;
+        log.readColumn(log.findColumn("z"), z);
+        const FlightRecorder::Stats& stats = recorder.getStats();
+        std::cout << filename << ": " << log.getRowCount() << " of " << stats.samples << " samples in "
+                  << log.getChunkCount() << " chunks, " << stats.fileBytes << " bytes, "
+                  << stats.stalls << " stalls, " << std::fixed << std::setprecision(0) << seconds * 1e6
+                  << " us; max recorded z " << std::setprecision(2) << *std::max_element(z.begin(), z.end())
+                  << " m (apogee " << result.apogee << " m)" << std::endl;
+        for (const FlightLog::Event& event : log.getEvents()) {
+            std::cout << "  " << std::setw(10) << std::left
+                      << FlightSim::eventName(static_cast<FlightSim::Event>(event.code)) << std::right
+                      << std::setprecision(3) << std::setw(9) << event.time << " s  row " << event.row << std::endl;
+        }
+        std::cout << std::defaultfloat;
+    }
 }
 
+int main(int argc, char** argv) {
+    Config config;
+    if (!parseArgs(argc, argv, config)) {
+        usage(argv[0]);
+        return 1;
+    }
 
+    try {
+        if (!config.aeroFile.empty()) {
+            RasData ras;
+            if (!ras.load(config.aeroFile)) {
+                std::cerr << "Error: cannot load aero data from " << config.aeroFile << std::endl;
+                ras.getLoadReport().write(std::cerr);
+                return 1;
+            }
+            config.rocket.setAerodynamics(ras);
+        }
+        std::cout << "method   steps  boost  coast  rejected   evals  min step  max step  apogee (m)  time (s)  us/flight  steps/s" << std::endl;
+        if (config.rk4) fly(config, RigidBodyIntegrator::Method::RK4);
+        if (config.rk45) fly(config, RigidBodyIntegrator::Method::RK45);
+        if (!config.recordPrefix.empty()) {
+            std::cout << std::endl;
+            if (config.rk4) record(config, RigidBodyIntegrator::Method::RK4);
+            if (config.rk45) record(config, RigidBodyIntegrator::Method::RK45);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
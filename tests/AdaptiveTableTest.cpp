@@ -0,0 +1,102 @@
+/**
+ * AdaptiveTableTest.cpp
+ *
+ * AdaptiveTableGenerator against AnalyticOracle: refinement must converge,
+ * and every cell edge midpoint, face centre and cell centre of the written
+ * table, reloaded from CSV, must be within the tolerance of the oracle.
+ */
+
+#include "TestSupport.h"
+#include "AdaptiveTableGenerator.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    typedef RPATableInterpolator::PerformanceData PerformanceData;
+
+    void values(const PerformanceData& p, double out[6]) {
+        out[0] = p.Cf;
+        out[1] = p.Cstar;
+        out[2] = p.Isp;
+        out[3] = p.Ve;
+        out[4] = p.Pe;
+        out[5] = p.gamma;
+    }
+
+    // Worst midpoint error over the tolerance, recomputed from scratch
+    double worstMidpointRatio(const RPATableInterpolator& table, const std::vector<double>* axes,
+                              AnalyticOracle& oracle, double tolerance) {
+        double scale[6] = { 0, 0, 0, 0, 0, 0 };
+        for (double Pc : axes[0]) {
+            for (double OF : axes[1]) {
+                for (double Pa : axes[2]) {
+                    PerformanceData p;
+                    double v[6];
+                    oracle.sample(Pc, OF, Pa, p);
+                    values(p, v);
+                    for (int f = 0; f < 6; ++f) scale[f] = std::max(scale[f], std::fabs(v[f]));
+                }
+            }
+        }
+
+        double worst = 0.0;
+        // Along each axis: breakpoints (even i) and interval midpoints (odd i)
+        for (size_t i = 0; i + 1 < 2 * axes[0].size(); ++i) {
+            for (size_t j = 0; j + 1 < 2 * axes[1].size(); ++j) {
+                for (size_t k = 0; k + 1 < 2 * axes[2].size(); ++k) {
+                    if (i % 2 == 0 && j % 2 == 0 && k % 2 == 0) continue;
+                    const size_t index[3] = { i, j, k };
+                    double x[3];
+                    for (int a = 0; a < 3; ++a) {
+                        const size_t n = index[a] / 2;
+                        x[a] = index[a] % 2 ? 0.5 * (axes[a][n] + axes[a][n + 1]) : axes[a][n];
+                    }
+                    PerformanceData exact;
+                    oracle.sample(x[0], x[1], x[2], exact);
+                    double e[6], g[6];
+                    values(exact, e);
+                    values(table.getPerformance(x[0], x[1], x[2]), g);
+                    for (int f = 0; f < 6; ++f) {
+                        worst = std::max(worst, std::fabs(g[f] - e[f]) / (tolerance * scale[f]));
+                    }
+                }
+            }
+        }
+        return worst;
+    }
+
+    void checkMode(RPATableInterpolator::InterpolationMode mode, const std::string& label) {
+        AdaptiveTableGenerator::Settings settings;
+        settings.tolerance = 2e-3;
+        settings.mode = mode;
+        AdaptiveTableGenerator generator(settings);
+        AnalyticOracle oracle(10.0);
+
+        if (!test::check(generator.generate(oracle), label + ": generation failed: " + generator.getError())) {
+            return;
+        }
+        const AdaptiveTableGenerator::Report& report = generator.getReport();
+        test::check(report.converged, label + ": refinement did not converge");
+        test::check(report.maxErrorRatio <= 1.0, label + ": reported error over tolerance");
+        test::check(report.axisPoints[2] < report.axisPoints[0] && report.axisPoints[2] < report.axisPoints[1],
+                    label + ": Pa axis refined as much as Pc or O/F");
+
+        const std::string csv = test::tempPath("adaptive.csv");
+        RPATableInterpolator table;
+        table.setInterpolationMode(mode);
+        test::check(generator.writeCsv(csv) && table.loadTable(csv), label + ": written table does not load");
+        std::remove(csv.c_str());
+
+        const std::vector<double> axes[3] = { generator.getAxis(0), generator.getAxis(1), generator.getAxis(2) };
+        const double worst = worstMidpointRatio(table, axes, oracle, settings.tolerance);
+        test::check(worst <= 1.0, label + ": midpoint error " + std::to_string(worst) + " x tolerance");
+        std::cout << label << ": " << report.axisPoints[0] << "x" << report.axisPoints[1] << "x"
+                  << report.axisPoints[2] << " grid, worst midpoint " << worst << " x tolerance" << std::endl;
+    }
+}
+
+int main() {
+    checkMode(RPATableInterpolator::InterpolationMode::Trilinear, "trilinear");
+    checkMode(RPATableInterpolator::InterpolationMode::MonotoneTricubic, "tricubic");
+    return test::finish("AdaptiveTableTest");
+}
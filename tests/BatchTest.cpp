@@ -0,0 +1,153 @@
+/**
+ * BatchTest.cpp
+ *
+ * getPerformanceBatch at every SIMD level the CPU supports must match
+ * getPerformance bit for bit, including NaN, infinite and out-of-table
+ * inputs and batches that end part-way through a vector, in both
+ * interpolation modes and every storage precision.
+ */
+
+#include "TestSupport.h"
+#include "RPATableInterpolator.h"
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <cstdio>
+
+namespace {
+    typedef RPATableInterpolator::SimdLevel SimdLevel;
+
+    const char* simdName(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        default: return "scalar";
+        }
+    }
+
+    struct Queries {
+        std::vector<double> Pc, OF, Pa;
+
+        void add(double pc, double of, double pa) {
+            Pc.push_back(pc);
+            OF.push_back(of);
+            Pa.push_back(pa);
+        }
+    };
+
+    // Random points inside and around the table, grid points, and NaN and
+    // infinite values on every axis
+    Queries makeQueries() {
+        Queries q;
+        std::mt19937_64 rng(11);
+        std::uniform_real_distribution<double> pc(0.0, 1100.0), of(0.5, 4.0), pa(-2.0, 17.0);
+        for (int i = 0; i < 4000; ++i) q.add(pc(rng), of(rng), pa(rng));
+        q.add(50.0, 1.0, 0.0);
+        q.add(1000.0, 3.5, 14.7);
+        q.add(300.0, 2.25, 4.9);
+        const double specials[] = {
+            std::numeric_limits<double>::quiet_NaN(),
+            std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity()
+        };
+        for (double s : specials) {
+            q.add(s, 2.0, 5.0);
+            q.add(400.0, s, 5.0);
+            q.add(400.0, 2.0, s);
+            q.add(s, s, s);
+        }
+        return q;
+    }
+
+    void checkBatches(RPATableInterpolator& table, const std::string& label) {
+        const Queries q = makeQueries();
+        const size_t n = q.Pc.size();
+        std::vector<double> out[RPATableInterpolator::NUM_FIELDS];
+        for (auto& field : out) field.resize(n);
+        const RPATableInterpolator::PerformanceBatch batch = {
+            out[0].data(), out[1].data(), out[2].data(), out[3].data(), out[4].data(), out[5].data()
+        };
+
+        const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512 };
+        for (SimdLevel level : levels) {
+            if (static_cast<int>(level) > static_cast<int>(RPATableInterpolator::detectSimdLevel())) {
+                break;
+            }
+            table.setSimdLevel(level);
+            // Odd counts leave a tail after the last full vector
+            const size_t counts[] = { n, n - 3, 1 };
+            for (size_t count : counts) {
+                table.getPerformanceBatch(q.Pc.data(), q.OF.data(), q.Pa.data(), count, batch);
+                for (size_t i = 0; i < count; ++i) {
+                    const RPATableInterpolator::PerformanceData ref = table.getPerformance(q.Pc[i], q.OF[i], q.Pa[i]);
+                    const double expected[] = { ref.Cf, ref.Cstar, ref.Isp, ref.Ve, ref.Pe, ref.gamma };
+                    bool same = true;
+                    for (int f = 0; f < RPATableInterpolator::NUM_FIELDS; ++f) {
+                        same = same && test::sameBits(out[f][i], expected[f]);
+                    }
+                    if (!test::check(same, label + simdName(level) + " batch differs at " +
+                                           test::point(q.Pc[i], q.OF[i], q.Pa[i]))) {
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    const std::string csv = test::tempPath("batch.csv");
+    if (!test::writeTestTable(csv)) {
+        std::cerr << "Cannot build the test table" << std::endl;
+        return 1;
+    }
+
+    // Fixed16 spreads each field's range over 65536 levels
+    double low[6], high[6];
+    std::vector<double> axes[3];
+    test::testTableAxes(axes[0], axes[1], axes[2]);
+    for (int f = 0; f < 6; ++f) {
+        low[f] = INFINITY;
+        high[f] = -INFINITY;
+    }
+    for (double Pc : axes[0]) {
+        for (double OF : axes[1]) {
+            for (double Pa : axes[2]) {
+                double v[6];
+                test::testTableValues(Pc, OF, Pa, v);
+                for (int f = 0; f < 6; ++f) {
+                    low[f] = std::min(low[f], v[f]);
+                    high[f] = std::max(high[f], v[f]);
+                }
+            }
+        }
+    }
+
+    typedef RPATableInterpolator::StoragePrecision StoragePrecision;
+    const StoragePrecision precisions[] = { StoragePrecision::Double, StoragePrecision::Float32,
+                                            StoragePrecision::Fixed16 };
+    const char* precisionNames[] = { "double", "float32", "fixed16" };
+    for (int p = 0; p < 3; ++p) {
+        const std::string label = std::string(precisionNames[p]) + " ";
+        RPATableInterpolator table;
+        table.setStoragePrecision(precisions[p]);
+        if (!test::check(table.loadTable(csv), label + "table does not load")) {
+            continue;
+        }
+        const RPATableInterpolator::ErrorReport& q = table.getQuantizationError();
+        for (int f = 0; f < RPATableInterpolator::NUM_FIELDS; ++f) {
+            const double bound = p == 0 ? 0.0 : p == 1 ? std::ldexp(std::max(std::fabs(low[f]), std::fabs(high[f])), -24)
+                                                       : 0.5 * (high[f] - low[f]) / 65535.0 * (1.0 + 1e-9);
+            test::check(q.fields[f].maxAbsError <= bound,
+                        label + "quantisation error of field " + std::to_string(f) + " is " +
+                        std::to_string(q.fields[f].maxAbsError));
+        }
+
+        checkBatches(table, label);
+        table.setInterpolationMode(RPATableInterpolator::InterpolationMode::MonotoneTricubic);
+        checkBatches(table, label + "tricubic ");
+    }
+    std::remove(csv.c_str());
+
+    return test::finish("BatchTest");
+}
@@ -0,0 +1,118 @@
+/**
+ * CompiledModelTest.cpp
+ *
+ * CompiledThrustModel must agree with ThrustCalculator::calculateThrust to
+ * rounding, flag clamped, non-finite and invalid-flow inputs in its status
+ * word, and stay valid after the calculator that built it is gone.
+ */
+
+#include "TestSupport.h"
+#include "ThrustCalculator.h"
+#include "CompiledThrustModel.h"
+#include <random>
+#include <memory>
+#include <stdexcept>
+#include <cstdio>
+
+namespace {
+    const double THROAT_AREA = 2.5;
+
+    void checkAgreement(const ThrustCalculator& calculator, const CompiledThrustModel& model) {
+        std::mt19937_64 rng(16);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        const size_t n = 5000;
+        std::vector<double> Pc(n), OF(n), Pa(n), F(n);
+        ThrustCalculator::QueryState state;
+        for (size_t i = 0; i < n; ++i) {
+            Pc[i] = 50.0 + 950.0 * unit(rng);
+            OF[i] = 1.0 + 2.5 * unit(rng);
+            Pa[i] = 14.7 * unit(rng);
+
+            const double mdot_fuel = 1.0 + 9.0 * unit(rng);
+            const double mdot_ox = OF[i] * mdot_fuel;
+            const double expected = calculator.calculateThrust(Pc[i], mdot_ox, mdot_fuel, Pa[i], state);
+            unsigned status = CompiledThrustModel::STATUS_OK;
+            const double fromFlows = model.thrust(Pc[i], mdot_ox, mdot_fuel, Pa[i], status);
+            if (!test::check(std::fabs(fromFlows - expected) <= 1e-12 * std::fabs(expected) &&
+                             status == CompiledThrustModel::STATUS_OK,
+                             "model thrust " + std::to_string(fromFlows) + " vs calculator " +
+                             std::to_string(expected) + " at " + test::point(Pc[i], OF[i], Pa[i]))) {
+                return;
+            }
+        }
+
+        unsigned status = CompiledThrustModel::STATUS_OK;
+        model.thrustBatch(Pc.data(), OF.data(), Pa.data(), n, F.data(), status);
+        bool same = status == CompiledThrustModel::STATUS_OK;
+        for (size_t i = 0; i < n; ++i) {
+            unsigned pointStatus = CompiledThrustModel::STATUS_OK;
+            same = same && test::sameBits(F[i], model.thrust(Pc[i], OF[i], Pa[i], pointStatus));
+        }
+        test::check(same, "thrustBatch differs from thrust");
+    }
+
+    void checkStatus(const CompiledThrustModel& model) {
+        unsigned status = CompiledThrustModel::STATUS_OK;
+        const double edge = model.thrust(1000.0, 2.0, 5.0, status);
+        test::check(status == CompiledThrustModel::STATUS_OK, "in-table query set a status flag");
+
+        // Pc clamps to the table edge, but thrust still scales with the actual Pc
+        const double above = model.thrust(1200.0, 2.0, 5.0, status);
+        test::check(status == CompiledThrustModel::STATUS_CLAMPED, "Pc above the table not flagged as clamped");
+        test::check(std::fabs(above - 1.2 * edge) <= 1e-12 * above, "clamped thrust does not use the edge value");
+
+        status = CompiledThrustModel::STATUS_OK;
+        test::check(std::isnan(model.thrust(NAN, 2.0, 5.0, status)) && status == CompiledThrustModel::STATUS_NON_FINITE,
+                    "NaN chamber pressure not flagged");
+        status = CompiledThrustModel::STATUS_OK;
+        test::check(std::isnan(model.thrust(500.0, 2.0, INFINITY, status)) &&
+                    (status & CompiledThrustModel::STATUS_NON_FINITE),
+                    "infinite ambient pressure not flagged");
+
+        status = CompiledThrustModel::STATUS_OK;
+        test::check(std::isnan(model.thrust(500.0, 10.0, 0.0, 5.0, status)) &&
+                    (status & CompiledThrustModel::STATUS_INVALID_FLOW),
+                    "zero fuel flow not flagged");
+
+        // Flags accumulate over queries
+        model.thrust(500.0, 2.0, 5.0, status);
+        test::check(status & CompiledThrustModel::STATUS_INVALID_FLOW, "a later query cleared the status");
+    }
+}
+
+int main() {
+    const std::string csv = test::tempPath("compiled_model.csv");
+    if (!test::writeTestTable(csv)) {
+        std::cerr << "Cannot build the test table" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<ThrustCalculator> calculator(new ThrustCalculator());
+    bool threw = false;
+    try {
+        calculator->compile();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    test::check(threw, "compile accepted a calculator without a table");
+
+    if (!test::check(calculator->loadPerformanceTable(csv), "table does not load")) {
+        return test::finish("CompiledModelTest");
+    }
+    std::remove(csv.c_str());
+    calculator->setThroatArea(THROAT_AREA);
+
+    CompiledThrustModel model = calculator->compile();
+    test::check(model.getThroatArea() == THROAT_AREA, "model lost the throat area");
+    checkAgreement(*calculator, model);
+
+    // The model owns its data
+    unsigned status = CompiledThrustModel::STATUS_OK;
+    const double before = model.thrust(321.0, 2.2, 4.4, status);
+    calculator.reset();
+    test::check(test::sameBits(model.thrust(321.0, 2.2, 4.4, status), before),
+                "model changed when its calculator was destroyed");
+    checkStatus(model);
+
+    return test::finish("CompiledModelTest");
+}
@@ -0,0 +1,95 @@
+/**
+ * CompiledTableTest.cpp
+ *
+ * The compiled binary format must round-trip a CSV table exactly, and
+ * corrupt, truncated or foreign files must be rejected.
+ */
+
+#include "TestSupport.h"
+#include "RPATableInterpolator.h"
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <cstdio>
+
+namespace {
+    std::vector<char> readFile(const std::string& filename) {
+        std::ifstream in(filename, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string& filename, const std::vector<char>& bytes) {
+        std::ofstream out(filename, std::ios::binary);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    void checkSameTable(const RPATableInterpolator& a, const RPATableInterpolator& b) {
+        double boundsA[6], boundsB[6];
+        a.getBounds(boundsA[0], boundsA[1], boundsA[2], boundsA[3], boundsA[4], boundsA[5]);
+        b.getBounds(boundsB[0], boundsB[1], boundsB[2], boundsB[3], boundsB[4], boundsB[5]);
+        for (int i = 0; i < 6; ++i) {
+            test::check(test::sameBits(boundsA[i], boundsB[i]), "compiled table bounds differ");
+        }
+
+        std::mt19937_64 rng(41);
+        std::uniform_real_distribution<double> pc(0.0, 1100.0), of(0.5, 4.0), pa(-2.0, 17.0);
+        for (int i = 0; i < 2000; ++i) {
+            const double Pc = pc(rng), OF = of(rng), Pa = pa(rng);
+            const RPATableInterpolator::PerformanceData x = a.getPerformance(Pc, OF, Pa);
+            const RPATableInterpolator::PerformanceData y = b.getPerformance(Pc, OF, Pa);
+            const bool same = test::sameBits(x.Cf, y.Cf) && test::sameBits(x.Cstar, y.Cstar) &&
+                              test::sameBits(x.Isp, y.Isp) && test::sameBits(x.Ve, y.Ve) &&
+                              test::sameBits(x.Pe, y.Pe) && test::sameBits(x.gamma, y.gamma);
+            if (!test::check(same, "compiled table differs at " + test::point(Pc, OF, Pa))) {
+                break;
+            }
+        }
+    }
+}
+
+int main() {
+    const std::string csv = test::tempPath("compiled.csv");
+    const std::string compiled = test::tempPath("compiled.rpat");
+    const std::string copy = test::tempPath("compiled_copy.rpat");
+    const std::string damaged = test::tempPath("compiled_damaged.rpat");
+
+    RPATableInterpolator source;
+    if (!test::writeTestTable(csv) || !source.loadTable(csv) ||
+        !RPATableInterpolator::compileTable(csv, compiled)) {
+        std::cerr << "Cannot build the test table" << std::endl;
+        return 1;
+    }
+
+    // Round trip, mapped and re-saved
+    RPATableInterpolator mapped;
+    test::check(mapped.loadCompiledTable(compiled), "compiled table does not load");
+    checkSameTable(source, mapped);
+    test::check(mapped.saveCompiledTable(copy), "mapped table cannot be saved");
+    test::check(readFile(copy) == readFile(compiled), "re-saved compiled table differs from the original");
+
+    const std::vector<char> bytes = readFile(compiled);
+
+    // A flipped payload byte fails the checksum, unless the check is skipped
+    std::vector<char> corrupt = bytes;
+    corrupt[corrupt.size() - 1] ^= 0x01;
+    writeFile(damaged, corrupt);
+    RPATableInterpolator table;
+    test::check(!table.loadCompiledTable(damaged), "corrupt payload accepted");
+    test::check(!table.isValid(), "table valid after a rejected load");
+    test::check(table.loadCompiledTable(damaged, false), "unverified load rejects a readable file");
+
+    // Truncated file and wrong magic
+    writeFile(damaged, std::vector<char>(bytes.begin(), bytes.begin() + bytes.size() / 2));
+    test::check(!table.loadCompiledTable(damaged, false), "truncated file accepted");
+    std::vector<char> foreign = bytes;
+    foreign[0] = 'X';
+    writeFile(damaged, foreign);
+    test::check(!table.loadCompiledTable(damaged, false), "file with a foreign magic accepted");
+    test::check(!table.loadCompiledTable(csv), "CSV accepted as a compiled table");
+
+    std::remove(csv.c_str());
+    std::remove(compiled.c_str());
+    std::remove(copy.c_str());
+    std::remove(damaged.c_str());
+    return test::finish("CompiledTableTest");
+}
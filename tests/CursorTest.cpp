@@ -0,0 +1,94 @@
+/**
+ * CursorTest.cpp
+ *
+ * Lookups through an InterpolationCursor must match cursor-free lookups bit
+ * for bit, whether the cursor hits its cached cell, steps to a neighbour or
+ * searches again, in both interpolation modes, and must notice when its
+ * table is reloaded.
+ */
+
+#include "TestSupport.h"
+#include "RPATableInterpolator.h"
+#include <random>
+#include <cstdio>
+
+namespace {
+    bool sameData(const RPATableInterpolator::PerformanceData& a, const RPATableInterpolator::PerformanceData& b) {
+        return test::sameBits(a.Cf, b.Cf) && test::sameBits(a.Cstar, b.Cstar) && test::sameBits(a.Isp, b.Isp) &&
+               test::sameBits(a.Ve, b.Ve) && test::sameBits(a.Pe, b.Pe) && test::sameBits(a.gamma, b.gamma);
+    }
+
+    // A random walk with occasional jumps, out of the table and back
+    void checkWalk(const RPATableInterpolator& table, const std::string& label) {
+        std::mt19937_64 rng(12);
+        std::normal_distribution<double> step(0.0, 1.0);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        InterpolationCursor cursor, cfCursor;
+        double Pc = 400.0, OF = 2.0, Pa = 7.0;
+        for (int i = 0; i < 20000; ++i) {
+            if (unit(rng) < 0.01) {
+                Pc = -100.0 + 1300.0 * unit(rng);
+                OF = 0.5 + 3.5 * unit(rng);
+                Pa = -1.0 + 17.0 * unit(rng);
+            } else {
+                Pc += 8.0 * step(rng);
+                OF += 0.01 * step(rng);
+                Pa += 0.05 * step(rng);
+            }
+            if (!test::check(sameData(table.getPerformance(Pc, OF, Pa, cursor), table.getPerformance(Pc, OF, Pa)),
+                             label + "cursor getPerformance differs at " + test::point(Pc, OF, Pa))) {
+                return;
+            }
+            const double Cf = table.getFields<RPATableInterpolator::MASK_CF>(Pc, OF, Pa, cfCursor).Cf;
+            if (!test::check(test::sameBits(Cf, table.getFields<RPATableInterpolator::MASK_CF>(Pc, OF, Pa).Cf),
+                             label + "cursor getFields<MASK_CF> differs at " + test::point(Pc, OF, Pa))) {
+                return;
+            }
+        }
+        const InterpolationCursor::Stats& stats = cursor.getStats();
+        test::check(stats.cellHits > 0 && stats.neighbourHits > 0 && stats.fullSearches > 0,
+                    label + "walk did not exercise cell hits, neighbour steps and full searches");
+    }
+}
+
+int main() {
+    const std::string csv = test::tempPath("cursor.csv");
+    RPATableInterpolator table;
+    if (!test::writeTestTable(csv) || !table.loadTable(csv)) {
+        std::cerr << "Cannot build the test table" << std::endl;
+        return 1;
+    }
+
+    checkWalk(table, "trilinear: ");
+    table.setInterpolationMode(RPATableInterpolator::InterpolationMode::MonotoneTricubic);
+    checkWalk(table, "tricubic: ");
+    table.setInterpolationMode(RPATableInterpolator::InterpolationMode::Trilinear);
+
+
+    // A reload must invalidate cells cached from the old grid, and a cursor
+    // moved to another table must not reuse the first one's cell
+    InterpolationCursor cursor;
+    const double before = table.getPerformance(400.0, 2.0, 7.0, cursor).Cf;
+    std::FILE* file = std::fopen(csv.c_str(), "w");
+    std::fprintf(file, "Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma\n");
+    for (double Pc : { 100.0, 900.0 }) {
+        for (double OF : { 1.0, 3.0 }) {
+            for (double Pa : { 0.0, 14.7 }) {
+                std::fprintf(file, "%g,%g,%g,2,1500,200,2000,5,1.2\n", Pc, OF, Pa);
+            }
+        }
+    }
+    std::fclose(file);
+    RPATableInterpolator other;
+    test::check(other.loadTable(csv), "second table does not load");
+    test::check(other.getPerformance(400.0, 2.0, 7.0, cursor).Cf == 2.0, "cursor reused a cell of another table");
+    test::check(test::sameBits(table.getPerformance(400.0, 2.0, 7.0, cursor).Cf, before), "cursor lost its table");
+    test::check(table.loadTable(csv), "reload fails");
+    test::check(table.getPerformance(400.0, 2.0, 7.0, cursor).Cf == 2.0 && before != 2.0,
+                "cursor reused a cell from before the reload");
+
+
+    std::remove(csv.c_str());
+    return test::finish("CursorTest");
+}
@@ -0,0 +1,182 @@
+/**
+ * EngineLibraryTest.cpp
+ *
+ * EngineLibrary must parse every bundled RPA example engine, keep resident
+ * tables within its memory budget by dropping the least recently used, and
+ * let concurrent first requests for a table share one load.
+ *
+ * Usage: EngineLibraryTest [repository root]
+ */
+
+#include "TestSupport.h"
+#include "EngineLibrary.h"
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+
+namespace {
+    std::string counts(const EngineLibrary::Stats& stats) {
+        return std::to_string(stats.loads) + " loads, " + std::to_string(stats.hits) + " hits, " +
+               std::to_string(stats.evictions) + " evictions, " + std::to_string(stats.residentTables) +
+               " resident";
+    }
+
+    // A table large enough that its load takes a while
+    bool writeLargeTable(const std::string& filename) {
+        std::FILE* file = std::fopen(filename.c_str(), "w");
+        if (!file) return false;
+        std::fprintf(file, "Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma\n");
+        for (int i = 0; i < 100; ++i) {
+            for (int j = 0; j < 50; ++j) {
+                for (int k = 0; k < 20; ++k) {
+                    const double Pc = 50.0 + 10.0 * i, OF = 1.0 + 0.05 * j, Pa = 0.75 * k;
+                    double v[6];
+                    test::testTableValues(Pc, OF, Pa, v);
+                    std::fprintf(file, "%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
+                                 Pc, OF, Pa, v[0], v[1], v[2], v[3], v[4], v[5]);
+                }
+            }
+        }
+        return std::fclose(file) == 0;
+    }
+
+    void checkBudget(const std::string& examples, const std::vector<std::string>& tables) {
+        EngineLibrary library;
+        library.addDirectory(examples);
+        const std::vector<std::string> ids = library.getEngineIds();
+        for (size_t i = 0; i < 3; ++i) {
+            library.mapEngine(ids[i], tables[i]);
+        }
+        EngineLibrary::TablePtr first = library.getTable(ids[0]);
+        if (!test::check(first != nullptr, "mapped table does not load")) {
+            return;
+        }
+        const size_t bytes = first->getGridBytes();
+        first.reset();
+        library.clearCache();
+        library.setMemoryBudget(2 * bytes);
+
+        const struct {
+            size_t engine;
+            uint64_t loads, hits, evictions;
+        } steps[] = {
+            { 0, 2, 0, 0 },     // A (loaded once before the cache was cleared)
+            { 1, 3, 0, 0 },     // B
+            { 0, 3, 1, 0 },     // A is resident and becomes most recent
+            { 2, 4, 1, 1 },     // C drops B, the least recently used
+            { 0, 4, 2, 1 },     // A stayed
+            { 1, 5, 2, 2 }      // B was dropped, so it loads again
+        };
+        for (const auto& step : steps) {
+            test::check(library.getTable(ids[step.engine]) != nullptr, "table does not load");
+            const EngineLibrary::Stats stats = library.getStats();
+            if (!test::check(stats.loads == step.loads && stats.hits == step.hits &&
+                             stats.evictions == step.evictions && stats.residentBytes <= 2 * bytes,
+                             "after engine " + ids[step.engine] + ": " + counts(stats))) {
+                return;
+            }
+        }
+
+        // A smaller budget keeps only the most recently used table
+        library.setMemoryBudget(1);
+        test::check(library.getStats().residentTables == 1, "budget below one table dropped every table");
+        library.clearCache();
+        test::check(library.getStats().residentTables == 0 && library.getStats().residentBytes == 0,
+                    "clearCache left tables resident");
+
+        // A missing table is not cached, so it is tried again
+        library.mapEngine(ids[0], test::tempPath("missing.csv"));
+        test::check(library.getTable(ids[0]) == nullptr && library.getTable(ids[0]) == nullptr &&
+                    library.getStats().failedLoads == 2, "missing table not retried");
+    }
+
+    void checkCoalescing(const std::string& examples, const std::string& table) {
+        EngineLibrary library;
+        library.addDirectory(examples);
+        const std::vector<std::string> ids = library.getEngineIds();
+        const size_t threadCount = 8;
+        for (size_t i = 0; i < threadCount; ++i) {
+            library.mapEngine(ids[i], table);
+        }
+
+        std::vector<EngineLibrary::TablePtr> results(threadCount);
+        std::vector<std::thread> threads;
+        std::atomic<bool> go(false);
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&, i]() {
+                while (!go) std::this_thread::yield();
+                results[i] = library.getTable(ids[i]);
+            });
+        }
+        go = true;
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        bool shared = results[0] != nullptr;
+        for (const EngineLibrary::TablePtr& result : results) {
+            shared = shared && result == results[0];
+        }
+        const EngineLibrary::Stats stats = library.getStats();
+        test::check(shared, "engines sharing a table got different tables");
+        test::check(stats.loads == 1 && stats.coalesced > 0 && stats.coalesced + stats.hits == threadCount - 1,
+                    "concurrent requests not coalesced: " + counts(stats) + ", " +
+                    std::to_string(stats.coalesced) + " coalesced");
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string root = argc > 1 ? argv[1] : ".";
+    const std::string examples = root + "/RPA/2.3/standard/examples";
+
+    size_t cfgFiles = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(examples)) {
+        cfgFiles += entry.path().extension() == ".cfg" ? 1 : 0;
+    }
+
+    EngineLibrary library;
+    const size_t added = library.addDirectory(examples);
+    test::check(library.addEngine(root + "/engine_test.cfg"), "engine_test.cfg does not parse");
+    for (const EngineLibrary::ConfigError& error : library.getConfigErrors()) {
+        test::check(false, error.filename + ": " + error.message);
+    }
+    test::check(cfgFiles > 0 && added == cfgFiles, std::to_string(added) + " of " + std::to_string(cfgFiles) +
+                " example engines added");
+
+    const std::vector<std::string> ids = library.getEngineIds();
+    test::check(ids.size() == cfgFiles + 1, "engine ids missing");
+    test::check(library.hasEngine("RD-170") && library.hasEngine("RD-170_altitude"),
+                "engines with one name inside different files not kept apart");
+    const EngineConfig& vulcain = library.getEngine("Vulcain-2");
+    test::check(vulcain.getChamberPressure() > 0.0 && vulcain.getMixtureRatio() > 0.0 &&
+                !vulcain.getOxidizerName().empty() && !vulcain.getFuelName().empty(),
+                "Vulcain-2 parsed without pressure, mixture ratio or propellants");
+    bool threw = false;
+    try {
+        library.getEngine("no-such-engine");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    test::check(threw, "unknown engine id accepted");
+    if (added < 8) {
+        return test::finish("EngineLibraryTest");
+    }
+
+    std::vector<std::string> tables;
+    for (int i = 0; i < 3; ++i) {
+        tables.push_back(test::tempPath("engine_table_" + std::to_string(i) + ".csv"));
+        test::writeTestTable(tables.back());
+    }
+    const std::string large = test::tempPath("engine_table_large.csv");
+    writeLargeTable(large);
+
+    checkBudget(examples, tables);
+    checkCoalescing(examples, large);
+
+    for (const std::string& table : tables) {
+        std::remove(table.c_str());
+    }
+    std::remove(large.c_str());
+    return test::finish("EngineLibraryTest");
+}
@@ -0,0 +1,104 @@
+/**
+ * EquilibriumTest.cpp
+ *
+ * EquilibriumSolver and RocketPerformance against cases with known answers:
+ * stoichiometric H2/O2 is pure water at 500 K and burns at 3079 K at 1 atm
+ * (Glassman, Combustion, table of adiabatic flame temperatures), every
+ * solve conserves elements and holds its assigned enthalpy or entropy, and
+ * a warm-started nozzle solve agrees with a cold one.
+ *
+ * Usage:
+ *   equilibrium_test [thermo.inp]
+ */
+
+#include "TestSupport.h"
+#include "RocketPerformance.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const double H2O_MOL_WEIGHT = 18.01528;     // g/mol
+    const double H2_O2_FLAME_T = 3079.0;        // K, stoichiometric at 1 atm
+
+    bool near(double a, double b, double relative) {
+        return std::fabs(a - b) <= relative * std::fabs(b);
+    }
+
+    // To RP-1311's convergence limit: 1e-6 of the largest element content
+    void checkElements(const EquilibriumSolver& solver, const EquilibriumSolver::Reactants& reactants,
+                       const EquilibriumSolver::State& state, const std::string& label) {
+        double largest = 0.0;
+        for (double b : reactants.elements) largest = std::max(largest, b);
+        for (size_t e = 0; e < solver.elements().size(); ++e) {
+            double moles = 0.0;
+            for (size_t j = 0; j < solver.productCount(); ++j) {
+                moles += solver.product(j).atoms(solver.elements()[e]) * std::exp(state.lnMoles[j]);
+            }
+            test::check(std::fabs(moles - reactants.elements[e]) <= 1e-6 * largest,
+                        label + ": element " + solver.elements()[e] + " not conserved");
+        }
+    }
+
+    void checkHydrogenOxygen(const ThermoDatabase& db) {
+        EquilibriumSolver solver(db, { "O2", "H2" });
+        const double OF = 0.5 * db.find("O2")->molWeight / db.find("H2")->molWeight;
+        const EquilibriumSolver::Reactants reactants = solver.makeReactants({ OF / (1.0 + OF), 1.0 / (1.0 + OF) });
+
+        EquilibriumSolver::State cold;
+        test::check(solver.solveTP(reactants, 1.0, 500.0, cold), "TP solve at 500 K failed");
+        test::check(near(cold.molecularWeight(), H2O_MOL_WEIGHT, 1e-5),
+                    "500 K products are not water: M = " + std::to_string(cold.molecularWeight()));
+        checkElements(solver, reactants, cold, "TP");
+
+        EquilibriumSolver::State flame;
+        test::check(solver.solveHP(reactants, 1.01325, flame), "HP solve failed");
+        test::check(std::fabs(flame.T - H2_O2_FLAME_T) < 20.0,
+                    "adiabatic flame temperature " + std::to_string(flame.T) + " K");
+        // Stoichiometric H2/O2 from the elements has no net enthalpy (J/kg)
+        test::check(std::fabs(flame.enthalpy - reactants.enthalpy) < 1e-3, "HP solve did not hold the enthalpy");
+
+        checkElements(solver, reactants, flame, "HP");
+
+        EquilibriumSolver::State expanded = flame;
+        test::check(solver.solveSP(reactants, 0.1, flame.entropy, expanded), "SP solve failed");
+        test::check(near(expanded.entropy, flame.entropy, 1e-8), "SP solve did not hold the entropy");
+        test::check(expanded.T < flame.T, "isentropic expansion did not cool the gas");
+        checkElements(solver, reactants, expanded, "SP");
+    }
+
+    void checkNozzle(const ThermoDatabase& db) {
+        EquilibriumSolver solver(db, { "N2O4(L)", "UDMH" });
+        RocketPerformance performance(solver);
+        const double Pc = 68.9476;  // 1000 psi
+
+        RocketPerformance::WarmStart warm;
+        RocketPerformance::Result previous, result;
+        const double mixtures[] = { 2.0, 2.1 };
+        for (double OF : mixtures) {
+            const EquilibriumSolver::Reactants reactants = solver.makeReactants({ OF / (1.0 + OF), 1.0 / (1.0 + OF) });
+            RocketPerformance::WarmStart fresh;
+            test::check(performance.solve(reactants, Pc, 10.0, fresh, result), "nozzle solve failed");
+            test::check(performance.solve(reactants, Pc, 10.0, warm, previous), "warm-started nozzle solve failed");
+            test::check(near(previous.Cstar, result.Cstar, 1e-8) && near(previous.Ve, result.Ve, 1e-8) &&
+                        near(previous.Pe, result.Pe, 1e-8), "warm and cold starts disagree");
+            test::check(near(result.areaRatio, 10.0, 1e-6), "exit area ratio " + std::to_string(result.areaRatio));
+            test::check(result.Pe < result.Pt && result.Pt < Pc && result.Pt > 0.5 * Pc,
+                        "throat and exit pressures out of order");
+            test::check(result.Tc > 3000.0 && result.Tc < 3500.0 && result.Cstar > 1600.0 && result.Cstar < 1850.0,
+                        "N2O4/UDMH chamber out of range: Tc " + std::to_string(result.Tc) +
+                        " K, c* " + std::to_string(result.Cstar) + " m/s");
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string thermo = argc > 1 ? argv[1] : "RPA/2.3/standard/resources/thermo.inp";
+    ThermoDatabase db;
+    if (!db.load(thermo)) {
+        std::cerr << "Cannot load " << thermo << std::endl;
+        return 1;
+    }
+    checkHydrogenOxygen(db);
+    checkNozzle(db);
+    return test::finish("EquilibriumTest");
+}
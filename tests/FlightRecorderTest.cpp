@@ -0,0 +1,257 @@
+/**
+ * FlightRecorderTest
+ *
+ * FlightRecorder -> FlightLog round trips: a synthetic stream with
+ * decimation and late-marked events checked row by row against the rows
+ * that should survive, then a FlightSim run recorded in full with its
+ * events.
+ */
+
+#include "FlightRecorder.h"
+#include "FlightSim.h"
+#include "TestSupport.h"
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+
+namespace {
+    const double DT = 0.01;
+    const size_t SAMPLES = 1000;
+
+    struct Mark {
+        size_t after;               // Marked once this sample has been offered
+        uint32_t code;
+        double time;
+    };
+
+    double sampleTime(size_t i) {
+        return i * DT;
+    }
+
+    // The recorder's own rule: every decimation-th sample, the last one, and
+    // any within the window of an event
+    bool kept(size_t i, const FlightRecorder::Settings& settings, const std::vector<Mark>& marks) {
+        const double t = sampleTime(i);
+        if (i % settings.decimation == 0 || i + 1 == SAMPLES) {
+            return true;
+        }
+        for (const Mark& mark : marks) {
+            if (!(mark.time + settings.eventWindow < t) && mark.time - settings.eventWindow <= t) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void checkDecimatedStream() {
+        const std::string path = test::tempPath("stream.flog");
+        FlightRecorder::Settings settings;
+        settings.chunkRows = 16;
+        settings.chunkCount = 2;
+        settings.decimation = 10;
+        settings.eventWindow = 0.05;
+        settings.preEventRows = 8;
+
+        // The first event is marked six samples late, as FlightSim marks
+        // apogee a step after it; the hold ring still has the samples before it
+        const std::vector<Mark> marks = { { 302, 7, 3.005 }, { 750, 9, 7.5 } };
+
+        FlightRecorder recorder;
+        test::check(recorder.open(path, { "t", "a", "b" }, settings), "recorder opens");
+        size_t nextMark = 0;
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            const double row[3] = { sampleTime(i), double(i), -0.5 * i };
+            recorder.record(row);
+            if (nextMark < marks.size() && marks[nextMark].after == i) {
+                recorder.markEvent(marks[nextMark].code, marks[nextMark].time);
+                ++nextMark;
+            }
+        }
+        test::check(recorder.close(), "recorder closes cleanly");
+
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            if (kept(i, settings, marks)) expected.push_back(i);
+        }
+        const FlightRecorder::Stats& stats = recorder.getStats();
+        test::check(stats.samples == SAMPLES, "every sample counted");
+        test::check(stats.rows == expected.size(), "rows kept: " + std::to_string(stats.rows) +
+                                                   " (expected " + std::to_string(expected.size()) + ")");
+        test::check(stats.events == marks.size(), "events counted");
+        test::check(stats.chunks == (expected.size() + 15) / 16, "chunks handed to the writer");
+
+        FlightLog log;
+        if (!test::check(log.open(path), "log opens")) {
+            std::remove(path.c_str());
+            return;
+        }
+        test::check(log.getRowCount() == expected.size(), "log row count");
+        test::check(log.getColumns() == std::vector<std::string>({ "t", "a", "b" }), "column names");
+        test::check(log.findColumn("b") == 2 && log.findColumn("c") == -1, "findColumn");
+        test::check(log.getChunkRows() == 16 && log.getChunkCount() == (expected.size() + 15) / 16, "chunk layout");
+
+        std::vector<double> t, a, b;
+        log.readColumn(0, t);
+        log.readColumn(1, a);
+        log.readColumn(2, b);
+        for (size_t r = 0; r < expected.size() && r < log.getRowCount(); ++r) {
+            const size_t i = expected[r];
+            test::check(test::sameBits(t[r], sampleTime(i)) && test::sameBits(a[r], double(i)) &&
+                        test::sameBits(b[r], -0.5 * i), "row " + std::to_string(r) + " is sample " + std::to_string(i));
+            test::check(test::sameBits(log.value(1, r), a[r]), "value() matches readColumn at row " + std::to_string(r));
+        }
+
+        // Each event's window is kept in full, and its row is the first at or after it
+        test::check(log.getEvents().size() == marks.size(), "events read back");
+        for (size_t e = 0; e < marks.size() && e < log.getEvents().size(); ++e) {
+            const FlightLog::Event& event = log.getEvents()[e];
+            test::check(event.code == marks[e].code && test::sameBits(event.time, marks[e].time),
+                        "event " + std::to_string(e) + " code and time");
+            size_t firstRow = 0;
+            while (firstRow < t.size() && t[firstRow] < marks[e].time) ++firstRow;
+            test::check(event.row == firstRow, "event " + std::to_string(e) + " row");
+            for (size_t i = 0; i < SAMPLES; ++i) {
+                const double ti = sampleTime(i);
+                if (ti >= marks[e].time - settings.eventWindow && ti <= marks[e].time + settings.eventWindow) {
+                    test::check(std::find(expected.begin(), expected.end(), i) != expected.end(),
+                                "sample " + std::to_string(i) + " in event window kept");
+                }
+            }
+        }
+
+        // Chunk columns are contiguous in the mapping
+        size_t rows = 0;
+        const double* column = log.chunkColumn(1, 1, rows);
+        test::check(rows == 16 && test::sameBits(column[0], a[16]) && test::sameBits(column[15], a[31]),
+                    "chunkColumn hands out a whole chunk");
+        bool threw = false;
+        try {
+            log.chunkColumn(3, 0, rows);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        test::check(threw, "bad column rejected");
+        log.close();
+
+        // A log cut short is refused
+        std::vector<char> bytes;
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 8));
+        }
+        test::check(!log.open(path), "truncated log refused");
+        std::remove(path.c_str());
+    }
+
+    void checkMisuse() {
+        FlightRecorder recorder;
+        const double row[1] = { 0.0 };
+        bool threw = false;
+        try {
+            recorder.record(row);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        test::check(threw, "record() without a recording throws");
+
+        threw = false;
+        try {
+            recorder.open(test::tempPath("bad.flog"), {});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        test::check(threw, "no columns rejected");
+
+        const std::string path = test::tempPath("order.flog");
+        recorder.open(path, { "t" });
+        recorder.markEvent(1, 2.0);
+        threw = false;
+        try {
+            recorder.markEvent(2, 1.0);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        test::check(threw, "events out of time order rejected");
+        recorder.close();
+        std::remove(path.c_str());
+    }
+
+    void checkFlight() {
+        const std::string path = test::tempPath("flight.flog");
+        FlightSim::Settings settings;
+        settings.integrator.method = RigidBodyIntegrator::Method::RK4;
+        FlightSim sim(Rocket(), settings);
+
+        FlightRecorder recorder;
+        test::check(recorder.open(path, FlightSim::recordColumns()), "flight recorder opens");
+        sim.setRecorder(&recorder);
+        const FlightSim::Result result = sim.run();
+        test::check(recorder.close(), "flight recorder closes");
+        sim.setRecorder(nullptr);
+
+        // Undecimated: the start of every step plus the end of the flight
+        FlightLog log;
+        if (!test::check(log.open(path), "flight log opens")) {
+            std::remove(path.c_str());
+            return;
+        }
+        test::check(log.getRowCount() == result.steps.steps + 1, "one row per step plus the end");
+        test::check(log.getColumnCount() == 1 + RigidBodyState::SIZE, "time plus the state");
+        std::vector<double> t, z;
+        log.readColumn(0, t);
+        log.readColumn(log.findColumn("z"), z);
+        test::check(!t.empty() && t.front() == 0.0 && test::sameBits(t.back(), result.flightTime), "log spans the flight");
+        bool ordered = true;
+        for (size_t i = 1; i < t.size(); ++i) ordered = ordered && t[i] > t[i - 1];
+        test::check(ordered, "time increases row to row");
+        test::check(!z.empty() && std::fabs(z.back()) < 1e-9, "last row on the ground");
+
+        const std::vector<FlightLog::Event>& events = log.getEvents();
+        const FlightSim::Event order[] = {
+            FlightSim::Event::RAIL_EXIT, FlightSim::Event::BURNOUT, FlightSim::Event::APOGEE, FlightSim::Event::IMPACT
+        };
+        test::check(events.size() == 4, "rail exit, burnout, apogee and impact marked");
+        for (size_t e = 0; e < events.size() && e < 4; ++e) {
+            test::check(events[e].code == static_cast<uint32_t>(order[e]),
+                        std::string(FlightSim::eventName(order[e])) + " in order");
+        }
+        if (events.size() == 4) {
+            test::check(test::sameBits(events[1].time, result.burnoutTime), "burnout time");
+            test::check(test::sameBits(events[2].time, result.apogeeTime), "apogee time");
+            test::check(test::sameBits(events[3].time, result.flightTime), "impact time");
+        }
+        log.close();
+
+        // A flight stopped before the motor burns out has no burnout
+        settings.maxTime = 0.5 * Rocket().burnTime();
+        sim.setSettings(settings);
+        recorder.open(path, FlightSim::recordColumns());
+        sim.setRecorder(&recorder);
+        const FlightSim::Result cut = sim.run();
+        recorder.close();
+        test::check(cut.burnoutTime == 0.0 && cut.boostSteps == 0, "no burnout before the motor stops");
+        test::check(cut.flightTime == settings.maxTime && !cut.impacted, "flight ends at maxTime");
+        if (test::check(log.open(path), "cut flight log opens")) {
+            for (const FlightLog::Event& event : log.getEvents()) {
+                test::check(event.code != static_cast<uint32_t>(FlightSim::Event::BURNOUT), "no burnout event");
+            }
+        }
+        log.close();
+        std::remove(path.c_str());
+    }
+}
+
+int main() {
+    checkDecimatedStream();
+    checkMisuse();
+    checkFlight();
+    return test::finish("FlightRecorderTest");
+}
@@ -0,0 +1,164 @@
+/**
+ * FlightSimLanesTest
+ *
+ * FlightSimLanes of 4, 8 and 16 lanes at every SIMD level the CPU supports
+ * must give results bit-identical to FlightSim::run with RK4, for
+ * thrust-curve, engine and aero-table rockets in varied wind and launch
+ * angles, including flights cut off between thrust curve points, before
+ * burnout and in the coast. A rocket FlightSim rejects comes back as a null
+ * result.
+ */
+
+#include "FlightSimLanes.h"
+#include "TestSupport.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+    typedef RPATableInterpolator::SimdLevel SimdLevel;
+
+    const char* simdName(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        default: return "scalar";
+        }
+    }
+
+    bool sameResult(const FlightSim::Result& a, const FlightSim::Result& b) {
+        using test::sameBits;
+        return sameBits(a.apogee, b.apogee) && sameBits(a.apogeeTime, b.apogeeTime) &&
+               sameBits(a.maxSpeed, b.maxSpeed) && sameBits(a.burnoutTime, b.burnoutTime) &&
+               sameBits(a.burnoutSpeed, b.burnoutSpeed) && sameBits(a.railExitSpeed, b.railExitSpeed) &&
+               sameBits(a.flightTime, b.flightTime) && sameBits(a.range, b.range) &&
+               sameBits(a.landing[0], b.landing[0]) && sameBits(a.landing[1], b.landing[1]) &&
+               a.impacted == b.impacted && a.steps.steps == b.steps.steps &&
+               a.steps.evaluations == b.steps.evaluations && a.boostSteps == b.boostSteps &&
+               a.coastSteps == b.coastSteps;
+    }
+
+    struct Flight {
+        Rocket rocket;
+        FlightSim::Settings settings;
+    };
+
+    std::vector<Flight> makeFlights(const std::shared_ptr<const RPATableInterpolator>& table) {
+        std::vector<double> mach, alpha, cdOff, cdOn, cn;
+        for (int i = 0; i <= 40; ++i) mach.push_back(0.05 * i);
+        for (int j = 0; j <= 15; ++j) alpha.push_back(j * 3.14159265358979323846 / 180.0);
+        for (double m : mach) {
+            for (double a : alpha) {
+                const double cd = 0.4 + 0.2 * std::exp(-(m - 1.0) * (m - 1.0) / 0.03) + 0.8 * a * a;
+                cdOff.push_back(cd);
+                cdOn.push_back(cd - 0.05);
+                cn.push_back((9.0 + m) * a + 2.0 * a * a);
+            }
+        }
+        RasData ras;
+        test::check(ras.loadGrid(mach, alpha, cdOff, cdOn, cn), "aero tables build");
+
+        std::vector<Flight> flights;
+        std::mt19937_64 rng(15);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        for (int i = 0; i < 27; ++i) {
+            Flight f;
+            f.settings.integrator.method = RigidBodyIntegrator::Method::RK4;
+            if (i % 3 != 0) {
+                f.rocket.engine.table = table;
+                f.rocket.engine.tankPressure *= 0.9 + 0.2 * unit(rng);
+            }
+            if (i % 2 == 1) {
+                f.rocket.setAerodynamics(ras);
+                f.rocket.aeroDragScale = 0.9 + 0.2 * unit(rng);
+            }
+            f.rocket.dragCoefficient *= 0.9 + 0.2 * unit(rng);
+            f.settings.wind[0] = 8.0 * unit(rng) - 4.0;
+            f.settings.wind[1] = 8.0 * unit(rng) - 4.0;
+            f.settings.launchAngle = 0.15 * unit(rng);
+            if (i == 3) f.settings.maxTime = 0.2;       // Between thrust curve points
+            if (i == 6) f.settings.maxTime = 4.2;       // After the last kink, before burnout
+            if (i == 7) f.settings.maxTime = 2.0;       // Engine cut off in the boost
+            if (i == 8) f.settings.maxTime = 30.0;      // Ends in the coast
+            if (i == 11) f.rocket.dryMass = 0.0;        // Rejected
+            flights.push_back(f);
+        }
+        return flights;
+    }
+
+    template <size_t W>
+    void checkLanes(const std::vector<Flight>& flights, const std::vector<FlightSim::Result>& expected,
+                    const std::vector<bool>& rejected, SimdLevel level) {
+        const std::string name = std::to_string(W) + " lanes " + simdName(level);
+        FlightSimLanes<W> lanes(flights[0].settings.integrator);
+        lanes.setSimdLevel(level);
+        std::vector<int> seen(flights.size(), 0);
+        size_t next = 0;
+        lanes.run(
+            [&](uint64_t& id, Rocket& rocket, FlightSim::Settings& settings) {
+                if (next == flights.size()) return false;
+                id = next;
+                rocket = flights[next].rocket;
+                settings = flights[next].settings;
+                ++next;
+                return true;
+            },
+            [&](uint64_t id, const FlightSim::Result* result) {
+                ++seen[id];
+                if (test::check(!result == rejected[id],
+                                name + ": flight " + std::to_string(id) + (result ? " flew" : " was rejected")) &&
+                    result) {
+                    test::check(sameResult(*result, expected[id]),
+                                name + ": flight " + std::to_string(id) + " differs from FlightSim");
+                }
+            });
+        for (size_t i = 0; i < flights.size(); ++i) {
+            test::check(seen[i] == 1, name + ": flight " + std::to_string(i) + " finished " +
+                                      std::to_string(seen[i]) + " times");
+        }
+        test::check(lanes.getStats().flights == flights.size(), name + ": flights counted");
+    }
+}
+
+int main() {
+    const std::string csv = test::tempPath("lanes.csv");
+    std::shared_ptr<RPATableInterpolator> table = std::make_shared<RPATableInterpolator>();
+    const bool loaded = test::writeTestTable(csv) && table->loadTable(csv);
+    std::remove(csv.c_str());
+    if (!test::check(loaded, "test table loads")) {
+        return test::finish("FlightSimLanesTest");
+    }
+    const std::vector<Flight> flights = makeFlights(table);
+
+    std::vector<FlightSim::Result> expected(flights.size());
+    std::vector<bool> rejected(flights.size(), false);
+    for (size_t i = 0; i < flights.size(); ++i) {
+        try {
+            FlightSim sim(flights[i].rocket, flights[i].settings);
+            expected[i] = sim.run();
+        } catch (const std::invalid_argument&) {
+            rejected[i] = true;
+        }
+    }
+    test::check(rejected[11] && !rejected[0], "only the massless rocket rejected");
+    test::check(expected[3].burnoutTime == 0.0 && expected[6].burnoutTime == 0.0 &&
+                expected[7].burnoutTime == 0.0, "no burnout in flights cut off before it");
+    test::check(expected[8].burnoutTime > 0.0 && !expected[8].impacted, "coast cut-off flight burns out");
+
+    const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512 };
+    for (SimdLevel level : levels) {
+        if (static_cast<int>(level) > static_cast<int>(RPATableInterpolator::detectSimdLevel())) {
+            continue;
+        }
+        // The lanes' batched engine lookups run at the table's level
+        table->setSimdLevel(level);
+        checkLanes<4>(flights, expected, rejected, level);
+        checkLanes<8>(flights, expected, rejected, level);
+        checkLanes<16>(flights, expected, rejected, level);
+    }
+    return test::finish("FlightSimLanesTest");
+}
@@ -0,0 +1,115 @@
+/**
+ * GradientTest.cpp
+ *
+ * getPerformanceWithGradient must return the same values as getPerformance
+ * bit for bit, derivatives that agree with central differences inside the
+ * cells in both interpolation modes, and zero derivatives along an axis
+ * where the point is clamped to the table edge.
+ */
+
+#include "TestSupport.h"
+#include "RPATableInterpolator.h"
+#include <random>
+#include <cstdio>
+
+namespace {
+    typedef RPATableInterpolator::PerformanceData PerformanceData;
+
+    void values(const PerformanceData& p, double out[6]) {
+        out[0] = p.Cf;
+        out[1] = p.Cstar;
+        out[2] = p.Isp;
+        out[3] = p.Ve;
+        out[4] = p.Pe;
+        out[5] = p.gamma;
+    }
+
+    void checkGradients(const RPATableInterpolator& table, const std::string& label) {
+        std::vector<double> axes[3];
+        test::testTableAxes(axes[0], axes[1], axes[2]);
+
+        std::mt19937_64 rng(5);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        InterpolationCursor cursor;
+        for (int n = 0; n < 2000; ++n) {
+            // A point well inside a random cell, so the finite difference stays in it
+            double x[3], width[3];
+            for (int a = 0; a < 3; ++a) {
+                const size_t i = static_cast<size_t>(unit(rng) * (axes[a].size() - 1));
+                width[a] = axes[a][i + 1] - axes[a][i];
+                x[a] = axes[a][i] + (0.1 + 0.8 * unit(rng)) * width[a];
+            }
+
+            RPATableInterpolator::PerformanceGradient gradient, cursorGradient;
+            const PerformanceData p = table.getPerformanceWithGradient(x[0], x[1], x[2], gradient);
+            double f[6], g[6];
+            values(p, f);
+            values(table.getPerformance(x[0], x[1], x[2]), g);
+            bool same = true;
+            for (int k = 0; k < 6; ++k) same = same && test::sameBits(f[k], g[k]);
+            if (!test::check(same, label + "values differ from getPerformance at " + test::point(x[0], x[1], x[2]))) {
+                return;
+            }
+
+            const PerformanceData* d[3] = { &gradient.dPc, &gradient.dOF, &gradient.dPa };
+            for (int a = 0; a < 3; ++a) {
+                const double h = 1e-4 * width[a];
+                double up[3] = { x[0], x[1], x[2] }, down[3] = { x[0], x[1], x[2] };
+                up[a] += h;
+                down[a] -= h;
+                double fu[6], fd[6], dx[6];
+                values(table.getPerformance(up[0], up[1], up[2]), fu);
+                values(table.getPerformance(down[0], down[1], down[2]), fd);
+                values(*d[a], dx);
+                for (int k = 0; k < 6; ++k) {
+                    const double numeric = (fu[k] - fd[k]) / (2.0 * h);
+                    const double tolerance = 1e-6 * (std::fabs(dx[k]) + std::fabs(f[k]) / width[a]);
+                    if (!test::check(std::fabs(numeric - dx[k]) <= tolerance,
+                                     label + "derivative " + std::to_string(k) + " along axis " + std::to_string(a) +
+                                     " is " + std::to_string(dx[k]) + ", central difference " +
+                                     std::to_string(numeric) + " at " + test::point(x[0], x[1], x[2]))) {
+                        return;
+                    }
+                }
+            }
+
+            // The cursor overload walks the same cells
+            table.getFieldsWithGradient<RPATableInterpolator::MASK_ALL>(x[0], x[1], x[2], cursorGradient, cursor);
+            double c[6], e[6];
+            values(cursorGradient.dOF, c);
+            values(gradient.dOF, e);
+            for (int k = 0; k < 6; ++k) same = same && test::sameBits(c[k], e[k]);
+            test::check(same, label + "cursor gradient differs at " + test::point(x[0], x[1], x[2]));
+        }
+
+        // Clamped below the Pc axis and above the Pa axis
+        RPATableInterpolator::PerformanceGradient gradient;
+        table.getPerformanceWithGradient(10.0, 2.1, 20.0, gradient);
+        double dPc[6], dOF[6], dPa[6];
+        values(gradient.dPc, dPc);
+        values(gradient.dOF, dOF);
+        values(gradient.dPa, dPa);
+        bool zero = true, inside = false;
+        for (int k = 0; k < 6; ++k) {
+            zero = zero && dPc[k] == 0.0 && dPa[k] == 0.0;
+            inside = inside || dOF[k] != 0.0;
+        }
+        test::check(zero, label + "derivative along a clamped axis is not zero");
+        test::check(inside, label + "derivative along the unclamped axis is zero");
+    }
+}
+
+int main() {
+    const std::string csv = test::tempPath("gradient.csv");
+    RPATableInterpolator table;
+    if (!test::writeTestTable(csv) || !table.loadTable(csv)) {
+        std::cerr << "Cannot build the test table" << std::endl;
+        return 1;
+    }
+    std::remove(csv.c_str());
+
+    checkGradients(table, "trilinear: ");
+    table.setInterpolationMode(RPATableInterpolator::InterpolationMode::MonotoneTricubic);
+    checkGradients(table, "tricubic: ");
+    return test::finish("GradientTest");
+}
@@ -0,0 +1,120 @@
+/**
+ * MonteCarloTest
+ *
+ * MonteCarlo results must be bit-identical whatever the thread count and
+ * schedule, and each case must replay alone from caseInputs(). Runs with a
+ * pressure-fed engine on the synthetic table and with the thrust curve.
+ */
+
+#include "MonteCarlo.h"
+#include "PerformanceTableRegistry.h"
+#include "TestSupport.h"
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <cstdio>
+
+namespace {
+    const uint64_t CASES = 120;
+
+    bool sameCase(const MonteCarlo::CaseResult& a, const MonteCarlo::CaseResult& b) {
+        return test::sameBits(a.apogee, b.apogee) && test::sameBits(a.apogeeTime, b.apogeeTime) &&
+               test::sameBits(a.maxSpeed, b.maxSpeed) && test::sameBits(a.flightTime, b.flightTime) &&
+               test::sameBits(a.landing[0], b.landing[0]) && test::sameBits(a.landing[1], b.landing[1]) &&
+               a.steps == b.steps && a.impacted == b.impacted && a.failed == b.failed;
+    }
+
+    void checkRocket(const Rocket& rocket, RigidBodyIntegrator::Method method, const std::string& label) {
+        FlightSim::Settings flight;
+        flight.integrator.method = method;
+        MonteCarlo::Settings settings;
+        settings.seed = 7;
+        settings.threads = 1;
+
+        MonteCarlo serial(rocket, flight, settings);
+        const std::vector<MonteCarlo::CaseResult> reference = serial.run(CASES);
+        test::check(serial.getStats().cases == CASES && serial.getStats().failedCases == 0,
+                    label + ": every case flown");
+
+        // Apogees must actually vary, or identical results would prove nothing
+        size_t varied = 0;
+        for (const MonteCarlo::CaseResult& r : reference) {
+            if (r.apogee != reference[0].apogee) ++varied;
+        }
+        test::check(varied > CASES / 2, label + ": dispersions change the apogee");
+
+        for (unsigned threads : { 2u, 3u, 8u }) {
+            for (MonteCarlo::Schedule schedule : { MonteCarlo::Schedule::WORK_STEALING, MonteCarlo::Schedule::STATIC }) {
+                settings.threads = threads;
+                settings.schedule = schedule;
+                MonteCarlo parallel(rocket, flight, settings);
+                const std::vector<MonteCarlo::CaseResult>& results = parallel.run(CASES);
+                const std::string name = label + " on " + std::to_string(threads) + " threads" +
+                                         (schedule == MonteCarlo::Schedule::STATIC ? " (static)" : "");
+
+                size_t same = 0;
+                for (size_t i = 0; i < CASES && i < results.size(); ++i) {
+                    if (sameCase(results[i], reference[i])) ++same;
+                }
+                test::check(results.size() == CASES && same == CASES,
+                            name + ": " + std::to_string(same) + " of " + std::to_string(CASES) + " identical");
+
+                const MonteCarlo::Stats& stats = parallel.getStats();
+                uint64_t flown = 0;
+                for (uint64_t cases : stats.threadCases) flown += cases;
+                test::check(stats.threads == threads && flown == CASES, name + ": cases shared out");
+                if (schedule == MonteCarlo::Schedule::STATIC) {
+                    test::check(stats.steals == 0, name + ": no steals");
+                }
+            }
+        }
+
+        // A case replays alone from its inputs
+        for (uint64_t i : { uint64_t(0), CASES / 2, CASES - 1 }) {
+            Rocket dispersed;
+            FlightSim::Settings caseFlight;
+            serial.caseInputs(i, dispersed, caseFlight);
+            FlightSim sim(dispersed, caseFlight);
+            const FlightSim::Result result = sim.run();
+            test::check(test::sameBits(result.apogee, reference[i].apogee) &&
+                        test::sameBits(result.flightTime, reference[i].flightTime) &&
+                        result.steps.steps == reference[i].steps,
+                        label + ": case " + std::to_string(i) + " replays");
+            test::check(result.burnoutTime == dispersed.burnTime(), label + ": burnout stepped to exactly");
+        }
+
+        // Another seed draws other dispersions
+        settings.threads = 1;
+        settings.seed = 8;
+        MonteCarlo reseeded(rocket, flight, settings);
+        test::check(!sameCase(reseeded.run(CASES)[0], reference[0]), label + ": seed changes the draws");
+    }
+}
+
+int main() {
+    const std::string csv = test::tempPath("monte_carlo.csv");
+    if (!test::check(test::writeTestTable(csv), "write test table")) {
+        return test::finish("MonteCarloTest");
+    }
+    const PerformanceTableRegistry::TablePtr table = PerformanceTableRegistry::instance().acquire(csv);
+    std::remove(csv.c_str());
+    if (!test::check(table != nullptr, "test table loads")) {
+        return test::finish("MonteCarloTest");
+    }
+
+    Rocket engine;
+    engine.engine.table = table;
+    checkRocket(engine, RigidBodyIntegrator::Method::RK45, "engine, RK45");
+    checkRocket(Rocket(), RigidBodyIntegrator::Method::RK4, "thrust curve, RK4");
+
+    bool threw = false;
+    try {
+        const Rocket rocket;
+        MonteCarlo monteCarlo(rocket, FlightSim::Settings());
+        monteCarlo.run(MonteCarlo::MAX_CASES + 1);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    test::check(threw, "too many cases rejected");
+    return test::finish("MonteCarloTest");
+}
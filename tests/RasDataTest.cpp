@@ -0,0 +1,154 @@
+/**
+ * RasDataTest
+ *
+ * RasData loads of RASAero-style CSV exports: columns found by name (extra
+ * columns ignored, a single CD for both power states), alpha converted to
+ * radians, and files with a missing column or grid point rejected. CoeffData
+ * built from the load must reproduce the grid scaled by the reference area,
+ * interpolate bilinearly between points, clamp at the edges and apply a
+ * rocket's scale factors.
+ */
+
+#include "RasData.h"
+#include "TestSupport.h"
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <cstdio>
+
+namespace {
+    const double PI = 3.14159265358979323846;
+
+    // Bilinear in Mach and alpha (degrees), so interpolation is exact up to rounding
+    double cdOff(double mach, double alpha) { return 0.45 + 0.1 * mach + 0.02 * alpha + 0.003 * mach * alpha; }
+    double cdOn(double mach, double alpha) { return cdOff(mach, alpha) - 0.05; }
+    double cn(double mach, double alpha) { return (0.15 + 0.01 * mach) * alpha; }
+
+    const double MACH[] = { 0.0, 0.1, 0.3, 0.6, 1.0, 1.5 };
+    const double ALPHA[] = { 0.0, 1.0, 2.0, 4.0 };
+
+    /**
+     * Write a RASAero export
+     * @param header Column names; values come from the column's position
+     * @param skip Grid point (index into the rows) left out, or -1
+     */
+    bool writeRas(const std::string& filename, const char* header, bool singleCd, int skip) {
+        FILE* file = std::fopen(filename.c_str(), "w");
+        if (!file) {
+            return false;
+        }
+        std::fprintf(file, "%s\n", header);
+        int row = 0;
+        for (double m : MACH) {
+            for (double a : ALPHA) {
+                if (row++ == skip) continue;
+                if (singleCd) {
+                    std::fprintf(file, "%.17g,%.17g,%.17g,%.17g\n", m, a, cdOff(m, a), cn(m, a));
+                } else {
+                    std::fprintf(file, "%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
+                                 m, a, 0.9 + m, cdOff(m, a), cdOn(m, a), cn(m, a));
+                }
+            }
+        }
+        return std::fclose(file) == 0;
+    }
+
+    void checkLoad(const std::string& path) {
+        RasData ras;
+        test::check(writeRas(path, "Mach,Alpha,CP,CD Power-Off,CD Power-On,CN", false, -1), "write export");
+        if (!test::check(ras.load(path) && ras.isLoaded(), "RASAero export loads")) {
+            return;
+        }
+        test::check(ras.getLoadReport().clean(), "clean load report");
+        test::check(ras.getMachAxis().size() == 6 && ras.getAlphaAxis().size() == 4, "axis sizes");
+        test::check(ras.getAlphaAxis()[3] == 4.0 * PI / 180.0, "alpha in radians");
+        for (size_t i = 0; i < 6; ++i) {
+            for (size_t j = 0; j < 4; ++j) {
+                const double m = MACH[i], a = ALPHA[j];
+                test::check(ras.dragCoefficient(RasData::Power::OFF, i, j) == cdOff(m, a) &&
+                            ras.dragCoefficient(RasData::Power::ON, i, j) == cdOn(m, a) &&
+                            ras.normalCoefficient(i, j) == cn(m, a),
+                            "grid value at Mach " + std::to_string(m) + ", alpha " + std::to_string(a));
+            }
+        }
+
+        // A single CD column serves both power states
+        test::check(writeRas(path, "Mach,Alpha,CD,CN", true, -1), "write single-CD export");
+        test::check(ras.load(path) && ras.dragCoefficient(RasData::Power::ON, 2, 1) == cdOff(MACH[2], ALPHA[1]),
+                    "single CD used for power on");
+
+        test::check(writeRas(path, "Mach,Alpha,CD,CM", true, -1), "write export without CN");
+        test::check(!ras.load(path) && !ras.isLoaded(), "missing CN rejected");
+
+        test::check(writeRas(path, "Alpha,Mach,CD,CN", true, -1), "write export with swapped axes");
+        test::check(!ras.load(path), "axes out of order rejected");
+
+        test::check(writeRas(path, "Mach,Alpha,CD,CN", true, 9), "write export with a hole");
+        test::check(!ras.load(path) && ras.getLoadReport().holeCount == 1, "missing grid point reported");
+        test::check(!ras.load(test::tempPath("no_such_file.csv")), "missing file rejected");
+    }
+
+    void checkCoefficients(const std::string& path) {
+        RasData ras;
+        writeRas(path, "Mach,Alpha,CP,CD Power-Off,CD Power-On,CN", false, -1);
+        if (!test::check(ras.load(path), "export loads for CoeffData")) {
+            return;
+        }
+        const double area = 0.0081;
+        const CoeffData coeff(ras, area);
+        test::check(coeff.getReferenceArea() == area, "reference area kept");
+
+        // Grid points exactly, scaled by the area
+        for (size_t i = 0; i < 6; ++i) {
+            for (size_t j = 0; j < 4; ++j) {
+                const CoeffData::Coefficients c =
+                    coeff.lookup(RasData::Power::ON, MACH[i], ALPHA[j] * PI / 180.0, 1.0, 1.0);
+                test::check(test::sameBits(c.dragArea, cdOn(MACH[i], ALPHA[j]) * area) &&
+                            test::sameBits(c.normalArea, cn(MACH[i], ALPHA[j]) * area),
+                            "grid point " + std::to_string(i) + ", " + std::to_string(j));
+            }
+        }
+
+        // Between points the bilinear fields come back to rounding
+        for (double m = 0.05; m < 1.5; m += 0.137) {
+            for (double a = 0.25; a < 4.0; a += 0.61) {
+                const CoeffData::Coefficients c = coeff.lookup(RasData::Power::OFF, m, a * PI / 180.0, 1.0, 1.0);
+                test::check(std::fabs(c.dragArea - cdOff(m, a) * area) <= 1e-14 &&
+                            std::fabs(c.normalArea - cn(m, a) * area) <= 1e-14,
+                            "interpolated at Mach " + std::to_string(m) + ", alpha " + std::to_string(a));
+            }
+        }
+
+        // Clamped outside the table, and the rocket's scales applied
+        const CoeffData::Coefficients edge = coeff.lookup(RasData::Power::OFF, 1.5, 4.0 * PI / 180.0, 1.0, 1.0);
+        const CoeffData::Coefficients beyond = coeff.lookup(RasData::Power::OFF, 3.0, 0.5, 1.0, 1.0);
+        test::check(test::sameBits(beyond.dragArea, edge.dragArea) && test::sameBits(beyond.normalArea, edge.normalArea),
+                    "clamped beyond the top corner");
+        const CoeffData::Coefficients scaled = coeff.lookup(RasData::Power::OFF, 1.5, 4.0 * PI / 180.0, 1.1, 0.9);
+        test::check(test::sameBits(scaled.dragArea, edge.dragArea * 1.1) &&
+                    test::sameBits(scaled.normalArea, edge.normalArea * 0.9), "scale factors applied");
+
+        bool threw = false;
+        try {
+            CoeffData bad(ras, 0.0);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        test::check(threw, "zero reference area rejected");
+        threw = false;
+        try {
+            CoeffData bad(RasData(), area);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        test::check(threw, "unloaded data rejected");
+    }
+}
+
+int main() {
+    const std::string path = test::tempPath("ras.csv");
+    checkLoad(path);
+    checkCoefficients(path);
+    std::remove(path.c_str());
+    return test::finish("RasDataTest");
+}
@@ -0,0 +1,119 @@
+/**
+ * RegistryTest.cpp
+ *
+ * PerformanceTableRegistry must hand every caller of a file the same table,
+ * keep one table per storage precision, coalesce concurrent first loads,
+ * reload a file whose contents changed and retry a file that failed to load.
+ */
+
+#include "TestSupport.h"
+#include "PerformanceTableRegistry.h"
+#include "ThrustCalculator.h"
+#include <thread>
+#include <cstdio>
+
+namespace {
+    typedef PerformanceTableRegistry::TablePtr TablePtr;
+
+    // The test table with Cf scaled, written with fewer digits so the file
+    // size changes too
+    void writeScaledTable(const std::string& filename, double cfScale) {
+        std::vector<double> Pc, OF, Pa;
+        test::testTableAxes(Pc, OF, Pa);
+        std::FILE* file = std::fopen(filename.c_str(), "w");
+        std::fprintf(file, "Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma\n");
+        for (double p : Pc) {
+            for (double o : OF) {
+                for (double a : Pa) {
+                    double v[6];
+                    test::testTableValues(p, o, a, v);
+                    std::fprintf(file, "%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g\n",
+                                 p, o, a, v[0] * cfScale, v[1], v[2], v[3], v[4], v[5]);
+                }
+            }
+        }
+        std::fclose(file);
+    }
+}
+
+int main() {
+    PerformanceTableRegistry& registry = PerformanceTableRegistry::instance();
+    const std::string csv = test::tempPath("registry.csv");
+    const std::string compiled = test::tempPath("registry.rpat");
+    if (!test::writeTestTable(csv) || !RPATableInterpolator::compileTable(csv, compiled)) {
+        std::cerr << "Cannot build the test table" << std::endl;
+        return 1;
+    }
+
+    // One table per file, shared by every caller and thread
+    TablePtr first = registry.acquire(csv);
+    test::check(first != nullptr, "CSV table does not load");
+    test::check(registry.acquire(csv) == first, "second acquire loaded the table again");
+
+    ThrustCalculator a, b;
+    test::check(a.loadPerformanceTable(csv) && b.loadPerformanceTable(csv), "calculators cannot load the table");
+    test::check(a.getPerformanceTable() == first && b.getPerformanceTable() == first,
+                "calculators do not share the registry's table");
+
+    TablePtr mapped = registry.acquire(compiled);
+    test::check(mapped != nullptr && mapped != first && mapped->isMemoryMapped(),
+                "compiled table not detected or not mapped");
+    test::check(mapped && test::sameBits(mapped->getPerformance(333.0, 2.1, 3.3).Cf,
+                                         first->getPerformance(333.0, 2.1, 3.3).Cf),
+                "compiled and CSV tables differ");
+
+    // Each storage precision of a file is its own table
+    TablePtr packed = registry.acquire(csv, RPATableInterpolator::StoragePrecision::Fixed16);
+    test::check(packed != nullptr && packed != first &&
+                packed->getStoragePrecision() == RPATableInterpolator::StoragePrecision::Fixed16,
+                "Fixed16 acquire returned the double table");
+    test::check(registry.acquire(csv, RPATableInterpolator::StoragePrecision::Fixed16) == packed,
+                "second Fixed16 acquire loaded the table again");
+    packed.reset();
+
+    // Concurrent first requests wait for one load
+    mapped.reset();
+    registry.purge();
+    std::vector<TablePtr> results(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&registry, &results, &compiled, i]() { results[i] = registry.acquire(compiled); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    bool shared = results[0] != nullptr;
+    for (const TablePtr& table : results) {
+        shared = shared && table == results[0];
+    }
+    test::check(shared, "concurrent acquires did not share one table");
+    test::check(registry.size() == 2, "registry holds " + std::to_string(registry.size()) + " tables, not 2");
+
+    // Editing the file yields a fresh table; holders of the old one keep it
+    const double oldCf = first->getPerformance(333.0, 2.1, 3.3).Cf;
+    writeScaledTable(csv, 2.0);
+    TablePtr edited = registry.acquire(csv);
+    test::check(edited != nullptr && edited != first, "edited file did not reload");
+    test::check(edited && std::fabs(edited->getPerformance(333.0, 2.1, 3.3).Cf - 2.0 * oldCf) < 1e-6,
+                "reloaded table has the old contents");
+    test::check(test::sameBits(first->getPerformance(333.0, 2.1, 3.3).Cf, oldCf), "old table changed");
+
+    // Released tables are dropped; a failed load is not remembered
+    first.reset();
+    a.setPerformanceTable(nullptr);
+    b.setPerformanceTable(nullptr);
+    results.clear();
+    registry.purge();
+    test::check(registry.size() == 1, "released tables still alive");
+    std::FILE* file = std::fopen(csv.c_str(), "w");
+    std::fprintf(file, "Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma\n100,2,0,1.5\n");
+    std::fclose(file);
+    test::check(registry.acquire(csv) == nullptr, "malformed table accepted");
+    writeScaledTable(csv, 1.0);
+    test::check(registry.acquire(csv) != nullptr, "table not retried after a failed load");
+    test::check(registry.acquire(test::tempPath("missing.csv")) == nullptr, "missing file accepted");
+
+    std::remove(csv.c_str());
+    std::remove(compiled.c_str());
+    return test::finish("RegistryTest");
+}
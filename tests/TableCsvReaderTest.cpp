@@ -0,0 +1,169 @@
+/**
+ * TableCsvReaderTest.cpp
+ *
+ * TableCsvReader must report skipped rows with their line, column and
+ * reason, rows repeating a grid point and grid points no row provides, with
+ * the same report and grid whether a file is parsed on one thread or many.
+ */
+
+#include "TestSupport.h"
+#include "TableCsvReader.h"
+#include "RPATableInterpolator.h"
+#include <fstream>
+#include <cstdio>
+
+namespace {
+    TableCsvReader::Settings settings(unsigned threads) {
+        TableCsvReader::Settings s;
+        s.axisColumns = 3;
+        s.valueColumns = 6;
+        s.allowExtraColumns = false;
+        s.threads = threads;
+        return s;
+    }
+
+    void writeFile(const std::string& filename, const std::string& contents) {
+        std::ofstream out(filename, std::ios::binary);
+        out << contents;
+    }
+
+    // Grid point of a 2x2x2 table: coordinates and values derived from the index
+    std::string row(int i, int j, int k, double value) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%d,%d,%d,%.17g,2,3,4,5,6\n", 100 * (i + 1), j + 2, 10 * k, value);
+        return line;
+    }
+
+    void checkDiagnostics() {
+        const std::string csv = test::tempPath("diagnostics.csv");
+        std::string contents = "Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma\n";     // Line 1
+        for (int n = 0; n < 8; ++n) {                                         // Lines 2-9
+            contents += row(n >> 2, (n >> 1) & 1, n & 1, 1.0 + n);
+        }
+        contents += "100,2,0,1.5,2,3\n";                                      // 10: too few columns
+        contents += "100,2,0,1.5,2,3,4,5,6,7\n";                              // 11: too many columns
+        contents += "100,2,abc,1.5,2,3,4,5,6\n";                              // 12: malformed Pa
+        contents += "nan,2,0,1.5,2,3,4,5,6\n";                                // 13: non-finite Pc
+        contents += "\n";                                                     // 14: blank
+        contents += row(1, 1, 0, 42.0);                                       // 15: repeats line 8
+        writeFile(csv, contents);
+
+        TableCsvReader reader(settings(1));
+        test::check(reader.read(csv), "table with bad rows but no holes rejected");
+        const TableCsvReader::Report& report = reader.getReport();
+        test::check(report.dataRows == 13 && report.loadedRows == 9,
+                    "counted " + std::to_string(report.dataRows) + " data rows and " +
+                    std::to_string(report.loadedRows) + " loaded, not 13 and 9");
+        test::check(report.skippedRowCount == 4 && report.skippedRows.size() == 4, "skipped rows not all reported");
+        test::check(report.duplicateCount == 1 && report.holeCount == 0 && !report.clean(), "wrong problem counts");
+
+        const size_t lines[4] = { 10, 11, 12, 13 };
+        const TableCsvReader::SkipReason reasons[4] = {
+            TableCsvReader::SKIP_TOO_FEW_COLUMNS, TableCsvReader::SKIP_TOO_MANY_COLUMNS,
+            TableCsvReader::SKIP_MALFORMED_VALUE, TableCsvReader::SKIP_NON_FINITE_COORDINATE
+        };
+        const size_t columns[4] = { 0, 10, 3, 1 };
+        for (size_t i = 0; i < 4 && i < report.skippedRows.size(); ++i) {
+            const TableCsvReader::SkippedRow& skipped = report.skippedRows[i];
+            test::check(skipped.line == lines[i] && skipped.reason == reasons[i] && skipped.column == columns[i],
+                        "skipped row " + std::to_string(i) + " reported as line " + std::to_string(skipped.line) +
+                        ", " + TableCsvReader::skipReasonName(skipped.reason) + ", column " +
+                        std::to_string(skipped.column));
+        }
+        test::check(!report.duplicates.empty() && report.duplicates[0].line == 15 &&
+                    report.duplicates[0].firstLine == 8, "duplicate not reported against its first row");
+
+        // The later row wins; the Cf block has the last axis varying fastest
+        std::vector<double> grid;
+        reader.takeGrid(grid);
+        test::check(grid.size() == 48 && grid[6] == 42.0, "repeated grid point does not take the later value");
+        std::remove(csv.c_str());
+    }
+
+    void checkHoles() {
+        const std::string csv = test::tempPath("holes.csv");
+        std::string contents = "Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma\n";
+        for (int n = 0; n < 8; ++n) {
+            if (n != 5) contents += row(n >> 2, (n >> 1) & 1, n & 1, 1.0 + n);
+        }
+        writeFile(csv, contents);
+
+        TableCsvReader reader(settings(1));
+        test::check(!reader.read(csv), "table with a missing grid point accepted");
+        const TableCsvReader::Report& report = reader.getReport();
+        test::check(report.holeCount == 1 && report.holes.size() == 1 && report.holes[0] == std::vector<double>{ 200, 2, 10 },
+                    "missing grid point not reported with its coordinates");
+
+        RPATableInterpolator table;
+        test::check(!table.loadTable(csv) && table.getLoadReport().holeCount == 1,
+                    "interpolator does not report the missing grid point");
+        std::remove(csv.c_str());
+    }
+
+    // A file large enough to be split: a bad row and a duplicate far into it
+    void checkThreads() {
+        const std::string csv = test::tempPath("threads.csv");
+        std::string contents = "Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma\n";
+        char line[256];
+        for (int i = 0; i < 60; ++i) {
+            for (int j = 0; j < 40; ++j) {
+                for (int k = 0; k < 10; ++k) {
+                    const double v = 1.0 + 0.001 * i + 0.01 * j + 0.1 * k;
+                    std::snprintf(line, sizeof(line), "%d,%.2f,%d,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
+                                  100 + 10 * i, 1.0 + 0.05 * j, k, v, 1500 * v, 300 * v, 3000 * v, 2 * v, 1.2 * v);
+                    contents += line;
+                    if (i == 50 && j == 20 && k == 5) {
+                        contents += "700,2.00,5,1.0,x,1,1,1,1\n";
+                        contents += line;
+                    }
+                }
+            }
+        }
+        writeFile(csv, contents);
+
+        TableCsvReader serial(settings(1)), parallel(settings(4));
+        test::check(serial.read(csv) && parallel.read(csv), "large table does not load");
+        const TableCsvReader::Report& a = serial.getReport();
+        const TableCsvReader::Report& b = parallel.getReport();
+        test::check(b.threads > 1, "large table was not split");
+        test::check(a.dataRows == b.dataRows && a.loadedRows == b.loadedRows && a.skippedRowCount == 1 &&
+                    b.skippedRowCount == 1 && a.duplicateCount == 1 && b.duplicateCount == 1,
+                    "parallel report counts differ from serial");
+        test::check(!b.skippedRows.empty() && b.skippedRows[0].line == a.skippedRows[0].line &&
+                    b.skippedRows[0].column == 5, "parallel skipped-row line or column wrong");
+        test::check(!b.duplicates.empty() && b.duplicates[0].line == a.duplicates[0].line &&
+                    b.duplicates[0].firstLine == a.duplicates[0].firstLine &&
+                    b.duplicates[0].line == b.duplicates[0].firstLine + 2,
+                    "parallel duplicate lines wrong");
+
+        std::vector<double> ga, gb;
+        serial.takeGrid(ga);
+        parallel.takeGrid(gb);
+        bool same = ga.size() == gb.size() && ga.size() == 60 * 40 * 10 * 6;
+        for (size_t i = 0; same && i < ga.size(); ++i) same = test::sameBits(ga[i], gb[i]);
+        test::check(same, "parallel grid differs from serial");
+        std::remove(csv.c_str());
+    }
+}
+
+int main() {
+    const std::string csv = test::tempPath("clean.csv");
+    TableCsvReader reader(settings(0));
+    if (!test::writeTestTable(csv) || !reader.read(csv)) {
+        std::cerr << "Cannot read the test table" << std::endl;
+        return 1;
+    }
+    std::remove(csv.c_str());
+    std::vector<double> Pc, OF, Pa;
+    test::testTableAxes(Pc, OF, Pa);
+    const TableCsvReader::Report& report = reader.getReport();
+    test::check(report.clean() && report.loadedRows == Pc.size() * OF.size() * Pa.size(),
+                "clean table reported problems");
+    test::check(reader.getAxis(0) == Pc && reader.getAxis(1) == OF && reader.getAxis(2) == Pa,
+                "axes differ from the written table");
+
+    checkDiagnostics();
+    checkHoles();
+    checkThreads();
+    return test::finish("TableCsvReaderTest");
+}
@@ -0,0 +1,112 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+/**
+ * TestSupport
+ *
+ * Shared pieces of the programs in tests/. Each test is a standalone program
+ * that reports failed checks on stderr and exits non-zero if any failed.
+ */
+namespace test {
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    /**
+     * Record a check; the first few failures are printed
+     */
+    inline bool check(bool ok, const std::string& message) {
+        if (!ok && ++failures() <= 20) {
+            std::cerr << "FAIL: " << message << std::endl;
+        }
+        return ok;
+    }
+
+    /**
+     * Print the outcome and return the process exit code
+     */
+    inline int finish(const char* name) {
+        if (failures() == 0) {
+            std::cout << name << ": ok" << std::endl;
+            return 0;
+        }
+        std::cout << name << ": " << failures() << " failed checks" << std::endl;
+        return 1;
+    }
+
+    inline bool sameBits(double a, double b) {
+        return std::memcmp(&a, &b, sizeof(double)) == 0;
+    }
+
+    inline std::string point(double Pc, double OF, double Pa) {
+        return "(" + std::to_string(Pc) + ", " + std::to_string(OF) + ", " + std::to_string(Pa) + ")";
+    }
+
+    /**
+     * Scratch file in the working directory (the build directory under ctest)
+     */
+    inline std::string tempPath(const std::string& name) {
+        return "rpa_test_" + name;
+    }
+
+    /**
+     * Axes of the synthetic test table: Pc 50-1000 psi (unevenly spaced),
+     * O/F 1-3.5, Pa 0-14.7 psi
+     */
+    inline void testTableAxes(std::vector<double>& Pc, std::vector<double>& OF, std::vector<double>& Pa) {
+        Pc.clear();
+        OF.clear();
+        Pa.clear();
+        for (double p = 50.0; p <= 1000.0; p += p < 300.0 ? 25.0 : 50.0) Pc.push_back(p);
+        for (int i = 0; i <= 10; ++i) OF.push_back(1.0 + 0.25 * i);
+        for (int i = 0; i <= 6; ++i) Pa.push_back(14.7 * i / 6.0);
+    }
+
+    /**
+     * Smooth, curved stand-in for RPA output at one grid point
+     * @param values Cf, Cstar, Isp, Ve, Pe, gamma
+     */
+    inline void testTableValues(double Pc, double OF, double Pa, double values[6]) {
+        values[0] = 1.25 + 0.12 * std::log(Pc / 50.0) - 0.015 * Pa + 0.02 * OF - 0.004 * OF * OF;
+        values[1] = 1450.0 + 180.0 * OF - 38.0 * OF * OF + 0.04 * Pc;
+        values[2] = values[0] * values[1] / 9.80665;
+        values[3] = values[2] * 9.80665 + 0.5 * Pa;
+        values[4] = 0.02 * Pc / (1.0 + 0.1 * OF);
+        values[5] = 1.25 - 0.01 * OF + 1e-5 * Pc;
+    }
+
+    /**
+     * Write the synthetic table as a generate_rpa_tables.js CSV
+     * @return false if the file cannot be written
+     */
+    inline bool writeTestTable(const std::string& filename) {
+        FILE* file = std::fopen(filename.c_str(), "w");
+        if (!file) {
+            return false;
+        }
+        std::vector<double> Pc, OF, Pa;
+        testTableAxes(Pc, OF, Pa);
+        std::fprintf(file, "Pc,OF,Pa,Cf,Cstar,Isp,Ve,Pe,Gamma\n");
+        for (double p : Pc) {
+            for (double o : OF) {
+                for (double a : Pa) {
+                    double v[6];
+                    testTableValues(p, o, a, v);
+                    std::fprintf(file, "%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
+                                 p, o, a, v[0], v[1], v[2], v[3], v[4], v[5]);
+                }
+            }
+        }
+        return std::fclose(file) == 0;
+    }
+}
+
+#endif // TEST_SUPPORT_H
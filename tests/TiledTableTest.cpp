@@ -0,0 +1,152 @@
+/**
+ * TiledTableTest.cpp
+ *
+ * A tiled table must answer every query bit for bit like the in-memory
+ * table it was written from, keep at most its budget of bricks resident,
+ * evict the least recently used brick first, count brick hits and misses
+ * exactly, and reject a corrupt brick when it is read.
+ */
+
+#include "TestSupport.h"
+#include "RPATableInterpolator.h"
+#include "PerformanceTableRegistry.h"
+#include <random>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <cstdio>
+
+namespace {
+    const size_t BRICK_CELLS = 4;
+
+    bool sameData(const RPATableInterpolator::PerformanceData& a, const RPATableInterpolator::PerformanceData& b) {
+        return test::sameBits(a.Cf, b.Cf) && test::sameBits(a.Cstar, b.Cstar) && test::sameBits(a.Isp, b.Isp) &&
+               test::sameBits(a.Ve, b.Ve) && test::sameBits(a.Pe, b.Pe) && test::sameBits(a.gamma, b.gamma);
+    }
+
+    std::string counts(const TiledGrid::Stats& stats) {
+        return std::to_string(stats.hits) + " hits, " + std::to_string(stats.misses) + " misses, " +
+               std::to_string(stats.evictions) + " evictions";
+    }
+
+    void checkQueries(const RPATableInterpolator& memory, const RPATableInterpolator& tiled) {
+        std::mt19937_64 rng(19);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        InterpolationCursor cursor;
+        double Pc = 400.0, OF = 2.0, Pa = 7.0;
+        for (int i = 0; i < 20000; ++i) {
+            // Random points, including some off the table, then a walk for the cursor
+            const double x = -100.0 + 1300.0 * unit(rng), y = 0.5 + 3.5 * unit(rng), z = -1.0 + 17.0 * unit(rng);
+            if (!test::check(sameData(tiled.getPerformance(x, y, z), memory.getPerformance(x, y, z)),
+                             "tiled query differs at " + test::point(x, y, z))) {
+                return;
+            }
+            Pc = std::min(1100.0, std::max(0.0, Pc + 20.0 * (unit(rng) - 0.5)));
+            OF = std::min(4.0, std::max(0.5, OF + 0.02 * (unit(rng) - 0.5)));
+            Pa = std::min(16.0, std::max(-1.0, Pa + 0.1 * (unit(rng) - 0.5)));
+            if (!test::check(sameData(tiled.getPerformance(Pc, OF, Pa, cursor), memory.getPerformance(Pc, OF, Pa)),
+                             "tiled cursor query differs at " + test::point(Pc, OF, Pa))) {
+                return;
+            }
+        }
+    }
+
+    // Brick cache of two bricks: LRU order decides which one a third evicts
+    void checkEviction(const std::string& tiledFile, size_t brickBytes, const std::vector<double>& PcAxis) {
+        RPATableInterpolator tiled;
+        tiled.setTilePrefetch(false);
+        if (!test::check(tiled.loadTiledTable(tiledFile, 2 * brickBytes), "tiled table does not load")) {
+            return;
+        }
+        test::check(tiled.getTileStats().capacityBricks == 2, "cache budget of two bricks not honoured");
+
+        // Middle of the first Pc cell of bricks 0, 1 and 2 along Pc
+        auto brick = [&](size_t b) {
+            const size_t cell = b * BRICK_CELLS;
+            return tiled.getPerformance(0.5 * (PcAxis[cell] + PcAxis[cell + 1]), 1.1, 1.0).Cf;
+        };
+        const struct {
+            size_t brick;
+            uint64_t hits, misses, evictions;
+        } steps[] = {
+            { 0, 0, 1, 0 },     // Read A
+            { 1, 0, 2, 0 },     // Read B
+            { 0, 1, 2, 0 },     // A is resident and becomes most recent
+            { 2, 1, 3, 1 },     // Reading C evicts B, the least recently used
+            { 0, 2, 3, 1 },     // A survived
+            { 1, 2, 4, 2 }      // B was evicted
+        };
+        for (const auto& step : steps) {
+            brick(step.brick);
+            const TiledGrid::Stats stats = tiled.getTileStats();
+            if (!test::check(stats.hits == step.hits && stats.misses == step.misses &&
+                             stats.evictions == step.evictions && stats.residentBricks <= 2,
+                             "after reading brick " + std::to_string(step.brick) + ": " + counts(stats))) {
+                return;
+            }
+        }
+        test::check(tiled.getTileStats().hitRate() == 2.0 / 6.0, "hit rate does not match the counts");
+        tiled.resetTileStats();
+        test::check(tiled.getTileStats().hits == 0 && tiled.getTileStats().misses == 0, "stats not reset");
+    }
+}
+
+int main() {
+    const std::string csv = test::tempPath("tiled.csv");
+    const std::string tiledFile = test::tempPath("tiled.rptl");
+    RPATableInterpolator memory;
+    if (!test::writeTestTable(csv) || !memory.loadTable(csv) || !memory.saveTiledTable(tiledFile, BRICK_CELLS)) {
+        std::cerr << "Cannot build the test table" << std::endl;
+        return 1;
+    }
+    std::remove(csv.c_str());
+
+    std::vector<double> Pc, OF, Pa;
+    test::testTableAxes(Pc, OF, Pa);
+
+    // A cache of a few bricks keeps reading bricks back in
+    RPATableInterpolator tiled;
+    if (!tiled.loadTiledTable(tiledFile)) {
+        std::cerr << "Cannot load the tiled table" << std::endl;
+        return 1;
+    }
+    const size_t brickBytes = tiled.getTileStats().brickBytes;
+    if (test::check(tiled.loadTiledTable(tiledFile, 4 * brickBytes), "tiled table does not reload")) {
+        test::check(tiled.isTiled() && !memory.isTiled(), "isTiled is wrong");
+        checkQueries(memory, tiled);
+        const TiledGrid::Stats stats = tiled.getTileStats();
+        test::check(stats.misses > 0 && stats.evictions > 0 && stats.residentBricks <= stats.capacityBricks,
+                    "sweep did not cycle the cache: " + counts(stats));
+    }
+    checkEviction(tiledFile, brickBytes, Pc);
+
+    // The registry recognises tiled files
+    PerformanceTableRegistry::TablePtr shared = PerformanceTableRegistry::instance().acquire(tiledFile);
+    test::check(shared && shared->isTiled(), "registry did not load the tiled table");
+    shared.reset();
+    PerformanceTableRegistry::instance().purge();
+
+    // Flip the last byte, in the brick of the table's top corner
+    {
+        std::fstream file(tiledFile, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(-1, std::ios::end);
+        const char last = static_cast<char>(file.get());
+        file.seekp(-1, std::ios::end);
+        file.put(static_cast<char>(last ^ 0x40));
+    }
+    RPATableInterpolator corrupt;
+    bool threw = false;
+    if (test::check(corrupt.loadTiledTable(tiledFile), "a corrupt brick failed the load")) {
+        test::check(sameData(corrupt.getPerformance(60.0, 1.1, 1.0), memory.getPerformance(60.0, 1.1, 1.0)),
+                    "intact brick of a corrupt file differs");
+        try {
+            corrupt.getPerformance(990.0, 3.4, 14.0);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+    }
+    test::check(threw, "corrupt brick was not rejected");
+    std::remove(tiledFile.c_str());
+
+    return test::finish("TiledTableTest");
+}